@@ -0,0 +1,77 @@
+#pragma once
+
+#include <curl/curl.h>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 进程级共享的 curl multi 引擎，所有出站 HTTP 调用（LLM、语音、MCP）经它执行
+ *
+ * 每个 worker 线程持有一个 multi 句柄，以 curl_multi_poll 驱动其上的全部传输：
+ * - 同一 multi 上的连接缓存跨请求复用，HTTPS 请求协商 HTTP/2（2TLS），
+ *   并发请求通过 PIPEWAIT 等待已有连接确认多路复用后共用一条连接，而不是各自握手；
+ * - 所有 worker 共享一个 CURLSH，DNS 解析结果与 TLS 会话（用于会话恢复）跨线程复用；
+ * - 引擎自身的线程数与传输数无关，只有 threads 个。
+ *
+ * 注意 perform() 会阻塞调用线程直到传输结束：经 perform() 发起的流式对话（AIHelper::chatStream）
+ * 在整条流期间仍占用调用方的一个线程（AI 线程池），并发流数受该线程池大小限制；只有 submit() 不占用调用线程。
+ *
+ * 调用方负责 easy 句柄的创建、设置与清理，以及回调所用缓冲区/头部的生命周期（须持续到完成）。
+ * 传输的读写/进度回调与完成回调都在 worker 线程上执行，不得阻塞，也不得在其中调用 perform()。
+ */
+class CurlEngine
+{
+public:
+    struct Options
+    {
+        int threads = 1;                  // worker 线程（multi 句柄）数
+        long maxHostConnections = 0;      // 每个 host 的连接上限，0 为不限
+        long maxTotalConnections = 0;     // 每个 worker 的连接上限，0 为不限
+        long maxConnectsCache = 64;       // 每个 worker 空闲连接缓存大小
+        long maxConcurrentStreams = 100;  // 单条 HTTP/2 连接上的并发流上限
+    };
+
+    /// 传输完成回调，在 worker 线程上调用；此时 easy 句柄已从 multi 移除，可由调用方清理
+    using Completion = std::function<void(CURLcode)>;
+
+    /// 进程级单例，首次调用时按 configure() 的参数启动
+    static CurlEngine& instance();
+
+    /// 设置单例参数，须在首次 instance() 之前调用（ChatServer 初始化时），之后调用无效
+    static void configure(const Options& options);
+
+    explicit CurlEngine(const Options& options);
+    ~CurlEngine();
+
+    CurlEngine(const CurlEngine&) = delete;
+    CurlEngine& operator=(const CurlEngine&) = delete;
+
+    /// 异步提交：立即返回，传输结束（含失败）后调用 done
+    void submit(CURL* easy, Completion done);
+
+    /// 同步执行，等价于 curl_easy_perform 但复用引擎的连接、DNS 与 TLS 会话
+    CURLcode perform(CURL* easy);
+
+    /// 唤醒所有 worker 立即驱动一轮传输，可在任意线程调用。暂停中的传输只在 worker 驱动时得到进度回调，
+    /// 下游恢复可写时调用它，传输即可在进度回调中恢复，而不必等到 curl_multi_poll 超时（最长 1s）
+    void wakeup();
+
+    /// 进行中（含排队）的传输数
+    size_t inflight() const
+    {
+        return inflight_.load(std::memory_order_relaxed);
+    }
+
+private:
+    class Worker;
+    struct Share;
+
+    std::unique_ptr<Share> share_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> next_{0};
+    std::atomic<size_t> inflight_{0};
+};
@@ -3,7 +3,6 @@
 #include <curl/curl.h>
 #include <functional>
 #include <iostream>
-#include <map>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -14,6 +13,8 @@
 #include "Common/Threading/ThreadPool.h"
 #include "common/Message.h"
 #include "llm/AIFactory.h"
+#include "llm/SerializedHistory.h"
+#include "llm/StreamDeltaParser.h"
 #include "mcp/AIToolRegistry.h"
 #include "storage/MysqlUtil.h"
 
@@ -29,7 +30,7 @@ class SessionCache;
  * @brief AI助手类，封装curl访问各模型的接口。
  *
  * 线程安全说明：
- * - msgMutex_ 保护 messages_ 向量的所有读写
+ * - msgMutex_ 保护 messages_ 向量及其序列化缓存 history_ 的所有读写
  * - processing_ 原子标志保证同一 session 同一时刻只有一个 chatStream() 在执行
  */
 class AIHelper
@@ -38,6 +39,15 @@ public:
     /// SSE 流式回调类型：每收到一个数据块调用一次，返回 false 表示中止
     using StreamCallback = std::function<bool(const std::string& chunk)>;
 
+    /// 下游（如 SSE 客户端）的接收状态，用于流式传输的背压
+    enum class Downstream
+    {
+        kWritable,  ///< 可继续接收
+        kFull,      ///< 缓冲已满：暂停读取上游（curl 暂停传输），恢复后继续
+        kClosed,    ///< 已断开：中止传输
+    };
+    using DownstreamCheck = std::function<Downstream()>;
+
     AIHelper(storage::MysqlUtil* mysqlUtil = nullptr,
              common::ThreadPool* threadPool = nullptr,
              infra::cache::SessionCache* sessionCache = nullptr);
@@ -67,6 +77,7 @@ public:
      * 作为项目唯一的 AI 对话入口函数（v2.1.0 已移除非流式 chat()）。
      *
      * @param onChunk 每个 chunk 的回调，返回 false 终止流
+     * @param downstream 可选的背压检查，见 Downstream
      * @return 完整的 AI 回复内容（用于持久化）
      */
     std::string chatStream(int userId,
@@ -79,7 +90,8 @@ public:
                            std::string modelId,
                            StreamCallback onChunk,
                            std::string endpointId = "",
-                           bool isNewSession = false);
+                           bool isNewSession = false,
+                           DownstreamCheck downstream = nullptr);
 
     json request(const json& payload);
 
@@ -124,22 +136,29 @@ public:
 
     /**
      * @brief 流式 curl 请求，每收到数据块调用 onChunk
-     * @return 完整响应字符串
+     * @param body 已序列化的请求体
+     * @param downstream kFull 时暂停传输（CURL_WRITEFUNC_PAUSE），由进度回调轮询恢复；kClosed 时中止
+     * @return 累积的文本、合并后的 tool_calls、finish_reason 与 usage
      */
-    std::string executeCurlStream(const json& payload, StreamCallback onChunk);
+    StreamResult executeCurlStream(const std::string& body,
+                                  StreamCallback onChunk,
+                                  DownstreamCheck downstream = nullptr);
 
     static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp);
 
     /// SSE 流式回调的 userdata 结构
     struct StreamContext
     {
-        std::string buffer;             ///< 未处理的数据缓冲
-        std::string fullContent;        ///< 累积的文本 token（拼成 choices[0].message.content）
-        std::map<int, json> toolCalls;  ///< 按 index 累积 tool_calls 增量（id/type/function.name/function.arguments）
-        StreamCallback callback;
+        explicit StreamContext(StreamCallback onToken) : parser(std::move(onToken)) {}
+
+        StreamDeltaParser parser;  ///< 切行 + 提取 delta，累积文本与 tool_calls
+        DownstreamCheck downstream;
+        CURL* curl = nullptr;
+        bool paused = false;
         bool aborted = false;
     };
     static size_t StreamWriteCallback(void* contents, size_t size, size_t nmemb, void* userp);
+    static int StreamProgressCallback(void* userp, curl_off_t, curl_off_t, curl_off_t, curl_off_t);
 
     json buildMessagesPayload(const std::vector<Message>& msgs) const;
 
@@ -147,12 +166,19 @@ private:
     std::shared_ptr<AIStrategy> strategy;
     mutable std::mutex msgMutex_;
     std::vector<Message> messages_;
+    SerializedHistory history_;  ///< messages_ 的序列化缓存，非追加式修改 messages_ 时须同步 truncate
     std::atomic<bool> processing_;
     storage::MysqlUtil* mysqlUtil_ = nullptr;
     common::ThreadPool* threadPool_ = nullptr;
     infra::cache::SessionCache* sessionCache_ = nullptr;  ///< 可选的 Redis 对话上下文缓存
     std::string pendingUserPayload_;                      ///< 待入库的 user 消息 payload（一次性消费）
 
+    /**
+     * @brief 由 history_ 拼出本轮流式请求体（不含 tools）：Dr.Rain 人设 + 消息历史
+     * @param reserveExtra 额外预留的容量，随后拼入 tools 时不再扩容
+     */
+    std::string buildStreamBody(const std::string& modelName, size_t reserveExtra);
+
     /// 异步 LLM 标题生成（新会话首条对话完成后调用，复用当前策略与模型名）
     void startTitleSummarization(const std::string& sessionId,
                                  const std::string& userQuestion,
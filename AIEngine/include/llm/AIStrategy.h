@@ -9,6 +9,7 @@
 #include "3rdparty/JsonUtil.h"
 #include "Common/Config/ConfigManager.h"
 #include "common/Message.h"
+#include "llm/StreamDeltaParser.h"
 
 /// OpenAI tool_calls 中的单个调用信息
 struct ToolCallInfo
@@ -18,6 +19,13 @@ struct ToolCallInfo
     json arguments;    ///< function.arguments (已解析的 JSON 对象)
 };
 
+/// 流式请求体中 messages 数组前后的固定部分：head + messages[] + tail 即完整请求体
+struct RequestEnvelope
+{
+    std::string head;
+    std::string tail;
+};
+
 class AIStrategy
 {
 public:
@@ -50,12 +58,35 @@ public:
                               const json& tools = json::object(),
                               const std::string& modelName = "") const = 0;
 
-    /// 从 LLM 响应中提取文本内容（兼容现有代码）
+    /**
+     * @brief 流式请求（stream=true）的外壳，调用方在中间拼入已序列化的 messages 数组，不经过 json 树
+     *
+     * 拼接结果与 buildRequest(messages, {}, modelName) 加 stream=true 后 dump() 逐字节一致；messages 位于最前，
+     * 同一会话各轮请求体的前缀保持不变。默认按 OpenAI 兼容格式。
+     */
+    virtual RequestEnvelope streamEnvelope(const std::string& modelName) const;
+
+    /// 请求体是否接受 tools 字段（Function Calling）；为 false 时调用方不拼入工具快照
+    virtual bool supportsTools() const
+    {
+        return true;
+    }
+
+    /// 从非流式 LLM 响应中提取文本内容
     virtual std::string parseResponse(const json& response) const = 0;
 
-    /// 从 LLM 响应中提取 tool_calls（OpenAI 原生 Function Calling）
+    /// 从非流式 LLM 响应中提取 tool_calls（OpenAI 原生 Function Calling）
     /// @return 工具调用列表，无调用时返回空 vector
     virtual std::vector<ToolCallInfo> parseToolCalls(const json& response) const = 0;
+
+    /// 从流式调用结果中提取文本内容，默认即累积的 content
+    virtual std::string parseStreamContent(const StreamResult& result) const
+    {
+        return result.content;
+    }
+
+    /// 从流式调用结果中提取 tool_calls：解析 arguments（空或非法时为 {}），丢弃没有 name 的调用
+    virtual std::vector<ToolCallInfo> parseStreamToolCalls(const StreamResult& result) const;
 };
 
 class AliyunStrategy : public AIStrategy
@@ -139,8 +170,14 @@ public:
     json buildRequest(const std::vector<Message>& messages,
                       const json& tools = json::object(),
                       const std::string& modelName = "") const override;
+    RequestEnvelope streamEnvelope(const std::string& modelName) const override;
+    bool supportsTools() const override
+    {
+        return false;
+    }
     std::string parseResponse(const json& response) const override;
     std::vector<ToolCallInfo> parseToolCalls(const json& response) const override;
+    std::vector<ToolCallInfo> parseStreamToolCalls(const StreamResult& result) const override;
 
 private:
     std::string api_key_;
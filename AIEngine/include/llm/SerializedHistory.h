@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "3rdparty/JsonUtil.h"
+#include "common/Message.h"
+
+/**
+ * @brief 会话消息历史的序列化缓存：每条消息只序列化一次，按 OpenAI messages[] 元素格式追加到一块连续缓冲
+ *
+ * 缓存始终是消息向量的前缀；新消息在 sync() 时追加，前缀字节保持不变，
+ * 请求体由缓存区间直接拼接，上游的 prompt 前缀缓存可以命中。
+ * 消息被插入、删除或修改时，由调用方 truncate() 到第一个变动的下标。非线程安全，由持有者加锁。
+ */
+class SerializedHistory
+{
+public:
+    /// 单条消息的 OpenAI 格式（role="assistant" 带 tool_calls 时 content 为 null）
+    static json toJson(const Message& m);
+
+    /// 序列化 messages 中尚未缓存的尾部；messages 的前 size() 条须与缓存一致
+    void sync(const std::vector<Message>& messages);
+
+    /// 丢弃下标 >= index 的缓存
+    void truncate(size_t index);
+
+    /// 已缓存的消息条数
+    size_t size() const
+    {
+        return ends_.size();
+    }
+
+    /// 第 from 条起的所有元素，以逗号分隔，不含方括号；from >= size() 时为空
+    std::string_view range(size_t from) const;
+
+private:
+    std::string bytes_;         // "m0,m1,m2"
+    std::vector<size_t> ends_;  // ends_[i]：第 i 条在 bytes_ 中的结束位置
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "3rdparty/JsonUtil.h"
+
+/**
+ * @brief SSE 行切分：数据追加到一块连续缓冲，按读偏移原地取出完整的行
+ *
+ * 取出的行是指向缓冲的 string_view（已去掉行尾 \r），在下一次 append() 之前有效。
+ * 已消费的前缀在 append() 时才回收：全部消费则直接清空（网络块通常恰好以行尾结束），
+ * 否则消费量过半时整体前移一次，均摊后每字节至多移动一次。
+ */
+class SseLineBuffer
+{
+public:
+    void append(std::string_view data);
+
+    /// 取下一个完整的行；缓冲中没有换行符时返回 false
+    bool nextLine(std::string_view* line);
+
+    /// 尚未组成完整行的字节数
+    size_t pending() const
+    {
+        return buf_.size() - pos_;
+    }
+
+private:
+    std::string buf_;
+    size_t pos_ = 0;
+};
+
+/**
+ * @brief 单个 chunk 中 choices[0].delta 的内容
+ *
+ * 字符串已反转义。多次解析复用同一对象，字符串与数组的容量跨 chunk 保留，不再逐 token 分配。
+ */
+struct ChatDelta
+{
+    struct ToolCall
+    {
+        int index = -1;
+        bool hasId = false;
+        bool hasType = false;
+        bool hasFunction = false;
+        bool hasName = false;
+        bool hasArguments = false;
+        std::string id;
+        std::string type;
+        std::string name;
+        std::string arguments;
+    };
+
+    bool hasContent = false;
+    std::string content;
+    std::vector<ToolCall> toolCalls;  // 只有前 toolCallCount 个有效
+    size_t toolCallCount = 0;
+    bool hasFinishReason = false;
+    std::string finishReason;  // choices[0].finish_reason
+    std::string_view usage;    // 顶层 usage 的原始 JSON 文本（指向 chunk，非空时才有），通常只在最后一帧出现
+};
+
+/**
+ * @brief 一次流式调用的完整结果，由 StreamDeltaParser::finish() 按移动返回
+ */
+struct StreamResult
+{
+    struct ToolCall
+    {
+        int index = 0;
+        std::string id;
+        std::string type;
+        std::string name;
+        std::string arguments;  // 拼接后的原始 arguments 文本，未解析
+    };
+
+    std::string content;              // 全部文本 token 拼接
+    std::vector<ToolCall> toolCalls;  // 按 index 升序
+    std::string finishReason;         // 最后一个非空的 finish_reason，如 "stop" / "tool_calls" / "length"
+    json usage;                       // 上游返回的 usage（未返回时为 null）
+};
+
+/**
+ * @brief 按需解析 OpenAI 兼容的流式 chunk，只提取 choices[0] 的 delta（content 与 tool_calls 片段）、
+ *        finish_reason，以及顶层 usage
+ *
+ * 单遍扫描，不构建 DOM：id / model / logprobs 等其余字段只跳过不解析，usage 只截取原文，值为 null 的字段视为缺省。
+ * @return JSON 语法错误时返回 false，out 内容未定义
+ */
+bool parseChatDelta(std::string_view chunk, ChatDelta* out);
+
+/**
+ * @brief 流式响应的增量解析器：SseLineBuffer 切行 + parseChatDelta 提取增量，并累积完整回复
+ *
+ * 文本 token 逐个交给回调；tool_calls 按 index 合并 id / type / function.name，拼接 function.arguments 片段。
+ * 跳过空行与 "data: [DONE]"；以 '{' 开头的行是上游非 SSE 的错误响应，记录日志后跳过；解析失败的 chunk 整体忽略。
+ */
+class StreamDeltaParser
+{
+public:
+    /// 返回 false 时中止解析
+    using TokenCallback = std::function<bool(const std::string& token)>;
+
+    explicit StreamDeltaParser(TokenCallback onToken) : onToken_(std::move(onToken)) {}
+
+    /// 处理一块网络数据；token 回调要求中止时返回 false
+    bool feed(std::string_view data);
+
+    /// 目前累积的文本
+    const std::string& content() const
+    {
+        return content_;
+    }
+
+    /// 流结束后取出结果；之后解析器不应再使用
+    StreamResult finish();
+
+private:
+    struct ToolCall
+    {
+        bool hasId = false;
+        bool hasType = false;
+        bool hasName = false;
+        std::string id;
+        std::string type;
+        std::string name;
+        std::string arguments;
+    };
+
+    bool handleLine(std::string_view line);
+    void mergeToolCall(const ChatDelta::ToolCall& delta);
+
+    TokenCallback onToken_;
+    SseLineBuffer lines_;
+    ChatDelta delta_;
+    std::string content_;
+    std::map<int, ToolCall> toolCalls_;
+    std::string finishReason_;
+    json usage_;
+};
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <memory>
 #include <mutex>
 #include <string>
 
 #include "3rdparty/JsonUtil.h"
+#include "mcp/ToolCatalog.h"
 
 /**
  * @brief 纯血 MCP 工具注册表 — 薄层代理
@@ -24,12 +26,19 @@ public:
     json invoke(const std::string& name, const json& args) const;
 
     /**
-     * @brief 返回 OpenAI 兼容的 tools[] 数组（用于 Function Calling）
+     * @brief 实时向所有 MCP Server 拉取的原始工具列表（{name, description, inputSchema}）
      *
-     * 直接委托 McpClientManager::discoverAllTools()，零本地缓存。
+     * 直接委托 McpClientManager::discoverAllTools()，每次调用都会发 tools/list。
      */
     json getToolsSchema() const;
 
+    /**
+     * @brief 缓存的 OpenAI 兼容 tools[] 快照（用于 Function Calling），对话热路径使用此接口
+     *
+     * 委托 McpClientManager::toolsSnapshot()；未注入 McpClientManager 时返回空快照。
+     */
+    std::shared_ptr<const ToolSnapshot> getToolsSnapshot() const;
+
     /// 设置 McpClientManager 引用
     void setMcpClientManager(class McpClientManager* mgr);
 
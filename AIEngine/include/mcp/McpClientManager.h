@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <filesystem>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -8,6 +10,7 @@
 #include <vector>
 
 #include "3rdparty/JsonUtil.h"
+#include "mcp/ToolCatalog.h"
 
 /**
  * @brief MCP Client 抽象基类
@@ -33,13 +36,25 @@ public:
 
     /// 停止连接
     virtual void stop() = 0;
+
+    /// 收到 notifications/tools/list_changed 时的回调（由 McpClientManager 注入）
+    void setToolsChangedHandler(std::function<void()> handler)
+    {
+        onToolsChanged_ = std::move(handler);
+    }
+
+protected:
+    std::function<void()> onToolsChanged_;
 };
 
 /**
  * @brief McpClientManager — 管理多个 MCP Server 连接
  *
  * 单例，支持 stdio / sse 两种 transport，通过工厂创建对应 Client。
- * 提供 discoverAllTools() 和 callTool() 接口供 AIToolRegistry 路由。
+ * 提供 toolsSnapshot() 和 callTool() 接口供 AIToolRegistry 路由。
+ *
+ * 工具列表由 ToolCatalog 缓存：配置文件 mtime 变化（热插拔）、server 增删、
+ * 以及 server 推送的 notifications/tools/list_changed 都会使其失效，对话轮次不再逐次 tools/list。
  */
 class McpClientManager
 {
@@ -55,8 +70,12 @@ public:
     /// 注册并启动单个 server
     void registerServer(const std::string& name, const json& serverDef);
 
-    /// 获取所有远端工具的 OpenaAI tools schema（融合）
-    json discoverAllTools();
+    /// 向所有 client 发 tools/list，返回融合后的 MCP 原始工具列表，并重建 tool → client 路由。
+    /// 某个 server 拉取失败时沿用它上次成功拉到的工具与路由（而不是从结果中去掉），并把 *complete 置为 false
+    json discoverAllTools(bool* complete = nullptr);
+
+    /// 缓存的 OpenAI tools 快照；先检查配置文件是否变更（至多每秒 stat 一次）
+    std::shared_ptr<const ToolSnapshot> toolsSnapshot();
 
     /// 按工具名路由到对应 client 执行
     json callTool(const std::string& name, const json& args);
@@ -69,15 +88,29 @@ private:
     /// 停止指定 server 并清除其关联的工具缓存
     void unregisterServer(const std::string& name);
 
+    /// 配置文件 mtime 变化时执行 reloadFromConfig
+    void reloadIfConfigChanged();
+
     std::mutex mutex_;
     std::vector<std::shared_ptr<McpClient>> clients_;
 
     /// tool name → client index 缓存（加速 callTool 查找）
     std::unordered_map<std::string, size_t> toolToClient_;
 
+    /// client index → 上次成功的 tools/list 结果，拉取失败时沿用；server 注销时清除
+    std::unordered_map<size_t, json> lastTools_;
+
     /// server name → client index 映射
     std::unordered_map<std::string, size_t> serverToClient_;
 
     /// 上次加载的配置文件路径（供热插拔使用）
     std::string configPath_;
+
+    /// 上次加载时配置文件的 mtime，及下一次允许 stat 的时间
+    std::filesystem::file_time_type configMtime_{};
+    std::chrono::steady_clock::time_point nextConfigCheck_{};
+    std::chrono::milliseconds configCheckInterval_{1000};
+
+    /// 转换后的 OpenAI tools 快照缓存
+    ToolCatalog catalog_{[this](bool* complete) { return discoverAllTools(complete); }};
 };
\ No newline at end of file
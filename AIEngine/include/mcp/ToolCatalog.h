@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "3rdparty/JsonUtil.h"
+
+/**
+ * @brief 工具目录的一个不可变快照：OpenAI Function Calling 格式的 tools[] 及其预序列化文本
+ *
+ * 通过 shared_ptr<const> 发放，持有者在整轮对话内使用同一份，目录刷新不影响已发出的快照。
+ */
+struct ToolSnapshot
+{
+    uint64_t version = 0;          // 工具集合内容变化时递增；重建后内容相同则沿用旧版本号
+    json tools = json::array();    // [{type:"function", function:{name, description, parameters}}]
+    std::string toolsJson = "[]";  // tools.dump()，拼请求体时直接使用
+
+    bool empty() const
+    {
+        return tools.empty();
+    }
+
+    /**
+     * @brief 把 "tools" 字段拼入已序列化的请求体（JSON 对象文本），工具为空时原样返回
+     *
+     * 请求体中不应已有 tools 字段。
+     */
+    std::string spliceInto(std::string requestBody) const;
+};
+
+/**
+ * @brief 带版本的工具目录：缓存 MCP 工具列表转换后的 OpenAI tools 快照，失效时才重新拉取
+ *
+ * 失效来源：invalidate()（配置变更、server 增删、MCP notifications/tools/list_changed），
+ * 以及超过 maxAge 的兜底过期（覆盖无法推送通知的 server）。拉取失败或只拉到部分 server 时，
+ * 结果只保留 retryInterval（不超过 maxAge），让故障 server 恢复后尽快补上。
+ * 重建是单飞的：已有快照时其余调用方直接拿旧快照，不排队等待 tools/list。
+ */
+class ToolCatalog
+{
+public:
+    /// 拉取全部 MCP 原始工具（{name, description, inputSchema}）；有 server 拉取失败时把 *complete 置为 false
+    using Loader = std::function<json(bool* complete)>;
+
+    explicit ToolCatalog(Loader loader, std::chrono::milliseconds maxAge = std::chrono::minutes(5));
+
+    /// 当前快照，过期或已失效时先重建；永不返回空指针
+    std::shared_ptr<const ToolSnapshot> snapshot();
+
+    /// 标记失效，下次 snapshot() 时重建；可在任意线程、持有任意锁时调用
+    void invalidate()
+    {
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+
+    /// 兜底过期时间，<= 0 表示只靠 invalidate() 刷新
+    void setMaxAge(std::chrono::milliseconds maxAge)
+    {
+        maxAgeMs_.store(maxAge.count(), std::memory_order_relaxed);
+    }
+
+    /// 不完整结果（拉取失败或部分失败）的重试间隔，<= 0 表示与 maxAge 相同
+    void setRetryInterval(std::chrono::milliseconds interval)
+    {
+        retryMs_.store(interval.count(), std::memory_order_relaxed);
+    }
+
+    /// MCP 工具 → OpenAI tools[]：{name, description, inputSchema} → {type, function:{name, description, parameters}}
+    static json toOpenAiTools(const json& mcpTools);
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<const ToolSnapshot> snapshot;
+        uint64_t generation = 0;
+        std::chrono::steady_clock::time_point builtAt;
+        bool complete = true;  // 拉取时所有 server 都成功
+    };
+
+    bool fresh(const Entry& entry) const;
+    std::shared_ptr<const Entry> rebuild(const std::shared_ptr<const Entry>& previous);
+
+    Loader loader_;
+    std::atomic<int64_t> maxAgeMs_;
+    std::atomic<int64_t> retryMs_{30 * 1000};
+    std::atomic<uint64_t> generation_{1};
+    std::shared_ptr<const Entry> current_;  // 通过 std::atomic_load / atomic_store 访问
+    std::mutex rebuildMutex_;
+};
@@ -3,6 +3,8 @@
 #include <ctime>
 #include <mutex>
 
+#include "common/CurlEngine.h"
+
 // Token 缓存（有效期约 30 天）
 static std::string s_cachedToken;
 static time_t s_tokenExpiry = 0;
@@ -44,7 +46,7 @@ std::string AISpeechProcessor::getAccessToken()
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, onWriteData);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &result);
 
-    CURLcode res = curl_easy_perform(curl);
+    CURLcode res = CurlEngine::instance().perform(curl);
     curl_easy_cleanup(curl);
     if (headers) curl_slist_free_all(headers);
     if (res != CURLE_OK) return "";
@@ -102,7 +104,7 @@ std::string AISpeechProcessor::recognize(const std::string& speechData,
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, onWriteData);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &result);
 
-    CURLcode res = curl_easy_perform(curl);
+    CURLcode res = CurlEngine::instance().perform(curl);
 
     curl_easy_cleanup(curl);
     if (headers) curl_slist_free_all(headers);
@@ -162,7 +164,7 @@ std::string AISpeechProcessor::synthesize(
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, onWriteData);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
 
-    res = curl_easy_perform(curl);
+    res = CurlEngine::instance().perform(curl);
     curl_easy_cleanup(curl);
     if (headers) curl_slist_free_all(headers);
     if (res != CURLE_OK) return "";
@@ -221,7 +223,7 @@ std::string AISpeechProcessor::synthesize(
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, onWriteData);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
 
-        res = curl_easy_perform(curl);
+        res = CurlEngine::instance().perform(curl);
         curl_easy_cleanup(curl);
         if (headers) curl_slist_free_all(headers);
         if (res != CURLE_OK) break;
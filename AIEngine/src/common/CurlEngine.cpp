@@ -0,0 +1,257 @@
+#include "common/CurlEngine.h"
+
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "Common/Logging/Logger.h"
+
+namespace
+{
+
+CurlEngine::Options& singletonOptions()
+{
+    static CurlEngine::Options options;
+    return options;
+}
+
+}  // namespace
+
+// ─── Share：跨 worker 共享 DNS 缓存与 TLS 会话 ─────────────────────
+
+struct CurlEngine::Share
+{
+    CURLSH* handle = nullptr;
+    std::mutex locks[CURL_LOCK_DATA_LAST];
+
+    Share()
+    {
+        handle = curl_share_init();
+        curl_share_setopt(handle, CURLSHOPT_LOCKFUNC, lock);
+        curl_share_setopt(handle, CURLSHOPT_UNLOCKFUNC, unlock);
+        curl_share_setopt(handle, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+
+    ~Share()
+    {
+        curl_share_cleanup(handle);
+    }
+
+    static void lock(CURL*, curl_lock_data data, curl_lock_access, void* userp)
+    {
+        static_cast<Share*>(userp)->locks[data].lock();
+    }
+
+    static void unlock(CURL*, curl_lock_data data, void* userp)
+    {
+        static_cast<Share*>(userp)->locks[data].unlock();
+    }
+};
+
+// ─── Worker：一个线程驱动一个 multi 句柄 ──────────────────────────
+
+class CurlEngine::Worker
+{
+public:
+    Worker(const Options& options, int index) : multi_(curl_multi_init())
+    {
+        curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, options.maxHostConnections);
+        curl_multi_setopt(multi_, CURLMOPT_MAX_TOTAL_CONNECTIONS, options.maxTotalConnections);
+        curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, options.maxConnectsCache);
+#if LIBCURL_VERSION_NUM >= 0x074300
+        curl_multi_setopt(multi_, CURLMOPT_MAX_CONCURRENT_STREAMS, options.maxConcurrentStreams);
+#endif
+        thread_ = std::thread([this, index] {
+            SPDLOG_INFO_TAG("AI") << "[CurlEngine] worker " << index << " started";
+            run();
+        });
+    }
+
+    ~Worker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        curl_multi_wakeup(multi_);
+        thread_.join();
+        curl_multi_cleanup(multi_);
+    }
+
+    void add(CURL* easy, Completion done)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!stopping_)
+            {
+                pending_.emplace_back(easy, std::move(done));
+                done = nullptr;
+            }
+        }
+        if (done)
+        {
+            complete(done, CURLE_ABORTED_BY_CALLBACK);
+            return;
+        }
+        curl_multi_wakeup(multi_);
+    }
+
+    void wakeup()
+    {
+        curl_multi_wakeup(multi_);
+    }
+
+private:
+    void run()
+    {
+        std::vector<std::pair<CURL*, Completion>> batch;
+        while (true)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (stopping_) break;
+                batch.swap(pending_);
+            }
+            for (auto& [easy, done] : batch)
+            {
+                CURLMcode mc = curl_multi_add_handle(multi_, easy);
+                if (mc != CURLM_OK)
+                {
+                    SPDLOG_ERROR_TAG("AI") << "[CurlEngine] add handle failed: " << curl_multi_strerror(mc);
+                    complete(done, CURLE_FAILED_INIT);
+                    continue;
+                }
+                running_.emplace(easy, std::move(done));
+            }
+            batch.clear();
+
+            int stillRunning = 0;
+            curl_multi_perform(multi_, &stillRunning);
+            reapFinished();
+
+            // 有 socket 事件、内部定时器到期或 add() / wakeup() 唤醒时返回；最长 1s，与 curl_easy_perform
+            // 的轮询节奏一致，保证没有调用方唤醒时暂停中的传输仍能按时得到进度回调
+            curl_multi_poll(multi_, nullptr, 0, 1000, nullptr);
+        }
+
+        // 停止：未完成与未开始的传输一律以中止结束，调用方的等待随之返回
+        for (auto& [easy, done] : running_)
+        {
+            curl_multi_remove_handle(multi_, easy);
+            complete(done, CURLE_ABORTED_BY_CALLBACK);
+        }
+        running_.clear();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [easy, done] : pending_)
+        {
+            complete(done, CURLE_ABORTED_BY_CALLBACK);
+        }
+        pending_.clear();
+    }
+
+    void reapFinished()
+    {
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi_, &queued))
+        {
+            if (msg->msg != CURLMSG_DONE) continue;
+            CURL* easy = msg->easy_handle;
+            CURLcode result = msg->data.result;
+            curl_multi_remove_handle(multi_, easy);
+            auto it = running_.find(easy);
+            if (it == running_.end()) continue;
+            Completion done = std::move(it->second);
+            running_.erase(it);
+            complete(done, result);
+        }
+    }
+
+    static void complete(const Completion& done, CURLcode result)
+    {
+        try
+        {
+            done(result);
+        }
+        catch (const std::exception& e)
+        {
+            SPDLOG_ERROR_TAG("AI") << "[CurlEngine] completion threw: " << e.what();
+        }
+    }
+
+    CURLM* multi_;
+    std::mutex mutex_;  // 保护 pending_ 与 stopping_
+    std::vector<std::pair<CURL*, Completion>> pending_;
+    bool stopping_ = false;
+    std::unordered_map<CURL*, Completion> running_;  // 仅 worker 线程访问
+    std::thread thread_;
+};
+
+// ─── CurlEngine ─────────────────────────────────────────────────────
+
+CurlEngine& CurlEngine::instance()
+{
+    static CurlEngine engine(singletonOptions());
+    return engine;
+}
+
+void CurlEngine::configure(const Options& options)
+{
+    singletonOptions() = options;
+}
+
+CurlEngine::CurlEngine(const Options& options)
+{
+    // curl_global_init 非线程安全，在 worker 启动前由构造线程完成
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    share_ = std::make_unique<Share>();
+    int threads = options.threads > 0 ? options.threads : 1;
+    for (int i = 0; i < threads; ++i)
+    {
+        workers_.push_back(std::make_unique<Worker>(options, i));
+    }
+}
+
+CurlEngine::~CurlEngine()
+{
+    workers_.clear();
+    share_.reset();
+    curl_global_cleanup();
+}
+
+void CurlEngine::submit(CURL* easy, Completion done)
+{
+    curl_easy_setopt(easy, CURLOPT_SHARE, share_->handle);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+    // 并发请求先等待在建连接确认是否支持多路复用，再决定复用还是新建
+    curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+
+    inflight_.fetch_add(1, std::memory_order_relaxed);
+    Worker& worker = *workers_[next_.fetch_add(1, std::memory_order_relaxed) % workers_.size()];
+    worker.add(easy, [this, done = std::move(done)](CURLcode result) {
+        inflight_.fetch_sub(1, std::memory_order_relaxed);
+        done(result);
+    });
+}
+
+CURLcode CurlEngine::perform(CURL* easy)
+{
+    std::promise<CURLcode> result;
+    std::future<CURLcode> future = result.get_future();
+    submit(easy, [&result](CURLcode code) { result.set_value(code); });
+    return future.get();
+}
+
+void CurlEngine::wakeup()
+{
+    for (auto& worker : workers_)
+    {
+        worker->wakeup();
+    }
+}
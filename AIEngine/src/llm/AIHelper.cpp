@@ -7,6 +7,35 @@
 #include "Common/Logging/Logger.h"
 #include "Common/Utf8.h"
 #include "Infralib/Cache/SessionCache.h"
+#include "common/CurlEngine.h"
+
+namespace
+{
+
+// 把当前请求 ID 带给上游模型服务，便于按同一 ID 对照双方日志
+curl_slist* appendRequestIdHeader(curl_slist* headers)
+{
+    const std::string& requestId = common::tls_log_ctx.req_id;
+    if (requestId.empty()) return headers;
+    std::string header = "X-Request-Id: " + requestId;
+    return curl_slist_append(headers, header.c_str());
+}
+
+// Dr.Rain System Prompt（SP 5.5），每轮请求置于 messages 最前
+const char* const kDrRainSystemPrompt =
+    "你是 Dr.Rain，一位专业的 AI 医疗健康助手。你基于医学知识提供健康咨询、"
+    "症状分析、用药参考和生活方式建议。请注意：\n"
+    "1. 你的回答仅供参考，不能替代专业医生的诊断和治疗\n"
+    "2. 遇到紧急情况，请建议用户立即就医\n"
+    "3. 你不提供具体处方，只提供通用医学知识\n"
+    "4. 回答时保持专业、温暖、易懂的风格";
+
+bool isVisionContext(const Message& m)
+{
+    return m.role == "system" && m.content.rfind("[系统提示：", 0) == 0;
+}
+
+}  // namespace
 
 AIHelper::AIHelper(storage::MysqlUtil* mysqlUtil,
                    common::ThreadPool* threadPool,
@@ -72,7 +101,8 @@ std::string AIHelper::chatStream(int userId,
                                  std::string modelId,
                                  StreamCallback onChunk,
                                  std::string endpointId,
-                                 bool isNewSession)
+                                 bool isNewSession,
+                                 DownstreamCheck downstream)
 {
     auto _callStart = std::chrono::steady_clock::now();
     auto _logCall = [&](const std::string& status, const std::string& errMsg = "")
@@ -82,7 +112,8 @@ std::string AIHelper::chatStream(int userId,
         if (userId > 0)
         {
             CallLogRepository _repo;
-            _repo.insert(static_cast<long long>(userId), sessionId, modelId, provider, _dur, status, errMsg);
+            _repo.insert(static_cast<long long>(userId), sessionId, modelId, provider, _dur, status, errMsg,
+                         common::tls_log_ctx.req_id);
         }
     };
     bool expected = false;
@@ -124,26 +155,9 @@ std::string AIHelper::chatStream(int userId,
                        pendingUserPayload_);
     pendingUserPayload_.clear();  // 单次消费
 
-    // 获取工具 schema（MCP 原始格式），并转换为 OpenAI Function Calling 格式
+    // 工具目录快照：已转换为 OpenAI Function Calling 格式并预序列化，本次对话的各轮共用同一份
     auto& registry = AIToolRegistry::instance();
-    json rawMcpTools = registry.getToolsSchema();
-
-    // MCP → OpenAI 格式转换：{name, description, inputSchema}
-    //                 → {type: "function", function: {name, description, parameters}}
-    json toolsSchema = json::array();
-    for (const auto& mcpTool : rawMcpTools)
-    {
-        json openAiTool;
-        openAiTool["type"] = "function";
-        openAiTool["function"]["name"] = mcpTool.value("name", "");
-        openAiTool["function"]["description"] = mcpTool.value("description", "");
-        if (mcpTool.contains("inputSchema"))
-            openAiTool["function"]["parameters"] = mcpTool["inputSchema"];
-        else
-            openAiTool["function"]["parameters"] = json::object();
-
-        toolsSchema.push_back(std::move(openAiTool));
-    }
+    auto tools = registry.getToolsSnapshot();
 
     // L2 Redis 对话上下文恢复（v3.2.0）：避免重启/多节点场景下重复从 MySQL 拉取
     if (sessionCache_)
@@ -159,6 +173,7 @@ std::string AIHelper::chatStream(int userId,
                 // 保留刚追加的 user 消息，在前面插入缓存的历史
                 Message currentUser = messages_.back();
                 messages_.pop_back();
+                history_.truncate(messages_.size());
                 for (auto& mj : j)
                 {
                     messages_.push_back({mj.value("role", ""), mj.value("content", ""), mj.value("model", ""),
@@ -183,65 +198,33 @@ std::string AIHelper::chatStream(int userId,
 
     for (int round = 0; round < MAX_TOOL_ROUNDS; ++round)
     {
-        std::vector<Message> snapshot;
-        {
-            std::lock_guard<std::mutex> lock(msgMutex_);
-            snapshot = messages_;
-        }
-
-        // Dr.Rain System Prompt 注入（SP 5.5）
-        // 策略：先判断第一条消息是否为 vision 视觉上下文，若是则保留在其后插入人设
-        const std::string drRainSystemPrompt =
-            "你是 Dr.Rain，一位专业的 AI 医疗健康助手。你基于医学知识提供健康咨询、"
-            "症状分析、用药参考和生活方式建议。请注意：\n"
-            "1. 你的回答仅供参考，不能替代专业医生的诊断和治疗\n"
-            "2. 遇到紧急情况，请建议用户立即就医\n"
-            "3. 你不提供具体处方，只提供通用医学知识\n"
-            "4. 回答时保持专业、温暖、易懂的风格";
-        {
-            bool hasVisionCtx =
-                !snapshot.empty() && snapshot[0].role == "system" && snapshot[0].content.rfind("[系统提示：", 0) == 0;
-            if (hasVisionCtx)
-            {
-                // 第一条是 vision 上下文 → 在它前面插入 Dr.Rain 人设
-                snapshot.insert(snapshot.begin(), {"system", drRainSystemPrompt, "", ""});
-            }
-            else
-            {
-                bool hasSystem = !snapshot.empty() && snapshot[0].role == "system";
-                if (hasSystem)
-                    snapshot[0] = {"system", drRainSystemPrompt, "", ""};
-                else
-                    snapshot.insert(snapshot.begin(), {"system", drRainSystemPrompt, "", ""});
-            }
-        }
-
-        // 每次构建 payload，传 stream=true（使用前端传入的 modelId）
-        json payload = strategy->buildRequest(snapshot, toolsSchema, effectiveModel);
-        payload["stream"] = true;
+        // 请求体由已序列化的历史拼接（使用前端传入的 modelId）；tools 以预序列化文本拼入，不再逐轮拷贝与序列化
+        size_t toolsBytes = strategy->supportsTools() ? tools->toolsJson.size() + 16 : 0;
+        std::string body = buildStreamBody(effectiveModel, toolsBytes);
 
-        // 审计日志：记录发起 LLM 请求前的关键信息
+        // 审计日志：记录发起 LLM 请求前的关键信息（工具只记版本与数量）
         SPDLOG_INFO_TAG("AI") << "[LLM Request] userId: " << userId << " | sessionId: " << sessionId
-                              << " | provider: " << provider << " | model: " << effectiveModel
-                              << " | payload: " << payload.dump();
+                              << " | provider: " << provider << " | model: " << effectiveModel << " | tools: v"
+                              << tools->version << " x" << tools->tools.size() << " | payload: " << body;
+
+        if (strategy->supportsTools()) body = tools->spliceInto(std::move(body));
 
         // 流式请求：累积完整响应 + SSE 回调给前端
         auto roundStreamCb = onChunk;  // 复用前端回调
-        std::string roundResponse = executeCurlStream(payload, roundStreamCb);
+        StreamResult streamed = executeCurlStream(body, roundStreamCb, downstream);
+        SPDLOG_INFO_TAG("AI") << "[LLM Response] finish_reason: " << streamed.finishReason
+                              << " | tool_calls: " << streamed.toolCalls.size()
+                              << " | usage: " << streamed.usage.dump();
 
-        // 检查是否包含 tool_calls（从累积的完整响应中解析）
+        // 检查是否包含 tool_calls
         try
         {
-            json fullResp = json::parse(roundResponse);
-            auto toolCalls = strategy->parseToolCalls(fullResp);
+            auto toolCalls = strategy->parseStreamToolCalls(streamed);
 
             if (toolCalls.empty())
             {
-                // 纯文本回复：roundResponse 中只有 content
-                auto& msg = fullResp["choices"][0]["message"];
-                std::string textContent;
-                if (msg.contains("content") && !msg["content"].is_null())
-                    textContent = msg["content"].get<std::string>();
+                // 纯文本回复
+                std::string textContent = strategy->parseStreamContent(streamed);
 
                 // 将完整的助理回复加入历史
                 auto tsNow = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -339,15 +322,16 @@ std::string AIHelper::chatStream(int userId,
         }
         catch (const std::exception&)
         {
-            SPDLOG_ERROR_TAG("AI") << "[LLM Response] parse/stream failed, treating as plain text";
+            SPDLOG_ERROR_TAG("AI") << "[LLM Response] tool round failed, treating as plain text";
             auto tsNow = std::chrono::duration_cast<std::chrono::milliseconds>(
                              std::chrono::system_clock::now().time_since_epoch())
                              .count();
             {
                 std::lock_guard<std::mutex> lock(msgMutex_);
-                messages_.push_back({"assistant", roundResponse, strategy->getModel(), "", tsNow});
+                messages_.push_back({"assistant", streamed.content, strategy->getModel(), "", tsNow});
             }
-            pushMessageToMysql(userId, userName, "assistant", roundResponse, tsNow, sessionId, strategy->getModel());
+            pushMessageToMysql(userId, userName, "assistant", streamed.content, tsNow, sessionId,
+                               strategy->getModel());
 
             // Redis 保存对话上下文（v3.2.0）
             if (sessionCache_)
@@ -370,7 +354,7 @@ std::string AIHelper::chatStream(int userId,
             }
 
             _logCall("success");
-            return roundResponse;
+            return streamed.content;
         }
     }
 
@@ -381,31 +365,68 @@ std::string AIHelper::chatStream(int userId,
     return msg;
 }
 
+// ─── 流式请求体：人设 + 序列化历史 ──────────────────────────────────
+std::string AIHelper::buildStreamBody(const std::string& modelName, size_t reserveExtra)
+{
+    static const std::string systemPrompt = SerializedHistory::toJson({"system", kDrRainSystemPrompt}).dump();
+    RequestEnvelope env = strategy->streamEnvelope(modelName);
+
+    std::lock_guard<std::mutex> lock(msgMutex_);
+    history_.sync(messages_);
+
+    // Dr.Rain 人设总在最前：第一条是 vision 视觉上下文时保留在人设之后，是其他 system 消息时由人设替换
+    bool replaceFirst = !messages_.empty() && messages_[0].role == "system" && !isVisionContext(messages_[0]);
+    std::string_view rest = history_.range(replaceFirst ? 1 : 0);
+
+    std::string body;
+    body.reserve(env.head.size() + systemPrompt.size() + rest.size() + env.tail.size() + 3 + reserveExtra);
+    body += env.head;
+    body += '[';
+    body += systemPrompt;
+    if (!rest.empty())
+    {
+        body += ',';
+        body += rest;
+    }
+    body += ']';
+    body += env.tail;
+    return body;
+}
+
 // ─── 流式 curl 请求 ────────────────────────────────────────────────
-std::string AIHelper::executeCurlStream(const json& payload, StreamCallback onChunk)
+StreamResult AIHelper::executeCurlStream(const std::string& body, StreamCallback onChunk, DownstreamCheck downstream)
 {
     CURL* curl = curl_easy_init();
     if (!curl) throw std::runtime_error("Failed to initialize curl");
 
-    StreamContext ctx;
-    ctx.callback = std::move(onChunk);
+    StreamContext ctx(std::move(onChunk));
+    ctx.downstream = std::move(downstream);
+    ctx.curl = curl;
 
     struct curl_slist* headers = nullptr;
     std::string authHeader = "Authorization: Bearer " + strategy->getApiKey();
     headers = curl_slist_append(headers, authHeader.c_str());
     headers = curl_slist_append(headers, "Content-Type: application/json");
+    headers = appendRequestIdHeader(headers);
 
-    std::string payloadStr = payload.dump();
     curl_easy_setopt(curl, CURLOPT_URL, strategy->getApiUrl().c_str());
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payloadStr.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, StreamWriteCallback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &ctx);
     curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 30L);
     curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1L);
     curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, 60L);
+    if (ctx.downstream)
+    {
+        // 暂停的传输只能在同一句柄的回调里恢复；进度回调在暂停期间仍被周期调用
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, StreamProgressCallback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &ctx);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    }
 
-    CURLcode curlRes = curl_easy_perform(curl);
+    // 经共享引擎执行：连接、DNS 与 TLS 会话跨请求复用；写回调与进度回调在引擎线程上运行
+    CURLcode curlRes = CurlEngine::instance().perform(curl);
     curl_slist_free_all(headers);
     curl_easy_cleanup(curl);
 
@@ -416,28 +437,7 @@ std::string AIHelper::executeCurlStream(const json& payload, StreamCallback onCh
         throw std::runtime_error(std::string("LLM API call failed: ") + curl_easy_strerror(curlRes));
     }
 
-    // 流结束后，构造完整的 JSON 响应给 chatStream 解析
-    json fakeResponse;
-    fakeResponse["choices"] = json::array({json::object()});
-    auto& msg = fakeResponse["choices"][0]["message"];
-    msg["role"] = "assistant";
-    if (ctx.fullContent.empty())
-        msg["content"] = nullptr;
-    else
-        msg["content"] = ctx.fullContent;
-
-    // 将累积的 tool_calls map 转成 json 数组
-    if (!ctx.toolCalls.empty())
-    {
-        json tcArr = json::array();
-        for (auto& kv : ctx.toolCalls)
-        {
-            tcArr.push_back(kv.second);
-        }
-        msg["tool_calls"] = std::move(tcArr);
-    }
-
-    return fakeResponse.dump();
+    return ctx.parser.finish();
 }
 
 // ─── SSE 流式回调 ────────────────────────────────────────────────────
@@ -446,103 +446,51 @@ size_t AIHelper::StreamWriteCallback(void* contents, size_t size, size_t nmemb,
     size_t total = size * nmemb;
     auto* ctx = static_cast<StreamContext*>(userp);
     if (ctx->aborted) return 0;
-
-    ctx->buffer.append(static_cast<char*>(contents), total);
-
-    // 按行处理 SSE 格式：data: {...}\n\n
-    std::string& buf = ctx->buffer;
-    size_t pos = 0;
-    while (true)
+    if (ctx->downstream)
     {
-        size_t nl = buf.find('\n', pos);
-        if (nl == std::string::npos) break;
-
-        std::string line = buf.substr(pos, nl - pos);
-        pos = nl + 1;
-
-        // 去掉 \r
-        if (!line.empty() && line.back() == '\r') line.pop_back();
-
-        // 跳过空行和 [DONE]
-        if (line.empty() || line == "data: [DONE]") continue;
-
-        // 拦截非 SSE 格式的 API 原生错误响应（HTTP 400/401 等）
-        if (!line.empty() && line[0] == '{')
+        Downstream state = ctx->downstream();
+        if (state == Downstream::kClosed)
         {
-            SPDLOG_ERROR_TAG("AI") << "[API Raw Error] " << line;
-            continue;
+            ctx->aborted = true;
+            return 0;
         }
-
-        // 解析 "data: {...}"
-        if (line.substr(0, 6) == "data: ")
+        // 下游读得慢：不消费本块，curl 暂停并在恢复后重新投递同一块数据
+        if (state == Downstream::kFull)
         {
-            std::string jsonStr = line.substr(6);
-            try
-            {
-                json chunk = json::parse(jsonStr);
-                // OpenAI 兼容格式
-                if (chunk.contains("choices") && !chunk["choices"].empty())
-                {
-                    auto& delta = chunk["choices"][0]["delta"];
-
-                    // 1) 累积文本 token
-                    if (delta.contains("content") && !delta["content"].is_null())
-                    {
-                        std::string token = delta["content"].get<std::string>();
-                        if (!token.empty())
-                        {
-                            ctx->fullContent += token;
-                            if (!ctx->callback(token))
-                            {
-                                ctx->aborted = true;
-                                buf = buf.substr(pos);
-                                return 0;
-                            }
-                        }
-                    }
-
-                    // 2) 累积 tool_calls 增量
-                    if (delta.contains("tool_calls") && delta["tool_calls"].is_array())
-                    {
-                        for (const auto& tc : delta["tool_calls"])
-                        {
-                            int idx = tc.value("index", -1);
-                            if (idx < 0) continue;
-
-                            auto& merged = ctx->toolCalls[idx];
-                            // 首次出现：设置 index
-                            if (!merged.contains("index")) merged["index"] = idx;
-                            // 增量合并 id
-                            if (tc.contains("id") && !tc["id"].is_null()) merged["id"] = tc["id"];
-                            // 增量合并 type
-                            if (tc.contains("type") && !tc["type"].is_null()) merged["type"] = tc["type"];
-                            // 增量合并 function name + arguments 片段
-                            if (tc.contains("function"))
-                            {
-                                auto& fn = tc["function"];
-                                if (!merged.contains("function")) merged["function"] = json::object();
-                                if (fn.contains("name") && !fn["name"].is_null())
-                                    merged["function"]["name"] = fn["name"];
-                                if (fn.contains("arguments"))
-                                {
-                                    std::string argsPiece = fn["arguments"].get<std::string>();
-                                    merged["function"]["arguments"] =
-                                        merged["function"].value("arguments", "") + argsPiece;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            catch (...)
-            { /* 忽略解析失败的 chunk */
-            }
+            ctx->paused = true;
+            return CURL_WRITEFUNC_PAUSE;
         }
     }
-    buf = buf.substr(pos);
+
+    // 按行切分 "data: {...}" 并按需提取 delta，不逐行拷贝、不构建完整 JSON
+    if (!ctx->parser.feed(std::string_view(static_cast<char*>(contents), total)))
+    {
+        ctx->aborted = true;
+        return 0;
+    }
     return total;
 }
 
+// ─── 流式传输进度回调：背压解除后恢复暂停的传输 ─────────────────────
+int AIHelper::StreamProgressCallback(void* userp, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+{
+    auto* ctx = static_cast<StreamContext*>(userp);
+    if (ctx->aborted) return 1;
+    if (!ctx->paused) return 0;
+    switch (ctx->downstream())
+    {
+        case Downstream::kClosed:
+            ctx->aborted = true;
+            return 1;
+        case Downstream::kWritable:
+            ctx->paused = false;
+            curl_easy_pause(ctx->curl, CURLPAUSE_CONT);
+            return 0;
+        default:
+            return 0;
+    }
+}
+
 // ─── curl 请求 ────────────────────────────────────────────────────
 json AIHelper::executeCurl(const json& payload)
 {
@@ -555,6 +503,7 @@ json AIHelper::executeCurl(const json& payload)
 
     headers = curl_slist_append(headers, authHeader.c_str());
     headers = curl_slist_append(headers, "Content-Type: application/json");
+    headers = appendRequestIdHeader(headers);
 
     std::string payloadStr = payload.dump();
 
@@ -566,12 +515,12 @@ json AIHelper::executeCurl(const json& payload)
     curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 30L);
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, 120L);
 
-    CURLcode res = curl_easy_perform(curl);
+    CURLcode res = CurlEngine::instance().perform(curl);
     curl_slist_free_all(headers);
     curl_easy_cleanup(curl);
 
     if (res != CURLE_OK)
-        throw std::runtime_error("curl_easy_perform() failed: " + std::string(curl_easy_strerror(res)));
+        throw std::runtime_error("LLM API call failed: " + std::string(curl_easy_strerror(res)));
 
     try
     {
@@ -733,6 +682,7 @@ void AIHelper::injectVisionContext(const std::string& visionPrompt)
     // 如果已有 system 消息（Dr.Rain 人设），则插入到其后；否则放在开头
     if (!messages_.empty() && messages_[0].role == "system")
     {
+        history_.truncate(1);
         // 移除已有的视觉提示（避免重复）
         if (messages_.size() > 1 && messages_[1].role == "system")
         {
@@ -742,6 +692,7 @@ void AIHelper::injectVisionContext(const std::string& visionPrompt)
     }
     else
     {
+        history_.truncate(0);
         // 移除可能存在的同类视觉提示
         for (auto it = messages_.begin(); it != messages_.end();)
         {
@@ -2,36 +2,43 @@
 
 #include "common/Message.h"
 #include "llm/AIFactory.h"
+#include "llm/SerializedHistory.h"
+
+// ─── AIStrategy：流式结果的默认解析（OpenAI 兼容） ───────────────
+std::vector<ToolCallInfo> AIStrategy::parseStreamToolCalls(const StreamResult& result) const
+{
+    std::vector<ToolCallInfo> calls;
+    calls.reserve(result.toolCalls.size());
+    for (const auto& tc : result.toolCalls)
+    {
+        if (tc.name.empty()) continue;
+        ToolCallInfo info;
+        info.id = tc.id;
+        info.name = tc.name;
+        info.arguments = json::parse(tc.arguments.empty() ? "{}" : tc.arguments, nullptr, false);
+        if (info.arguments.is_discarded()) info.arguments = json::object();
+        calls.push_back(std::move(info));
+    }
+    return calls;
+}
 
 // ─── Helper: Message 向量转 OpenAI messages 格式 ────────────────
 static json messagesToJsonArray(const std::vector<Message>& messages)
 {
     json arr = json::array();
-    for (const auto& m : messages)
-    {
-        json msg;
-        msg["role"] = m.role;
-        // role="tool" 的消息内容是 tool 执行结果
-        if (m.role == "tool")
-        {
-            msg["content"] = m.content;
-            msg["tool_call_id"] = m.tool_call_id;
-        }
-        // role="assistant" 且携带 tool_call_id 表示这是一条带 tool_calls 的助理回复
-        else if (m.role == "assistant" && !m.tool_call_id.empty())
-        {
-            msg["content"] = nullptr;                    // OpenAI 要求 content=null
-            msg["tool_calls"] = json::parse(m.content);  // 存储为 JSON 数组
-        }
-        else
-        {
-            msg["content"] = m.content;
-        }
-        arr.push_back(msg);
-    }
+    for (const auto& m : messages) arr.push_back(SerializedHistory::toJson(m));
     return arr;
 }
 
+// ─── AIStrategy：流式请求体的默认外壳（OpenAI 兼容） ─────────────
+RequestEnvelope AIStrategy::streamEnvelope(const std::string& modelName) const
+{
+    RequestEnvelope env;
+    env.head = "{\"messages\":";
+    env.tail = ",\"model\":" + json(modelName.empty() ? getModel() : modelName).dump() + ",\"stream\":true}";
+    return env;
+}
+
 // ═══════════════════════════════════════════════════════════════
 // AliyunStrategy
 // ═══════════════════════════════════════════════════════════════
@@ -203,6 +210,12 @@ json AliyunRAGStrategy::buildRequest(const std::vector<Message>& messages,
     return payload;
 }
 
+RequestEnvelope AliyunRAGStrategy::streamEnvelope(const std::string& modelName) const
+{
+    (void)modelName;
+    return {"{\"input\":{\"messages\":", "},\"parameters\":{},\"stream\":true}"};
+}
+
 std::string AliyunRAGStrategy::parseResponse(const json& response) const
 {
     if (response.contains("output") && response["output"].contains("text")) return response["output"]["text"];
@@ -217,6 +230,12 @@ std::vector<ToolCallInfo> AliyunRAGStrategy::parseToolCalls(const json& response
     return {};  // RAG 策略不支持 Function Calling
 }
 
+std::vector<ToolCallInfo> AliyunRAGStrategy::parseStreamToolCalls(const StreamResult& result) const
+{
+    (void)result;
+    return {};
+}
+
 static StrategyRegister<AliyunStrategy> regAliyun("aliyun");
 static StrategyRegister<DouBaoStrategy> regDoubao("volcengine");
 static StrategyRegister<AliyunRAGStrategy> regAliyunRag("aliyun-rag");
@@ -0,0 +1,51 @@
+#include "llm/SerializedHistory.h"
+
+json SerializedHistory::toJson(const Message& m)
+{
+    json msg;
+    msg["role"] = m.role;
+    // role="tool" 的消息内容是 tool 执行结果
+    if (m.role == "tool")
+    {
+        msg["content"] = m.content;
+        msg["tool_call_id"] = m.tool_call_id;
+    }
+    // role="assistant" 且携带 tool_call_id 表示这是一条带 tool_calls 的助理回复
+    else if (m.role == "assistant" && !m.tool_call_id.empty())
+    {
+        msg["content"] = nullptr;                    // OpenAI 要求 content=null
+        msg["tool_calls"] = json::parse(m.content);  // 存储为 JSON 数组
+    }
+    else
+    {
+        msg["content"] = m.content;
+    }
+    return msg;
+}
+
+void SerializedHistory::sync(const std::vector<Message>& messages)
+{
+    for (size_t i = ends_.size(); i < messages.size(); ++i)
+    {
+        std::string element = toJson(messages[i]).dump();
+        if (!ends_.empty()) bytes_ += ',';
+        bytes_ += element;
+        ends_.push_back(bytes_.size());
+    }
+}
+
+void SerializedHistory::truncate(size_t index)
+{
+    if (index >= ends_.size()) return;
+
+    bytes_.resize(index == 0 ? 0 : ends_[index - 1]);
+    ends_.resize(index);
+}
+
+std::string_view SerializedHistory::range(size_t from) const
+{
+    if (from >= ends_.size()) return {};
+
+    size_t begin = from == 0 ? 0 : ends_[from - 1] + 1;  // 跳过前一条后的逗号
+    return std::string_view(bytes_).substr(begin);
+}
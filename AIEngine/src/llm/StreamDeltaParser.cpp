@@ -0,0 +1,502 @@
+#include "llm/StreamDeltaParser.h"
+
+#include <cstring>
+
+#include "Common/Logging/Logger.h"
+
+// ─── SseLineBuffer ──────────────────────────────────────────────────
+
+void SseLineBuffer::append(std::string_view data)
+{
+    if (pos_ == buf_.size())
+    {
+        buf_.clear();
+        pos_ = 0;
+    }
+    else if (pos_ > 0 && pos_ >= buf_.size() / 2)
+    {
+        buf_.erase(0, pos_);
+        pos_ = 0;
+    }
+    buf_.append(data.data(), data.size());
+}
+
+bool SseLineBuffer::nextLine(std::string_view* line)
+{
+    const char* begin = buf_.data() + pos_;
+    size_t size = buf_.size() - pos_;
+    const void* nl = std::memchr(begin, '\n', size);
+    if (!nl) return false;
+    size_t len = static_cast<const char*>(nl) - begin;
+    pos_ += len + 1;
+    if (len > 0 && begin[len - 1] == '\r') --len;
+    *line = std::string_view(begin, len);
+    return true;
+}
+
+// ─── parseChatDelta ─────────────────────────────────────────────────
+
+namespace
+{
+
+// 只读游标：按需读取关心的值，其余值整体跳过
+class JsonCursor
+{
+public:
+    explicit JsonCursor(std::string_view text) : p_(text.data()), end_(text.data() + text.size()) {}
+
+    bool eat(char c)
+    {
+        skipSpace();
+        if (p_ < end_ && *p_ == c)
+        {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    bool atEnd()
+    {
+        skipSpace();
+        return p_ == end_;
+    }
+
+    bool null()
+    {
+        skipSpace();
+        if (end_ - p_ >= 4 && std::memcmp(p_, "null", 4) == 0)
+        {
+            p_ += 4;
+            return true;
+        }
+        return false;
+    }
+
+    /// 遍历对象成员，member(key) 须消费该成员的值
+    template <typename F>
+    bool object(F&& member)
+    {
+        if (!eat('{')) return false;
+        if (eat('}')) return true;
+        do
+        {
+            std::string_view key;
+            if (!readKey(&key) || !member(key)) return false;
+        } while (eat(','));
+        return eat('}');
+    }
+
+    /// 遍历数组元素，element(i) 须消费该元素
+    template <typename F>
+    bool array(F&& element)
+    {
+        if (!eat('[')) return false;
+        if (eat(']')) return true;
+        size_t i = 0;
+        do
+        {
+            if (!element(i++)) return false;
+        } while (eat(','));
+        return eat(']');
+    }
+
+    /// 读取字符串并反转义，追加到 out
+    bool string(std::string* out)
+    {
+        if (!eat('"')) return false;
+        while (p_ < end_)
+        {
+            const char* run = p_;
+            while (p_ < end_ && *p_ != '"' && *p_ != '\\') ++p_;
+            out->append(run, p_ - run);
+            if (p_ == end_) return false;
+            if (*p_++ == '"') return true;
+            if (p_ == end_) return false;
+            char e = *p_++;
+            switch (e)
+            {
+                case '"':
+                case '\\':
+                case '/':
+                    out->push_back(e);
+                    break;
+                case 'b':
+                    out->push_back('\b');
+                    break;
+                case 'f':
+                    out->push_back('\f');
+                    break;
+                case 'n':
+                    out->push_back('\n');
+                    break;
+                case 'r':
+                    out->push_back('\r');
+                    break;
+                case 't':
+                    out->push_back('\t');
+                    break;
+                case 'u':
+                    if (!unicodeEscape(out)) return false;
+                    break;
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    bool integer(int* value)
+    {
+        skipSpace();
+        bool negative = p_ < end_ && *p_ == '-';
+        if (negative) ++p_;
+        if (p_ == end_ || *p_ < '0' || *p_ > '9') return false;
+        long v = 0;
+        while (p_ < end_ && *p_ >= '0' && *p_ <= '9')
+        {
+            if (v < 1000000) v = v * 10 + (*p_ - '0');
+            ++p_;
+        }
+        *value = static_cast<int>(negative ? -v : v);
+        // 小数 / 指数部分一并跳过
+        while (p_ < end_ && (*p_ == '.' || *p_ == 'e' || *p_ == 'E' || *p_ == '+' || *p_ == '-' ||
+                             (*p_ >= '0' && *p_ <= '9')))
+        {
+            ++p_;
+        }
+        return true;
+    }
+
+    /// 跳过任意值并返回其原始文本
+    bool raw(std::string_view* out)
+    {
+        skipSpace();
+        const char* start = p_;
+        if (!skip()) return false;
+        *out = std::string_view(start, p_ - start);
+        return true;
+    }
+
+    /// 跳过任意值；容器按括号深度线性扫描，不逐层递归
+    bool skip()
+    {
+        skipSpace();
+        if (p_ == end_) return false;
+        if (*p_ == '"') return skipString();
+        if (*p_ == '{' || *p_ == '[')
+        {
+            int depth = 0;
+            while (p_ < end_)
+            {
+                char c = *p_;
+                if (c == '"')
+                {
+                    if (!skipString()) return false;
+                    continue;
+                }
+                ++p_;
+                if (c == '{' || c == '[')
+                    ++depth;
+                else if ((c == '}' || c == ']') && --depth == 0)
+                    return true;
+            }
+            return false;
+        }
+        // 数字与字面量
+        const char* start = p_;
+        while (p_ < end_ && *p_ != ',' && *p_ != '}' && *p_ != ']' && *p_ != ' ' && *p_ != '\t' && *p_ != '\r' &&
+               *p_ != '\n')
+        {
+            ++p_;
+        }
+        return p_ > start;
+    }
+
+private:
+    void skipSpace()
+    {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) ++p_;
+    }
+
+    // 键按原文比较，不反转义（关心的键都是纯 ASCII）
+    bool readKey(std::string_view* key)
+    {
+        if (!eat('"')) return false;
+        const char* start = p_;
+        while (p_ < end_ && *p_ != '"')
+        {
+            if (*p_ == '\\') ++p_;
+            ++p_;
+        }
+        if (p_ >= end_) return false;
+        *key = std::string_view(start, p_ - start);
+        ++p_;
+        return eat(':');
+    }
+
+    bool skipString()
+    {
+        ++p_;  // 开引号
+        while (p_ < end_)
+        {
+            const void* q = std::memchr(p_, '"', end_ - p_);
+            if (!q) break;
+            const char* quote = static_cast<const char*>(q);
+            // 引号前连续反斜杠为偶数个时才是结束引号
+            const char* b = quote;
+            while (b > p_ && b[-1] == '\\') --b;
+            p_ = quote + 1;
+            if ((quote - b) % 2 == 0) return true;
+        }
+        p_ = end_;
+        return false;
+    }
+
+    bool hex4(unsigned* cp)
+    {
+        if (end_ - p_ < 4) return false;
+        unsigned v = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            char c = *p_++;
+            v <<= 4;
+            if (c >= '0' && c <= '9')
+                v |= c - '0';
+            else if (c >= 'a' && c <= 'f')
+                v |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                v |= c - 'A' + 10;
+            else
+                return false;
+        }
+        *cp = v;
+        return true;
+    }
+
+    bool unicodeEscape(std::string* out)
+    {
+        unsigned cp = 0;
+        if (!hex4(&cp)) return false;
+        if (cp >= 0xD800 && cp <= 0xDBFF)
+        {
+            unsigned low = 0;
+            if (end_ - p_ < 6 || p_[0] != '\\' || p_[1] != 'u') return false;
+            p_ += 2;
+            if (!hex4(&low) || low < 0xDC00 || low > 0xDFFF) return false;
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        }
+        if (cp < 0x80)
+        {
+            out->push_back(static_cast<char>(cp));
+        }
+        else if (cp < 0x800)
+        {
+            out->push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        else if (cp < 0x10000)
+        {
+            out->push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        else
+        {
+            out->push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out->push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        return true;
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+// 可为 null 的字符串字段：null 视为缺省
+bool optionalString(JsonCursor& c, bool* present, std::string* out)
+{
+    if (c.null()) return true;
+    *present = true;
+    return c.string(out);
+}
+
+bool parseToolCall(JsonCursor& c, ChatDelta::ToolCall* tc)
+{
+    return c.object(
+        [&](std::string_view key)
+        {
+            if (key == "index") return c.null() || c.integer(&tc->index);
+            if (key == "id") return optionalString(c, &tc->hasId, &tc->id);
+            if (key == "type") return optionalString(c, &tc->hasType, &tc->type);
+            if (key == "function")
+            {
+                tc->hasFunction = true;
+                if (c.null()) return true;
+                return c.object(
+                    [&](std::string_view fnKey)
+                    {
+                        if (fnKey == "name") return optionalString(c, &tc->hasName, &tc->name);
+                        if (fnKey == "arguments") return optionalString(c, &tc->hasArguments, &tc->arguments);
+                        return c.skip();
+                    });
+            }
+            return c.skip();
+        });
+}
+
+ChatDelta::ToolCall* nextToolCall(ChatDelta* out)
+{
+    if (out->toolCallCount == out->toolCalls.size()) out->toolCalls.emplace_back();
+    ChatDelta::ToolCall* tc = &out->toolCalls[out->toolCallCount++];
+    tc->index = -1;
+    tc->hasId = tc->hasType = tc->hasFunction = tc->hasName = tc->hasArguments = false;
+    tc->id.clear();
+    tc->type.clear();
+    tc->name.clear();
+    tc->arguments.clear();
+    return tc;
+}
+
+bool parseDelta(JsonCursor& c, ChatDelta* out)
+{
+    if (c.null()) return true;
+    return c.object(
+        [&](std::string_view key)
+        {
+            if (key == "content") return optionalString(c, &out->hasContent, &out->content);
+            if (key == "tool_calls")
+            {
+                if (c.null()) return true;
+                return c.array([&](size_t) { return parseToolCall(c, nextToolCall(out)); });
+            }
+            return c.skip();
+        });
+}
+
+}  // namespace
+
+bool parseChatDelta(std::string_view chunk, ChatDelta* out)
+{
+    out->hasContent = false;
+    out->content.clear();
+    out->toolCallCount = 0;
+    out->hasFinishReason = false;
+    out->finishReason.clear();
+    out->usage = std::string_view();
+
+    JsonCursor c(chunk);
+    bool ok = c.object(
+        [&](std::string_view key)
+        {
+            if (key == "usage") return c.null() || c.raw(&out->usage);
+            if (key != "choices") return c.skip();
+            if (c.null()) return true;
+            return c.array(
+                [&](size_t i)
+                {
+                    if (i > 0) return c.skip();
+                    return c.object(
+                        [&](std::string_view choiceKey)
+                        {
+                            if (choiceKey == "delta") return parseDelta(c, out);
+                            if (choiceKey == "finish_reason")
+                                return optionalString(c, &out->hasFinishReason, &out->finishReason);
+                            return c.skip();
+                        });
+                });
+        });
+    return ok && c.atEnd();
+}
+
+// ─── StreamDeltaParser ──────────────────────────────────────────────
+
+bool StreamDeltaParser::feed(std::string_view data)
+{
+    lines_.append(data);
+    std::string_view line;
+    while (lines_.nextLine(&line))
+    {
+        if (!handleLine(line)) return false;
+    }
+    return true;
+}
+
+bool StreamDeltaParser::handleLine(std::string_view line)
+{
+    if (line.empty()) return true;
+
+    // 拦截非 SSE 格式的 API 原生错误响应（HTTP 400/401 等）
+    if (line.front() == '{')
+    {
+        SPDLOG_ERROR_TAG("AI") << "[API Raw Error] " << line;
+        return true;
+    }
+
+    // 只处理 "data:" 行，event: / id: / 注释行忽略
+    if (line.compare(0, 5, "data:") != 0) return true;
+    line.remove_prefix(5);
+    if (!line.empty() && line.front() == ' ') line.remove_prefix(1);
+    if (line == "[DONE]") return true;
+
+    // 解析失败的 chunk 整体忽略
+    if (!parseChatDelta(line, &delta_)) return true;
+
+    if (delta_.hasContent && !delta_.content.empty())
+    {
+        content_ += delta_.content;
+        if (!onToken_(delta_.content)) return false;
+    }
+    for (size_t i = 0; i < delta_.toolCallCount; ++i)
+    {
+        if (delta_.toolCalls[i].index >= 0) mergeToolCall(delta_.toolCalls[i]);
+    }
+    if (delta_.hasFinishReason && !delta_.finishReason.empty()) finishReason_ = delta_.finishReason;
+    if (!delta_.usage.empty())
+    {
+        // 每次调用至多一帧，按完整 JSON 解析
+        usage_ = json::parse(delta_.usage.begin(), delta_.usage.end(), nullptr, false);
+        if (usage_.is_discarded()) usage_ = nullptr;
+    }
+    return true;
+}
+
+void StreamDeltaParser::mergeToolCall(const ChatDelta::ToolCall& delta)
+{
+    ToolCall& merged = toolCalls_[delta.index];
+    // id / type / name 只在首个片段中有值，部分厂商在后续片段中发送空串，不覆盖已有值
+    if (delta.hasId && (!merged.hasId || !delta.id.empty()))
+    {
+        merged.hasId = true;
+        merged.id = delta.id;
+    }
+    if (delta.hasType && (!merged.hasType || !delta.type.empty()))
+    {
+        merged.hasType = true;
+        merged.type = delta.type;
+    }
+    if (delta.hasName && (!merged.hasName || !delta.name.empty()))
+    {
+        merged.hasName = true;
+        merged.name = delta.name;
+    }
+    if (delta.hasArguments) merged.arguments += delta.arguments;
+}
+
+StreamResult StreamDeltaParser::finish()
+{
+    StreamResult result;
+    result.content = std::move(content_);
+    result.toolCalls.reserve(toolCalls_.size());
+    for (auto& [index, tc] : toolCalls_)
+    {
+        result.toolCalls.push_back({index, std::move(tc.id), std::move(tc.type), std::move(tc.name),
+                                    std::move(tc.arguments)});
+    }
+    toolCalls_.clear();
+    result.finishReason = std::move(finishReason_);
+    result.usage = std::move(usage_);
+    return result;
+}
@@ -65,6 +65,15 @@ json AIToolRegistry::getToolsSchema() const
     return mcpManager_->discoverAllTools();
 }
 
+// ─── getToolsSnapshot ───────────────────────────────────────────
+std::shared_ptr<const ToolSnapshot> AIToolRegistry::getToolsSnapshot() const
+{
+    static const auto kEmpty = std::make_shared<const ToolSnapshot>();
+    if (!mcpManager_) return kEmpty;
+
+    return mcpManager_->toolsSnapshot();
+}
+
 // ─── setMcpClientManager ────────────────────────────────────────
 void AIToolRegistry::setMcpClientManager(McpClientManager* mgr)
 {
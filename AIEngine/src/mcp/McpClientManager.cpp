@@ -13,6 +13,18 @@
 #include "Common/Config/ConfigManager.h"
 #include "Common/Logging/Logger.h"
 #include "JsonUtil.h"
+#include "common/CurlEngine.h"
+
+namespace
+{
+
+// tools/call 的 params._meta 可携带任意元数据（MCP 规范），把当前请求 ID 带给工具服务端
+void attachRequestId(json& req)
+{
+    if (!common::tls_log_ctx.req_id.empty()) req["params"]["_meta"]["requestId"] = common::tls_log_ctx.req_id;
+}
+
+}  // namespace
 
 // ═══════════════════════════════════════════════════════════════
 // McpClientManager 单例
@@ -30,6 +42,13 @@ void McpClientManager::loadFromConfig(const std::string& configPath)
 {
     configPath_ = configPath;
 
+    auto& cfg = common::ConfigManager::instance();
+    configCheckInterval_ = std::chrono::milliseconds(cfg.getInt("mcp.config_check_interval_ms", 1000));
+    catalog_.setMaxAge(std::chrono::seconds(cfg.getInt("mcp.tools_max_age_sec", 300)));
+
+    std::error_code ec;
+    configMtime_ = std::filesystem::last_write_time(configPath, ec);
+
     std::ifstream file(configPath);
     if (!file.is_open())
     {
@@ -117,6 +136,8 @@ void McpClientManager::unregisterServer(const std::string& name)
     SPDLOG_INFO_TAG("MCP") << "[McpClientManager] Shutting down server '" << name << "' (client[" << idx << "])";
 
     clients_[idx]->stop();
+    lastTools_.erase(idx);
+    catalog_.invalidate();
 
     // 清除该 server 关联的工具缓存
     for (auto ti = toolToClient_.begin(); ti != toolToClient_.end();)
@@ -337,7 +358,7 @@ void McpClientManager::registerServer(const std::string& name, const json& serve
                 ssize_t written = write(write_fd, reqStr.c_str(), reqStr.size());
                 (void)written;
 
-                // 非阻塞循环读取，缓冲区拼接到完整行
+                // 非阻塞循环读取，缓冲区拼接到完整行；响应之前到达的通知（无 id）就地处理后跳过
                 std::string buf;
                 char chunk[4096];
                 for (int retries = 0; retries < 1000; ++retries)
@@ -347,8 +368,15 @@ void McpClientManager::registerServer(const std::string& name, const json& serve
                     {
                         chunk[n] = '\0';
                         buf += chunk;
-                        size_t nl = buf.find('\n');
-                        if (nl != std::string::npos) return json::parse(buf.substr(0, nl));
+                        size_t nl;
+                        while ((nl = buf.find('\n')) != std::string::npos)
+                        {
+                            json msg = json::parse(buf.substr(0, nl));
+                            buf.erase(0, nl + 1);
+                            if (msg.contains("id") || !msg.contains("method")) return msg;
+                            if (msg["method"] == "notifications/tools/list_changed" && onToolsChanged_)
+                                onToolsChanged_();
+                        }
                     }
                     else if (n == 0)
                     {
@@ -385,6 +413,7 @@ void McpClientManager::registerServer(const std::string& name, const json& serve
                 req["method"] = "tools/call";
                 req["params"]["name"] = name;
                 req["params"]["arguments"] = args;
+                attachRequestId(req);
 
                 json resp = sendRequest(req);
                 if (resp.contains("result") && resp["result"].contains("content"))
@@ -507,7 +536,7 @@ void McpClientManager::registerServer(const std::string& name, const json& serve
                 }
                 if (hlist) curl_easy_setopt(curl, CURLOPT_HTTPHEADER, hlist);
 
-                CURLcode res = curl_easy_perform(curl);
+                CURLcode res = CurlEngine::instance().perform(curl);
                 curl_slist_free_all(hlist);
                 curl_easy_cleanup(curl);
 
@@ -546,6 +575,11 @@ void McpClientManager::registerServer(const std::string& name, const json& serve
 
                 struct curl_slist* hlist = nullptr;
                 hlist = curl_slist_append(hlist, "Content-Type: application/json");
+                if (!common::tls_log_ctx.req_id.empty())
+                {
+                    std::string rid = "X-Request-Id: " + common::tls_log_ctx.req_id;
+                    hlist = curl_slist_append(hlist, rid.c_str());
+                }
                 for (auto& [k, v] : headers_.items())
                 {
                     std::string h = k + ": " + v.get<std::string>();
@@ -553,7 +587,7 @@ void McpClientManager::registerServer(const std::string& name, const json& serve
                 }
                 curl_easy_setopt(curl, CURLOPT_HTTPHEADER, hlist);
 
-                CURLcode res = curl_easy_perform(curl);
+                CURLcode res = CurlEngine::instance().perform(curl);
                 curl_slist_free_all(hlist);
                 curl_easy_cleanup(curl);
 
@@ -588,6 +622,7 @@ void McpClientManager::registerServer(const std::string& name, const json& serve
                 req["method"] = "tools/call";
                 req["params"]["name"] = name;
                 req["params"]["arguments"] = args;
+                attachRequestId(req);
 
                 json resp = sendRequest(req);
                 if (resp.contains("result") && resp["result"].contains("content"))
@@ -625,55 +660,108 @@ void McpClientManager::registerServer(const std::string& name, const json& serve
 
     if (client)
     {
+        client->setToolsChangedHandler(
+            [this, name]
+            {
+                SPDLOG_INFO_TAG("MCP") << "[McpClientManager] Server '" << name << "' tools/list_changed";
+                catalog_.invalidate();
+            });
+
         std::lock_guard<std::mutex> lock(mutex_);
         size_t idx = clients_.size();
         clients_.push_back(client);
         serverToClient_[name] = idx;
         SPDLOG_INFO_TAG("MCP") << "[McpClientManager] Server '" << name << "' registered at client[" << idx << "]";
+        catalog_.invalidate();
     }
 }
 
 // ═══════════════════════════════════════════════════════════════
 // 融合远端工具 schema
 // ═══════════════════════════════════════════════════════════════
-json McpClientManager::discoverAllTools()
+json McpClientManager::discoverAllTools(bool* complete)
 {
-    // 热插拔：每次获取工具列表前先 reload、检测配置变更
-    {
-        std::string cfg;
-        {
-            std::lock_guard<std::mutex> lk(mutex_);
-            cfg = configPath_;
-        }
-        if (!cfg.empty()) reloadFromConfig(cfg);
-    }
-
     std::lock_guard<std::mutex> lock(mutex_);
     json allTools = json::array();
     toolToClient_.clear();
+    size_t failed = 0;
+
+    // 按 client 下标顺序拼接，工具顺序跨重建稳定；已注销的 server 不再参与
+    std::vector<const std::string*> active(clients_.size(), nullptr);
+    for (const auto& [name, idx] : serverToClient_) active[idx] = &name;
 
     for (size_t i = 0; i < clients_.size(); ++i)
     {
+        if (!active[i]) continue;
+        const std::string& server = *active[i];
+        const json* tools = nullptr;
         try
         {
-            json tools = clients_[i]->getTools();
-            for (auto& tool : tools)
-            {
-                std::string name = tool.value("name", "");
-                if (!name.empty()) toolToClient_[name] = i;
-            }
-            for (auto& t : tools) allTools.push_back(std::move(t));
+            json listed = clients_[i]->getTools();
+            if (!listed.is_array()) throw std::runtime_error("tools/list result is not an array");
+            json& last = lastTools_[i];
+            last = std::move(listed);
+            tools = &last;
         }
         catch (const std::exception& e)
         {
-            SPDLOG_WARN_TAG("MCP") << "[McpClientManager] tools/list failed for client " << i << ": " << e.what();
+            ++failed;
+            // 一次失败不代表 server 的工具没了：沿用上次的列表与路由，调用失败时由 callTool 报错
+            auto it = lastTools_.find(i);
+            SPDLOG_WARN_TAG("MCP") << "[McpClientManager] tools/list failed for server '" << server << "': " << e.what()
+                                   << (it != lastTools_.end() ? ", keeping previously listed tools" : "");
+            if (it != lastTools_.end()) tools = &it->second;
+        }
+        if (!tools) continue;
+
+        for (const auto& tool : *tools)
+        {
+            std::string name = tool.value("name", "");
+            if (!name.empty()) toolToClient_[name] = i;
+            allTools.push_back(tool);
         }
     }
 
-    SPDLOG_INFO_TAG("MCP") << "[McpClientManager] discoverAllTools: " << allTools.size() << " remote tools";
+    if (complete) *complete = failed == 0;
+    SPDLOG_INFO_TAG("MCP") << "[McpClientManager] discoverAllTools: " << allTools.size() << " remote tools"
+                           << (failed ? " (" + std::to_string(failed) + " servers failed)" : std::string());
     return allTools;
 }
 
+// ═══════════════════════════════════════════════════════════════
+// 工具快照：热插拔检测 + 目录缓存
+// ═══════════════════════════════════════════════════════════════
+std::shared_ptr<const ToolSnapshot> McpClientManager::toolsSnapshot()
+{
+    reloadIfConfigChanged();
+    return catalog_.snapshot();
+}
+
+void McpClientManager::reloadIfConfigChanged()
+{
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        if (configPath_.empty() || now < nextConfigCheck_) return;
+        nextConfigCheck_ = now + configCheckInterval_;
+        path = configPath_;
+    }
+
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (mtime == configMtime_) return;
+        configMtime_ = mtime;
+    }
+
+    SPDLOG_INFO_TAG("MCP") << "[McpClientManager] " << path << " modified, reloading";
+    reloadFromConfig(path);
+    catalog_.invalidate();
+}
+
 // ═══════════════════════════════════════════════════════════════
 // 按工具名路由执行
 // ═══════════════════════════════════════════════════════════════
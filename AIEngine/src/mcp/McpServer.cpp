@@ -10,10 +10,10 @@ void McpServer::syncMetasFromRegistry()
 {
     toolMetas_.clear();
     auto& registry = AIToolRegistry::instance();
-    json toolsSchema = registry.getToolsSchema();
-    for (auto& toolDef : toolsSchema)
+    auto tools = registry.getToolsSnapshot();
+    for (const auto& toolDef : tools->tools)
     {
-        auto& func = toolDef["function"];
+        const auto& func = toolDef["function"];
         ToolMeta meta;
         meta.name = func.value("name", "");
         meta.description = func.value("description", "");
@@ -0,0 +1,140 @@
+#include "mcp/ToolCatalog.h"
+
+#include "Common/Logging/Logger.h"
+
+// ═══════════════════════════════════════════════════════════════
+// ToolSnapshot
+// ═══════════════════════════════════════════════════════════════
+std::string ToolSnapshot::spliceInto(std::string requestBody) const
+{
+    if (empty()) return requestBody;
+
+    size_t close = requestBody.find_last_of('}');
+    if (close == std::string::npos || close == 0) return requestBody;
+
+    // 空对象 "{}" 不需要分隔逗号
+    size_t last = requestBody.find_last_not_of(" \t\r\n", close - 1);
+    bool emptyObject = last != std::string::npos && requestBody[last] == '{';
+
+    std::string field;
+    field.reserve(toolsJson.size() + 10);
+    if (!emptyObject) field += ',';
+    field += "\"tools\":";
+    field += toolsJson;
+    requestBody.insert(close, field);
+    return requestBody;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// ToolCatalog
+// ═══════════════════════════════════════════════════════════════
+ToolCatalog::ToolCatalog(Loader loader, std::chrono::milliseconds maxAge)
+    : loader_(std::move(loader)), maxAgeMs_(maxAge.count())
+{
+}
+
+json ToolCatalog::toOpenAiTools(const json& mcpTools)
+{
+    json tools = json::array();
+    if (!mcpTools.is_array()) return tools;
+
+    for (const auto& mcpTool : mcpTools)
+    {
+        if (!mcpTool.is_object()) continue;
+
+        json openAiTool;
+        openAiTool["type"] = "function";
+        openAiTool["function"]["name"] = mcpTool.value("name", "");
+        openAiTool["function"]["description"] = mcpTool.value("description", "");
+        if (mcpTool.contains("inputSchema"))
+            openAiTool["function"]["parameters"] = mcpTool["inputSchema"];
+        else
+            openAiTool["function"]["parameters"] = json::object();
+
+        tools.push_back(std::move(openAiTool));
+    }
+    return tools;
+}
+
+bool ToolCatalog::fresh(const Entry& entry) const
+{
+    if (entry.generation != generation_.load(std::memory_order_acquire)) return false;
+
+    int64_t maxAgeMs = maxAgeMs_.load(std::memory_order_relaxed);
+    int64_t retryMs = retryMs_.load(std::memory_order_relaxed);
+    if (!entry.complete && retryMs > 0 && (maxAgeMs <= 0 || retryMs < maxAgeMs)) maxAgeMs = retryMs;
+    return maxAgeMs <= 0 || std::chrono::steady_clock::now() - entry.builtAt < std::chrono::milliseconds(maxAgeMs);
+}
+
+std::shared_ptr<const ToolSnapshot> ToolCatalog::snapshot()
+{
+    auto current = std::atomic_load(&current_);
+    if (current && fresh(*current)) return current->snapshot;
+
+    std::unique_lock<std::mutex> lock(rebuildMutex_, std::defer_lock);
+    if (current)
+    {
+        // 别的线程正在重建：先用旧快照，不让对话首 token 等 tools/list
+        if (!lock.try_lock()) return current->snapshot;
+    }
+    else
+    {
+        lock.lock();
+    }
+
+    current = std::atomic_load(&current_);
+    if (current && fresh(*current)) return current->snapshot;
+
+    auto next = rebuild(current);
+    std::atomic_store(&current_, next);
+    return next->snapshot;
+}
+
+std::shared_ptr<const ToolCatalog::Entry> ToolCatalog::rebuild(const std::shared_ptr<const Entry>& previous)
+{
+    // 先取代数再拉取：拉取期间到达的 invalidate() 会让这份结果立即过期，下次再重建
+    uint64_t generation = generation_.load(std::memory_order_acquire);
+
+    json mcpTools;
+    bool complete = true;
+    try
+    {
+        mcpTools = loader_(&complete);
+    }
+    catch (const std::exception& e)
+    {
+        SPDLOG_WARN_TAG("MCP") << "[ToolCatalog] load failed: " << e.what();
+        if (previous)
+        {
+            // 保留旧工具集，按新时间戳延后 retryInterval 重试，避免每轮对话都撞上故障的 server
+            auto kept = std::make_shared<Entry>(*previous);
+            kept->generation = generation;
+            kept->builtAt = std::chrono::steady_clock::now();
+            kept->complete = false;
+            return kept;
+        }
+        complete = false;
+    }
+
+    auto snap = std::make_shared<ToolSnapshot>();
+    snap->tools = toOpenAiTools(mcpTools);
+    snap->toolsJson = snap->tools.dump();
+
+    auto entry = std::make_shared<Entry>();
+    if (previous && previous->snapshot->toolsJson == snap->toolsJson)
+    {
+        // 内容未变：沿用旧快照与版本号
+        entry->snapshot = previous->snapshot;
+    }
+    else
+    {
+        snap->version = previous ? previous->snapshot->version + 1 : 1;
+        SPDLOG_INFO_TAG("MCP") << "[ToolCatalog] tools v" << snap->version << ": " << snap->tools.size()
+                               << " tools, " << snap->toolsJson.size() << " bytes";
+        entry->snapshot = std::move(snap);
+    }
+    entry->generation = generation;
+    entry->builtAt = std::chrono::steady_clock::now();
+    entry->complete = complete;
+    return entry;
+}
@@ -11,5 +11,6 @@ public:
                 const std::string& provider,
                 int durationMs,
                 const std::string& status,
-                const std::string& errorMessage = "");
+                const std::string& errorMessage = "",
+                const std::string& requestId = "");
 };
@@ -10,5 +10,13 @@ public:
     void handle(const http::HttpRequest& req, http::HttpResponse* resp) override;
 
 private:
+    // 在密码哈希线程池中执行：校验旧密码、哈希并保存新密码，输出响应状态与 JSON 体
+    void changePassword(long long userId,
+                        const std::string& oldPassword,
+                        const std::string& newPassword,
+                        http::HttpResponse::HttpStatusCode* code,
+                        std::string* statusMsg,
+                        std::string* body);
+
     ChatServer* server_;
 };
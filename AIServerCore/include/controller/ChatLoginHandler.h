@@ -15,11 +15,31 @@ public:
 
     // 处理用户登录请求（使用 AuthService 进行 argon2id 密码验证）。
     //
+    // 密码校验提交到 ChatServer 的密码哈希线程池，响应以 deferred 方式在校验完成后发出；
+    // 线程池队列已满时直接回复 503。
+    //
     // Args:
     //   req: HTTP 请求对象。
     //   resp: HTTP 响应对象。
     void handle(const http::HttpRequest& req, http::HttpResponse* resp) override;
 
 private:
+    // 按校验结果写登录响应（IO 线程中调用）：建立会话、签发 JWT 或返回失败原因。
+    //
+    // Args:
+    //   sessionId: 原请求 Cookie 中的会话 ID（可为空）。
+    //   version: 原请求的 HTTP 版本。
+    //   username: 登录用户名。
+    //   account: AuthService::login 的返回值。
+    //   resp: 待填写的响应。
+    void respond(const std::string& sessionId,
+                 const std::string& version,
+                 const std::string& username,
+                 const json& account,
+                 http::HttpResponse* resp);
+
+    // 写出登录异常响应。
+    void respondError(const std::string& version, const std::string& what, http::HttpResponse* resp);
+
     ChatServer* server_;
 };
@@ -14,11 +14,28 @@ public:
 
     // 处理用户注册请求（使用 AuthService 进行 argon2id 密码哈希）。
     //
+    // 邀请码与邮箱验证码在 IO 线程中校验；建号与密码哈希提交到密码哈希线程池，
+    // 响应以 deferred 方式在完成后发出，线程池队列已满时回复 503。
+    //
     // Args:
     //   req: HTTP 请求对象。
     //   resp: HTTP 响应对象。
     void handle(const http::HttpRequest& req, http::HttpResponse* resp) override;
 
 private:
+    // 按建号结果写注册响应（IO 线程中调用）：成功时签发 JWT 完成登录。
+    //
+    // Args:
+    //   account: AuthService::registerWithInviteCode 的返回值。
+    //   error: 建号过程中的异常信息，空表示无异常。
+    //   resp: 待填写的响应。
+    static void respond(const std::string& version,
+                        const std::string& username,
+                        const std::string& email,
+                        const std::string& role,
+                        const json& account,
+                        const std::string& error,
+                        http::HttpResponse* resp);
+
     ChatServer* server_;
 };
@@ -8,10 +8,13 @@
  * 路由：POST /chat/send-stream
  * 响应类型：text/event-stream (Server-Sent Events)
  *
- * 数据格式：
+ * 数据格式（每个事件带 id: <流 key>:<序号>）：
  *   data: {"token":"xxx"}\n\n   ← 每个 token
  *   data: [DONE]\n\n            ← 流结束
  *   data: {"error":"xxx"}\n\n   ← 错误
+ *
+ * 断线续传：客户端断开后生成继续 sse.resume_grace_sec 秒；带 Last-Event-ID 头重新请求本路由
+ * （请求体忽略）会补发该 ID 之后的事件并接上实时输出。流不存在或已过期时返回 404。
  */
 class ChatSseHandler : public http::router::RouterHandler
 {
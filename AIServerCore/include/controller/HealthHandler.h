@@ -9,4 +9,6 @@ public:
 
 private:
     ChatServer* server_;
+    // 探活/抓取结果不应被中间代理缓存；模板构造时编码一次
+    http::HeaderTemplate headers_{{"Cache-Control", "no-store"}};
 };
\ No newline at end of file
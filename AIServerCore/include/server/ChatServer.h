@@ -35,7 +35,10 @@
 #include <vector>
 
 #include "3rdparty/JsonUtil.h"
+#include "Common/Crypto/CryptoPool.h"
+#include "HttpServer/include/http/Compression.h"
 #include "HttpServer/include/http/HttpServer.h"
+#include "HttpServer/include/http/SseStream.h"
 #include "HttpServer/include/utils/FileUtil.h"
 #include "HttpServer/include/utils/ThreadPool.h"
 #include "audio/AISpeechProcessor.h"
@@ -87,6 +90,16 @@ public:
      */
     void setThreadNum(int numThreads);
 
+    /**
+     * @brief 设置 SO_REUSEPORT acceptor 数量
+     *
+     * 大于 1 时需以 kReusePort 构造，见 HttpServer::setAcceptorNum
+     *
+     * @param num acceptor 数量
+     * @param pinCpu 是否为每个 acceptor 线程绑核
+     */
+    void setAcceptorNum(int num, bool pinCpu);
+
     /**
      * @brief 启动HTTP服务器
      *
@@ -107,6 +120,14 @@ public:
     {
         return httpServer_.getSessionManager();
     }
+    const http::ConnectionReapStats& getConnectionReapStats() const
+    {
+        return httpServer_.reapStats();
+    }
+    const ssl::SslSessionStats* getSslSessionStats() const
+    {
+        return httpServer_.sslStats();
+    }
     const std::string& getResourceRoot() const
     {
         return resource_root_;
@@ -119,6 +140,21 @@ public:
     {
         return aiThreadPool_;
     }
+    /// 密码哈希专用线程池（登录 / 注册 / 改密），不占用 IO 线程与 AI 线程池
+    common::CryptoPool& getCryptoPool()
+    {
+        return *cryptoPool_;
+    }
+    /// 动态响应压缩策略（CompressionMiddleware 与 SSE 流共用）
+    const http::CompressionOptions& getCompressionOptions() const
+    {
+        return compression_;
+    }
+    /// 进行中的可续传对话流，断线重连时按 Last-Event-ID 查找
+    http::SseStreamRegistry& getSseStreams()
+    {
+        return *sseStreams_;
+    }
     auto& getOnlineUsers()
     {
         return onlineUsers_;
@@ -191,9 +227,14 @@ private:
     void initDatabase();
     void checkOnnxModel();
     void seedRootAccount();
+    void initializeCrypto();
     void initializeSession();
     void initializeRouter();
     void initializeMiddleware();
+    void initializeRateLimit();
+    void initializeConnectionLimits();
+    void initializeSseStreams();
+    void initializeCurlEngine();
     void initializeRedis();
     void initializeMQ();
     void readDataFromMySQL();
@@ -202,6 +243,9 @@ private:
 
     http::HttpServer httpServer_;
     common::ThreadPool aiThreadPool_{8};
+    std::unique_ptr<common::CryptoPool> cryptoPool_;  // initializeCrypto() 按配置创建
+    std::unique_ptr<http::SseStreamRegistry> sseStreams_;  // initializeSseStreams() 按配置创建
+    http::CompressionOptions compression_;                 // initializeMiddleware() 读取配置
     storage::MysqlUtil mysqlUtil_;
     std::string resource_root_ = "../";
     std::unordered_map<int, bool> onlineUsers_;
@@ -8,16 +8,17 @@ bool CallLogRepository::insert(long long accountId,
                                const std::string& provider,
                                int durationMs,
                                const std::string& status,
-                               const std::string& errorMessage)
+                               const std::string& errorMessage,
+                               const std::string& requestId)
 {
     storage::MysqlUtil mu;
     try
     {
         std::string errMsg = errorMessage.empty() ? "" : errorMessage;
         mu.executeUpdate(
-            "INSERT INTO call_logs (account_id, session_id, model, provider, duration_ms, status, error_message) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?)",
-            accountId, sessionId, model, provider, durationMs, status, errMsg);
+            "INSERT INTO call_logs (request_id, account_id, session_id, model, provider, duration_ms, status, "
+            "error_message) VALUES (NULLIF(?, ''), ?, ?, ?, ?, ?, ?, ?)",
+            requestId, accountId, sessionId, model, provider, durationMs, status, errMsg);
         return true;
     }
     catch (const std::exception& e)
@@ -1,5 +1,6 @@
 #include "Service/AuthService.h"
 
+#include "Common/Logging/Logger.h"
 #include "Crypto/PasswordHash.h"
 #include "Repository/AccountRepository.h"
 #include "storage/MysqlUtil.h"
@@ -22,6 +23,7 @@ json AuthService::login(const std::string& username, const std::string& password
     storage::MysqlUtil mu;
     long long accountId = account["id"].get<long long>();
 
+    // 在密码哈希线程池中调用：argon2id 校验耗时数百毫秒
     if (!common::verifyPassword(password, account["password_hash"].get<std::string>()))
     {
         mu.executeUpdate("UPDATE accounts SET failed_attempts = failed_attempts + 1 WHERE id = ?", accountId);
@@ -38,6 +40,21 @@ json AuthService::login(const std::string& username, const std::string& password
 
     mu.executeUpdate("UPDATE accounts SET failed_attempts = 0, locked_until = NULL, last_login_at = NOW() WHERE id = ?",
                      accountId);
+
+    // 透明重哈希：档位（password.profile）调整后，旧参数的哈希在登录成功、明文可用时升级
+    const std::string& storedHash = account["password_hash"].get_ref<const std::string&>();
+    if (common::passwordNeedsRehash(storedHash))
+    {
+        try
+        {
+            repo.updatePassword(accountId, common::hashPassword(password));
+            SPDLOG_INFO_TAG("AUTH") << "Password rehashed for account " << accountId;
+        }
+        catch (const std::exception& e)
+        {
+            SPDLOG_WARN_TAG("AUTH") << "Password rehash failed for account " << accountId << ": " << e.what();
+        }
+    }
     return account;
 }
 
@@ -56,40 +56,43 @@ void ChangePasswordHandler::handle(const http::HttpRequest& req, http::HttpRespo
             return;
         }
 
-        // ── 校验旧密码 ──
-        AccountRepository repo;
-        json account = repo.findPasswordHashById(userId);
-        if (account.empty())
+        // ── 校验旧密码并更新：两次 argon2id 计算，交给密码哈希线程池，完成后以 deferred 方式回写 ──
+        resp->setDeferred(true);
+        http::ResponseWriter writer = resp->getWriter();
+        std::string version = req.getVersion();
+        bool accepted = server_->getCryptoPool().submit(
+            [this, writer, version, userId, oldPassword, newPassword]()
+            {
+                http::HttpResponse::HttpStatusCode code = http::HttpResponse::k500InternalServerError;
+                std::string statusMsg = "Internal Server Error";
+                std::string body;
+                try
+                {
+                    changePassword(userId, oldPassword, newPassword, &code, &statusMsg, &body);
+                }
+                catch (const std::exception& e)
+                {
+                    SPDLOG_ERROR_TAG("AUTH") << "ChangePasswordHandler failed: " << e.what();
+                    code = http::HttpResponse::k500InternalServerError;
+                    statusMsg = "Internal Server Error";
+                    body = common::ApiResult::fail(500, "Internal error").toJson().dump();
+                }
+                bool close = code == http::HttpResponse::k500InternalServerError;
+                writer.complete(
+                    [this, version, code, statusMsg, body, close](http::HttpResponse* out)
+                    {
+                        server_->packageResp(version, code, statusMsg, close, "application/json",
+                                             static_cast<int>(body.size()), body, out);
+                    });
+            });
+        if (!accepted)
         {
-            json err = common::ApiResult::fail(404, "用户不存在").toJson();
-            std::string body = err.dump();
-            server_->packageResp(req.getVersion(), http::HttpResponse::k404NotFound, "Not Found", false,
-                                 "application/json", static_cast<int>(body.size()), body, resp);
-            return;
-        }
-
-        std::string storedHash = account["password_hash"].get<std::string>();
-        if (!common::verifyPassword(oldPassword, storedHash))
-        {
-            SPDLOG_INFO_TAG("AUTH") << "Password change failed for user " << account["username"]
-                                    << " — old password mismatch";
-            json err = common::ApiResult::fail(403, "旧密码错误").toJson();
-            std::string body = err.dump();
-            server_->packageResp(req.getVersion(), http::HttpResponse::k400BadRequest, "Bad Request", false,
-                                 "application/json", static_cast<int>(body.size()), body, resp);
-            return;
+            resp->setDeferred(false);
+            SPDLOG_WARN_TAG("AUTH") << "Crypto pool saturated, rejecting password change for user " << userId;
+            std::string body = common::ApiResult::fail(503, "Server busy, please retry").toJson().dump();
+            server_->packageResp(req.getVersion(), http::HttpResponse::k503ServiceUnavailable, "Service Unavailable",
+                                 false, "application/json", static_cast<int>(body.size()), body, resp);
         }
-
-        // ── 更新密码 ──
-        std::string newHash = common::hashPassword(newPassword);
-        repo.updatePassword(userId, newHash);
-
-        SPDLOG_INFO_TAG("AUTH") << "Password changed for user " << account["username"] << " (id=" << userId << ")";
-
-        json result = common::ApiResult::ok({{"message", "密码修改成功"}}).toJson();
-        std::string body = result.dump();
-        server_->packageResp(req.getVersion(), http::HttpResponse::k200Ok, "OK", false, "application/json",
-                             static_cast<int>(body.size()), body, resp);
     }
     catch (const std::exception& e)
     {
@@ -100,3 +103,42 @@ void ChangePasswordHandler::handle(const http::HttpRequest& req, http::HttpRespo
                              true, "application/json", static_cast<int>(body.size()), body, resp);
     }
 }
+
+void ChangePasswordHandler::changePassword(long long userId,
+                                           const std::string& oldPassword,
+                                           const std::string& newPassword,
+                                           http::HttpResponse::HttpStatusCode* code,
+                                           std::string* statusMsg,
+                                           std::string* body)
+{
+    AccountRepository repo;
+    json account = repo.findPasswordHashById(userId);
+    if (account.empty())
+    {
+        *code = http::HttpResponse::k404NotFound;
+        *statusMsg = "Not Found";
+        *body = common::ApiResult::fail(404, "用户不存在").toJson().dump();
+        return;
+    }
+
+    std::string storedHash = account["password_hash"].get<std::string>();
+    if (!common::verifyPassword(oldPassword, storedHash))
+    {
+        SPDLOG_INFO_TAG("AUTH") << "Password change failed for user " << account["username"]
+                                << " — old password mismatch";
+        *code = http::HttpResponse::k400BadRequest;
+        *statusMsg = "Bad Request";
+        *body = common::ApiResult::fail(403, "旧密码错误").toJson().dump();
+        return;
+    }
+
+    // ── 更新密码 ──
+    std::string newHash = common::hashPassword(newPassword);
+    repo.updatePassword(userId, newHash);
+
+    SPDLOG_INFO_TAG("AUTH") << "Password changed for user " << account["username"] << " (id=" << userId << ")";
+
+    *code = http::HttpResponse::k200Ok;
+    *statusMsg = "OK";
+    *body = common::ApiResult::ok({{"message", "密码修改成功"}}).toJson().dump();
+}
@@ -38,9 +38,9 @@ void ChatFeedbackHandler::handle(const http::HttpRequest& req, http::HttpRespons
         // Truncate very long feedback
         if (content.size() > 5000) content.resize(5000);
 
-        // AccountId comes from AuthMiddleware (X-Auth-UserId header)
-        std::string userIdStr = req.getHeader("X-Auth-UserId");
-        if (userIdStr.empty())
+        // AccountId comes from AuthMiddleware (verified JWT)
+        long long accountId = req.authUserId();
+        if (accountId == 0)
         {
             std::string body = common::ApiResult::fail(401, "Unauthorized").dump();
             resp->setStatusLine(req.getVersion(), http::HttpResponse::k401Unauthorized, "Unauthorized");
@@ -50,7 +50,6 @@ void ChatFeedbackHandler::handle(const http::HttpRequest& req, http::HttpRespons
             resp->setBody(body);
             return;
         }
-        long long accountId = std::stoll(userIdStr);
 
         storage::MysqlUtil mu;
         mu.executeUpdate("INSERT INTO feedback (account_id, content) VALUES (?, ?)", accountId, content);
@@ -1,7 +1,6 @@
 
 #include "controller/ChatHandler.h"
 
-#include "Common/Auth/JwtService.h"
 #include "Common/Http/ApiResult.h"
 #include "Common/Logging/Logger.h"
 
@@ -22,24 +21,11 @@ void ChatHandler::handle(const http::HttpRequest& req, http::HttpResponse* resp)
         else
         {
             // Fallback: check JWT cookie
-            std::string cookie = req.getHeader("Cookie");
-            std::string token;
-            size_t pos = cookie.find("jwt=");
-            if (pos != std::string::npos)
+            // JWT Cookie fallback：AuthMiddleware 已校验并写入请求
+            userId = req.authUserId();
+            if (userId != 0)
             {
-                pos += 4;
-                size_t end = cookie.find(';', pos);
-                token = (end == std::string::npos) ? cookie.substr(pos) : cookie.substr(pos, end - pos);
-            }
-            if (!token.empty())
-            {
-                common::JwtService jwtService;
-                json payload = jwtService.verify(token);
-                if (!payload.empty())
-                {
-                    userId = payload["sub"].get<long long>();
-                    username = "user" + std::to_string(userId);
-                }
+                username = "user" + std::to_string(userId);
             }
             if (userId == 0)
             {
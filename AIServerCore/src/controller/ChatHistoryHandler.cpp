@@ -1,6 +1,5 @@
 #include "controller/ChatHistoryHandler.h"
 
-#include "Common/Auth/JwtService.h"
 #include "Common/Http/ApiResult.h"
 #include "Common/Logging/Logger.h"
 
@@ -17,22 +16,8 @@ void ChatHistoryHandler::handle(const http::HttpRequest& req, http::HttpResponse
         }
         else
         {
-            // JWT Cookie fallback (align with ChatSseHandler)
-            std::string ck = req.getHeader("Cookie");
-            std::string tok;
-            size_t pos = ck.find("jwt=");
-            if (pos != std::string::npos)
-            {
-                pos += 4;
-                size_t end = ck.find(';', pos);
-                tok = (end == std::string::npos) ? ck.substr(pos) : ck.substr(pos, end - pos);
-            }
-            if (!tok.empty())
-            {
-                common::JwtService js;
-                json pld = js.verify(tok);
-                if (!pld.empty()) userId = pld["sub"].get<long long>();
-            }
+            // JWT Cookie fallback：AuthMiddleware 已校验并写入请求
+            userId = req.authUserId();
         }
 
         if (userId == 0)
@@ -1,6 +1,6 @@
 /**
  * @file ChatLoginHandler.cpp
- * @brief 用户登录处理器 — 使用 AuthService 进行 argon2id 密码验证
+ * @brief 用户登录处理器 — 使用 AuthService 进行 argon2id 密码验证（在密码哈希线程池中执行）
  */
 #include "controller/ChatLoginHandler.h"
 
@@ -26,15 +26,71 @@ void ChatLoginHandler::handle(const http::HttpRequest& req, http::HttpResponse*
         return;
     }
 
+    std::string username;
+    std::string password;
     try
     {
         json parsed = json::parse(req.getBody());
-        std::string username = parsed["username"];
-        std::string password = parsed["password"];
+        username = parsed["username"];
+        password = parsed["password"];
+    }
+    catch (const std::exception& e)
+    {
+        respondError(req.getVersion(), e.what(), resp);
+        return;
+    }
 
-        // 通过 AuthService 进行 argon2id 密码验证
-        AuthService auth;
-        json account = auth.login(username, password);
+    // argon2id 校验耗时数百毫秒并占用数百 MB 内存：交给密码哈希线程池，IO 线程不等待；
+    // 请求在 handle 返回后即被复用，任务只捕获所需字段的副本
+    resp->setDeferred(true);
+    http::ResponseWriter writer = resp->getWriter();
+    std::string version = req.getVersion();
+    std::string sessionId = http::session::SessionManager::getSessionIdFromCookie(req);
+    bool accepted = server_->getCryptoPool().submit(
+        [this, writer, version, sessionId, username, password]()
+        {
+            json account;
+            std::string error;
+            try
+            {
+                // 通过 AuthService 进行 argon2id 密码验证（档位过期时顺带重哈希）
+                AuthService auth;
+                account = auth.login(username, password);
+            }
+            catch (const std::exception& e)
+            {
+                error = e.what();
+            }
+            writer.complete(
+                [this, version, sessionId, username, account, error](http::HttpResponse* out)
+                {
+                    if (!error.empty())
+                    {
+                        respondError(version, error, out);
+                        return;
+                    }
+                    respond(sessionId, version, username, account, out);
+                });
+        });
+    if (!accepted)
+    {
+        // 密码哈希队列已满：直接拒绝，避免登录洪峰在内存中堆积
+        resp->setDeferred(false);
+        SPDLOG_WARN_TAG("AUTH") << "Crypto pool saturated, rejecting login";
+        std::string body = common::ApiResult::fail(503, "Server busy, please retry").toJson().dump(4);
+        server_->packageResp(req.getVersion(), http::HttpResponse::k503ServiceUnavailable, "Service Unavailable",
+                             false, "application/json", static_cast<int>(body.size()), body, resp);
+    }
+}
+
+void ChatLoginHandler::respond(const std::string& sessionId,
+                               const std::string& version,
+                               const std::string& username,
+                               const json& account,
+                               http::HttpResponse* resp)
+{
+    try
+    {
         if (account.contains("locked") && account["locked"].get<bool>())
         {
             // 账号已被锁定，计算剩余时间
@@ -57,7 +113,7 @@ void ChatLoginHandler::handle(const http::HttpRequest& req, http::HttpResponse*
             json failureResp = common::ApiResult::fail(429, msg).toJson();
             std::string failureBody = failureResp.dump(4);
 
-            resp->setStatusLine(req.getVersion(), http::HttpResponse::k429TooManyRequests, "Too Many Requests");
+            resp->setStatusLine(version, http::HttpResponse::k429TooManyRequests, "Too Many Requests");
             resp->setCloseConnection(false);
             resp->setContentType("application/json");
             resp->setContentLength(failureBody.size());
@@ -67,7 +123,7 @@ void ChatLoginHandler::handle(const http::HttpRequest& req, http::HttpResponse*
         else if (!account.empty())
         {
             int userId = account["id"].get<int>();
-            auto session = server_->getSessionManager()->getSession(req, resp);
+            auto session = server_->getSessionManager()->getSession(sessionId, resp);
 
             // 设置会话信息
             session->setValue("userId", std::to_string(userId));
@@ -100,7 +156,7 @@ void ChatLoginHandler::handle(const http::HttpRequest& req, http::HttpResponse*
 
                 std::string successBody = successResp.dump(4);
 
-                resp->setStatusLine(req.getVersion(), http::HttpResponse::k200Ok, "OK");
+                resp->setStatusLine(version, http::HttpResponse::k200Ok, "OK");
                 resp->setCloseConnection(false);
                 resp->setContentType("application/json");
                 resp->setContentLength(successBody.size());
@@ -115,7 +171,7 @@ void ChatLoginHandler::handle(const http::HttpRequest& req, http::HttpResponse*
                 failureResp["error"] = "already logged in";
                 std::string failureBody = failureResp.dump(4);
 
-                resp->setStatusLine(req.getVersion(), http::HttpResponse::k403Forbidden, "Forbidden");
+                resp->setStatusLine(version, http::HttpResponse::k403Forbidden, "Forbidden");
                 resp->setCloseConnection(true);
                 resp->setContentType("application/json");
                 resp->setContentLength(failureBody.size());
@@ -129,7 +185,7 @@ void ChatLoginHandler::handle(const http::HttpRequest& req, http::HttpResponse*
             json failureResp = common::ApiResult::fail(400, "Invalid username or password").toJson();
             std::string failureBody = failureResp.dump(4);
 
-            resp->setStatusLine(req.getVersion(), http::HttpResponse::k401Unauthorized, "Unauthorized");
+            resp->setStatusLine(version, http::HttpResponse::k401Unauthorized, "Unauthorized");
             resp->setCloseConnection(false);
             resp->setContentType("application/json");
             resp->setContentLength(failureBody.size());
@@ -139,17 +195,21 @@ void ChatLoginHandler::handle(const http::HttpRequest& req, http::HttpResponse*
     }
     catch (const std::exception& e)
     {
-        SPDLOG_ERROR_TAG("AUTH") << "Login exception: " << common::Redactor::mask(std::string(e.what()));
-        json failureResp;
-        failureResp["status"] = "error";
-        failureResp["message"] = "Internal server error";
-        std::string failureBody = failureResp.dump(4);
-
-        resp->setStatusLine(req.getVersion(), http::HttpResponse::k400BadRequest, "Bad Request");
-        resp->setCloseConnection(true);
-        resp->setContentType("application/json");
-        resp->setContentLength(failureBody.size());
-        resp->setBody(failureBody);
-        return;
+        respondError(version, e.what(), resp);
     }
 }
+
+void ChatLoginHandler::respondError(const std::string& version, const std::string& what, http::HttpResponse* resp)
+{
+    SPDLOG_ERROR_TAG("AUTH") << "Login exception: " << common::Redactor::mask(what);
+    json failureResp;
+    failureResp["status"] = "error";
+    failureResp["message"] = "Internal server error";
+    std::string failureBody = failureResp.dump(4);
+
+    resp->setStatusLine(version, http::HttpResponse::k400BadRequest, "Bad Request");
+    resp->setCloseConnection(true);
+    resp->setContentType("application/json");
+    resp->setContentLength(failureBody.size());
+    resp->setBody(failureBody);
+}
@@ -87,14 +87,71 @@ void ChatRegisterHandler::handle(const http::HttpRequest& req, http::HttpRespons
         }
 
         // Step 3: Register account (with invite code tracking)
+        // argon2id 哈希耗时数百毫秒：交给密码哈希线程池，完成后以 deferred 方式回写
         long long inviteCodeId = invite.value("id", 0);
-        AuthService auth;
-        json account = auth.registerWithInviteCode(username, password, email, role, inviteCodeId);
+        resp->setDeferred(true);
+        http::ResponseWriter writer = resp->getWriter();
+        std::string version = req.getVersion();
+        bool accepted = server_->getCryptoPool().submit(
+            [writer, version, username, password, email, role, inviteCodeId]()
+            {
+                json account;
+                std::string error;
+                try
+                {
+                    AuthService auth;
+                    account = auth.registerWithInviteCode(username, password, email, role, inviteCodeId);
+                }
+                catch (const std::exception& e)
+                {
+                    error = e.what();
+                }
+                writer.complete([version, username, email, role, account, error](http::HttpResponse* out)
+                                { respond(version, username, email, role, account, error, out); });
+            });
+        if (!accepted)
+        {
+            resp->setDeferred(false);
+            SPDLOG_WARN_TAG("AUTH") << "[REGISTER] Crypto pool saturated, rejecting " << username;
+            std::string body = common::ApiResult::fail(503, "Server busy, please retry").dump();
+            resp->setStatusLine(req.getVersion(), http::HttpResponse::k503ServiceUnavailable, "Service Unavailable");
+            resp->setCloseConnection(false);
+            resp->setContentType("application/json");
+            resp->setContentLength(body.size());
+            resp->setBody(body);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        SPDLOG_ERROR_TAG("AUTH") << "[REGISTER] Exception: " << e.what();
+        std::string body = common::ApiResult::fail(500, "Internal server error").dump();
+        resp->setStatusLine(req.getVersion(), http::HttpResponse::k500InternalServerError, "Internal Server Error");
+        resp->setCloseConnection(false);
+        resp->setContentType("application/json");
+        resp->setContentLength(body.size());
+        resp->setBody(body);
+    }
+}
+
+void ChatRegisterHandler::respond(const std::string& version,
+                                  const std::string& username,
+                                  const std::string& email,
+                                  const std::string& role,
+                                  const json& account,
+                                  const std::string& error,
+                                  http::HttpResponse* resp)
+{
+    try
+    {
+        if (!error.empty())
+        {
+            throw std::runtime_error(error);
+        }
         if (account.empty())
         {
             SPDLOG_INFO_TAG("AUTH") << "[REGISTER] Username taken: " << username;
             std::string body = common::ApiResult::fail(409, "Username already exists").dump();
-            resp->setStatusLine(req.getVersion(), http::HttpResponse::k409Conflict, "Conflict");
+            resp->setStatusLine(version, http::HttpResponse::k409Conflict, "Conflict");
             resp->setCloseConnection(false);
             resp->setContentType("application/json");
             resp->setContentLength(body.size());
@@ -105,7 +162,7 @@ void ChatRegisterHandler::handle(const http::HttpRequest& req, http::HttpRespons
         {
             SPDLOG_INFO_TAG("AUTH") << "[REGISTER] Email taken: " << email;
             std::string body = common::ApiResult::fail(409, "Email already registered").dump();
-            resp->setStatusLine(req.getVersion(), http::HttpResponse::k409Conflict, "Conflict");
+            resp->setStatusLine(version, http::HttpResponse::k409Conflict, "Conflict");
             resp->setCloseConnection(false);
             resp->setContentType("application/json");
             resp->setContentLength(body.size());
@@ -129,7 +186,7 @@ void ChatRegisterHandler::handle(const http::HttpRequest& req, http::HttpRespons
         successResp["username"] = username;
         successResp["email"] = email;
         std::string successBody = successResp.dump();
-        resp->setStatusLine(req.getVersion(), http::HttpResponse::k200Ok, "OK");
+        resp->setStatusLine(version, http::HttpResponse::k200Ok, "OK");
         resp->setCloseConnection(false);
         resp->setContentType("application/json");
         resp->setContentLength(successBody.size());
@@ -139,7 +196,7 @@ void ChatRegisterHandler::handle(const http::HttpRequest& req, http::HttpRespons
     {
         SPDLOG_ERROR_TAG("AUTH") << "[REGISTER] Exception: " << e.what();
         std::string body = common::ApiResult::fail(500, "Internal server error").dump();
-        resp->setStatusLine(req.getVersion(), http::HttpResponse::k500InternalServerError, "Internal Server Error");
+        resp->setStatusLine(version, http::HttpResponse::k500InternalServerError, "Internal Server Error");
         resp->setCloseConnection(false);
         resp->setContentType("application/json");
         resp->setContentLength(body.size());
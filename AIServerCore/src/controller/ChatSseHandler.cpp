@@ -7,12 +7,14 @@
 #include <random>
 #include <sstream>
 
-#include "Common/Auth/JwtService.h"
 #include "Common/Config/ConfigManager.h"
 #include "Common/Http/ApiResult.h"
 #include "Common/Logging/Logger.h"
+#include "Common/Logging/RequestId.h"
+#include "http/SseWriter.h"
 #include "Infralib/Cache/SessionCache.h"
 #include "common/AISessionIdGenerator.h"
+#include "common/CurlEngine.h"
 #include "common/base64.h"
 #include "llm/AIHelper.h"
 #ifdef HAS_AMQPCPP
@@ -37,23 +39,49 @@ static std::string generateUUID()
     return oss.str();
 }
 
-static void sendSseChunk(const muduo::net::TcpConnectionPtr& conn, const std::string& data)
+static void sendSseChunk(http::SseStream& stream, const std::string& data)
 {
-    std::string frame = "data: " + data + "\n\n";
-    conn->getLoop()->runInLoop(
-        [conn, frame]()
-        {
-            if (conn->connected()) conn->send(frame);
-        });
+    stream.publish(data);
 }
 
-static void sendSseDone(const muduo::net::TcpConnectionPtr& conn)
+static void sendSseDone(http::SseStream& stream)
 {
-    conn->getLoop()->runInLoop(
-        [conn]()
-        {
-            if (conn->connected()) conn->send("data: [DONE]\n\n");
-        });
+    stream.publish("[DONE]");
+    stream.finish();
+}
+
+/// SSE 握手：立即发送响应头，之后的事件经 SseWriter 合并写出，客户端读得慢时对上游 LLM 传输施加背压；
+/// 客户端接受 gzip / br 时整条流按事件批次压缩
+static std::shared_ptr<http::SseWriter> openSse(const http::HttpRequest& req,
+                                                http::HttpResponse* resp,
+                                                const http::CompressionOptions& compression)
+{
+    http::SseWriter::Options options;
+    // 客户端读空积压后立即唤醒 curl 引擎，被背压暂停的 LLM 传输在进度回调中恢复
+    options.onWritable = []() { CurlEngine::instance().wakeup(); };
+    if (compression.enabled && compression.sse)
+    {
+        options.encoding = http::negotiateEncoding(req.headerView("Accept-Encoding"), compression.brotli);
+        options.compressionLevel = compression.level(options.encoding);
+    }
+
+    resp->setDeferred(true);
+    // 写出端在 HTTPS 连接上自动加密，并负责切换到 IO 线程
+    http::ResponseWriter writer = resp->getWriter();
+    std::string head =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Connection: keep-alive\r\n"
+        "Access-Control-Allow-Origin: *\r\n";
+    if (options.encoding != http::ContentEncoding::kIdentity)
+    {
+        head.append("Content-Encoding: ").append(http::contentEncodingName(options.encoding)).append("\r\n");
+        head.append("Vary: Accept-Encoding\r\n");
+    }
+    head.append("\r\n");
+    writer.send(std::move(head));
+    return http::SseWriter::open(writer, options);
 }
 
 void ChatSseHandler::handle(const http::HttpRequest& req, http::HttpResponse* resp)
@@ -71,24 +99,11 @@ void ChatSseHandler::handle(const http::HttpRequest& req, http::HttpResponse* re
         }
         else
         {
-            std::string ck = req.getHeader("Cookie");
-            std::string tok;
-            size_t pos = ck.find("jwt=");
-            if (pos != std::string::npos)
-            {
-                pos += 4;
-                size_t end = ck.find(';', pos);
-                tok = (end == std::string::npos) ? ck.substr(pos) : ck.substr(pos, end - pos);
-            }
-            if (!tok.empty())
+            // JWT Cookie fallback：AuthMiddleware 已校验并写入请求
+            userId = req.authUserId();
+            if (userId != 0)
             {
-                common::JwtService js;
-                json pld = js.verify(tok);
-                if (!pld.empty())
-                {
-                    userId = pld["sub"].get<long long>();
-                    username = "user" + std::to_string(userId);
-                }
+                username = "user" + std::to_string(userId);
             }
             if (userId == 0)
             {
@@ -100,6 +115,42 @@ void ChatSseHandler::handle(const http::HttpRequest& req, http::HttpResponse* re
             }
         }
 
+        // 断线重连：Last-Event-ID 指向仍在生成或刚结束的流时，补发错过的事件并接上实时输出，不再重新调用 LLM
+        std::string lastEventId = req.getHeader("Last-Event-ID");
+        if (!lastEventId.empty())
+        {
+            std::string streamKey;
+            uint64_t lastSeq = 0;
+            std::shared_ptr<http::SseStream> stream;
+            if (http::SseStream::parseEventId(lastEventId, &streamKey, &lastSeq))
+            {
+                stream = server_->getSseStreams().find(streamKey, userId);
+            }
+            if (stream)
+            {
+                auto sse = openSse(req, resp, server_->getCompressionOptions());
+                if (stream->attach(sse, lastSeq))
+                {
+                    SPDLOG_INFO_TAG("AI") << "Chat stream resumed: userId=" << userId << " stream=" << streamKey
+                                          << " lastSeq=" << lastSeq;
+                    return;
+                }
+                // 所需的事件已被淘汰：告知前端重新提问
+                json err;
+                err["error"] = "Stream can no longer be resumed";
+                err["resumable"] = false;
+                sse->data(err.dump());
+                sse->data("[DONE]");
+                sse->close();
+                return;
+            }
+            json e = common::ApiResult::fail(404, "Stream not found or expired").toJson();
+            std::string b = e.dump();
+            server_->packageResp(req.getVersion(), http::HttpResponse::k404NotFound, "Not Found", false,
+                                 "application/json", (int)b.size(), b, resp);
+            return;
+        }
+
         std::string userQuestion, modelType, sessionId, ragId, provider, imageBase64;
         auto body = req.getBody();
         if (!body.empty())
@@ -198,24 +249,15 @@ void ChatSseHandler::handle(const http::HttpRequest& req, http::HttpResponse* re
             // SessionStore handles LRU touch/evict internally via getOrCreate
         }
 
-        // 标记 deferred，发送 SSE 握手头
-        resp->setDeferred(true);
-        auto conn = resp->getConnection();
-
-        // SSE 握手：在 IO 线程中立即发送响应头
-        conn->getLoop()->runInLoop(
-            [conn, req]()
-            {
-                if (!conn->connected()) return;
-                std::string sseHeader =
-                    "HTTP/1.1 200 OK\r\n"
-                    "Content-Type: text/event-stream\r\n"
-                    "Cache-Control: no-cache\r\n"
-                    "Connection: keep-alive\r\n"
-                    "Access-Control-Allow-Origin: *\r\n"
-                    "\r\n";
-                conn->send(sseHeader);
-            });
+        // 标记 deferred，发送 SSE 握手头；事件经可续传的流发出，连接断开后生成继续，重连可补发
+        auto sse = openSse(req, resp, server_->getCompressionOptions());
+        std::shared_ptr<http::SseStream> stream =
+            server_->getSseStreams().create(common::generateRequestId(), userId);
+        stream->attach(sse, 0);
+        // 续传要客户端配合（记录事件 ID、断线后带 Last-Event-ID 重发）；未声明 X-Stream-Resume 的客户端
+        // 不会回来，断开即中止生成，不必空跑宽限期
+        std::shared_ptr<http::SseSink> oneShotSink;
+        if (req.getHeader("X-Stream-Resume") != "1") oneShotSink = sse;
 
 #ifdef HAS_AMQPCPP
         // v3.2.0: 图片异步削峰 — 当请求包含图像时，HTTP 线程不做重型推理，直接投递到 RabbitMQ。
@@ -234,34 +276,30 @@ void ChatSseHandler::handle(const http::HttpRequest& req, http::HttpResponse* re
             taskMsg.payload["provider"] = provider;
             taskMsg.payload["modelType"] = modelType;
             taskMsg.payload["apiKey"] = apiKey;
+            taskMsg.payload["requestId"] = common::tls_log_ctx.req_id;
 
             server_->getTaskProducer()->publish("vision_tasks", taskMsg);
             SPDLOG_INFO_TAG("AI") << "Vision task offloaded to MQ: taskId=" << taskId;
 
-            auto loop = conn->getLoop();
-            loop->runInLoop(
-                [conn, sessionId, taskId, isNewSession]()
-                {
-                    if (!conn->connected()) return;
-                    json ack;
-                    if (isNewSession) ack["sessionId"] = sessionId;
-                    ack["status"] = "accepted";
-                    ack["taskId"] = taskId;
-                    std::string data = "data: " + ack.dump() + "\n\n";
-                    conn->send(data);
-                    conn->send("data: [DONE]\n\n");
-                    conn->shutdown();
-                });
+            json ack;
+            if (isNewSession) ack["sessionId"] = sessionId;
+            ack["status"] = "accepted";
+            ack["taskId"] = taskId;
+            sendSseChunk(*stream, ack.dump());
+            sendSseDone(*stream);
             return;
         }
 #endif
 
         auto requestStart = std::chrono::steady_clock::now();
+        // 请求 ID 随任务带到 AI 线程：日志、LLM / MCP 请求头与 call_logs 都以它关联
+        std::string requestId = common::tls_log_ctx.req_id;
         // 提交流式 AI 调用到线程池
         server_->getAiThreadPool().submit(
-            [this, conn, AIHelperPtr, userId, username, sessionId, userQuestion, modelType, apiKey, ragId, provider,
-             isNewSession, imageBase64, requestStart]()
+            [this, stream, oneShotSink, AIHelperPtr, userId, username, sessionId, userQuestion, modelType, apiKey,
+             ragId, provider, isNewSession, imageBase64, requestStart, requestId]()
             {
+                common::ScopedLogContext logContext(requestId, std::to_string(userId));
                 try
                 {
                     // 若包含图片：异步执行 ONNX 推理并将结果注入到 AIHelper 上下文中
@@ -375,22 +413,30 @@ void ChatSseHandler::handle(const http::HttpRequest& req, http::HttpResponse* re
                     {
                         json sidEvent;
                         sidEvent["sessionId"] = sessionId;
-                        sendSseChunk(conn, sidEvent.dump());
+                        sendSseChunk(*stream, sidEvent.dump());
                     }
 
+                    // 可续传的流断开后仍继续生成，宽限期内无人重连才中止；一次性的流断开即中止
+                    auto gone = [&stream, &oneShotSink]()
+                    { return stream->abandoned() || (oneShotSink && !oneShotSink->connected()); };
                     AIHelperPtr->chatStream(
                         userId, username, sessionId, userQuestion, provider, apiKey, ragId, modelType,
-                        [&conn](const std::string& token) -> bool
+                        [&stream, &gone](const std::string& token) -> bool
                         {
-                            if (!conn->connected()) return false;
+                            if (gone()) return false;
                             json data;
                             data["token"] = token;
-                            sendSseChunk(conn, data.dump());
+                            sendSseChunk(*stream, data.dump());
                             return true;
                         },
-                        "", isNewSession);
-                    sendSseDone(conn);
-                    conn->shutdown();
+                        "", isNewSession,
+                        [&stream, &gone]()
+                        {
+                            if (gone()) return AIHelper::Downstream::kClosed;
+                            return stream->writable() ? AIHelper::Downstream::kWritable
+                                                      : AIHelper::Downstream::kFull;
+                        });
+                    sendSseDone(*stream);
                     auto requestEnd = std::chrono::steady_clock::now();
                     auto durationMs =
                         std::chrono::duration_cast<std::chrono::milliseconds>(requestEnd - requestStart).count();
@@ -402,9 +448,8 @@ void ChatSseHandler::handle(const http::HttpRequest& req, http::HttpResponse* re
                 {
                     json err;
                     err["error"] = e.what();
-                    sendSseChunk(conn, err.dump());
-                    sendSseDone(conn);
-                    conn->shutdown();
+                    sendSseChunk(*stream, err.dump());
+                    sendSseDone(*stream);
                     auto requestEnd = std::chrono::steady_clock::now();
                     auto durationMs =
                         std::chrono::duration_cast<std::chrono::milliseconds>(requestEnd - requestStart).count();
@@ -23,5 +23,6 @@ void HealthHandler::handle(const http::HttpRequest& req, http::HttpResponse* res
     resp->setCloseConnection(false);
     resp->setContentType("application/json");
     resp->setContentLength(body.size());
+    resp->setHeaderTemplate(headers_);
     resp->setBody(body);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <sstream>
 
+#include "Common/Crypto/PasswordHash.h"
 #include "Common/Metrics/MetricsCollector.h"
 #include "storage/MysqlUtil.h"
 void MetricsHandler::handle(const http::HttpRequest& req, http::HttpResponse* resp)
@@ -27,10 +28,68 @@ void MetricsHandler::handle(const http::HttpRequest& req, http::HttpResponse* re
     catch (...)
     {
     }
+    const http::ConnectionReapStats& reaped = server_->getConnectionReapStats();
+    out << "# HELP http_connections_reaped_total Connections closed by timeout or size-limit rules\n";
+    out << "# TYPE http_connections_reaped_total counter\n";
+    for (size_t i = 0; i < static_cast<size_t>(http::ReapReason::kCount); ++i)
+    {
+        auto reason = static_cast<http::ReapReason>(i);
+        out << "http_connections_reaped_total{rule=\"" << http::ConnectionReapStats::name(reason) << "\"} "
+            << reaped.get(reason) << "\n";
+    }
+    if (const ssl::SslSessionStats* tls = server_->getSslSessionStats())
+    {
+        out << "# HELP tls_handshakes_total TLS handshakes by outcome (resumed = session cache or ticket)\n";
+        out << "# TYPE tls_handshakes_total counter\n";
+        for (int i = 0; i < ssl::SslSessionStats::kHandshakeCount; ++i)
+        {
+            auto kind = static_cast<ssl::SslSessionStats::Handshake>(i);
+            out << "tls_handshakes_total{type=\"" << ssl::SslSessionStats::name(kind) << "\"} " << tls->handshakes(kind)
+                << "\n";
+        }
+        out << "# HELP tls_session_tickets_total TLS session tickets by result\n";
+        out << "# TYPE tls_session_tickets_total counter\n";
+        for (int i = 0; i < ssl::SslSessionStats::kTicketCount; ++i)
+        {
+            auto result = static_cast<ssl::SslSessionStats::Ticket>(i);
+            out << "tls_session_tickets_total{result=\"" << ssl::SslSessionStats::name(result) << "\"} "
+                << tls->tickets(result) << "\n";
+        }
+    }
+    const common::CryptoPool::Stats crypto = server_->getCryptoPool().stats();
+    out << "# HELP crypto_pool_queue_depth Password hashing tasks waiting in the crypto pool\n";
+    out << "# TYPE crypto_pool_queue_depth gauge\n";
+    out << "crypto_pool_queue_depth " << crypto.queued << "\n";
+    out << "# HELP crypto_pool_running Password hashing tasks currently executing\n";
+    out << "# TYPE crypto_pool_running gauge\n";
+    out << "crypto_pool_running " << crypto.running << "\n";
+    out << "# HELP crypto_pool_tasks_total Crypto pool tasks by result (rejected = queue full)\n";
+    out << "# TYPE crypto_pool_tasks_total counter\n";
+    out << "crypto_pool_tasks_total{result=\"completed\"} " << crypto.completed << "\n";
+    out << "crypto_pool_tasks_total{result=\"rejected\"} " << crypto.rejected << "\n";
+    out << "# HELP crypto_pool_wait_seconds_total Time tasks spent queued\n";
+    out << "# TYPE crypto_pool_wait_seconds_total counter\n";
+    out << "crypto_pool_wait_seconds_total " << crypto.waitSeconds << "\n";
+    out << "# HELP crypto_pool_task_seconds End-to-end task latency (queue + run)\n";
+    out << "# TYPE crypto_pool_task_seconds histogram\n";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < common::CryptoPool::kLatencyBuckets.size(); ++i)
+    {
+        cumulative += crypto.latency[i];
+        out << "crypto_pool_task_seconds_bucket{le=\"" << common::CryptoPool::kLatencyBuckets[i] << "\"} " << cumulative
+            << "\n";
+    }
+    out << "crypto_pool_task_seconds_bucket{le=\"+Inf\"} " << crypto.completed << "\n";
+    out << "crypto_pool_task_seconds_sum " << (crypto.waitSeconds + crypto.runSeconds) << "\n";
+    out << "crypto_pool_task_seconds_count " << crypto.completed << "\n";
+    out << "# HELP password_hash_memory_bytes Memory held by in-flight argon2id computations\n";
+    out << "# TYPE password_hash_memory_bytes gauge\n";
+    out << "password_hash_memory_bytes " << common::passwordMemoryInUse() << "\n";
     std::string body = out.str();
     resp->setStatusLine(req.getVersion(), http::HttpResponse::k200Ok, "OK");
     resp->setCloseConnection(false);
     resp->setContentType("text/plain; version=0.0.4; charset=utf-8");
     resp->setContentLength(body.size());
+    resp->setHeaderTemplate(headers_);
     resp->setBody(body);
 }
\ No newline at end of file
@@ -56,8 +56,12 @@ int main(int argc, char* argv[])
     // 日志时区设为东八区 (CST)，方便国内排查
     muduo::Logger::setTimeZone(muduo::TimeZone(8 * 3600, "CST"));
     muduo::Logger::setOutput(muduoLogRedirect);
-    ChatServer server(port, serverName);
+    // server.acceptors > 1：多个 SO_REUSEPORT acceptor 分摊建连，见 HttpServer::setAcceptorNum
+    int acceptors = cfg.getInt("server.acceptors", 1);
+    ChatServer server(port, serverName,
+                      acceptors > 1 ? muduo::net::TcpServer::kReusePort : muduo::net::TcpServer::kNoReusePort);
     server.setThreadNum(cfg.getInt("server.threads", 4));
+    server.setAcceptorNum(acceptors, cfg.getInt("server.pin_acceptors", 0) != 0);
 
     std::this_thread::sleep_for(std::chrono::seconds(2));
 
@@ -2,14 +2,19 @@
 
 #include "server/ChatServer.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <random>
+#include <thread>
 
 #include "Common/Config/ConfigManager.h"
 #include "Common/Crypto/PasswordHash.h"
 #include "Common/Logging/Logger.h"
 #include "Infralib/Cache/RedisClient.h"
+#include "Infralib/Cache/RedisRateLimiter.h"
+#include "Infralib/Cache/RedisSessionStorage.h"
 #include "Infralib/Cache/SessionCache.h"
+#include "common/CurlEngine.h"
 #include "controller/AIUploadHandler.h"
 #include "controller/AIUploadSendHandler.h"
 #include "controller/AdminDashboardHandler.h"
@@ -46,6 +51,7 @@
 #include "http/HttpServer.h"
 #include "http/StaticFileHandler.h"
 #include "middleware/AdminAuthMiddleware.h"
+#include "middleware/CompressionMiddleware.h"
 #include "middleware/AuthMiddleware.h"
 #include "middleware/RateLimitMiddleware.h"
 #include "middleware/RequestIdMiddleware.h"
@@ -83,9 +89,13 @@ void ChatServer::initialize()
 
     initDatabase();
     checkOnnxModel();
+    initializeCrypto();  // 须在 seedRootAccount 之前：初始账号按配置的档位哈希
     seedRootAccount();
     initializeSession();
     initializeMiddleware();
+    initializeConnectionLimits();
+    initializeSseStreams();
+    initializeCurlEngine();
     initializeRedis();
 #ifdef HAS_AMQPCPP
     initializeMQ();
@@ -201,6 +211,7 @@ void ChatServer::initDatabase()
     const char* createCallLogs = R"SQL(
         CREATE TABLE IF NOT EXISTS call_logs (
             id BIGINT UNSIGNED AUTO_INCREMENT PRIMARY KEY,
+            request_id VARCHAR(64) DEFAULT NULL,
             session_id VARCHAR(64) DEFAULT NULL,
             account_id BIGINT UNSIGNED NOT NULL,
             model VARCHAR(64) NOT NULL,
@@ -210,10 +221,18 @@ void ChatServer::initDatabase()
             error_message VARCHAR(512) DEFAULT NULL,
             created_at DATETIME(3) NOT NULL DEFAULT CURRENT_TIMESTAMP(3),
             INDEX idx_account_created (account_id, created_at),
-            INDEX idx_created (created_at)
+            INDEX idx_created (created_at),
+            INDEX idx_request_id (request_id)
         ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
     )SQL";
 
+    // v3.3.0 之前创建的 call_logs 没有 request_id 列，启动时先查 information_schema，缺列才补上；
+    // ALTER 失败（权限、锁超时等）按建表失败处理，不静默吞掉，否则 CallLogRepository::insert 运行时才报缺列
+    const char* addCallLogRequestId = R"SQL(
+        ALTER TABLE call_logs ADD COLUMN request_id VARCHAR(64) DEFAULT NULL AFTER id,
+            ADD INDEX idx_request_id (request_id)
+    )SQL";
+
     auto initAllTables = [&]()
     {
         mysqlUtil_.executeRawSql(createAccounts);
@@ -224,6 +243,14 @@ void ChatServer::initDatabase()
         mysqlUtil_.executeRawSql(createVerificationCodes);
         mysqlUtil_.executeRawSql(createFeedback);
         mysqlUtil_.executeRawSql(createCallLogs);
+        auto col = mysqlUtil_.executeQuery(
+            "SELECT COUNT(*) AS cnt FROM information_schema.COLUMNS "
+            "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'call_logs' AND COLUMN_NAME = 'request_id'");
+        if (!(col && col->next() && col->getInt64("cnt") > 0))
+        {
+            SPDLOG_INFO_TAG("HTTP") << "call_logs.request_id missing, migrating";
+            mysqlUtil_.executeRawSql(addCallLogRequestId);
+        }
     };
     try
     {
@@ -381,6 +408,11 @@ void ChatServer::setThreadNum(int numThreads)
     httpServer_.setThreadNum(numThreads);
 }
 
+void ChatServer::setAcceptorNum(int num, bool pinCpu)
+{
+    httpServer_.setAcceptorNum(num, pinCpu);
+}
+
 void ChatServer::start()
 {
     httpServer_.start();
@@ -423,12 +455,18 @@ void ChatServer::initializeRouter()
     httpServer_.Get("/upload", std::make_shared<AIUploadHandler>(this));
     httpServer_.Post("/upload/send", std::make_shared<AIUploadSendHandler>(this));
 
-    // 静态文件路由（CSS / JS / 图片 / 字体 — 动态正则匹配）
-    auto staticFileHandler = std::make_shared<http::StaticFileHandler>(resource_root_);
+    // 静态文件路由（CSS / JS / 图片 / 字体 — 前缀树参数/通配符匹配）
+    // /assets/*path 覆盖任意层级，含 ChatSseHandler 生成的 /assets/images/uploads/ 缩略图
+    // 命中内存缓存时直接复用预压缩变体与预拼头部，并支持 ETag / Last-Modified 条件请求
+    auto& cfg = common::ConfigManager::instance();
+    http::StaticFileCache::Options staticOptions;
+    staticOptions.maxAgeSec = cfg.getInt("static.max_age", staticOptions.maxAgeSec);
+    staticOptions.maxTotalBytes = static_cast<size_t>(cfg.getInt("static.cache_max_mb", 64)) * 1024 * 1024;
+    staticOptions.maxFileBytes = static_cast<size_t>(cfg.getInt("static.max_file_kb", 4096)) * 1024;
+    auto staticFileHandler = std::make_shared<http::StaticFileHandler>(resource_root_, staticOptions);
     httpServer_.addRoute(http::HttpRequest::kGet, "/css/:file", staticFileHandler);
     httpServer_.addRoute(http::HttpRequest::kGet, "/js/:file", staticFileHandler);
-    httpServer_.addRoute(http::HttpRequest::kGet, "/assets/:path", staticFileHandler);
-    httpServer_.addRoute(http::HttpRequest::kGet, "/assets/images/:file", staticFileHandler);
+    httpServer_.addRoute(http::HttpRequest::kGet, "/assets/*path", staticFileHandler);
 
     // 模型列表路由（厂商-模型双层注册表）
     httpServer_.Get("/api/chat/models", std::make_shared<ModelListHandler>(this, resource_root_));
@@ -460,15 +498,86 @@ void ChatServer::initializeRouter()
     httpServer_.Post("/admin/api/invite-codes/toggle", std::make_shared<AdminInviteCodeToggleHandler>(this));
 }
 
+void ChatServer::initializeCrypto()
+{
+    auto& cfg = common::ConfigManager::instance();
+
+    // argon2id 档位：新密码按此哈希，旧档位的密码在下次登录成功时透明重哈希
+    common::PasswordCost cost = common::PasswordCost::moderate();
+    std::string profile = cfg.get("password.profile", "moderate");
+    if (!common::PasswordCost::fromName(profile, &cost))
+    {
+        SPDLOG_WARN_TAG("AUTH") << "Unknown password.profile '" << profile << "', using moderate";
+    }
+    // 全局内存预算：同时进行的哈希 / 校验占用内存之和的上限，默认容纳两次 moderate
+    size_t budgetMb = static_cast<size_t>(cfg.getInt("crypto.memory_budget_mb", 512));
+    common::configurePasswordHashing(cost, budgetMb * 1024 * 1024);
+
+    common::CryptoPool::Options options;
+    options.threads = static_cast<size_t>(cfg.getInt("crypto.threads", static_cast<int>(options.threads)));
+    options.maxQueue = static_cast<size_t>(cfg.getInt("crypto.max_queue", static_cast<int>(options.maxQueue)));
+    cryptoPool_ = std::make_unique<common::CryptoPool>(options);
+    SPDLOG_INFO_TAG("AUTH") << "Crypto pool: threads=" << cryptoPool_->threadCount() << " queue=" << options.maxQueue
+                            << " profile=" << profile << " budget=" << budgetMb << "MB";
+}
+
 void ChatServer::initializeSession()
 {
-    auto sessionStorage = std::make_unique<http::session::MemorySessionStorage>();
+    auto& cfg = common::ConfigManager::instance();
+    std::unique_ptr<http::session::SessionStorage> sessionStorage;
+
+    // session.store = "redis" 时会话存入 Redis，多实例共享登录态；连不上则退回内存存储
+    if (cfg.get("session.store", "memory") == "redis")
+    {
+        auto redis = std::make_shared<infra::cache::RedisClient>();  // 会话专用连接，不与业务缓存争用
+        if (redis->connect(cfg.get("redis.host", "127.0.0.1"), cfg.getInt("redis.port", 6379),
+                           cfg.get("redis.password", ""), cfg.getInt("redis.db", 0)))
+        {
+            infra::cache::RedisSessionStorage::Options options;
+            options.nearCacheTtlMs = cfg.getInt("session.near_cache_ms", options.nearCacheTtlMs);
+            options.touchIntervalSec = cfg.getInt("session.touch_interval_sec", options.touchIntervalSec);
+            sessionStorage = std::make_unique<infra::cache::RedisSessionStorage>(std::move(redis), options);
+            SPDLOG_INFO_TAG("SESSION") << "Using Redis session storage";
+        }
+        else
+        {
+            SPDLOG_WARN_TAG("SESSION") << "Redis unavailable — falling back to in-memory session storage";
+        }
+    }
+
+    if (!sessionStorage)
+    {
+        using http::session::MemorySessionStorage;
+        sessionStorage = std::make_unique<MemorySessionStorage>(
+            static_cast<size_t>(
+                cfg.getInt("session.max_entries", static_cast<int>(MemorySessionStorage::kDefaultMaxSessions))),
+            static_cast<size_t>(cfg.getInt("session.shards", static_cast<int>(MemorySessionStorage::kDefaultShards))));
+    }
     auto sessionManager = std::make_unique<http::session::SessionManager>(std::move(sessionStorage));
     setSessionManager(std::move(sessionManager));
 }
 
 void ChatServer::initializeMiddleware()
 {
+    // 响应压缩：最先注册，after() 最后执行，压缩的是其他中间件处理完的响应
+    auto& cfg = common::ConfigManager::instance();
+    compression_.enabled = cfg.getInt("compression.enabled", 1) != 0;
+    compression_.minBytes = static_cast<size_t>(cfg.getInt("compression.min_bytes", 1024));
+    compression_.zlibLevel = cfg.getInt("compression.level", compression_.zlibLevel);
+    compression_.brotli = cfg.getInt("compression.brotli", 1) != 0;
+    compression_.brotliQuality = cfg.getInt("compression.brotli_quality", compression_.brotliQuality);
+    compression_.sse = cfg.getInt("compression.sse", 1) != 0;
+    json types = cfg.getJson("compression.content_types");
+    if (types.is_array() && !types.empty())
+    {
+        compression_.contentTypes.clear();
+        for (const auto& t : types)
+        {
+            if (t.is_string()) compression_.contentTypes.push_back(t.get<std::string>());
+        }
+    }
+    httpServer_.addMiddleware(std::make_shared<http::middleware::CompressionMiddleware>(compression_));
+
     // CORS 中间件：内测阶段仅允许本地访问
     http::middleware::CorsConfig corsCfg = http::middleware::CorsConfig::defaultConfig();
     corsCfg.allowedOrigins = {"http://localhost:8080", "http://127.0.0.1:8080", "http://localhost:8088",
@@ -482,9 +591,17 @@ void ChatServer::initializeMiddleware()
     auto secHeaders = std::make_shared<http::middleware::SecurityHeadersMiddleware>();
     httpServer_.addMiddleware(secHeaders);
 
+    // 以下中间件各自声明作用范围（appliesTo），启动时按路由挑选：静态资源与页面路由不经过鉴权与限流
+    // AuthMiddleware：/api/*、/admin/*（公开接口除外）
     auto authMiddleware = std::make_shared<http::middleware::AuthMiddleware>();
     httpServer_.addMiddleware(authMiddleware);
 
+    // 可选鉴权：/chat* 页面与对话接口也接受登录会话，携带有效 JWT 时写入身份、不拒绝
+    auto optionalAuthMiddleware =
+        std::make_shared<http::middleware::AuthMiddleware>(http::middleware::AuthMiddleware::Mode::kOptional);
+    httpServer_.addMiddleware(optionalAuthMiddleware);
+
+    // AdminAuthMiddleware：/admin/*，须在 AuthMiddleware 之后
     auto adminAuthMiddleware = std::make_shared<http::middleware::AdminAuthMiddleware>();
     httpServer_.addMiddleware(adminAuthMiddleware);
 
@@ -492,9 +609,123 @@ void ChatServer::initializeMiddleware()
     auto reqIdMiddleware = std::make_shared<http::middleware::RequestIdMiddleware>();
     httpServer_.addMiddleware(reqIdMiddleware);
 
-    // RateLimit middleware: 10 req/min per user for /api/chat/*
-    auto rateLimitMiddleware = std::make_shared<http::middleware::RateLimitMiddleware>();
-    httpServer_.addMiddleware(rateLimitMiddleware);
+    // RateLimit middleware：按 rate_limit.rules 对路由前缀分档限流，缺省 /api/chat/* 每用户 10 次/分钟
+    initializeRateLimit();
+}
+
+void ChatServer::initializeRateLimit()
+{
+    auto& cfg = common::ConfigManager::instance();
+
+    // rate_limit.store = "redis" 时以 Redis GCRA 跨实例共享额度；连不上则退回进程内分片桶
+    // 限流在中间件中同步判定：用一小组专用连接（各规则共用）并设短超时，Redis 卡顿时尽快退回本地
+    std::vector<std::shared_ptr<infra::cache::RedisClient>> redisPool;
+    if (cfg.get("rate_limit.store", "memory") == "redis")
+    {
+        int poolSize = std::max(cfg.getInt("rate_limit.redis_pool_size", 4), 1);
+        int timeoutMs = std::max(cfg.getInt("rate_limit.redis_timeout_ms", 100), 1);
+        for (int i = 0; i < poolSize; ++i)
+        {
+            auto redis = std::make_shared<infra::cache::RedisClient>();
+            redis->setTimeouts(timeoutMs, timeoutMs);
+            if (!redis->connect(cfg.get("redis.host", "127.0.0.1"), cfg.getInt("redis.port", 6379),
+                                cfg.get("redis.password", ""), cfg.getInt("redis.db", 0)))
+            {
+                redisPool.clear();
+                break;
+            }
+            redisPool.push_back(std::move(redis));
+        }
+        if (!redisPool.empty())
+        {
+            SPDLOG_INFO_TAG("RATE") << "Using Redis rate limiter (" << redisPool.size() << " connections)";
+        }
+        else
+        {
+            SPDLOG_WARN_TAG("RATE") << "Redis unavailable — falling back to in-memory rate limiter";
+        }
+    }
+    size_t shards = static_cast<size_t>(
+        cfg.getInt("rate_limit.shards", static_cast<int>(common::ShardedRateLimiter::kDefaultShards)));
+    int reclaimSec =
+        cfg.getInt("rate_limit.reclaim_interval_sec", common::ShardedRateLimiter::kDefaultReclaimIntervalSec);
+    auto makeLimiter = [&](const std::string& route) -> std::shared_ptr<common::RateLimiter>
+    {
+        if (redisPool.empty()) return std::make_shared<common::ShardedRateLimiter>(shards, reclaimSec);
+        infra::cache::RedisRateLimiter::Options options;
+        options.keyPrefix = "ratelimit:" + route + ":";
+        options.fallbackShards = shards;
+        return std::make_shared<infra::cache::RedisRateLimiter>(redisPool, options);
+    };
+
+    // rate_limit.rules: [{"route": "/api/chat", "tiers": {"*": {"burst": 10, "per_minute": 10}, "admin": {...}}}]
+    std::vector<http::middleware::RateLimitRule> rules;
+    json rulesCfg = cfg.getJson("rate_limit.rules");
+    if (rulesCfg.is_array())
+    {
+        for (const auto& item : rulesCfg)
+        {
+            if (!item.is_object() || !item.contains("route") || !item["route"].is_string()) continue;
+            http::middleware::RateLimitRule rule;
+            rule.routePrefix = item["route"].get<std::string>();
+            if (item.contains("tiers") && item["tiers"].is_object())
+            {
+                for (const auto& [tier, limitCfg] : item["tiers"].items())
+                {
+                    common::RateLimit limit;
+                    limit.burst = limitCfg.value("burst", limit.burst);
+                    limit.perSec = limitCfg.value("per_minute", limit.perSec * 60) / 60.0;
+                    rule.tiers.emplace(tier, limit);
+                }
+            }
+            rules.push_back(std::move(rule));
+        }
+    }
+    if (rules.empty()) rules.push_back({"/api/chat", {{"*", common::RateLimit{}}}, nullptr});
+    for (auto& rule : rules) rule.limiter = makeLimiter(rule.routePrefix);
+
+    httpServer_.addMiddleware(std::make_shared<http::middleware::RateLimitMiddleware>(std::move(rules)));
+}
+
+void ChatServer::initializeConnectionLimits()
+{
+    // 空闲/慢速连接回收与请求大小上限，配置缺省时使用 ConnectionLimits 的默认值
+    auto& cfg = common::ConfigManager::instance();
+    http::ConnectionLimits limits;
+    limits.headerTimeoutSec = cfg.getInt("server.header_timeout_sec", limits.headerTimeoutSec);
+    limits.bodyTimeoutSec = cfg.getInt("server.body_timeout_sec", limits.bodyTimeoutSec);
+    limits.keepAliveTimeoutSec = cfg.getInt("server.keepalive_timeout_sec", limits.keepAliveTimeoutSec);
+    limits.maxRequestLineBytes = static_cast<size_t>(cfg.getInt("server.max_request_line_kb", 8)) * 1024;
+    limits.maxHeaderBytes = static_cast<size_t>(cfg.getInt("server.max_header_kb", 64)) * 1024;
+    limits.maxHeaderCount = static_cast<size_t>(cfg.getInt("server.max_header_count", 100));
+    limits.maxBodyBytes = static_cast<uint64_t>(cfg.getInt("server.max_body_mb", 64)) * 1024 * 1024;
+    httpServer_.setConnectionLimits(limits);
+}
+
+void ChatServer::initializeSseStreams()
+{
+    // 对话流断线后继续生成 resume_grace_sec 秒，期间以 Last-Event-ID 重连可补发错过的事件
+    auto& cfg = common::ConfigManager::instance();
+    http::SseStreamRegistry::Options options;
+    options.stream.graceMs = static_cast<int64_t>(cfg.getInt("sse.resume_grace_sec", 30)) * 1000;
+    options.stream.maxFrames = static_cast<size_t>(cfg.getInt("sse.replay_frames", 2048));
+    options.stream.maxBytes = static_cast<size_t>(cfg.getInt("sse.replay_kb", 256)) * 1024;
+    sseStreams_ = std::make_unique<http::SseStreamRegistry>(options);
+}
+
+void ChatServer::initializeCurlEngine()
+{
+    // 出站 HTTP（LLM / 语音 / MCP）共用 curl multi 引擎：少量线程驱动全部传输，连接按 host 复用并走 HTTP/2 多路复用
+    auto& cfg = common::ConfigManager::instance();
+    CurlEngine::Options options;
+    // 缺省（或 <= 0）按 CPU 核数：每个 worker 独占一个 multi 句柄，流式回调的解析负载随并发流数分摊到各核
+    int threads = cfg.getInt("ai.curl_threads", 0);
+    options.threads = threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    options.maxHostConnections = cfg.getInt("ai.curl_max_host_connections", 0);
+    options.maxConnectsCache = cfg.getInt("ai.curl_connection_cache", 64);
+    CurlEngine::configure(options);
+    CurlEngine::instance();  // 在处理请求前启动 worker，curl_global_init 不在请求线程上执行
+    SPDLOG_INFO_TAG("AI") << "CurlEngine initialized: threads=" << options.threads;
 }
 
 void ChatServer::initializeRedis()
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace common
+{
+namespace base64url
+{
+
+/// Base64URL (RFC 4648 §5) without padding, table-driven.
+/// Both directions write into a caller-provided buffer and never allocate.
+
+namespace detail
+{
+
+inline constexpr char kEncode[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+constexpr std::array<uint8_t, 256> makeDecodeTable()
+{
+    std::array<uint8_t, 256> table{};
+    for (auto& v : table) v = 0xFF;
+    for (uint8_t i = 0; i < 64; ++i) table[static_cast<unsigned char>(kEncode[i])] = i;
+    return table;
+}
+
+inline constexpr std::array<uint8_t, 256> kDecode = makeDecodeTable();
+
+}  // namespace detail
+
+/// Encoded length for n input bytes (no padding)
+constexpr size_t encodedLength(size_t n)
+{
+    return n / 3 * 4 + (n % 3 == 0 ? 0 : n % 3 + 1);
+}
+
+/// Upper bound of decoded length for n encoded characters
+constexpr size_t decodedMaxLength(size_t n)
+{
+    return n / 4 * 3 + (n % 4 == 0 ? 0 : n % 4 - 1);
+}
+
+/// Encode n bytes into out (must hold encodedLength(n) chars).
+/// @return number of characters written
+inline size_t encode(const void* data, size_t n, char* out)
+{
+    const auto* in = static_cast<const unsigned char*>(data);
+    char* p = out;
+    size_t i = 0;
+    for (; i + 3 <= n; i += 3)
+    {
+        uint32_t v = (uint32_t(in[i]) << 16) | (uint32_t(in[i + 1]) << 8) | in[i + 2];
+        *p++ = detail::kEncode[(v >> 18) & 0x3F];
+        *p++ = detail::kEncode[(v >> 12) & 0x3F];
+        *p++ = detail::kEncode[(v >> 6) & 0x3F];
+        *p++ = detail::kEncode[v & 0x3F];
+    }
+    if (n - i == 1)
+    {
+        uint32_t v = uint32_t(in[i]) << 16;
+        *p++ = detail::kEncode[(v >> 18) & 0x3F];
+        *p++ = detail::kEncode[(v >> 12) & 0x3F];
+    }
+    else if (n - i == 2)
+    {
+        uint32_t v = (uint32_t(in[i]) << 16) | (uint32_t(in[i + 1]) << 8);
+        *p++ = detail::kEncode[(v >> 18) & 0x3F];
+        *p++ = detail::kEncode[(v >> 12) & 0x3F];
+        *p++ = detail::kEncode[(v >> 6) & 0x3F];
+    }
+    return static_cast<size_t>(p - out);
+}
+
+/// Decode into out (must hold decodedMaxLength(in.size()) bytes).
+/// Rejects padding, characters outside the URL alphabet and impossible lengths.
+/// @return true on success; *outLen receives the decoded length
+inline bool decode(std::string_view in, void* out, size_t* outLen)
+{
+    if (in.size() % 4 == 1) return false;
+    auto* p = static_cast<unsigned char*>(out);
+    size_t i = 0;
+    for (; i + 4 <= in.size(); i += 4)
+    {
+        uint8_t a = detail::kDecode[static_cast<unsigned char>(in[i])];
+        uint8_t b = detail::kDecode[static_cast<unsigned char>(in[i + 1])];
+        uint8_t c = detail::kDecode[static_cast<unsigned char>(in[i + 2])];
+        uint8_t d = detail::kDecode[static_cast<unsigned char>(in[i + 3])];
+        if ((a | b | c | d) & 0x80) return false;
+        uint32_t v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | d;
+        *p++ = static_cast<unsigned char>(v >> 16);
+        *p++ = static_cast<unsigned char>(v >> 8);
+        *p++ = static_cast<unsigned char>(v);
+    }
+    size_t rest = in.size() - i;
+    if (rest >= 2)
+    {
+        uint8_t a = detail::kDecode[static_cast<unsigned char>(in[i])];
+        uint8_t b = detail::kDecode[static_cast<unsigned char>(in[i + 1])];
+        uint8_t c = rest == 3 ? detail::kDecode[static_cast<unsigned char>(in[i + 2])] : 0;
+        if ((a | b | c) & 0x80) return false;
+        uint32_t v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6);
+        *p++ = static_cast<unsigned char>(v >> 16);
+        if (rest == 3) *p++ = static_cast<unsigned char>(v >> 8);
+    }
+    *outLen = static_cast<size_t>(p - static_cast<unsigned char*>(out));
+    return true;
+}
+
+}  // namespace base64url
+}  // namespace common
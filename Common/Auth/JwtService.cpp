@@ -1,93 +1,111 @@
 #include "Common/Auth/JwtService.h"
 
+#include <atomic>
 #include <chrono>
-#include <openssl/bio.h>
-#include <openssl/buffer.h>
+#include <list>
+#include <openssl/crypto.h>
 #include <openssl/evp.h>
 #include <openssl/hmac.h>
-#include <sstream>
+#include <unordered_map>
 
+#include "Common/Auth/Base64Url.h"
 #include "Common/Config/ConfigManager.h"
 
 namespace common
 {
 
-JwtService::JwtService()
+namespace
 {
-    auto& cfg = ConfigManager::instance();
-    secret_ = cfg.get("jwt.secret", "dev-secret-change-in-production");
-}
 
-JwtService::JwtService(const std::string& secret) : secret_(secret) {}
+std::atomic<uint64_t> g_nextInstanceId{1};
 
-std::string JwtService::base64UrlEncode(const std::string& data)
+long long nowSeconds()
 {
-    BIO *bio, *b64;
-    BUF_MEM* bufferPtr;
-
-    b64 = BIO_new(BIO_f_base64());
-    bio = BIO_new(BIO_s_mem());
-    bio = BIO_push(b64, bio);
-    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-    BIO_write(bio, data.data(), static_cast<int>(data.size()));
-    BIO_flush(bio);
-    BIO_get_mem_ptr(bio, &bufferPtr);
-
-    std::string result(bufferPtr->data, bufferPtr->length);
-    BIO_free_all(bio);
-
-    // Base64URL: replace + with -, / with _, remove padding =
-    for (auto& c : result)
-    {
-        if (c == '+')
-            c = '-';
-        else if (c == '/')
-            c = '_';
-    }
-    auto pos = result.find_last_not_of('=');
-    if (pos != std::string::npos) result.resize(pos + 1);
-    return result;
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
 }
 
-std::string JwtService::base64UrlDecode(const std::string& input)
+/// Per-thread LRU of verified tokens. Index keys are views into the list nodes' token strings.
+struct ClaimsCache
 {
-    std::string tmp = input;
-    for (auto& c : tmp)
+    struct Entry
     {
-        if (c == '-')
-            c = '+';
-        else if (c == '_')
-            c = '/';
+        std::string token;
+        uint64_t owner;
+        JwtClaims claims;
+    };
+
+    std::list<Entry> lru;  // front = most recently used
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+
+    const JwtClaims* find(std::string_view token, uint64_t owner)
+    {
+        auto it = index.find(token);
+        if (it == index.end() || it->second->owner != owner) return nullptr;
+        lru.splice(lru.begin(), lru, it->second);
+        return &it->second->claims;
+    }
+
+    void erase(std::string_view token)
+    {
+        auto it = index.find(token);
+        if (it == index.end()) return;
+        auto node = it->second;
+        index.erase(it);
+        lru.erase(node);
     }
-    // Add padding
-    while (tmp.size() % 4) tmp += '=';
-
-    BIO *bio, *b64;
-    size_t decodeLen = tmp.size();
-    std::string result(decodeLen, 0);
-    bio = BIO_new_mem_buf(tmp.data(), static_cast<int>(tmp.size()));
-    b64 = BIO_new(BIO_f_base64());
-    bio = BIO_push(b64, bio);
-    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-    int len = BIO_read(bio, result.data(), static_cast<int>(decodeLen));
-    BIO_free_all(bio);
-    if (len > 0) result.resize(static_cast<size_t>(len));
+
+    void insert(std::string_view token, uint64_t owner, const JwtClaims& claims)
+    {
+        erase(token);
+        if (lru.size() >= JwtService::kClaimsCacheSize)
+        {
+            index.erase(lru.back().token);
+            lru.pop_back();
+        }
+        lru.push_front(Entry{std::string(token), owner, claims});
+        index.emplace(lru.front().token, lru.begin());
+    }
+};
+
+thread_local ClaimsCache t_claimsCache;
+
+/// Per-thread scratch for the decoded payload JSON; keeps its capacity so verification
+/// does not allocate a string per token once warmed up
+thread_local std::string t_payloadBuffer;
+
+}  // namespace
+
+JwtService::JwtService() : instanceId_(g_nextInstanceId.fetch_add(1))
+{
+    auto& cfg = ConfigManager::instance();
+    secret_ = cfg.get("jwt.secret", "dev-secret-change-in-production");
+}
+
+JwtService::JwtService(const std::string& secret) : secret_(secret), instanceId_(g_nextInstanceId.fetch_add(1)) {}
+
+std::string JwtService::base64UrlEncode(std::string_view data)
+{
+    std::string result(base64url::encodedLength(data.size()), '\0');
+    base64url::encode(data.data(), data.size(), result.data());
     return result;
 }
 
-std::string JwtService::hmacSha256(const std::string& data, const std::string& key)
+bool JwtService::checkSignature(std::string_view signingInput, std::string_view sigB64, const std::string& key)
 {
     unsigned char md[EVP_MAX_MD_SIZE];
     unsigned int mdLen = 0;
-    HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()), reinterpret_cast<const unsigned char*>(data.data()),
-         data.size(), md, &mdLen);
-    return std::string(reinterpret_cast<char*>(md), mdLen);
+    HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()),
+         reinterpret_cast<const unsigned char*>(signingInput.data()), signingInput.size(), md, &mdLen);
+
+    char expected[base64url::encodedLength(EVP_MAX_MD_SIZE)];
+    size_t expectedLen = base64url::encode(md, mdLen, expected);
+    return sigB64.size() == expectedLen && CRYPTO_memcmp(sigB64.data(), expected, expectedLen) == 0;
 }
 
 std::string JwtService::sign(long long userId, const std::string& role, int ttlSec)
 {
-    auto now = std::chrono::system_clock::now();
-    auto nowTs = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    auto nowTs = nowSeconds();
     auto expTs = nowTs + ttlSec;
 
     json header;
@@ -100,53 +118,86 @@ std::string JwtService::sign(long long userId, const std::string& role, int ttlS
     payload["iat"] = nowTs;
     payload["exp"] = expTs;
 
-    std::string headerB64 = base64UrlEncode(header.dump());
-    std::string payloadB64 = base64UrlEncode(payload.dump());
+    std::string signingInput = base64UrlEncode(header.dump()) + "." + base64UrlEncode(payload.dump());
 
-    std::string signingInput = headerB64 + "." + payloadB64;
-    std::string sig = hmacSha256(signingInput, secret_);
-    std::string sigB64 = base64UrlEncode(sig);
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int mdLen = 0;
+    HMAC(EVP_sha256(), secret_.data(), static_cast<int>(secret_.size()),
+         reinterpret_cast<const unsigned char*>(signingInput.data()), signingInput.size(), md, &mdLen);
+    char sig[base64url::encodedLength(EVP_MAX_MD_SIZE)];
+    size_t sigLen = base64url::encode(md, mdLen, sig);
 
-    return signingInput + "." + sigB64;
+    return signingInput + "." + std::string(sig, sigLen);
 }
 
-json JwtService::verify(const std::string& token) const
+bool JwtService::decode(std::string_view token, json* payload) const
 {
     // Split into 3 parts
     auto dot1 = token.find('.');
-    if (dot1 == std::string::npos) return {};
+    if (dot1 == std::string_view::npos) return false;
     auto dot2 = token.find('.', dot1 + 1);
-    if (dot2 == std::string::npos) return {};
-
-    std::string headerB64 = token.substr(0, dot1);
-    std::string payloadB64 = token.substr(dot1 + 1, dot2 - dot1 - 1);
-    std::string sigB64 = token.substr(dot2 + 1);
-
-    // Verify signature
-    std::string signingInput = headerB64 + "." + payloadB64;
-    std::string expectedSig = hmacSha256(signingInput, secret_);
-    std::string expectedSigB64 = base64UrlEncode(expectedSig);
+    if (dot2 == std::string_view::npos) return false;
 
-    if (sigB64 != expectedSigB64) return {};
+    // Verify signature over "header.payload" in place (constant-time compare)
+    if (!checkSignature(token.substr(0, dot2), token.substr(dot2 + 1), secret_)) return false;
 
     // Decode payload
-    std::string payloadJson = base64UrlDecode(payloadB64);
-    json payload;
+    std::string_view payloadB64 = token.substr(dot1 + 1, dot2 - dot1 - 1);
+    std::string& payloadJson = t_payloadBuffer;
+    payloadJson.resize(base64url::decodedMaxLength(payloadB64.size()));
+    size_t len = 0;
+    if (!base64url::decode(payloadB64, payloadJson.data(), &len)) return false;
     try
     {
-        payload = json::parse(payloadJson);
+        *payload = json::parse(payloadJson.data(), payloadJson.data() + len);
     }
     catch (...)
     {
-        return {};
+        return false;
     }
+    if (!payload->is_object()) return false;
 
     // Check expiration
-    auto now = std::chrono::system_clock::now();
-    auto nowTs = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
-    if (payload.contains("exp") && payload["exp"].get<long long>() < nowTs) return {};
+    if (payload->contains("exp") && (*payload)["exp"].get<long long>() < nowSeconds()) return false;
+    return true;
+}
 
+json JwtService::verify(const std::string& token) const
+{
+    json payload;
+    if (!decode(token, &payload)) return {};
     return payload;
 }
 
+bool JwtService::verifyClaims(std::string_view token, JwtClaims* claims) const
+{
+    if (const JwtClaims* cached = t_claimsCache.find(token, instanceId_))
+    {
+        if (cached->exp != 0 && cached->exp < nowSeconds())
+        {
+            t_claimsCache.erase(token);
+            return false;
+        }
+        *claims = *cached;
+        return true;
+    }
+
+    json payload;
+    if (!decode(token, &payload)) return false;
+    try
+    {
+        JwtClaims decoded;
+        decoded.userId = payload.at("sub").get<long long>();
+        decoded.role = payload.value("role", std::string());
+        decoded.exp = payload.value("exp", 0LL);
+        t_claimsCache.insert(token, instanceId_, decoded);
+        *claims = std::move(decoded);
+    }
+    catch (...)
+    {
+        return false;
+    }
+    return true;
+}
+
 }  // namespace common
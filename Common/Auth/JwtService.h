@@ -1,17 +1,30 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 #include "JsonUtil.h"
 
 namespace common
 {
 
+/// Claims of a verified token
+struct JwtClaims
+{
+    long long userId = 0;
+    std::string role;
+    long long exp = 0;  ///< Unix seconds; 0 = no expiry
+};
+
 /// JWT token service using HS256 (HMAC-SHA256) via OpenSSL.
 /// No external JWT library required.
 class JwtService
 {
 public:
+    /// Per-thread verified-token cache capacity
+    static constexpr size_t kClaimsCacheSize = 1024;
+
     /// Load secret from ConfigManager ("jwt.secret")
     JwtService();
 
@@ -30,6 +43,14 @@ public:
     /// @return JSON with {sub, role, iat, exp} on success, empty JSON on failure
     json verify(const std::string& token) const;
 
+    /// Verify a token through a per-thread LRU cache of already-verified tokens.
+    /// A hit compares the full token and re-checks expiry, skipping HMAC and JSON parsing;
+    /// entries are private to this JwtService instance (its secret).
+    /// @param token   The JWT string
+    /// @param claims  Receives sub/role/exp on success
+    /// @return true if the token is valid and not expired
+    bool verifyClaims(std::string_view token, JwtClaims* claims) const;
+
     /// Get the secret (for use by AuthMiddleware)
     const std::string& secret() const
     {
@@ -37,11 +58,14 @@ public:
     }
 
 private:
-    static std::string base64UrlEncode(const std::string& data);
-    static std::string base64UrlDecode(const std::string& input);
-    static std::string hmacSha256(const std::string& data, const std::string& key);
+    static std::string base64UrlEncode(std::string_view data);
+    static bool checkSignature(std::string_view signingInput, std::string_view sigB64, const std::string& key);
+
+    /// Signature + payload decode + expiry check shared by verify() and verifyClaims()
+    bool decode(std::string_view token, json* payload) const;
 
     std::string secret_;
+    uint64_t instanceId_;  ///< Distinguishes cache entries of services with different secrets
 };
 
 }  // namespace common
@@ -56,6 +56,12 @@ int ConfigManager::getInt(const std::string& path, int defaultVal) const
     }
 }
 
+json ConfigManager::getJson(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return resolvePath(path);
+}
+
 json ConfigManager::resolvePath(const std::string& path) const
 {
     json node = config_;
@@ -28,6 +28,10 @@ public:
     /// 获取整数值（环境变量优先）
     int getInt(const std::string& path, int defaultVal = 0) const;
 
+    /// 获取 JSON 子树（数组 / 对象等结构化配置，不做环境变量覆盖）
+    /// @return 路径不存在时返回 null
+    json getJson(const std::string& path) const;
+
 private:
     ConfigManager() = default;
 
@@ -0,0 +1,94 @@
+#include "Common/Crypto/CryptoPool.h"
+
+#include <algorithm>
+
+namespace common
+{
+
+CryptoPool::CryptoPool(Options options) : options_(options)
+{
+    size_t threads = std::max<size_t>(options_.threads, 1);
+    for (size_t i = 0; i < threads; ++i)
+    {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+}
+
+CryptoPool::~CryptoPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : workers_)
+    {
+        if (t.joinable()) t.join();
+    }
+}
+
+bool CryptoPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_ || tasks_.size() >= options_.maxQueue)
+        {
+            ++stats_.rejected;
+            return false;
+        }
+        tasks_.push_back(Task{std::move(task), Clock::now()});
+        ++stats_.submitted;
+        stats_.queued = tasks_.size();
+    }
+    cv_.notify_one();
+    return true;
+}
+
+CryptoPool::Stats CryptoPool::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void CryptoPool::workerLoop()
+{
+    while (true)
+    {
+        Task task;
+        Clock::time_point started;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            // 停止时丢弃未开始的任务：其回调多半已无连接可写
+            if (stop_) return;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            stats_.queued = tasks_.size();
+            ++stats_.running;
+            started = Clock::now();
+        }
+
+        try
+        {
+            task.fn();
+        }
+        catch (...)
+        {
+        }
+
+        Clock::time_point finished = Clock::now();
+        double wait = std::chrono::duration<double>(started - task.enqueued).count();
+        double run = std::chrono::duration<double>(finished - started).count();
+        size_t bucket = static_cast<size_t>(
+            std::lower_bound(kLatencyBuckets.begin(), kLatencyBuckets.end(), wait + run) - kLatencyBuckets.begin());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        --stats_.running;
+        ++stats_.completed;
+        stats_.waitSeconds += wait;
+        stats_.runSeconds += run;
+        ++stats_.latency[bucket];
+    }
+}
+
+}  // namespace common
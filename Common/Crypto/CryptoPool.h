@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace common
+{
+
+/// 密码哈希等 CPU / 内存密集任务的专用线程池
+///
+/// 与 common::ThreadPool 的区别：队列有上限，满时 submit 直接拒绝（调用方回复 503），
+/// 避免登录洪峰在内存中堆积任务；并统计排队深度与排队 / 执行耗时，供 /metrics 导出。
+/// 每个任务占用的内存由 PasswordHash 的全局内存预算另行约束。
+class CryptoPool
+{
+public:
+    struct Options
+    {
+        size_t threads = 2;    ///< 工作线程数
+        size_t maxQueue = 64;  ///< 排队任务上限（不含执行中的任务）
+    };
+
+    /// 端到端耗时（排队 + 执行）直方图的桶上界，单位秒；最后隐含 +Inf 桶
+    static constexpr std::array<double, 7> kLatencyBuckets = {0.05, 0.1, 0.25, 0.5, 1, 2.5, 5};
+
+    struct Stats
+    {
+        size_t queued = 0;        ///< 当前排队数
+        size_t running = 0;       ///< 当前执行数
+        uint64_t submitted = 0;   ///< 累计接受的任务数
+        uint64_t rejected = 0;    ///< 累计因队列满或已停止被拒绝的任务数
+        uint64_t completed = 0;   ///< 累计完成的任务数
+        double waitSeconds = 0;   ///< 累计排队耗时
+        double runSeconds = 0;    ///< 累计执行耗时
+        std::array<uint64_t, kLatencyBuckets.size() + 1> latency{};  ///< 各桶计数（非累积）
+    };
+
+    explicit CryptoPool(Options options);
+    ~CryptoPool();
+
+    CryptoPool(const CryptoPool&) = delete;
+    CryptoPool& operator=(const CryptoPool&) = delete;
+
+    /// 提交任务；任务内抛出的异常被捕获并丢弃，调用方应在任务内自行处理
+    /// @return 队列已满或线程池已停止时返回 false，任务不会执行
+    bool submit(std::function<void()> task);
+
+    Stats stats() const;
+
+    size_t threadCount() const
+    {
+        return workers_.size();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Task
+    {
+        std::function<void()> fn;
+        Clock::time_point enqueued;
+    };
+
+    void workerLoop();
+
+    const Options options_;
+    std::vector<std::thread> workers_;
+    std::deque<Task> tasks_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    Stats stats_;  // 受 mutex_ 保护
+};
+
+}  // namespace common
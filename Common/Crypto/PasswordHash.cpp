@@ -1,21 +1,156 @@
 #include "Common/Crypto/PasswordHash.h"
 
 #include <sodium.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
 #include <stdexcept>
 
 namespace common
 {
 
+namespace
+{
+
+/// 按字节计数的信号量：限制同时进行的 argon2id 计算占用的内存之和
+class MemoryBudget
+{
+public:
+    void setLimit(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        limit_ = bytes;
+        cv_.notify_all();
+    }
+
+    /// @return 实际占用的字节数（超过预算时按预算计，保证单次计算总能执行）
+    size_t acquire(size_t bytes)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (limit_ != 0)
+        {
+            bytes = std::min(bytes, limit_);
+            cv_.wait(lock, [&] { return limit_ == 0 || used_ + bytes <= limit_; });
+        }
+        used_ += bytes;
+        return bytes;
+    }
+
+    void release(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        used_ -= bytes;
+        cv_.notify_all();
+    }
+
+    size_t used() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return used_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t limit_ = 0;
+    size_t used_ = 0;
+};
+
+class BudgetGuard
+{
+public:
+    BudgetGuard(MemoryBudget& budget, size_t bytes) : budget_(budget), bytes_(budget.acquire(bytes)) {}
+    ~BudgetGuard()
+    {
+        budget_.release(bytes_);
+    }
+    BudgetGuard(const BudgetGuard&) = delete;
+    BudgetGuard& operator=(const BudgetGuard&) = delete;
+
+private:
+    MemoryBudget& budget_;
+    size_t bytes_;
+};
+
+MemoryBudget g_budget;
+std::mutex g_costMutex;
+PasswordCost g_cost = PasswordCost::moderate();
+
+// 从 "$argon2id$v=19$m=262144,t=3,p=1$..." 中取出 m（KiB），解析失败时按当前档位估计
+size_t memoryOf(const std::string& hash)
+{
+    size_t pos = hash.find("$m=");
+    if (pos != std::string::npos)
+    {
+        unsigned long long kib = std::strtoull(hash.c_str() + pos + 3, nullptr, 10);
+        if (kib > 0) return static_cast<size_t>(kib) * 1024;
+    }
+    return passwordCost().memLimit;
+}
+
+}  // namespace
+
+PasswordCost PasswordCost::interactive()
+{
+    return {crypto_pwhash_OPSLIMIT_INTERACTIVE, crypto_pwhash_MEMLIMIT_INTERACTIVE};
+}
+
+PasswordCost PasswordCost::moderate()
+{
+    return {crypto_pwhash_OPSLIMIT_MODERATE, crypto_pwhash_MEMLIMIT_MODERATE};
+}
+
+PasswordCost PasswordCost::sensitive()
+{
+    return {crypto_pwhash_OPSLIMIT_SENSITIVE, crypto_pwhash_MEMLIMIT_SENSITIVE};
+}
+
+bool PasswordCost::fromName(const std::string& name, PasswordCost* cost)
+{
+    if (name == "interactive")
+        *cost = interactive();
+    else if (name == "moderate")
+        *cost = moderate();
+    else if (name == "sensitive")
+        *cost = sensitive();
+    else
+        return false;
+    return true;
+}
+
+void configurePasswordHashing(const PasswordCost& cost, size_t memoryBudget)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_costMutex);
+        g_cost = cost;
+    }
+    g_budget.setLimit(memoryBudget);
+}
+
+PasswordCost passwordCost()
+{
+    std::lock_guard<std::mutex> lock(g_costMutex);
+    return g_cost;
+}
+
+size_t passwordMemoryInUse()
+{
+    return g_budget.used();
+}
+
 std::string hashPassword(const std::string& plaintext)
 {
-    // argon2id 内存开销 256 MB，迭代 3 次（MODERATE 级别）
+    // argon2id，默认 MODERATE 档位：内存开销 256 MB，迭代 3 次
     // hash 输出格式：$argon2id$v=19$m=262144,t=3,p=1$<salt>$<hash>
     // 存入 accounts.password_hash VARCHAR(256)
     if (sodium_init() < 0) throw std::runtime_error("[PasswordHash] libsodium init failed");
 
+    PasswordCost cost = passwordCost();
+    BudgetGuard guard(g_budget, cost.memLimit);
     char hash[crypto_pwhash_STRBYTES];
-    if (crypto_pwhash_str(hash, plaintext.c_str(), plaintext.size(), crypto_pwhash_OPSLIMIT_MODERATE,
-                          crypto_pwhash_MEMLIMIT_MODERATE) != 0)
+    if (crypto_pwhash_str(hash, plaintext.c_str(), plaintext.size(), cost.opsLimit, cost.memLimit) != 0)
         throw std::runtime_error("[PasswordHash] argon2id hash failed — out of memory or thread limit");
 
     return std::string(hash);
@@ -24,7 +159,15 @@ std::string hashPassword(const std::string& plaintext)
 bool verifyPassword(const std::string& plaintext, const std::string& hash)
 {
     if (sodium_init() < 0) return false;
+    BudgetGuard guard(g_budget, memoryOf(hash));
     return crypto_pwhash_str_verify(hash.c_str(), plaintext.c_str(), plaintext.size()) == 0;
 }
 
+bool passwordNeedsRehash(const std::string& hash)
+{
+    if (sodium_init() < 0) return false;
+    PasswordCost cost = passwordCost();
+    return crypto_pwhash_str_needs_rehash(hash.c_str(), cost.opsLimit, cost.memLimit) != 0;
+}
+
 }  // namespace common
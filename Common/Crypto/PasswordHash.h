@@ -1,18 +1,51 @@
 #pragma once
+#include <cstddef>
 #include <string>
 
 namespace common
 {
 
-/// argon2id password hashing via libsodium crypto_pwhash_str
+/// argon2id 成本参数（libsodium opslimit / memlimit）
+struct PasswordCost
+{
+    unsigned long long opsLimit;
+    size_t memLimit;  ///< 字节
+
+    static PasswordCost interactive();  ///< t=2, 64 MB
+    static PasswordCost moderate();     ///< t=3, 256 MB（默认）
+    static PasswordCost sensitive();    ///< t=4, 1 GB
+
+    /// 按名称（interactive / moderate / sensitive）取预设档位
+    /// @return 名称不识别时返回 false，*cost 不变
+    static bool fromName(const std::string& name, PasswordCost* cost);
+};
+
+/// 设置新哈希使用的成本档位与全局内存预算
+/// @param cost          hashPassword / passwordNeedsRehash 使用的档位
+/// @param memoryBudget  所有线程同时进行的 argon2id 计算占用内存之和的上限（字节），0 表示不限；
+///                      超出时后来者阻塞等待，单次计算超过预算时按独占预算执行
+void configurePasswordHashing(const PasswordCost& cost, size_t memoryBudget);
+
+/// 当前配置的成本档位
+PasswordCost passwordCost();
+
+/// 正在进行的 argon2id 计算占用的内存（字节）
+size_t passwordMemoryInUse();
+
+/// argon2id password hashing via libsodium crypto_pwhash_str（使用 configurePasswordHashing 配置的档位）
+/// 耗时数百毫秒并占用 memLimit 内存，不要在 IO 线程调用
 /// @param plaintext 明文密码
 /// @return argon2id hash string ($argon2id$v=19$m=...,t=3,p=1$...)
 std::string hashPassword(const std::string& plaintext);
 
 /// 验证明文密码与 argon2id hash 是否匹配
+/// 成本由 hash 自身的参数决定，同样受全局内存预算约束
 /// @param plaintext 用户输入的明文密码
 /// @param hash      数据库中存储的 hash 字符串
 /// @return true 匹配，false 不匹配
 bool verifyPassword(const std::string& plaintext, const std::string& hash);
 
+/// hash 的参数与当前档位不一致（含非 argon2id 算法）时返回 true，调用方可在验证成功后重新哈希
+bool passwordNeedsRehash(const std::string& hash);
+
 }  // namespace common
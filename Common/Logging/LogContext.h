@@ -27,4 +27,21 @@ inline void clearLogContext()
     tls_log_ctx.user_id.clear();
 }
 
+/// Installs a log context for the current scope and clears it on exit.
+/// Used by worker threads that continue a request after the IO thread has returned.
+class ScopedLogContext
+{
+public:
+    explicit ScopedLogContext(const std::string& req_id, const std::string& user_id = "")
+    {
+        setLogContext(req_id, user_id);
+    }
+    ~ScopedLogContext()
+    {
+        clearLogContext();
+    }
+    ScopedLogContext(const ScopedLogContext&) = delete;
+    ScopedLogContext& operator=(const ScopedLogContext&) = delete;
+};
+
 }  // namespace common
@@ -0,0 +1,108 @@
+#include "Common/Logging/RequestId.h"
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+namespace common
+{
+
+namespace
+{
+
+constexpr int kCounterBits = 26;
+constexpr uint32_t kCounterMask = (1u << kCounterBits) - 1;
+
+uint64_t splitmix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+struct Generator
+{
+    uint64_t rng;
+    uint64_t tag;  // 低 48 位有效
+    uint64_t lastMs = 0;
+    uint32_t counter = 0;
+
+    Generator()
+    {
+        std::random_device rd;
+        rng = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+        tag = splitmix64(rng) & 0xFFFFFFFFFFFFULL;
+    }
+
+    void next(uint64_t* ms, uint32_t* seq)
+    {
+        uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                 std::chrono::system_clock::now().time_since_epoch())
+                                                 .count());
+        if (now > lastMs)
+        {
+            lastMs = now;
+            // 每毫秒从随机起点开始，只用一半取值空间，留出自增余量
+            counter = static_cast<uint32_t>(splitmix64(rng)) & (kCounterMask >> 1);
+        }
+        else if (++counter > kCounterMask)
+        {
+            // 同一毫秒内计数用尽或时钟回拨：借用下一毫秒，保持单调
+            ++lastMs;
+            counter = 0;
+        }
+        *ms = lastMs;
+        *seq = counter;
+    }
+};
+
+thread_local Generator t_generator;
+
+constexpr char kHex[] = "0123456789abcdef";
+
+}  // namespace
+
+void generateRequestId(char* out)
+{
+    uint64_t ms;
+    uint32_t seq;
+    t_generator.next(&ms, &seq);
+
+    unsigned char b[16];
+    for (int i = 0; i < 6; ++i) b[i] = static_cast<unsigned char>(ms >> (40 - 8 * i));
+    b[6] = static_cast<unsigned char>(0x70 | ((seq >> 22) & 0x0F));  // 版本 7 + 计数高 4 位
+    b[7] = static_cast<unsigned char>(seq >> 14);
+    b[8] = static_cast<unsigned char>(0x80 | ((seq >> 8) & 0x3F));  // 变体 10 + 计数 6 位
+    b[9] = static_cast<unsigned char>(seq);
+    for (int i = 0; i < 6; ++i) b[10 + i] = static_cast<unsigned char>(t_generator.tag >> (40 - 8 * i));
+
+    char* p = out;
+    for (int i = 0; i < 16; ++i)
+    {
+        if (i == 4 || i == 6 || i == 8 || i == 10) *p++ = '-';
+        *p++ = kHex[b[i] >> 4];
+        *p++ = kHex[b[i] & 0x0F];
+    }
+}
+
+std::string generateRequestId()
+{
+    std::string id(kRequestIdLength, '\0');
+    generateRequestId(id.data());
+    return id;
+}
+
+bool isValidRequestId(std::string_view id)
+{
+    if (id.empty() || id.size() > 64) return false;
+    for (char c : id)
+    {
+        bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' ||
+                  c == '_' || c == '.' || c == ':';
+        if (!ok) return false;
+    }
+    return true;
+}
+
+}  // namespace common
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace common
+{
+
+/// Length of a request ID in its canonical text form (8-4-4-4-12 hex).
+inline constexpr size_t kRequestIdLength = 36;
+
+/// Generate a request ID in UUIDv7 layout (RFC 9562):
+///   48-bit Unix milliseconds | ver 7 | 26-bit counter | variant | 48-bit per-thread random tag
+/// IDs sort by creation time across nodes and are strictly increasing within a thread.
+/// The counter restarts at a random offset each millisecond and the tag is drawn once per
+/// thread, so threads and nodes never need to coordinate. No syscalls after the first call
+/// on a thread (the clock is read through the vDSO).
+std::string generateRequestId();
+
+/// Same as generateRequestId() but writes kRequestIdLength chars into out, without allocating.
+void generateRequestId(char* out);
+
+/// Accept a client-supplied X-Request-Id only if it is 1..64 chars of [A-Za-z0-9._:-],
+/// so it is safe to log, to forward as an outgoing header and to store in call_logs.
+bool isValidRequestId(std::string_view id);
+
+}  // namespace common
@@ -0,0 +1,87 @@
+#include "Common/RateLimit/RateLimiter.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace common
+{
+
+ShardedRateLimiter::ShardedRateLimiter(size_t shards, int reclaimIntervalSec)
+    : reclaimIntervalNs_(static_cast<int64_t>(std::max(reclaimIntervalSec, 0)) * 1000000000LL)
+{
+    shards = std::max<size_t>(shards, 1);
+    shards_.reserve(shards);
+    for (size_t i = 0; i < shards; ++i) shards_.push_back(std::make_unique<Shard>());
+}
+
+ShardedRateLimiter::Shard& ShardedRateLimiter::shardFor(long long key)
+{
+    // 乘法散列打散连续的 userId，取高位作分片号
+    uint64_t h = static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL;
+    return *shards_[(h >> 32) % shards_.size()];
+}
+
+bool ShardedRateLimiter::acquire(long long key, const RateLimit& limit, int n, int64_t* retryAfterNs)
+{
+    Shard& shard = shardFor(key);
+    int64_t now = gcra::nowNs();
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.buckets.find(key);
+        if (it != shard.buckets.end()) return gcra::consume(it->second, limit, n, now, retryAfterNs);
+    }
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    if (now - shard.lastReclaimNs >= reclaimIntervalNs_)
+    {
+        reclaimShard(shard, now);
+        shard.lastReclaimNs = now;
+    }
+    // 两次加锁之间可能已被其他线程插入，try_emplace 不会覆盖
+    auto& tat = shard.buckets.try_emplace(key, 0).first->second;
+    return gcra::consume(tat, limit, n, now, retryAfterNs);
+}
+
+size_t ShardedRateLimiter::reclaimShard(Shard& shard, int64_t now)
+{
+    size_t removed = 0;
+    for (auto it = shard.buckets.begin(); it != shard.buckets.end();)
+    {
+        if (gcra::isIdle(it->second, now))
+        {
+            it = shard.buckets.erase(it);
+            ++removed;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+size_t ShardedRateLimiter::reclaimIdle()
+{
+    size_t removed = 0;
+    int64_t now = gcra::nowNs();
+    for (auto& shard : shards_)
+    {
+        std::unique_lock<std::shared_mutex> lock(shard->mutex);
+        removed += reclaimShard(*shard, now);
+        shard->lastReclaimNs = now;
+    }
+    return removed;
+}
+
+size_t ShardedRateLimiter::size() const
+{
+    size_t total = 0;
+    for (const auto& shard : shards_)
+    {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        total += shard->buckets.size();
+    }
+    return total;
+}
+
+}  // namespace common
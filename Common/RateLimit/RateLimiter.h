@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/RateLimit/TokenBucket.h"
+
+namespace common
+{
+
+/// 按 key（通常为 userId）限流的存储抽象：本地实现见 ShardedRateLimiter，跨实例一致的实现见
+/// infra::cache::RedisRateLimiter。每条限流规则各用一个实例，key 只需在规则内唯一；
+/// 限流参数随每次调用传入，同一 key 换档（如用户升级）立即生效。
+class RateLimiter
+{
+public:
+    virtual ~RateLimiter() = default;
+
+    /// 尝试为 key 消费 n 个令牌
+    /// @param retryAfterNs 非空且被拒绝时写入最早可重试的等待时长（纳秒）
+    /// @return true 放行
+    virtual bool acquire(long long key, const RateLimit& limit, int n = 1, int64_t* retryAfterNs = nullptr) = 0;
+};
+
+/// 进程内限流：key 按哈希分片，每片一把读写锁 + 一张 key → TAT 的表。
+/// 已有 key 的消费只持读锁，令牌扣减是 TAT 上的 CAS，不同用户之间、同一用户的并发请求之间都不互斥；
+/// 仅首次出现的 key 需要写锁插入。插入时顺带检查本片距上次回收是否超过 reclaimInterval，
+/// 是则删除已回满的桶（与新建桶等价，删除不改变限流结果），表的大小因此只随活跃用户数增长。
+class ShardedRateLimiter : public RateLimiter
+{
+public:
+    static constexpr size_t kDefaultShards = 16;
+    static constexpr int kDefaultReclaimIntervalSec = 60;
+
+    explicit ShardedRateLimiter(size_t shards = kDefaultShards, int reclaimIntervalSec = kDefaultReclaimIntervalSec);
+
+    bool acquire(long long key, const RateLimit& limit, int n = 1, int64_t* retryAfterNs = nullptr) override;
+
+    /// 立即回收所有分片中已回满的桶
+    /// @return 回收的桶数
+    size_t reclaimIdle();
+
+    /// 当前桶数（各分片之和）
+    size_t size() const;
+
+    size_t shardCount() const
+    {
+        return shards_.size();
+    }
+
+private:
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        // unordered_map 节点地址稳定，atomic 不需要再包一层 unique_ptr
+        std::unordered_map<long long, std::atomic<int64_t>> buckets;
+        int64_t lastReclaimNs = 0;  // 受 mutex 写锁保护
+    };
+
+    Shard& shardFor(long long key);
+    static size_t reclaimShard(Shard& shard, int64_t now);
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    const int64_t reclaimIntervalNs_;
+};
+
+}  // namespace common
@@ -1,53 +1,72 @@
 #include "Common/RateLimit/TokenBucket.h"
 
 #include <algorithm>
+#include <chrono>
 
 namespace common
 {
 
-TokenBucket::TokenBucket(int maxTokens, double refillPerSec)
-    : tokens_(maxTokens),
-      lastRefillUs_(
-          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
-              .count()),
-      maxTokens_(maxTokens),
-      refillPerUs_(refillPerSec / 1000000.0)
+namespace gcra
 {
+
+namespace
+{
+
+// 单个令牌的补充间隔上限（约 11.5 天），保证 burst * T 不溢出 int64
+constexpr int64_t kMaxIntervalNs = 1000000000000000LL;
+
+int64_t intervalNs(double perSec)
+{
+    if (perSec <= 0) return kMaxIntervalNs;
+    return std::clamp<int64_t>(static_cast<int64_t>(1e9 / perSec), 1, kMaxIntervalNs);
+}
+
+}  // namespace
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
 }
 
-void TokenBucket::refill()
-{
-    auto now =
-        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
-            .count();
-    auto last = lastRefillUs_.load(std::memory_order_relaxed);
-    if (now <= last) return;
-    auto elapsed = now - last;
-    double gained = elapsed * refillPerUs_;
-    if (gained < 1.0) return;
-    // Atomically update tokens and lastRefill
-    auto current = tokens_.load(std::memory_order_relaxed);
-    auto newTokens = std::min<int64_t>(maxTokens_, current + static_cast<int64_t>(gained));
-    tokens_.store(newTokens, std::memory_order_relaxed);
-    lastRefillUs_.store(now, std::memory_order_relaxed);
+bool consume(std::atomic<int64_t>& tat, const RateLimit& limit, int n, int64_t now, int64_t* retryAfterNs)
+{
+    int64_t interval = intervalNs(limit.perSec);
+    int64_t increment = interval * n;
+    int64_t tolerance = interval * std::max(limit.burst, 0);
+
+    int64_t current = tat.load(std::memory_order_relaxed);
+    while (true)
+    {
+        int64_t next = std::max(current, now) + increment;
+        int64_t excess = next - now - tolerance;
+        if (excess > 0)
+        {
+            if (retryAfterNs) *retryAfterNs = excess;
+            return false;
+        }
+        // 失败时 current 被更新为最新值，按新 TAT 重新判定
+        if (tat.compare_exchange_weak(current, next, std::memory_order_relaxed)) return true;
+    }
 }
 
-bool TokenBucket::consume(int n)
+}  // namespace gcra
+
+TokenBucket::TokenBucket(int maxTokens, double refillPerSec) : limit_{maxTokens, refillPerSec} {}
+
+bool TokenBucket::consume(int n, int64_t* retryAfterNs)
 {
-    refill();
-    auto current = tokens_.load(std::memory_order_relaxed);
-    if (current < n) return false;
-    tokens_.store(current - n, std::memory_order_relaxed);
-    return true;
+    return gcra::consume(tat_, limit_, n, gcra::nowNs(), retryAfterNs);
 }
 
 void TokenBucket::reset()
 {
-    tokens_.store(maxTokens_, std::memory_order_relaxed);
-    lastRefillUs_.store(
-        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
-            .count(),
-        std::memory_order_relaxed);
+    tat_.store(0, std::memory_order_relaxed);
+}
+
+bool TokenBucket::idle() const
+{
+    return gcra::isIdle(tat_, gcra::nowNs());
 }
 
-}  // namespace common
\ No newline at end of file
+}  // namespace common
@@ -1,30 +1,61 @@
 #pragma once
 
 #include <atomic>
-#include <chrono>
+#include <cstdint>
 
 namespace common
 {
 
+/// 限流参数：突发容量 burst 个令牌，每秒补充 perSec 个
+struct RateLimit
+{
+    int burst = 10;
+    double perSec = 10.0 / 60.0;
+};
+
+/// GCRA（Generic Cell Rate Algorithm）形式的令牌桶。
+/// 状态只有一个"理论到达时间" TAT（纳秒，steady_clock），与令牌桶等价：
+/// 剩余令牌 = (now + burst * T - TAT) / T，T = 1 / perSec。
+/// 消费是对 TAT 的一次 CAS，并发调用不会超发；TAT <= now 即桶已满，可直接丢弃而不改变语义。
+namespace gcra
+{
+
+/// 当前 steady_clock 时间（纳秒）
+int64_t nowNs();
+
+/// 在 tat 上尝试消费 n 个令牌
+/// @param retryAfterNs 非空且被拒绝时写入最早可重试的等待时长（纳秒）
+/// @return true 放行
+bool consume(std::atomic<int64_t>& tat, const RateLimit& limit, int n, int64_t now, int64_t* retryAfterNs = nullptr);
+
+/// tat 表示的桶在 now 时刻已回满（空闲）
+inline bool isIdle(const std::atomic<int64_t>& tat, int64_t now)
+{
+    return tat.load(std::memory_order_relaxed) <= now;
+}
+
+}  // namespace gcra
+
 /// Thread-safe token bucket rate limiter.
-/// Uses atomic operations + chrono for lock-free refill.
+/// Lock-free: each consume() is a single CAS loop on the bucket's TAT.
 class TokenBucket
 {
 public:
     TokenBucket(int maxTokens = 10, double refillPerSec = 10.0 / 60.0);
 
-    /// Try to consume one token. Returns true if allowed.
-    bool consume(int n = 1);
+    /// Try to consume n tokens. Returns true if allowed.
+    /// @param retryAfterNs on rejection, receives the wait (ns) until n tokens are available
+    bool consume(int n = 1, int64_t* retryAfterNs = nullptr);
 
     /// Reset to full tokens.
     void reset();
 
+    /// True if the bucket has refilled completely.
+    bool idle() const;
+
 private:
-    void refill();
-    std::atomic<int64_t> tokens_;
-    std::atomic<int64_t> lastRefillUs_;
-    int maxTokens_;
-    double refillPerUs_;  // tokens per microsecond
+    std::atomic<int64_t> tat_{0};
+    RateLimit limit_;
 };
 
-}  // namespace common
\ No newline at end of file
+}  // namespace common
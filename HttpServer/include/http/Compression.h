@@ -0,0 +1,141 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace http
+{
+
+/**
+ * @brief 动态响应的内容编码
+ *
+ * gzip / deflate 依赖 zlib（HAS_ZLIB），br 依赖 brotlienc（HAS_BROTLI），编译时缺失的编码不会被协商选中。
+ */
+enum class ContentEncoding
+{
+    kIdentity,
+    kGzip,
+    kDeflate,
+    kBrotli,
+};
+
+/// 编码名（"gzip" / "deflate" / "br"），identity 为空串
+std::string_view contentEncodingName(ContentEncoding encoding);
+
+/// 本构建是否支持该编码
+bool compressionAvailable(ContentEncoding encoding);
+
+/**
+ * @brief Accept-Encoding 中各编码的 q 值
+ *
+ * 未出现的编码取 "*" 的 q 值，没有 "*" 时为 0（identity 缺省为 1）。
+ */
+struct AcceptEncoding
+{
+    double identity = 1;
+    double gzip = 0;
+    double deflate = 0;
+    double br = 0;
+
+    static AcceptEncoding parse(std::string_view header);
+
+    double q(ContentEncoding encoding) const;
+};
+
+/**
+ * @brief 选择双方都支持、q 值最高的编码；同 q 值时 br > gzip > deflate > identity
+ * @param allowBrotli 为 false 时不选 br（如动态响应不愿承担 br 的 CPU 开销）
+ */
+ContentEncoding negotiateEncoding(std::string_view acceptEncoding, bool allowBrotli = true);
+
+/**
+ * @brief 动态响应压缩策略（CompressionMiddleware 与 SSE 流共用）
+ */
+struct CompressionOptions
+{
+    bool enabled = true;
+    size_t minBytes = 1024;  // 小于该大小的响应体不压缩：省下的字节抵不过头部与 CPU 开销
+    int zlibLevel = 6;       // gzip / deflate 级别
+    bool brotli = true;      // 是否协商 br
+    int brotliQuality = 4;   // 动态内容用低质量档，压缩率接近 gzip 6 而速度相当
+    bool sse = true;         // 是否压缩 SSE 流
+    /// 可压缩的 Content-Type 前缀
+    std::vector<std::string> contentTypes = {"application/json", "text/", "application/javascript",
+                                             "application/xml", "image/svg+xml"};
+
+    bool compressible(std::string_view contentType) const;
+
+    int level(ContentEncoding encoding) const
+    {
+        return encoding == ContentEncoding::kBrotli ? brotliQuality : zlibLevel;
+    }
+};
+
+/**
+ * @brief 一次性压缩整个响应体，复用压缩状态
+ *
+ * zlib 每次 deflateInit 都要分配约 256 KiB 的窗口与哈希表；每个 IO 线程持有一个 Compressor
+ * （threadLocal()），gzip / deflate 各保留一个 z_stream，响应之间只 deflateReset，不再分配。
+ * br 没有重置接口，按次使用一次性接口。
+ */
+class Compressor
+{
+public:
+    Compressor();
+    ~Compressor();
+
+    Compressor(const Compressor&) = delete;
+    Compressor& operator=(const Compressor&) = delete;
+
+    /**
+     * @param level zlib 为 1~9，br 为 0~11
+     * @return 编码不可用或压缩失败时返回 false，out 内容未定义
+     */
+    bool compress(ContentEncoding encoding, int level, std::string_view in, std::string* out);
+
+    /// 当前线程的实例
+    static Compressor& threadLocal();
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+};
+
+/**
+ * @brief 流式压缩（SSE）：每次 write() 的输出都以 flush 结尾，客户端收到即可解出该段内容
+ *
+ * 状态跨事件保留，后续事件可引用前文，token 之间的重复片段（JSON 键名等）压缩效果明显。
+ * 每个流独占一份状态，窗口取较小值（zlib 4 KiB 窗口约 32 KiB 内存，br 64 KiB 窗口）以限制连接数多时的内存。
+ */
+class StreamCompressor
+{
+public:
+    StreamCompressor(ContentEncoding encoding, int level);
+    ~StreamCompressor();
+
+    StreamCompressor(const StreamCompressor&) = delete;
+    StreamCompressor& operator=(const StreamCompressor&) = delete;
+
+    /// 初始化成功（编码可用）时为 true
+    bool ok() const;
+
+    ContentEncoding encoding() const
+    {
+        return encoding_;
+    }
+
+    /// 压缩一段数据并 flush，输出追加到 out
+    bool write(std::string_view in, std::string* out);
+
+    /// 结束压缩流，尾部追加到 out；之后不可再 write()
+    bool finish(std::string* out);
+
+private:
+    struct State;
+    ContentEncoding encoding_;
+    std::unique_ptr<State> state_;
+};
+
+}  // namespace http
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace http
+{
+
+/**
+ * @brief 单连接的超时与请求大小上限
+ *
+ * 超时以秒计，由每个 IO 线程的时间轮检查；大小上限由 HttpContext 在解析时检查。
+ * 任一项为 0 表示不限制。
+ */
+struct ConnectionLimits
+{
+    int headerTimeoutSec = 10;     ///< 从请求首字节到头部结束的总时长（不因零星到达的字节而延长）
+    int bodyTimeoutSec = 30;       ///< 读取请求体时两次到达数据之间的最长间隔
+    int keepAliveTimeoutSec = 60;  ///< 响应发完后等待下一个请求的空闲时长
+
+    size_t maxRequestLineBytes = 8 * 1024;     ///< 请求行上限，超出返回 414
+    size_t maxHeaderBytes = 64 * 1024;         ///< 全部请求头字节上限，超出返回 431
+    size_t maxHeaderCount = 100;               ///< 请求头字段数上限，超出返回 431
+    uint64_t maxBodyBytes = 64 * 1024 * 1024;  ///< 请求体上限（含 chunked 解码后），超出返回 413
+};
+
+/**
+ * @brief 连接被回收的原因
+ */
+enum class ReapReason
+{
+    kHeaderTimeout,
+    kBodyTimeout,
+    kIdleTimeout,
+    kRequestLineTooLong,
+    kHeaderTooLarge,
+    kTooManyHeaders,
+    kBodyTooLarge,
+    kCount,
+};
+
+/**
+ * @brief 各回收规则的累计计数，IO 线程并发递增，任意线程读取
+ */
+class ConnectionReapStats
+{
+public:
+    void increment(ReapReason reason)
+    {
+        counts_[static_cast<size_t>(reason)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t get(ReapReason reason) const
+    {
+        return counts_[static_cast<size_t>(reason)].load(std::memory_order_relaxed);
+    }
+
+    // 指标标签名，例如 "header_timeout"
+    static const char* name(ReapReason reason)
+    {
+        static const char* const kNames[] = {
+            "header_timeout",   "body_timeout",     "idle_timeout",   "request_line_too_long",
+            "header_too_large", "too_many_headers", "body_too_large",
+        };
+        return kNames[static_cast<size_t>(reason)];
+    }
+
+private:
+    std::atomic<uint64_t> counts_[static_cast<size_t>(ReapReason::kCount)]{};
+};
+
+}  // namespace http
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <muduo/base/noncopyable.h>
+#include <muduo/net/TcpConnection.h>
+
+namespace ssl
+{
+class SslConnection;
+}
+
+namespace http
+{
+
+/**
+ * @brief 引用文件描述符与字节区间的响应体
+ *
+ * 大文件不再整体读入 std::string：响应只持有打开的 fd 和 [offset, offset + length) 区间，
+ * 由 FileSender 在连接可写时分段发出。析构时关闭 fd。
+ */
+class FileBody : muduo::noncopyable
+{
+public:
+    // 以只读方式打开普通文件，区间默认为整个文件。
+    // 参数：
+    // - path：磁盘路径。
+    // 返回值：文件不存在、不可读或不是普通文件时返回 nullptr。
+    static std::shared_ptr<FileBody> open(const std::string& path);
+
+    ~FileBody();
+
+    // 设置要发送的区间，调用方保证 offset + length <= fileSize()。
+    void setRange(uint64_t offset, uint64_t length)
+    {
+        offset_ = offset;
+        length_ = length;
+    }
+
+    int fd() const
+    {
+        return fd_;
+    }
+    uint64_t fileSize() const
+    {
+        return fileSize_;
+    }
+    time_t mtime() const
+    {
+        return mtime_;
+    }
+    uint64_t offset() const
+    {
+        return offset_;
+    }
+    uint64_t length() const
+    {
+        return length_;
+    }
+
+private:
+    FileBody(int fd, uint64_t fileSize, time_t mtime);
+
+    int fd_;
+    uint64_t fileSize_;
+    time_t mtime_;
+    uint64_t offset_;
+    uint64_t length_;
+};
+
+/// Range 头解析结果
+enum class ByteRangeResult
+{
+    kNone,           ///< 无 Range、语法不支持或多区间：按完整响应（200）处理
+    kSatisfiable,    ///< 单区间有效：返回 206
+    kUnsatisfiable,  ///< 区间超出文件：返回 416
+};
+
+// 解析单区间 Range 头：bytes=a-b / bytes=a- / bytes=-n（RFC 7233 §2.1）。
+// 参数：
+// - header：Range 头的值。
+// - fileSize：文件大小。
+// - offset / length：kSatisfiable 时写入区间起点与长度（末端已按文件大小截断）。
+// 返回值：见 ByteRangeResult。
+ByteRangeResult parseByteRange(std::string_view header, uint64_t fileSize, uint64_t* offset, uint64_t* length);
+
+/**
+ * @brief 文件响应体发送器
+ *
+ * 响应头写入连接后启动，在连接所在的 IO 线程内分段发送 FileBody 的区间：
+ * - 明文 TCP：sendfile(2) 直接从页缓存写入 socket，不经过用户态缓冲区；
+ *   socket 写满（EAGAIN）时补发一个有界分段进 muduo 输出缓冲区，借其 EPOLLOUT 等待可写。
+ * - SSL 连接：每次 pread 一个有界分段，经 SslConnection::send 加密后写出。
+ *
+ * 只有输出缓冲区清空（WriteCompleteCallback）后才发下一段，因此单个连接占用的内存
+ * 与文件大小无关。发送期间占用连接的 WriteCompleteCallback。
+ */
+class FileSender
+{
+public:
+    using CompleteCallback = std::function<void(const muduo::net::TcpConnectionPtr&)>;
+
+    static constexpr size_t kChunkBytes = 64 * 1024;        ///< 拷贝路径单段大小
+    static constexpr size_t kPumpBudgetBytes = 4 * 1024 * 1024;  ///< 单次回调最多发送的字节，避免饿死同线程其他连接
+
+    // 开始发送，必须在连接所在 IO 线程调用。
+    // 参数：
+    // - conn：目标连接，响应头应已写入。
+    // - body：文件响应体。
+    // - socketFd：连接的 socket fd，用于 sendfile；< 0 时退化为分段拷贝。
+    // - sslConn：非空时走 SSL 分段加密路径。
+    // - onComplete：区间全部交给连接后回调（此时输出缓冲区中可能仍有最后一段待写出）。
+    static void start(const muduo::net::TcpConnectionPtr& conn,
+                      std::shared_ptr<const FileBody> body,
+                      int socketFd,
+                      ssl::SslConnection* sslConn,
+                      CompleteCallback onComplete);
+
+    // 查找连接对应的 socket fd（muduo 未公开该 fd）：遍历本进程已打开的 socket，
+    // 按本端/对端地址匹配。开销与打开的 fd 数成正比，调用方应按连接缓存结果。
+    // 返回值：找不到时返回 -1。
+    static int resolveSocketFd(const muduo::net::TcpConnectionPtr& conn);
+};
+
+}  // namespace http
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace http
+{
+
+/**
+ * @brief 连接级的请求头内存池（bump allocator）
+ *
+ * 请求行与请求头在解析时只拷贝一次进 arena，HttpRequest 中的 method/path/header
+ * 均为指向 arena 的 string_view。arena 由 HttpContext 持有，生命周期与连接一致，
+ * reset() 只回拨游标、保留内存块，因此稳态下解析一个请求不触发任何堆分配。
+ *
+ * 已分配的内存在 reset() 之前地址稳定（按块分配，不做 realloc）。
+ */
+class HttpArena
+{
+public:
+    static constexpr size_t kDefaultBlockSize = 4096;
+    static constexpr size_t kMaxRetainedBlockSize = 64 * 1024;  // reset 后保留的单块上限
+
+    explicit HttpArena(size_t blockSize = kDefaultBlockSize) : blockSize_(blockSize) {}
+
+    // arena 中的 view 不能跨连接拷贝，HttpContext 被复制时（boost::any 存储）只复制配置
+    HttpArena(const HttpArena& that) : blockSize_(that.blockSize_) {}
+    HttpArena& operator=(const HttpArena& that)
+    {
+        if (this != &that)
+        {
+            blocks_.clear();
+            current_ = 0;
+            used_ = 0;
+            totalUsed_ = 0;
+            blockSize_ = that.blockSize_;
+        }
+        return *this;
+    }
+    HttpArena(HttpArena&&) noexcept = default;
+    HttpArena& operator=(HttpArena&&) noexcept = default;
+
+    // 分配 n 字节，返回地址在下一次 reset() 之前保持有效。
+    // 参数：
+    // - n：申请的字节数。
+    // 返回值：可写内存的起始指针。
+    char* allocate(size_t n)
+    {
+        while (current_ < blocks_.size() && blocks_[current_].size - used_ < n)
+        {
+            ++current_;
+            used_ = 0;
+        }
+        if (current_ == blocks_.size())
+        {
+            size_t size = n > blockSize_ ? n : blockSize_;
+            blocks_.push_back(Block{std::unique_ptr<char[]>(new char[size]), size});
+            used_ = 0;
+        }
+        char* p = blocks_[current_].data.get() + used_;
+        used_ += n;
+        totalUsed_ += n;
+        return p;
+    }
+
+    // 将 [data, data + n) 拷贝进 arena 并返回指向副本的 view。
+    std::string_view copy(const char* data, size_t n)
+    {
+        if (n == 0)
+        {
+            return std::string_view();
+        }
+        char* p = allocate(n);
+        std::memcpy(p, data, n);
+        return std::string_view(p, n);
+    }
+
+    // 回拨游标，使之前返回的所有 view 失效。
+    // 若上一个请求用到了多个块，则合并为一块（不超过 kMaxRetainedBlockSize），
+    // 让同一连接后续相似大小的请求落在单块内。
+    void reset()
+    {
+        if (blocks_.size() > 1)
+        {
+            size_t want = totalUsed_ < kMaxRetainedBlockSize ? totalUsed_ : kMaxRetainedBlockSize;
+            if (want < blockSize_)
+            {
+                want = blockSize_;
+            }
+            blocks_.clear();
+            blocks_.push_back(Block{std::unique_ptr<char[]>(new char[want]), want});
+        }
+        else if (!blocks_.empty() && blocks_[0].size > kMaxRetainedBlockSize)
+        {
+            blocks_.clear();  // 超大请求头用过的块不保留
+        }
+        current_ = 0;
+        used_ = 0;
+        totalUsed_ = 0;
+    }
+
+    // 当前请求已占用的字节数（用于请求头大小统计）。
+    size_t bytesUsed() const
+    {
+        return totalUsed_;
+    }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    size_t current_{0};    // 当前写入块下标
+    size_t used_{0};       // 当前块已用字节
+    size_t totalUsed_{0};  // 本轮请求累计字节
+    size_t blockSize_;
+};
+
+}  // namespace http
@@ -1,9 +1,20 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
 #include <muduo/net/TcpServer.h>
+#include <string>
 
+#include "ConnectionLimits.h"
+#include "HttpArena.h"
 #include "HttpRequest.h"
+#include "HttpResponse.h"
+#include "TimingWheel.h"
+
+namespace ssl
+{
+class SslConnection;
+}
 
 namespace http
 {
@@ -15,11 +26,39 @@ public:
     {
         kExpectRequestLine,  // 解析请求行
         kExpectHeaders,      // 解析请求头
-        kExpectBody,         // 解析请求体
+        kExpectBody,         // 解析请求体（Content-Length）
+        kExpectChunkSize,    // 解析 chunk 长度行（Transfer-Encoding: chunked）
+        kExpectChunkData,    // 读取 chunk 数据
+        kExpectChunkCRLF,    // chunk 数据后的 CRLF
+        kExpectTrailers,     // 末尾 0 长度 chunk 之后的 trailer 区
         kGotAll,             // 解析完成
     };
 
-    HttpContext() : state_(kExpectRequestLine) {}
+    // 解析失败的原因，决定 HttpServer 回复的状态码
+    enum ParseError
+    {
+        kNoError,
+        kBadRequest,          // 400：语法错误
+        kRequestLineTooLong,  // 414
+        kHeaderTooLarge,      // 431：请求头总字节超限
+        kTooManyHeaders,      // 431：请求头字段数超限
+        kBodyTooLarge,        // 413
+    };
+
+    // 连接当前所处的计时阶段，由 HttpServer 的时间轮检查
+    enum TimeoutPhase
+    {
+        kPhaseNone,       // 不计时（异步响应或文件响应体发送中）
+        kPhaseHeader,     // 等待请求行与请求头
+        kPhaseBody,       // 读取请求体
+        kPhaseKeepAlive,  // 响应已发完，等待下一个请求
+    };
+
+    // limits 为空时使用默认上限；指针需在连接存活期间有效（通常指向 HttpServer 的成员）
+    explicit HttpContext(const ConnectionLimits* limits = nullptr)
+        : state_(kExpectRequestLine), limits_(limits ? limits : &kDefaultLimits)
+    {
+    }
 
     // 从缓冲区解析 HTTP 请求数据，并更新内部请求状态。
     // 参数：
@@ -28,6 +67,24 @@ public:
     // 返回值：解析成功或需要更多数据时返回 true；检测到语法错误时返回 false。
     bool parseRequest(muduo::net::Buffer* buf, muduo::Timestamp receiveTime);
 
+    // 最近一次 parseRequest 返回 false 的原因。
+    ParseError error() const
+    {
+        return error_;
+    }
+
+    // 是否已收到当前请求的部分数据（请求行、请求头或请求体）。
+    bool inProgress() const
+    {
+        return state_ != kExpectRequestLine;
+    }
+
+    // 是否正在读取请求体（Content-Length 或 chunked）。
+    bool readingBody() const
+    {
+        return state_ >= kExpectBody && state_ <= kExpectTrailers;
+    }
+
     // 判断请求是否已完整解析。
     // 返回值：解析完成返回 true，否则返回 false。
     bool gotAll() const
@@ -36,11 +93,17 @@ public:
     }
 
     // 重置解析状态并清空当前请求数据。
+    // 请求与 arena 均保留容量，keep-alive 连接上的后续请求不再重复分配。
+    // 注意：reset 之后上一个请求中的 string_view 全部失效。
     void reset()
     {
         state_ = kExpectRequestLine;
-        HttpRequest dummyData;
-        request_.swap(dummyData);
+        request_.clear();
+        arena_.reset();
+        body_.clear();
+        chunkRemaining_ = 0;
+        headerBytes_ = 0;
+        error_ = kNoError;
     }
 
     // 获取已解析的请求（只读）。
@@ -57,7 +120,108 @@ public:
         return request_;
     }
 
+    // 标记连接上是否有尚未发完的响应（文件响应体，或尚未完成的 deferred 响应）。
+    // 标记期间不再解析后续流水线请求，以免其响应插到未发完的响应体中间；不受 reset 影响。
+    void setResponsePending(bool on)
+    {
+        responsePending_ = on;
+    }
+    bool responsePending() const
+    {
+        return responsePending_;
+    }
+
+    // 响应未发完期间输入积压超限、已暂停读取连接；由 HttpServer 在恢复处理时重新开始读取。
+    void setReadPaused(bool on)
+    {
+        readPaused_ = on;
+    }
+    bool readPaused() const
+    {
+        return readPaused_;
+    }
+
+    // 等待 ResponseWriter::complete() 填写的 deferred 响应；由 HttpServer 在 IO 线程中存取，不受 reset 影响。
+    void setDeferredResponse(std::shared_ptr<HttpResponse> response)
+    {
+        deferredResponse_ = std::move(response);
+    }
+    std::shared_ptr<HttpResponse> takeDeferredResponse()
+    {
+        return std::move(deferredResponse_);
+    }
+
+    // 连接的 socket fd 缓存（供 sendfile 使用）。
+    // 返回值：尚未查找时为 kSocketFdUnknown，查找失败时为 -1。
+    static constexpr int kSocketFdUnknown = -2;
+    int socketFd() const
+    {
+        return socketFd_;
+    }
+    void setSocketFd(int fd)
+    {
+        socketFd_ = fd;
+    }
+
+    // 计时阶段：切换阶段时递增令牌，时间轮上旧阶段的登记随之失效。
+    // since 为阶段开始（请求头）或最近一次收到数据（请求体、keep-alive）的时间，单位秒。
+    TimeoutPhase timeoutPhase() const
+    {
+        return timeoutPhase_;
+    }
+    uint64_t timerToken() const
+    {
+        return timerToken_;
+    }
+    int64_t phaseSince() const
+    {
+        return phaseSince_;
+    }
+    uint64_t enterPhase(TimeoutPhase phase, int64_t nowSec)
+    {
+        timeoutPhase_ = phase;
+        phaseSince_ = nowSec;
+        return ++timerToken_;
+    }
+    void touch(int64_t nowSec)
+    {
+        if (timeoutPhase_ != kPhaseHeader)
+        {
+            phaseSince_ = nowSec;
+        }
+    }
+
+    // 连接所属 IO 线程的时间轮；未启用时为空。
+    TimingWheel<muduo::net::TcpConnection>* timingWheel() const
+    {
+        return timingWheel_;
+    }
+    void setTimingWheel(TimingWheel<muduo::net::TcpConnection>* wheel)
+    {
+        timingWheel_ = wheel;
+    }
+
+    // 连接的 TLS 状态，与解析状态一同挂在 TcpConnection 的 context 上，按连接取用无需查表加锁；
+    // 明文连接为空。SslConnection 持有 TcpConnectionPtr，连接断开时须置空以打破引用环。
+    const std::shared_ptr<ssl::SslConnection>& sslConnection() const
+    {
+        return sslConn_;
+    }
+    void setSslConnection(std::shared_ptr<ssl::SslConnection> sslConn)
+    {
+        sslConn_ = std::move(sslConn);
+    }
+
 private:
+    static const ConnectionLimits kDefaultLimits;
+
+    // 记录解析错误并返回 false，便于在解析分支中直接 return fail(...)。
+    bool fail(ParseError error)
+    {
+        error_ = error;
+        return false;
+    }
+
     // 解析请求行，填充方法、路径、查询参数与协议版本。
     // 参数：
     // - begin：请求行起始指针。
@@ -65,9 +229,35 @@ private:
     // 返回值：请求行有效返回 true，否则返回 false。
     bool processRequestLine(const char* begin, const char* end);
 
+    // 请求头结束（空行）后根据方法与 Content-Length 决定下一状态。
+    // 返回值：头部语义合法返回 true，否则返回 false。
+    bool onHeadersComplete();
+
+    // 增量解码 chunked 请求体，可跨多次 parseRequest 调用。
+    // 参数：
+    // - buf：接收缓冲区。
+    // - hasMore：输出，是否仍可在本次调用中继续推进状态机。
+    // 返回值：格式合法返回 true，否则返回 false。
+    bool parseChunked(muduo::net::Buffer* buf, bool* hasMore);
+
 private:
     HttpRequestParseState state_;
     HttpRequest request_;
+    HttpArena arena_;   // 请求行与请求头的存储，request_ 中的 view 指向这里
+    std::string body_;  // 正在接收的请求体，完整后移动进 request_
+    uint64_t chunkRemaining_{0};  // 当前 chunk 尚未读取的字节数
+    size_t headerBytes_{0};       // 已接收的请求头字节数（含 CRLF）
+    ParseError error_{kNoError};
+    const ConnectionLimits* limits_;
+    bool responsePending_{false};     // 文件响应体发送中或 deferred 响应未完成
+    bool readPaused_{false};          // 因积压暂停了读取（stopRead）
+    std::shared_ptr<HttpResponse> deferredResponse_;  // 等待 complete() 的 deferred 响应（shared_ptr 使 context 可复制）
+    int socketFd_{kSocketFdUnknown};  // 按需查找的 socket fd
+    TimeoutPhase timeoutPhase_{kPhaseNone};
+    uint64_t timerToken_{0};
+    int64_t phaseSince_{0};
+    TimingWheel<muduo::net::TcpConnection>* timingWheel_{nullptr};
+    std::shared_ptr<ssl::SslConnection> sslConn_;
 };
 
 }  // namespace http
\ No newline at end of file
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <muduo/net/Buffer.h>
+
+namespace http
+{
+
+// ---------------------------------------------------------------------------
+// 状态行
+// ---------------------------------------------------------------------------
+
+struct StatusLineEntry
+{
+    int code;
+    std::string_view suffix;  ///< 版本号之后的部分，例如 " 200 OK\r\n"
+};
+
+// 登记的状态行；序列化时按状态码直接索引，不再 snprintf
+inline constexpr StatusLineEntry kStatusLines[] = {
+    {100, " 100 Continue\r\n"},
+    {101, " 101 Switching Protocols\r\n"},
+    {200, " 200 OK\r\n"},
+    {201, " 201 Created\r\n"},
+    {202, " 202 Accepted\r\n"},
+    {204, " 204 No Content\r\n"},
+    {206, " 206 Partial Content\r\n"},
+    {301, " 301 Moved Permanently\r\n"},
+    {302, " 302 Found\r\n"},
+    {303, " 303 See Other\r\n"},
+    {304, " 304 Not Modified\r\n"},
+    {307, " 307 Temporary Redirect\r\n"},
+    {308, " 308 Permanent Redirect\r\n"},
+    {400, " 400 Bad Request\r\n"},
+    {401, " 401 Unauthorized\r\n"},
+    {403, " 403 Forbidden\r\n"},
+    {404, " 404 Not Found\r\n"},
+    {405, " 405 Method Not Allowed\r\n"},
+    {408, " 408 Request Timeout\r\n"},
+    {409, " 409 Conflict\r\n"},
+    {411, " 411 Length Required\r\n"},
+    {413, " 413 Content Too Large\r\n"},
+    {414, " 414 URI Too Long\r\n"},
+    {415, " 415 Unsupported Media Type\r\n"},
+    {416, " 416 Range Not Satisfiable\r\n"},
+    {429, " 429 Too Many Requests\r\n"},
+    {431, " 431 Request Header Fields Too Large\r\n"},
+    {500, " 500 Internal Server Error\r\n"},
+    {501, " 501 Not Implemented\r\n"},
+    {502, " 502 Bad Gateway\r\n"},
+    {503, " 503 Service Unavailable\r\n"},
+    {504, " 504 Gateway Timeout\r\n"},
+};
+
+namespace detail
+{
+
+constexpr std::array<std::string_view, 500> makeStatusTable()
+{
+    std::array<std::string_view, 500> table{};
+    for (const auto& entry : kStatusLines)
+    {
+        table[static_cast<size_t>(entry.code - 100)] = entry.suffix;
+    }
+    return table;
+}
+
+inline constexpr std::array<std::string_view, 500> kStatusTable = makeStatusTable();
+
+}  // namespace detail
+
+// 状态行后半段（" 200 OK\r\n"）；未登记的状态码返回空。
+constexpr std::string_view statusLineSuffix(int code)
+{
+    return (code >= 100 && code < 600) ? detail::kStatusTable[static_cast<size_t>(code - 100)] : std::string_view();
+}
+
+// 标准原因短语（"OK"）；未登记的状态码返回空。
+constexpr std::string_view reasonPhrase(int code)
+{
+    std::string_view suffix = statusLineSuffix(code);
+    return suffix.empty() ? suffix : suffix.substr(5, suffix.size() - 7);
+}
+
+// ---------------------------------------------------------------------------
+// 预编码的常用响应头（整行，含 \r\n）
+// ---------------------------------------------------------------------------
+
+namespace headers
+{
+
+inline constexpr std::string_view kConnectionClose = "Connection: close\r\n";
+inline constexpr std::string_view kConnectionKeepAlive = "Connection: Keep-Alive\r\n";
+
+struct ContentTypeLine
+{
+    std::string_view type;
+    std::string_view line;
+};
+
+inline constexpr ContentTypeLine kContentTypes[] = {
+    {"application/json", "Content-Type: application/json\r\n"},
+    {"application/json; charset=utf-8", "Content-Type: application/json; charset=utf-8\r\n"},
+    {"text/html", "Content-Type: text/html\r\n"},
+    {"text/html; charset=utf-8", "Content-Type: text/html; charset=utf-8\r\n"},
+    {"text/plain", "Content-Type: text/plain\r\n"},
+    {"text/plain; charset=utf-8", "Content-Type: text/plain; charset=utf-8\r\n"},
+    {"text/plain; version=0.0.4; charset=utf-8", "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"},
+    {"text/css", "Content-Type: text/css\r\n"},
+    {"application/javascript", "Content-Type: application/javascript\r\n"},
+    {"text/event-stream", "Content-Type: text/event-stream\r\n"},
+    {"image/png", "Content-Type: image/png\r\n"},
+    {"image/jpeg", "Content-Type: image/jpeg\r\n"},
+    {"audio/mpeg", "Content-Type: audio/mpeg\r\n"},
+    {"application/octet-stream", "Content-Type: application/octet-stream\r\n"},
+};
+
+// 常见 Content-Type 的整行编码；不在表中时返回空，由调用方按普通头部处理。
+constexpr std::string_view contentTypeLine(std::string_view type)
+{
+    for (const auto& entry : kContentTypes)
+    {
+        if (entry.type == type)
+        {
+            return entry.line;
+        }
+    }
+    return std::string_view();
+}
+
+}  // namespace headers
+
+// ---------------------------------------------------------------------------
+// 响应头容器
+// ---------------------------------------------------------------------------
+
+// 动态响应头：各字段按 "name: value\r\n" 依次编码在同一块缓冲区中，序列化时整块追加；
+// 前 kInlineCapacity 个字段的位置内联记录，不为每个字段构造 std::string。
+// 字段名大小写不敏感，set() 同名覆盖；序列化保持插入顺序。
+class ResponseHeaders
+{
+public:
+    struct Field
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    static constexpr size_t kInlineCapacity = 8;
+
+    // 设置字段，同名（忽略大小写）时覆盖原值。
+    void set(std::string_view name, std::string_view value);
+
+    // 删除字段。
+    // 返回值：存在并已删除时为 true。
+    bool erase(std::string_view name);
+
+    // 查找字段值；视图在下一次修改前有效。
+    // 返回值：不存在时为空。
+    std::optional<std::string_view> find(std::string_view name) const;
+
+    size_t size() const
+    {
+        return inlineSize_ + overflow_.size();
+    }
+    bool empty() const
+    {
+        return size() == 0;
+    }
+    Field operator[](size_t i) const;
+
+    // 序列化后的字节数（"name: value\r\n" 之和）。
+    size_t encodedSize() const
+    {
+        return encoded_.size();
+    }
+
+    // 把已编码的全部字段追加到缓冲区。
+    void appendTo(muduo::net::Buffer* buf) const
+    {
+        buf->append(encoded_.data(), encoded_.size());
+    }
+
+private:
+    // 字段在 encoded_ 中的位置：name 起于 offset，value 起于 offset + nameLen + 2
+    struct Slot
+    {
+        uint32_t offset;
+        uint32_t nameLen;
+        uint32_t valueLen;
+    };
+
+    Slot& slot(size_t i)
+    {
+        return i < inlineSize_ ? inline_[i] : overflow_[i - inlineSize_];
+    }
+    const Slot& slot(size_t i) const
+    {
+        return i < inlineSize_ ? inline_[i] : overflow_[i - inlineSize_];
+    }
+    // 返回字段下标，不存在时为 size()
+    size_t indexOf(std::string_view name) const;
+
+    std::array<Slot, kInlineCapacity> inline_;
+    size_t inlineSize_ = 0;
+    std::vector<Slot> overflow_;
+    std::string encoded_;
+};
+
+// 可复用的响应头模板：构造一次、编码一次，之后每个响应只拷贝一个 shared_ptr。
+// 适合 Handler 在构造时登记固定不变的头部（Cache-Control、X-Robots-Tag 等）。
+class HeaderTemplate
+{
+public:
+    HeaderTemplate() = default;
+    HeaderTemplate(std::initializer_list<std::pair<std::string_view, std::string_view>> fields);
+
+    // 追加一个字段（模板内不去重）。
+    HeaderTemplate& add(std::string_view name, std::string_view value);
+
+    // 已编码的头部块，每行以 "\r\n" 结尾；空模板返回 nullptr。
+    const std::shared_ptr<const std::string>& block() const
+    {
+        return block_;
+    }
+
+private:
+    std::shared_ptr<const std::string> block_;
+};
+
+}  // namespace http
@@ -1,16 +1,33 @@
 #pragma once
 
-#include <map>
 #include <muduo/base/Timestamp.h>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace http
 {
 
+// 请求头字段。name/value 指向连接 arena（见 HttpArena），仅在本次请求处理期间有效。
+struct HttpHeaderField
+{
+    std::string_view name;
+    std::string_view value;
+};
+
+// 忽略大小写比较头字段名（RFC 7230: field-name 大小写不敏感）。
+bool headerNameEquals(std::string_view a, std::string_view b);
+
+// 解析后的 HttpRequest 不拥有请求行与请求头的内存：method/path/query/header 均为指向
+// HttpContext 内 arena 的 string_view，HttpContext::reset() 后失效。需要跨越请求生命周期
+// （如投递到线程池）的数据必须显式拷贝为 std::string。请求体由 HttpContext 移动进来，归请求所有。
 class HttpRequest
 {
 public:
+    using HeaderList = std::vector<HttpHeaderField>;
+
     enum Method
     {
         kInvalid,
@@ -24,6 +41,9 @@ public:
 
     HttpRequest() : method_(kInvalid), version_("Unknown") {}
 
+    // 清空请求数据但保留各容器容量，供同一连接解析下一个请求复用。
+    void clear();
+
     // 设置请求的接收时间。
     // 参数：
     // - t：请求数据接收时间。
@@ -50,7 +70,7 @@ public:
         return method_;
     }
 
-    // 设置请求路径。
+    // 设置请求路径（只记录 view，调用方保证 [start, end) 在请求处理期间有效）。
     // 参数：
     // - start：路径字符串起始指针。
     // - end：路径字符串结束指针。
@@ -59,6 +79,13 @@ public:
     // 获取请求路径。
     // 返回值：请求路径字符串。
     std::string path() const
+    {
+        return std::string(path_);
+    }
+
+    // 获取请求路径（零拷贝）。
+    // 返回值：指向 arena 的路径视图。
+    std::string_view pathView() const
     {
         return path_;
     }
@@ -69,18 +96,33 @@ public:
     // - value：参数值。
     void setPathParameters(const std::string& key, const std::string& value);
 
+    // 记录路由匹配出的路径参数（不拷贝）。name 指向路由表，value 指向请求路径。
+    // 参数：
+    // - name：参数名（模式中 ":name" / "*name" 的 name）。
+    // - value：参数值。
+    void addPathParameter(std::string_view name, std::string_view value)
+    {
+        pathParams_.push_back(HttpHeaderField{name, value});
+    }
+
     // 获取路径参数值。
     // 参数：
-    // - key：参数名。
+    // - key：参数名；兼容旧接口，"param1"、"param2"… 按出现顺序取值。
     // 返回值：参数值，不存在时返回空字符串。
     std::string getPathParameters(const std::string& key) const;
 
-    // 解析并设置查询参数。
+    // 设置查询字符串（只记录 view，按需在 getQueryParameters 中扫描，不预先建表）。
     // 参数：
     // - start：查询字符串起始指针。
     // - end：查询字符串结束指针。
     void setQueryParameters(const char* start, const char* end);
 
+    // 获取原始查询字符串（不含 '?'）。
+    std::string_view query() const
+    {
+        return query_;
+    }
+
     // 获取查询参数值。
     // 参数：
     // - key：参数名。
@@ -92,7 +134,7 @@ public:
     // - v：协议版本字符串。
     void setVersion(std::string v)
     {
-        version_ = v;
+        version_ = std::move(v);
     }
 
     // 获取请求协议版本。
@@ -102,29 +144,60 @@ public:
         return version_;
     }
 
-    // 添加请求头字段。
+    // 添加请求头字段（去除值两端空白后记录 view，不拷贝）。
     // 参数：
     // - start：头字段名起始指针。
     // - colon：分隔冒号位置指针。
     // - end：头字段值结束指针。
     void addHeader(const char* start, const char* colon, const char* end);
 
-    // 获取指定头字段值。
+    // 获取指定头字段值，字段名大小写不敏感；重复字段取最后一个。
     // 参数：
     // - field：头字段名。
     // 返回值：字段值，不存在时返回空字符串。
-    std::string getHeader(const std::string& field) const;
+    std::string getHeader(const std::string& field) const
+    {
+        return std::string(headerView(field));
+    }
 
-    // 获取所有请求头字段。
-    // 返回值：请求头映射表的常量引用。
-    const std::map<std::string, std::string>& headers() const
+    // 获取指定头字段值（零拷贝）。
+    // 中间件通过 addHeader(key, value) 注入的字段优先于客户端发送的同名字段。
+    // 参数：
+    // - field：头字段名（大小写不敏感）。
+    // 返回值：字段值视图，不存在时为空。
+    std::string_view headerView(std::string_view field) const;
+
+    // 获取解析得到的所有请求头字段（按到达顺序）。
+    // 返回值：请求头列表的常量引用。
+    const HeaderList& headers() const
     {
         return headers_;
     }
 
-    void addHeader(const std::string& key, const std::string& value)
+    // 添加服务端注入的请求头（如 X-Request-Id），自行持有内存，覆盖同名字段。
+    void addHeader(const std::string& key, const std::string& value);
+
+    // 记录已验证的身份（由 AuthMiddleware 写入）。
+    // 与请求头分开存放，客户端无法通过伪造请求头冒充；Handler 直接读取，无需再次校验 JWT。
+    // 参数：
+    // - userId：用户 ID。
+    // - role：用户角色。
+    void setAuth(long long userId, std::string role)
+    {
+        authUserId_ = userId;
+        authRole_ = std::move(role);
+    }
+
+    // 已验证的用户 ID，未认证时为 0。
+    long long authUserId() const
     {
-        headers_[key] = value;
+        return authUserId_;
+    }
+
+    // 已验证的用户角色，未认证时为空。
+    const std::string& authRole() const
+    {
+        return authRole_;
     }
 
     // 设置请求体内容。
@@ -135,6 +208,14 @@ public:
         content_ = body;
     }
 
+    // 设置请求体内容（移动，不拷贝）。
+    // 参数：
+    // - body：请求体字符串。
+    void setBody(std::string&& body)
+    {
+        content_ = std::move(body);
+    }
+
     // 设置请求体内容。
     // 参数：
     // - start：请求体起始指针。
@@ -148,8 +229,8 @@ public:
     }
 
     // 获取请求体内容。
-    // 返回值：请求体字符串。
-    std::string getBody() const
+    // 返回值：请求体字符串的常量引用。
+    const std::string& getBody() const
     {
         return content_;
     }
@@ -175,15 +256,19 @@ public:
     void swap(HttpRequest& that);
 
 private:
-    Method method_;                                                 // 请求方法
-    std::string version_;                                           // http版本
-    std::string path_;                                              // 请求路径
-    std::unordered_map<std::string, std::string> pathParameters_;   // 路径参数
-    std::unordered_map<std::string, std::string> queryParameters_;  // 查询参数
-    muduo::Timestamp receiveTime_;                                  // 接收时间
-    std::map<std::string, std::string> headers_;                    // 请求头
-    std::string content_;                                           // 请求体
-    uint64_t contentLength_{0};                                     // 请求体长度
+    Method method_;                                                // 请求方法
+    std::string version_;                                          // http版本
+    std::string_view path_;                                        // 请求路径（arena）
+    std::string_view query_;                                       // 查询字符串（arena）
+    std::unordered_map<std::string, std::string> pathParameters_;  // 路径参数（setPathParameters 写入）
+    std::vector<HttpHeaderField> pathParams_;                      // 路由匹配出的路径参数（view）
+    muduo::Timestamp receiveTime_;                                 // 接收时间
+    HeaderList headers_;                                           // 请求头（arena）
+    std::vector<std::pair<std::string, std::string>> extraHeaders_;  // 中间件注入的请求头
+    std::string content_;                                          // 请求体
+    uint64_t contentLength_{0};                                    // 请求体长度
+    long long authUserId_{0};                                      // 已验证的用户 ID
+    std::string authRole_;                                         // 已验证的用户角色
 };
 
 }  // namespace http
\ No newline at end of file
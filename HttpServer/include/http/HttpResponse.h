@@ -2,6 +2,15 @@
 
 #include <muduo/net/TcpServer.h>
 
+#include <array>
+#include <optional>
+#include <string_view>
+
+#include "http/Compression.h"
+#include "http/FileBody.h"
+#include "http/HttpHeaders.h"
+#include "http/ResponseWriter.h"
+
 namespace http
 {
 
@@ -19,14 +28,18 @@ public:
         k200Ok = 200,
         k202Accepted = 202,
         k204NoContent = 204,
+        k206PartialContent = 206,
         k301MovedPermanently = 301,
+        k304NotModified = 304,
         k400BadRequest = 400,
         k401Unauthorized = 401,
         k429TooManyRequests = 429,
         k403Forbidden = 403,
         k404NotFound = 404,
         k409Conflict = 409,
+        k416RangeNotSatisfiable = 416,
         k500InternalServerError = 500,
+        k503ServiceUnavailable = 503,
     };
 
     HttpResponse(bool close = true) : statusCode_(kUnknown), closeConnection_(close), deferred_(false) {}
@@ -38,7 +51,7 @@ public:
      *
      * 当 Handler 需要在独立线程中处理耗时任务（如 AI API 调用）时，
      * 设置 deferred=true，HttpServer::onRequest 将跳过自动发送。
-     * Handler 自行通过 getConnection()->send() 发送响应。
+     * Handler 自行通过 getWriter().send() 发送响应。
      */
     void setDeferred(bool on)
     {
@@ -49,6 +62,21 @@ public:
         return deferred_;
     }
 
+    /**
+     * @brief 记录/读取本请求协商出的内容编码
+     *
+     * 由 CompressionMiddleware::before() 按 Accept-Encoding 写入，after() 据此压缩响应体；
+     * 未经协商的响应保持 kIdentity。
+     */
+    void setAcceptedEncoding(ContentEncoding encoding)
+    {
+        acceptedEncoding_ = encoding;
+    }
+    ContentEncoding acceptedEncoding() const
+    {
+        return acceptedEncoding_;
+    }
+
     /**
      * @brief 注入/获取底层 TCP 连接
      *
@@ -64,6 +92,21 @@ public:
         return conn_;
     }
 
+    /**
+     * @brief 注入/获取异步响应的写出端
+     *
+     * 与 getConnection() 指向同一连接，但 HTTPS 连接上会经 TLS 加密后写出，
+     * 且可在任意线程调用。deferred Handler 应通过它回写，不要直接 conn->send()。
+     */
+    void setWriter(ResponseWriter writer)
+    {
+        writer_ = std::move(writer);
+    }
+    const ResponseWriter& getWriter() const
+    {
+        return writer_;
+    }
+
     /**
      * 设置HTTP协议版本
      * @param version 例如"HTTP/1.1"
@@ -124,33 +167,60 @@ public:
 
     /**
      * 设置Content-Type响应头
-     * @param contentType MIME类型字符串
+     * @param contentType MIME类型字符串；常见类型直接引用预编码的整行
      * @return 无返回值
      */
-    void setContentType(const std::string& contentType)
-    {
-        addHeader("Content-Type", contentType);
-    }
+    void setContentType(std::string_view contentType);
+
+    /**
+     * 获取Content-Type
+     * @return 未设置时为空
+     */
+    std::string_view getContentType() const;
 
     /**
-     * 设置Content-Length响应头
+     * 设置Content-Length响应头（序列化时直接格式化整数，不经过 std::to_string）
      * @param length 响应体字节长度
      * @return 无返回值
      */
     void setContentLength(uint64_t length)
     {
-        addHeader("Content-Length", std::to_string(length));
+        contentLength_ = static_cast<int64_t>(length);
     }
 
     /**
-     * 添加或覆盖任意响应头
+     * 添加或覆盖任意响应头（字段名大小写不敏感）
      * @param key 头部字段名
      * @param value 头部字段值
      * @return 无返回值
      */
-    void addHeader(const std::string& key, const std::string& value)
+    void addHeader(std::string_view key, std::string_view value);
+
+    /**
+     * 查找 addHeader 设置的响应头（不含预编码头部与头部块）
+     * @param key 头部字段名，大小写不敏感
+     * @return 未设置时为空；视图在下一次修改响应头前有效
+     */
+    std::optional<std::string_view> findHeader(std::string_view key) const
+    {
+        return headers_.find(key);
+    }
+
+    /**
+     * 追加预编码的响应头行，序列化时原样写出，不做同名覆盖
+     * @param lines 每行以 "\r\n" 结尾的头部文本；必须在响应发送前保持有效（常量或长生命周期对象的成员）
+     * @return 无返回值
+     */
+    void addRawHeaders(std::string_view lines);
+
+    /**
+     * 套用预先登记的响应头模板（与 setHeaderBlock 共用同一槽位，后设置者生效）
+     * @param tmpl 响应头模板
+     * @return 无返回值
+     */
+    void setHeaderTemplate(const HeaderTemplate& tmpl)
     {
-        headers_[key] = value;
+        headerBlock_ = tmpl.block();
     }
 
     /**
@@ -161,8 +231,70 @@ public:
     void setBody(const std::string& body)
     {
         body_ = body;
+        sharedBody_.reset();
         // body_ += "\0";
     }
+    void setBody(std::string&& body)
+    {
+        body_ = std::move(body);
+        sharedBody_.reset();
+    }
+
+    /**
+     * 获取响应体（共享响应体优先）
+     * @return 响应体内容；文件响应体不在此列
+     */
+    const std::string& getBody() const
+    {
+        return sharedBody_ ? *sharedBody_ : body_;
+    }
+
+    /**
+     * 是否为共享的只读响应体（如静态资源缓存，可能已是预压缩变体）
+     */
+    bool hasSharedBody() const
+    {
+        return sharedBody_ != nullptr;
+    }
+
+    /**
+     * 设置共享的只读响应体（如静态资源缓存），序列化时直接引用，不复制进 body_
+     * @param body 响应体；设置后优先于 setBody 的内容
+     * @return 无返回值
+     */
+    void setSharedBody(std::shared_ptr<const std::string> body)
+    {
+        sharedBody_ = std::move(body);
+    }
+
+    /**
+     * 设置文件响应体：appendToBuffer 只序列化头部，区间内容由 HttpServer 经 FileSender 分段发送
+     * @param body 已设定区间的文件；Content-Length 需由调用方按区间长度设置
+     * @return 无返回值
+     */
+    void setFileBody(std::shared_ptr<const FileBody> body)
+    {
+        fileBody_ = std::move(body);
+    }
+
+    /**
+     * 获取文件响应体
+     * @return 未设置时为空
+     */
+    const std::shared_ptr<const FileBody>& fileBody() const
+    {
+        return fileBody_;
+    }
+
+    /**
+     * 设置预先拼好的响应头块，序列化时原样追加在 addHeader 设置的头部之后
+     * @param block 每行以 "\r\n" 结尾的头部文本，例如 "ETag: \"x\"\r\nVary: Accept-Encoding\r\n"
+     * @return 无返回值
+     */
+    void setHeaderBlock(std::shared_ptr<const std::string> block)
+    {
+        headerBlock_ = std::move(block);
+    }
 
     /**
      * 设置状态行信息
@@ -187,15 +319,27 @@ public:
     void appendToBuffer(muduo::net::Buffer* outputBuf) const;
 
 private:
-    std::string httpVersion_;                     ///< HTTP协议版本
-    HttpStatusCode statusCode_;                   ///< 响应状态码
-    std::string statusMessage_;                   ///< 状态短语
-    bool closeConnection_;                        ///< 连接关闭标记
-    std::map<std::string, std::string> headers_;  ///< 响应头集合
-    std::string body_;                            ///< 响应体内容
-    bool isFile_;                                 ///< 标识响应是否为文件类型
-    bool deferred_;                               ///< 延迟发送标记（异步模式）
-    muduo::net::TcpConnectionPtr conn_;           ///< 异步模式下持有的连接
+    static constexpr size_t kMaxRawHeaders = 4;
+
+    std::string httpVersion_;                          ///< HTTP协议版本
+    HttpStatusCode statusCode_;                        ///< 响应状态码
+    std::string statusMessage_;                        ///< 状态短语
+    bool closeConnection_;                             ///< 连接关闭标记
+    std::string_view contentTypeLine_;                 ///< 预编码的 Content-Type 整行（常见类型）
+    int64_t contentLength_ = -1;                       ///< Content-Length，-1 表示未设置
+    ResponseHeaders headers_;                          ///< 动态响应头（整块编码）
+    std::array<std::string_view, kMaxRawHeaders> rawHeaders_;  ///< 预编码响应头行
+    size_t rawHeaderCount_ = 0;                        ///< rawHeaders_ 已用数量
+    std::string rawOverflow_;                          ///< rawHeaders_ 满后追加的预编码行副本
+    std::string body_;                                 ///< 响应体内容
+    std::shared_ptr<const std::string> sharedBody_;    ///< 共享只读响应体（优先于 body_）
+    std::shared_ptr<const std::string> headerBlock_;   ///< 预拼好的响应头块 / 响应头模板
+    std::shared_ptr<const FileBody> fileBody_;         ///< 文件响应体（不进输出缓冲区）
+    bool isFile_;                                      ///< 标识响应是否为文件类型
+    bool deferred_;                                    ///< 延迟发送标记（异步模式）
+    ContentEncoding acceptedEncoding_ = ContentEncoding::kIdentity;  ///< 协商出的内容编码
+    muduo::net::TcpConnectionPtr conn_;                ///< 异步模式下持有的连接
+    ResponseWriter writer_;                            ///< 异步模式下的写出端（自动走 TLS）
 };
 
 }  // namespace http
@@ -26,12 +26,15 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThread.h>
 #include <muduo/net/TcpServer.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <unordered_map>
+#include <vector>
 
 #include "../middleware/MiddlewareChain.h"
 #include "../middleware/SecurityHeadersMiddleware.h"
@@ -40,9 +43,12 @@
 #include "../session/SessionManager.h"
 #include "../ssl/SslConnection.h"
 #include "../ssl/SslContext.h"
+#include "ConnectionLimits.h"
+#include "FileBody.h"
 #include "HttpContext.h"
 #include "HttpRequest.h"
 #include "HttpResponse.h"
+#include "TimingWheel.h"
 
 class HttpRequest;
 class HttpResponse;
@@ -69,13 +75,18 @@ public:
      * @param port 服务器监听端口
      * @param name 服务器名称标识
      * @param useSSL 是否启用SSL加密（默认false）
-     * @param option muduo网络库配置选项
+     * @param option muduo网络库配置选项；多 acceptor 模式要求 kReusePort
      */
     HttpServer(int port,
                const std::string& name,
                bool useSSL = false,
                muduo::net::TcpServer::Option option = muduo::net::TcpServer::kNoReusePort);
 
+    /**
+     * @brief 析构：在各额外 acceptor 的事件循环线程内销毁其 TcpServer，再回收线程与路由快照
+     */
+    ~HttpServer();
+
     /**
      * @brief 设置服务器工作线程数
      *
@@ -86,9 +97,28 @@ public:
      */
     void setThreadNum(int numThreads)
     {
+        threadNum_ = numThreads;
         server_.setThreadNum(numThreads);
     }
 
+    /**
+     * @brief 设置 SO_REUSEPORT 多 acceptor 模式
+     *
+     * num > 1 时 start() 额外启动 num-1 个独立的 TcpServer/EventLoop，与主 acceptor 以 SO_REUSEPORT
+     * 绑定同一端口，由内核在各 acceptor 间分摊新连接；每个 acceptor 持有一份路由快照，
+     * setThreadNum 设置的 IO 线程按 acceptor 平均分配（分到 0 个时由 acceptor 线程自己处理 IO）。
+     * 必须在 start() 之前、所有路由注册完成之后生效；构造时 option 不是 kReusePort 则退回单 acceptor。
+     *
+     * @param num acceptor 数量
+     * @param pinCpu 是否把第 i 个额外 acceptor 线程绑定到第 i 个 CPU（按 CPU 数取模）；
+     *               主 acceptor 运行在调用 start() 的线程上，不绑核，以免与 IO 线程争用同一个核
+     */
+    void setAcceptorNum(int num, bool pinCpu = false)
+    {
+        acceptorNum_ = num;
+        pinAcceptors_ = pinCpu;
+    }
+
     /**
      * @brief 启动HTTP服务器
      *
@@ -225,7 +255,8 @@ public:
      * @brief 添加中间件到处理链
      *
      * 中间件在请求到达路由处理器之前执行预处理，
-     * 在响应返回客户端之前执行后处理。
+     * 在响应返回客户端之前执行后处理。start() 时按 Middleware::appliesTo
+     * 为每条路由挑选作用于它的中间件，因此须在 start() 之前注册。
      *
      * @param middleware 中间件实例
      */
@@ -255,7 +286,54 @@ public:
      */
     void setSslConfig(const ssl::SslConfig& config);
 
+    /**
+     * @brief 设置连接超时与请求大小上限
+     *
+     * 必须在 start() 之前调用；之后建立的连接都按该配置计时与解析。
+     *
+     * @param limits 超时与大小上限
+     */
+    void setConnectionLimits(const ConnectionLimits& limits)
+    {
+        limits_ = limits;
+    }
+
+    /**
+     * @brief 获取各回收规则的累计计数
+     *
+     * @return const ConnectionReapStats& 可在任意线程读取
+     */
+    const ConnectionReapStats& reapStats() const
+    {
+        return reapStats_;
+    }
+
+    /**
+     * @brief 获取 TLS 握手与会话票据计数（会话复用率）
+     *
+     * @return 未启用 SSL 时返回 nullptr；可在任意线程读取
+     */
+    const ssl::SslSessionStats* sslStats() const
+    {
+        return sslCtx_ ? &sslCtx_->stats() : nullptr;
+    }
+
 private:
+    friend class ResponseWriter;  // complete() 调用 completeDeferred
+
+    using ConnectionWheel = TimingWheel<muduo::net::TcpConnection>;
+
+    /// 额外的 SO_REUSEPORT acceptor：独立的事件循环线程、TcpServer 与路由快照。
+    /// 成员按逆序析构：server 先于其线程，路由快照最后（IO 线程经 t_router 使用它）
+    struct Acceptor
+    {
+        std::unique_ptr<router::Router> router;
+        std::unique_ptr<muduo::net::EventLoopThread> thread;
+        std::unique_ptr<muduo::net::TcpServer> server;
+    };
+
+    /// 时间轮格数：一圈 64 秒，更长的超时按圈数计
+    static constexpr size_t kWheelSlots = 64;
     /**
      * @brief 服务器初始化方法
      *
@@ -290,32 +368,132 @@ private:
      *
      * @param conn TCP连接指针
      * @param req HTTP请求对象
+     * @return true 可以继续处理同一缓冲区中流水线的下一个请求；
+     *         false 连接将关闭或响应为 deferred，需停止处理后续请求
+     */
+    bool onRequest(const muduo::net::TcpConnectionPtr&, HttpRequest&);
+
+    /**
+     * @brief 发送一个已填写好的响应：普通响应直接写出，文件响应交给 sendFileResponse
+     *
+     * @return true 可继续处理同一连接上的后续请求；false 连接将关闭或文件响应体发送中
+     */
+    bool sendResponse(const muduo::net::TcpConnectionPtr& conn, HttpContext* context, HttpResponse& response);
+
+    /**
+     * @brief 由 ResponseWriter::complete() 投递到 IO 线程：填写并发出保留的 deferred 响应
+     *
+     * @param conn TCP连接指针
+     * @param fill Handler 提供的填写函数
+     */
+    void completeDeferred(const muduo::net::TcpConnectionPtr& conn, const std::function<void(HttpResponse*)>& fill);
+
+    /**
+     * @brief 暂停期间（文件响应体、deferred 响应）的响应发完后恢复计时，并继续处理缓冲区中排队的请求
      */
-    void onRequest(const muduo::net::TcpConnectionPtr&, const HttpRequest&);
+    void resumeConnection(const muduo::net::TcpConnectionPtr& conn, HttpContext* context);
+
+    /**
+     * @brief 发送带文件响应体的响应
+     *
+     * 写出响应头后由 FileSender 分段发送文件区间（明文 sendfile，SSL 分段加密），
+     * 发送期间暂停解析同一连接上的后续请求，发完后继续处理或按需关闭连接。
+     *
+     * @param conn TCP连接指针
+     * @param response 含 FileBody 的响应
+     * @param header 已序列化的响应头
+     */
+    void sendFileResponse(const muduo::net::TcpConnectionPtr& conn,
+                          const HttpResponse& response,
+                          muduo::net::Buffer* header);
 
     /**
      * @brief 核心请求处理方法
      *
-     * 执行中间件链和路由匹配，分发请求到对应的处理器。
+     * 匹配路由后执行该路由预先挑选的中间件，全部通过再分发到处理器；
+     * 中间件就地修改请求（如注入鉴权头），不复制请求。
      *
-     * @param req HTTP请求对象
+     * @param req HTTP请求对象（连接上下文中的请求）
      * @param resp HTTP响应对象
      */
-    void handleRequest(const HttpRequest& req, HttpResponse* resp);
+    void handleRequest(HttpRequest& req, HttpResponse* resp);
+
+    /**
+     * @brief 为每条已注册路由预先挑选作用于它的中间件，中间件组合相同的路由共享同一条链；
+     *        同时编译未匹配路由的请求使用的兜底链
+     */
+    void compileMiddlewares();
+
+    /**
+     * @brief IO 线程初始化回调：为该线程的 EventLoop 创建时间轮并每秒推进一格
+     *
+     * @param loop IO 线程的事件循环（线程数为 0 时为主循环）
+     */
+    void onThreadInit(muduo::net::EventLoop* loop);
+
+    /**
+     * @brief 额外 acceptor 的 IO 线程初始化回调：在 onThreadInit 之外登记本线程使用的路由快照
+     *
+     * @param loop IO 线程的事件循环
+     * @param router 所属 acceptor 的路由快照
+     */
+    void onAcceptorThreadInit(muduo::net::EventLoop* loop, router::Router* router);
+
+    /**
+     * @brief 启动额外的 SO_REUSEPORT acceptor，并按 acceptor 分配 IO 线程
+     */
+    void startAcceptors();
+
+    /**
+     * @brief 按连接当前的解析状态切换计时阶段
+     *
+     * 阶段未变化时只刷新活动时间，不向时间轮重复登记。
+     *
+     * @param conn TCP连接指针
+     * @param context 连接的解析上下文
+     * @param partialInput 输入缓冲区中是否留有未解析完的数据
+     */
+    void updateTimeout(const muduo::net::TcpConnectionPtr& conn, HttpContext* context, bool partialInput);
+
+    /**
+     * @brief 时间轮到期回调：超时则回收连接并计数，否则返回剩余秒数
+     *
+     * @param conn TCP连接指针
+     * @param token 登记时的计时令牌
+     * @return int 仍需等待的秒数，0 表示不再计时
+     */
+    int onTimeout(const muduo::net::TcpConnectionPtr& conn, uint64_t token);
+
+    /**
+     * @brief 回复错误状态行并关闭连接（SSL 连接经加密发送）
+     *
+     * @param conn TCP连接指针
+     * @param response 完整的错误响应报文
+     */
+    void rejectConnection(const muduo::net::TcpConnectionPtr& conn, std::string_view response);
 
 private:
     muduo::net::InetAddress listenAddr_;                       ///< 服务器监听地址
     muduo::net::TcpServer server_;                             ///< muduo TCP服务器实例
     muduo::net::EventLoop mainLoop_;                           ///< 主事件循环
-    HttpCallback httpCallback_;                                ///< HTTP请求回调函数
+    std::function<void(HttpRequest&, HttpResponse*)> httpCallback_;  ///< HTTP请求回调函数
     router::Router router_;                                    ///< 路由管理器
     std::unique_ptr<session::SessionManager> sessionManager_;  ///< 会话管理器
     middleware::MiddlewareChain middlewareChain_;              ///< 中间件处理链
+    std::shared_ptr<const middleware::MiddlewareChain> fallbackChain_;  ///< 未匹配路由的请求使用的中间件链
     std::unique_ptr<ssl::SslContext> sslCtx_;                  ///< SSL上下文
     bool useSSL_;                                              ///< 是否启用SSL加密
+    muduo::net::TcpServer::Option option_;                     ///< 端口复用选项
+    int threadNum_ = 0;                                        ///< IO 线程总数
+    int acceptorNum_ = 1;                                      ///< acceptor 数量
+    bool pinAcceptors_ = false;                                ///< acceptor 线程是否绑核
+    std::vector<std::unique_ptr<Acceptor>> acceptors_;         ///< 主 acceptor 以外的 acceptor
+    ConnectionLimits limits_;                                  ///< 连接超时与请求大小上限
+    ConnectionReapStats reapStats_;                            ///< 各回收规则的累计计数
 
-    /// SSL连接映射表：TCP连接 -> SSL连接
-    std::map<muduo::net::TcpConnectionPtr, std::unique_ptr<ssl::SslConnection>> sslConns_;
+    /// 每个 IO 线程一个时间轮，仅由所属线程访问；映射本身在线程初始化与建连时加锁
+    std::unordered_map<muduo::net::EventLoop*, std::unique_ptr<ConnectionWheel>> wheels_;
+    std::mutex wheelsMutex_;
 };
 
 }  // namespace http
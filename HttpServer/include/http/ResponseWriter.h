@@ -0,0 +1,79 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/TcpConnection.h>
+#include <string>
+
+namespace ssl
+{
+class SslConnection;
+}
+
+namespace http
+{
+
+class HttpResponse;
+class HttpServer;
+
+/**
+ * @brief 异步响应的写出端
+ *
+ * 由 HttpServer 在分发请求时注入 HttpResponse，deferred Handler（如 SSE 流）通过它回写数据。
+ * 持有连接与其 TLS 状态：HTTPS 连接自动经 SslConnection 加密，明文连接直接写 socket，
+ * Handler 无需区分。所有方法可在任意线程调用，写操作投递到连接所属的 IO 线程执行，
+ * 同一线程先后提交的数据按提交顺序写出。
+ *
+ * 两种用法：流式响应（SSE）用 send() 逐段写出原始报文、以 shutdown() 结束；
+ * 普通响应只是把计算挪到别的线程（如密码哈希），算完调用一次 complete()，连接保持 keep-alive。
+ */
+class ResponseWriter
+{
+public:
+    ResponseWriter() = default;
+    ResponseWriter(muduo::net::TcpConnectionPtr conn,
+                   std::shared_ptr<ssl::SslConnection> sslConn,
+                   HttpServer* server = nullptr)
+        : conn_(std::move(conn)), sslConn_(std::move(sslConn)), server_(server)
+    {
+    }
+
+    explicit operator bool() const
+    {
+        return conn_ != nullptr;
+    }
+
+    // 写出一段数据；连接已断开时丢弃。
+    void send(std::string data) const;
+
+    // 在已提交的数据之后关闭写端。
+    void shutdown() const;
+
+    // 完成普通的 deferred 响应：在 IO 线程中调用 fill 填写 HttpServer 保留的响应对象
+    // （已含中间件 after() 写入的响应头），按同步响应的方式发出，再继续处理该连接上排队的请求。
+    // 每个 deferred 响应至多调用一次；连接已断开时 fill 不会被调用。
+    void complete(std::function<void(HttpResponse*)> fill) const;
+
+    bool connected() const
+    {
+        return conn_ && conn_->connected();
+    }
+
+    muduo::net::EventLoop* getLoop() const
+    {
+        return conn_->getLoop();
+    }
+
+    const muduo::net::TcpConnectionPtr& connection() const
+    {
+        return conn_;
+    }
+
+private:
+    muduo::net::TcpConnectionPtr conn_;
+    std::shared_ptr<ssl::SslConnection> sslConn_;
+    HttpServer* server_ = nullptr;  // complete() 使用；HttpServer 比其连接活得久
+};
+
+}  // namespace http
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace http
+{
+
+/**
+ * @brief SSE 事件的写出目标（实际连接为 SseWriter）
+ */
+class SseSink
+{
+public:
+    virtual ~SseSink() = default;
+
+    /// 写出一个带 ID 的事件 "id: <id>\ndata: <payload>\n\n"；连接已断开时返回 false
+    virtual bool event(std::string_view id, std::string_view payload) = 0;
+    virtual bool writable() const = 0;
+    virtual bool connected() const = 0;
+    virtual void close() = 0;
+};
+
+/**
+ * @brief 可断点续传的 SSE 流：生成端与客户端连接解耦
+ *
+ * 生成端（AI 线程）每个事件调用一次 publish()，事件按序编号并存入有界的重放环（按帧数与字节数淘汰最旧的帧），
+ * 同时转发给当前挂接的连接。事件 ID 为 "<key>:<seq>"，客户端断线重连时以 Last-Event-ID 带回，
+ * attach() 先补发 seq 之后仍在环中的帧，再挂接为实时输出，两者在同一把锁内完成，不丢帧也不重帧。
+ *
+ * 连接断开后生成继续写入重放环；无连接持续超过 graceMs 即视为放弃（abandoned() 置位且不可再挂接），
+ * 生成端据此中止上游调用。finish() 后流仍保留 graceMs 供晚到的重连读取结尾。
+ * 所有方法可在任意线程调用。
+ */
+class SseStream
+{
+public:
+    struct Options
+    {
+        size_t maxFrames = 2048;        // 重放环最多保留的帧数
+        size_t maxBytes = 256 * 1024;   // 重放环最多保留的 payload 字节数
+        int64_t graceMs = 30 * 1000;    // 断线后继续生成、完成后继续保留的时长
+    };
+
+    SseStream(std::string key, long long owner, Options options);
+
+    SseStream(const SseStream&) = delete;
+    SseStream& operator=(const SseStream&) = delete;
+
+    const std::string& key() const
+    {
+        return key_;
+    }
+    long long owner() const
+    {
+        return owner_;
+    }
+
+    /// 追加一个事件并转发给当前连接，返回其序号（从 1 开始）
+    uint64_t publish(std::string payload);
+
+    /**
+     * @brief 挂接连接：补发 lastSeq 之后的帧，随后实时转发；已有连接时替换并关闭旧连接
+     * @param lastSeq 客户端已收到的最后序号，新流传 0
+     * @return 所需的帧已被淘汰、lastSeq 超前或流已放弃时返回 false，连接不会挂接
+     */
+    bool attach(std::shared_ptr<SseSink> sink, uint64_t lastSeq);
+
+    /// 生成结束：关闭当前连接；之后的 attach() 补发剩余帧后立即关闭
+    void finish();
+
+    /// 无连接持续超过 graceMs，生成端应中止；一旦为 true 不再恢复
+    bool abandoned() const;
+
+    /// 当前连接可写，或暂无连接（帧只进重放环）
+    bool writable() const;
+
+    /// 可以从注册表移除：已放弃，或完成已超过 graceMs
+    bool expired(int64_t nowMs) const;
+
+    /// 事件 ID "<key>:<seq>" 的生成与解析
+    static std::string eventId(std::string_view key, uint64_t seq);
+    static bool parseEventId(std::string_view id, std::string* key, uint64_t* seq);
+
+private:
+    struct Frame
+    {
+        uint64_t seq;
+        std::string payload;
+    };
+
+    void detachIfClosedLocked(int64_t nowMs) const;
+    bool abandonedLocked(int64_t nowMs) const;
+
+    const std::string key_;
+    const long long owner_;
+    const Options options_;
+
+    mutable std::mutex mutex_;  // 保护以下全部成员
+    std::deque<Frame> frames_;
+    size_t bytes_ = 0;
+    uint64_t nextSeq_ = 1;
+    mutable std::shared_ptr<SseSink> sink_;
+    mutable int64_t detachedAtMs_;
+    mutable bool abandoned_ = false;
+    bool finished_ = false;
+    int64_t finishedAtMs_ = 0;
+};
+
+/**
+ * @brief 进行中的可续传 SSE 流，按 key 查找
+ *
+ * 新建流时顺带清理已过期的流（间隔 sweepIntervalMs），无需额外的定时器。
+ */
+class SseStreamRegistry
+{
+public:
+    struct Options
+    {
+        SseStream::Options stream;
+        int64_t sweepIntervalMs = 10 * 1000;
+    };
+
+    SseStreamRegistry() : SseStreamRegistry(Options()) {}
+    explicit SseStreamRegistry(Options options);
+
+    /// 以 key（调用方保证唯一，如请求 ID）新建流
+    std::shared_ptr<SseStream> create(std::string key, long long owner);
+
+    /// 查找 owner 的流；不存在、已过期或属于其他用户时返回空
+    std::shared_ptr<SseStream> find(const std::string& key, long long owner) const;
+
+    /// 移除已过期的流，返回移除数
+    size_t sweep();
+
+    size_t size() const;
+
+private:
+    size_t sweepLocked(int64_t nowMs);
+
+    const Options options_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<SseStream>> streams_;
+    int64_t lastSweepMs_ = 0;
+};
+
+}  // namespace http
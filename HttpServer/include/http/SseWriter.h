@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <muduo/net/TimerId.h>
+#include <string>
+#include <string_view>
+
+#include "http/Compression.h"
+#include "http/ResponseWriter.h"
+#include "http/SseStream.h"
+
+namespace http
+{
+
+/**
+ * @brief 单个 SSE 流的写出端：合并小帧、感知慢客户端、定时心跳
+ *
+ * 生产者（AI 线程）每个 token 调用一次 data()，只追加到本地缓冲；缓冲攒够 flushBytes
+ * 或最早一帧等待超过 flushIntervalMs 时才投递一次到 IO 线程写出，IO 线程的唤醒次数与 token 数无关。
+ *
+ * 背压：连接输出缓冲越过 highWaterMark（muduo HighWaterMarkCallback）时 writable() 变为 false，
+ * 上游应暂停读取（如 curl 返回 CURL_WRITEFUNC_PAUSE），输出缓冲写空（WriteCompleteCallback）后恢复，
+ * 并调用 onWritable 通知上游立即继续，而不必等上游下一次轮询 writable()。
+ * 暂停超过 stallTimeoutSec 视为客户端失联，强制断开。每个流占用的内存因此约为
+ * highWaterMark + flushBytes + 上游单次回调的数据量，与客户端读取速度无关。
+ *
+ * 心跳：heartbeatSec 内没有任何输出时发送注释帧 ": ping"，避免代理因空闲断开等待首个 token 的连接。
+ *
+ * 压缩：encoding 非 identity 时每次写出经 StreamCompressor 压缩并 flush，客户端逐批解出事件；
+ * 响应头中的 Content-Encoding 由调用方按同一编码写出。
+ *
+ * 流期间占用连接的 HighWaterMarkCallback 与 WriteCompleteCallback，close() 时清除。
+ * 除 open() 外所有方法可在任意线程调用。
+ */
+class SseWriter : public SseSink, public std::enable_shared_from_this<SseWriter>
+{
+public:
+    struct Options
+    {
+        size_t flushBytes = 4096;           // 缓冲达到该字节数立即写出
+        int flushIntervalMs = 10;           // 否则最多延迟该时长
+        size_t highWaterMark = 256 * 1024;  // 连接输出缓冲超过该值即暂停上游
+        double heartbeatSec = 15;           // 空闲心跳间隔，<= 0 关闭
+        double stallTimeoutSec = 60;        // 持续暂停超过该时长即断开，<= 0 不限
+        ContentEncoding encoding = ContentEncoding::kIdentity;  // 流式压缩编码
+        int compressionLevel = 6;                               // zlib 级别或 br 质量
+        std::function<void()> onWritable;  // 暂停后恢复可写时在 IO 线程调用，不得阻塞
+    };
+
+    /// 在 writer 上开启 SSE 流（响应头须已由调用方写出）
+    static std::shared_ptr<SseWriter> open(ResponseWriter writer, Options options);
+    static std::shared_ptr<SseWriter> open(ResponseWriter writer)
+    {
+        return open(std::move(writer), Options());
+    }
+
+    ~SseWriter() override;
+
+    SseWriter(const SseWriter&) = delete;
+    SseWriter& operator=(const SseWriter&) = delete;
+
+    /// 追加一个事件 "data: <payload>\n\n"（payload 不得含换行）
+    /// @return 连接已断开或流已关闭时返回 false，数据被丢弃
+    bool data(std::string_view payload);
+
+    /// 追加一个带 ID 的事件，供断线重连时以 Last-Event-ID 续传（见 SseStream）
+    bool event(std::string_view id, std::string_view payload) override;
+
+    /// 上游是否可以继续产生数据：连接仍在且输出缓冲未越过高水位
+    bool writable() const override
+    {
+        return !paused_.load(std::memory_order_acquire) && connected();
+    }
+
+    bool connected() const override
+    {
+        return !closed_.load(std::memory_order_acquire) && writer_.connected();
+    }
+
+    /// 写出剩余数据后关闭写端；可重复调用
+    void close() override;
+
+private:
+    SseWriter(ResponseWriter writer, Options options);
+
+    void start();                 // IO 线程：安装回调与心跳
+    void flush();                 // IO 线程：写出缓冲
+    void tick();                  // IO 线程：心跳与失联检测
+    void finish();                // IO 线程：清理并关闭写端
+    void scheduleFlush(bool now);  // 持有 mutex_ 时调用
+    bool append(std::string_view id, std::string_view payload);
+    void write(std::string data);  // IO 线程：经压缩（如启用）后写出
+
+    ResponseWriter writer_;
+    const Options options_;
+
+    std::mutex mutex_;  // 保护以下三项
+    std::string pending_;
+    bool timerScheduled_ = false;
+    bool urgentScheduled_ = false;
+
+    std::atomic<bool> paused_{false};
+    std::atomic<bool> closed_{false};
+
+    // 以下仅在 IO 线程访问
+    std::unique_ptr<StreamCompressor> compressor_;
+    muduo::net::TimerId heartbeat_;
+    bool heartbeatActive_ = false;
+    int64_t lastOutputMs_ = 0;
+    int64_t pausedSinceMs_ = 0;
+};
+
+}  // namespace http
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace http
+{
+
+/**
+ * @brief 静态资源内存缓存
+ *
+ * 以文件绝对路径为键缓存 web/ 下的资源。每个条目在加载时一次性完成：
+ * - 原始字节与预压缩的 gzip / brotli 变体（仅对文本类资源，且压缩后更小才保留）
+ * - 基于内容哈希的强 ETag 与 Last-Modified
+ * - 每个变体预拼好的响应头块（200 / 304 各一份），命中时无需再格式化任何头部
+ *
+ * 条目不可变，以 shared_ptr 形式交给响应，替换时旧条目随最后一个引用释放。
+ * 有效性通过 mtime + size 校验：同一条目在 revalidateMs 内不重复 stat，
+ * 超过后 stat 一次，文件变化则重新加载。
+ *
+ * 线程安全：多个 IO 线程可并发调用 lookup()。
+ */
+class StaticFileCache
+{
+public:
+    struct Options
+    {
+        size_t maxFileBytes = 4 * 1024 * 1024;     ///< 超过此大小的文件不进缓存
+        size_t maxTotalBytes = 64 * 1024 * 1024;   ///< 缓存总字节上限（含压缩变体）
+        int maxAgeSec = 300;                       ///< Cache-Control max-age
+        int revalidateMs = 1000;                   ///< mtime 复核间隔
+        size_t minCompressBytes = 256;             ///< 小于此大小不压缩
+    };
+
+    enum Encoding
+    {
+        kIdentity = 0,
+        kGzip = 1,
+        kBrotli = 2,
+        kEncodingCount = 3,
+    };
+
+    /// 一种内容编码下的响应数据
+    struct Variant
+    {
+        std::shared_ptr<const std::string> body;         ///< 响应体字节；为空表示该编码不可用
+        std::shared_ptr<const std::string> headers;      ///< 200 响应头块（每行以 \r\n 结尾）
+        std::shared_ptr<const std::string> notModified;  ///< 304 响应头块
+        std::string etag;                                ///< 该编码的强 ETag（含引号）
+    };
+
+    struct Entry
+    {
+        std::string path;          ///< 磁盘路径
+        time_t mtime = 0;          ///< 加载时的修改时间
+        uint64_t size = 0;         ///< 加载时的文件大小
+        std::string etag;          ///< identity 编码的强 ETag（含引号）
+        std::string lastModified;  ///< HTTP-date
+        Variant variants[kEncodingCount];
+        mutable std::atomic<int64_t> checkedAtMs{0};  ///< 上次 stat 复核时间
+    };
+
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    StaticFileCache() : StaticFileCache(Options()) {}
+    explicit StaticFileCache(Options options);
+
+    // 查找（必要时加载/重载）文件对应的缓存条目。
+    // 参数：
+    // - filePath：磁盘路径。
+    // - mimeType：Content-Type，用于决定是否压缩。
+    // 返回值：缓存条目；文件不存在、过大或缓存已满时返回 nullptr（调用方应回退到直接读盘）。
+    EntryPtr lookup(const std::string& filePath, const std::string& mimeType);
+
+    // 根据 Accept-Encoding 选择条目中可用的最佳编码（br > gzip > identity，遵循 q 值）。
+    static Encoding negotiate(const Entry& entry, std::string_view acceptEncoding);
+
+    // 条件请求判断：If-None-Match 优先，其次 If-Modified-Since。
+    // 返回值：应返回 304 时为 true。
+    static bool notModified(const Entry& entry, std::string_view ifNoneMatch, std::string_view ifModifiedSince);
+
+    // 格式化为 HTTP-date（RFC 7231 IMF-fixdate），例如 "Sun, 06 Nov 1994 08:49:37 GMT"。
+    static std::string httpDate(time_t t);
+
+    const Options& options() const
+    {
+        return options_;
+    }
+
+    // 当前缓存占用的字节数。
+    size_t bytes() const
+    {
+        return totalBytes_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::shared_ptr<Entry> load(const std::string& filePath, const std::string& mimeType, time_t mtime, uint64_t size);
+
+private:
+    Options options_;
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Entry>> entries_;
+    std::atomic<size_t> totalBytes_{0};
+};
+
+}  // namespace http
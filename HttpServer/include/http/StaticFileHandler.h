@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 
+#include "http/StaticFileCache.h"
 #include "router/RouterHandler.h"
 
 namespace http
@@ -9,13 +10,25 @@ namespace http
 class StaticFileHandler : public http::router::RouterHandler
 {
 public:
-    explicit StaticFileHandler(const std::string& resourceRoot);
+    explicit StaticFileHandler(const std::string& resourceRoot,
+                               StaticFileCache::Options cacheOptions = StaticFileCache::Options());
     void handle(const HttpRequest& req, HttpResponse* resp) override;
 
 private:
     bool isPathSafe(const std::string& path);
     std::string getMimeType(const std::string& path);
+
+    // 以文件响应体返回（缓存未命中、文件过大或带 Range 的请求），支持单区间 Range / If-Range。
+    // 参数：
+    // - entry：同一文件的缓存条目，可为空；未变化时沿用其 ETag。
+    void serveFile(const HttpRequest& req,
+                   const std::string& filePath,
+                   const std::string& mime,
+                   const StaticFileCache::Entry* entry,
+                   HttpResponse* resp);
+
     std::string resourceRoot_;
+    StaticFileCache cache_;  // web/ 资源内存缓存（含预压缩变体与预拼头部）
 };
 
 }  // namespace http
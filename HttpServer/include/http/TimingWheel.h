@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace http
+{
+
+/**
+ * @brief 哈希时间轮（单线程使用，每个 IO 线程一个）
+ *
+ * 每 tick 前进一格，到达格子里的条目若 rounds 为 0 则回调 onExpire。条目只持有目标的 weak_ptr
+ * 和一个令牌，不支持取消：目标重新计时时递增自己的令牌，旧条目在到期时由回调按令牌识别并忽略。
+ * 回调返回值 > 0 表示目标仍需等待这么多 tick，条目重新挂入，从而"活动即续期"不必逐次插入。
+ *
+ * @tparam T 被计时的对象类型（如 muduo::net::TcpConnection）
+ */
+template <typename T>
+class TimingWheel
+{
+public:
+    /// 到期回调：参数为仍存活的目标与登记时的令牌；返回还需等待的 tick 数，0 表示处理完毕
+    using ExpireCallback = std::function<int(const std::shared_ptr<T>&, uint64_t)>;
+
+    TimingWheel(size_t slots, ExpireCallback onExpire) : slots_(slots > 0 ? slots : 1), onExpire_(std::move(onExpire))
+    {
+    }
+
+    /**
+     * @brief 登记一个 delay 个 tick 后到期的条目
+     * @param target 目标对象；到期前被释放的条目直接丢弃
+     * @param token 回调时原样传回，用于识别过期的登记
+     * @param delay tick 数，小于 1 时按 1 处理
+     */
+    void schedule(const std::shared_ptr<T>& target, uint64_t token, int delay)
+    {
+        size_t d = delay > 0 ? static_cast<size_t>(delay) : 1;
+        size_t n = slots_.size();
+        slots_[(cursor_ + d) % n].push_back(Entry{target, token, (d - 1) / n});
+        ++size_;
+    }
+
+    /**
+     * @brief 前进一格并处理到期条目
+     */
+    void tick()
+    {
+        cursor_ = (cursor_ + 1) % slots_.size();
+        std::vector<Entry> due;
+        due.swap(slots_[cursor_]);
+        size_ -= due.size();
+        for (auto& entry : due)
+        {
+            if (entry.rounds > 0)
+            {
+                --entry.rounds;
+                slots_[cursor_].push_back(std::move(entry));
+                ++size_;
+                continue;
+            }
+            std::shared_ptr<T> target = entry.target.lock();
+            if (!target)
+            {
+                continue;
+            }
+            int again = onExpire_(target, entry.token);
+            if (again > 0)
+            {
+                schedule(target, entry.token, again);
+            }
+        }
+        // 复用本格的容量，稳态下 tick 不再分配
+        if (slots_[cursor_].empty())
+        {
+            due.clear();
+            slots_[cursor_].swap(due);
+        }
+    }
+
+    /// 仍挂在时间轮上的条目数（含已失效、待到期时丢弃的条目）
+    size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    struct Entry
+    {
+        std::weak_ptr<T> target;
+        uint64_t token;
+        size_t rounds;  ///< 还需转过的整圈数
+    };
+
+    std::vector<std::vector<Entry>> slots_;
+    size_t cursor_ = 0;
+    size_t size_ = 0;
+    ExpireCallback onExpire_;
+};
+
+}  // namespace http
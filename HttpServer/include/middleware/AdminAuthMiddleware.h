@@ -11,15 +11,16 @@ namespace middleware
  * @brief Admin role authorization middleware.
  *
  * Must be registered AFTER AuthMiddleware in the middleware chain.
- * Reads X-Auth-Role header (injected by AuthMiddleware) and rejects
- * non-admin requests to /admin/* paths with HTTP 403.
+ * Bound to /admin/* routes only; reads the verified role recorded by
+ * AuthMiddleware (HttpRequest::authRole) and rejects non-admin requests with HTTP 403.
  */
 class AdminAuthMiddleware : public Middleware
 {
 public:
     AdminAuthMiddleware() = default;
 
-    void before(HttpRequest& request) override;
+    bool before(HttpRequest& request, HttpResponse* response) override;
+    bool appliesTo(std::string_view routePattern) const override;
     void after(HttpResponse& response) override {}
 };
 
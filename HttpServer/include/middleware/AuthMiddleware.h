@@ -2,8 +2,10 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "Auth/JwtService.h"
 #include "Middleware.h"
 
 namespace http
@@ -11,23 +13,37 @@ namespace http
 namespace middleware
 {
 
-/// Authentication middleware: validates JWT from httpOnly cookie.
-/// Throws HttpResponse with 401 if token is missing or invalid.
-/// For public paths (/api/invite/verify, /api/verify/send, /api/verify/check)
-/// the middleware passes through without authentication.
+/// Authentication middleware: validates JWT from httpOnly cookie and records the
+/// verified identity on the request (HttpRequest::setAuth), so handlers never
+/// verify the token again. Verified tokens are cached per IO thread.
+///
+/// kRequired (default): bound to /api/* and /admin/* routes; answers 401 and
+/// stops the chain if the token is missing or invalid. Public routes
+/// (/api/invite/verify, /api/verify/send, /api/verify/check) are not bound.
+///
+/// kOptional: bound to /chat* page and chat routes, which also accept a login
+/// session; attaches the identity when a valid token is present, never rejects.
 class AuthMiddleware : public Middleware
 {
 public:
-    AuthMiddleware();
+    enum class Mode
+    {
+        kRequired,
+        kOptional,
+    };
 
-    void before(HttpRequest& request) override;
+    explicit AuthMiddleware(Mode mode = Mode::kRequired);
+
+    bool before(HttpRequest& request, HttpResponse* response) override;
     void after(HttpResponse& response) override {}
+    bool appliesTo(std::string_view routePattern) const override;
 
 private:
-    static bool isPublicPath(const std::string& path);
-    static std::string extractJwtFromCookie(const HttpRequest& request);
+    static bool isPublicPath(std::string_view path);
+    static std::string_view extractJwtFromCookie(const HttpRequest& request);
 
-    std::string secret_;
+    Mode mode_;
+    common::JwtService jwt_;
 };
 
 }  // namespace middleware
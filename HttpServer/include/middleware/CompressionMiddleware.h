@@ -0,0 +1,36 @@
+#pragma once
+
+#include "http/Compression.h"
+#include "middleware/Middleware.h"
+
+namespace http
+{
+namespace middleware
+{
+
+/**
+ * @brief 动态响应压缩中间件
+ *
+ * before() 按 Accept-Encoding 协商编码并记在 HttpResponse 上，after() 对同步响应的响应体整体压缩（gzip / deflate / br），
+ * 改写 Content-Length 并追加 Content-Encoding 与 Vary。以下响应原样发出：
+ * deferred 响应（SSE 由 SseWriter 自行流式压缩）、文件与共享响应体（静态资源已有预压缩变体）、
+ * 204 / 206 / 304、已带 Content-Encoding、小于 minBytes、Content-Type 不在白名单内，或压缩后不更小。
+ *
+ * 压缩使用当前 IO 线程的 Compressor，响应之间复用 zlib 状态。
+ * 应最先注册，使 after() 在其他中间件之后执行。
+ */
+class CompressionMiddleware : public Middleware
+{
+public:
+    CompressionMiddleware() : CompressionMiddleware(CompressionOptions()) {}
+    explicit CompressionMiddleware(CompressionOptions options);
+
+    bool before(HttpRequest& request, HttpResponse* response) override;
+    void after(HttpResponse& response) override;
+
+private:
+    const CompressionOptions options_;
+};
+
+}  // namespace middleware
+}  // namespace http
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string_view>
+
 #include "../http/HttpRequest.h"
 #include "../http/HttpResponse.h"
 
@@ -14,11 +16,22 @@ public:
     virtual ~Middleware() = default;
 
     // 请求前处理
-    virtual void before(HttpRequest& request) = 0;
+    //
+    // 返回 false 表示终止：中间件已把响应写入 response，后续中间件与路由处理器都不再执行，
+    // 之前已通过的中间件仍逆序执行 after()。
+    virtual bool before(HttpRequest& request, HttpResponse* response) = 0;
 
     // 响应后处理
     virtual void after(HttpResponse& response) = 0;
 
+    // 是否作用于给定的路由模式（如 "/api/chat/send"、"/assets/*path"）。
+    // HttpServer 启动时据此为每条路由预先挑选中间件，请求期间不再逐个判断路径；
+    // 未匹配任何路由的请求以请求路径代替模式判断。
+    virtual bool appliesTo(std::string_view routePattern) const
+    {
+        return true;
+    }
+
     // 设置下一个中间件
     void setNext(std::shared_ptr<Middleware> next)
     {
@@ -30,4 +43,4 @@ protected:
 };
 
 }  // namespace middleware
-}  // namespace http
\ No newline at end of file
+}  // namespace http
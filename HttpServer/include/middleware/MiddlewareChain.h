@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <string_view>
 #include <vector>
 
 #include "Middleware.h"
@@ -20,20 +21,50 @@ public:
     void addMiddleware(std::shared_ptr<Middleware> middleware);
 
     /**
-     * @brief 顺序执行所有中间件的前置处理。
+     * @brief 挑选作用于指定路由模式的中间件，按注册顺序组成新的执行链。
+     * @param routePattern 路由模式；未匹配路由时传请求路径。
+     * @return 只含 appliesTo(routePattern) 为真的中间件的执行链。
+     */
+    std::shared_ptr<const MiddlewareChain> compile(std::string_view routePattern) const;
+
+    /**
+     * @brief 顺序执行中间件的前置处理，遇到返回 false 的中间件即停止。
      * @param request HTTP 请求对象。
+     * @param response HTTP 响应对象，终止时已由中间件写好。
+     * @param passed 输出已通过（before 返回 true）的中间件个数。
+     * @return 全部通过返回 true。
      */
-    void processBefore(HttpRequest& request);
+    bool processBefore(HttpRequest& request, HttpResponse* response, size_t* passed) const;
+
+    /**
+     * @brief 逆序执行前 count 个中间件的后置处理。
+     * @param response HTTP 响应对象。
+     * @param count 参与后置处理的中间件个数，通常为 processBefore 输出的 passed。
+     */
+    void processAfter(HttpResponse& response, size_t count) const;
 
     /**
      * @brief 逆序执行所有中间件的后置处理。
      * @param response HTTP 响应对象。
      */
-    void processAfter(HttpResponse& response);
+    void processAfter(HttpResponse& response) const
+    {
+        processAfter(response, middlewares_.size());
+    }
+
+    const std::vector<std::shared_ptr<Middleware>>& middlewares() const
+    {
+        return middlewares_;
+    }
+
+    size_t size() const
+    {
+        return middlewares_.size();
+    }
 
 private:
     std::vector<std::shared_ptr<Middleware>> middlewares_;
 };
 
 }  // namespace middleware
-}  // namespace http
\ No newline at end of file
+}  // namespace http
@@ -1,9 +1,12 @@
 #pragma once
 
-#include <mutex>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
-#include "Common/RateLimit/TokenBucket.h"
+#include "Common/RateLimit/RateLimiter.h"
 #include "middleware/Middleware.h"
 
 namespace http
@@ -11,24 +14,35 @@ namespace http
 namespace middleware
 {
 
-/// Rate limit middleware: max 10 requests/min per user for /api/chat/*.
+/// 一条限流规则：路径前缀 + 按用户档位（JWT role：user / admin / org）的限额 + 该规则独占的桶存储
+struct RateLimitRule
+{
+    std::string routePrefix;                                   ///< 如 "/api/chat"
+    std::unordered_map<std::string, common::RateLimit> tiers;  ///< role → 限额，"*" 为其余档位的缺省值
+    std::shared_ptr<common::RateLimiter> limiter;              ///< 以 userId 为 key
+};
+
+/// Rate limit middleware: per-user token buckets, one bucket store per rule.
+/// Rules are matched by path prefix in order; the first match wins. A role with
+/// no tier entry (and no "*" entry) is not limited. Each rule's buckets live in a
+/// common::RateLimiter — sharded in-process by default, Redis GCRA when shared
+/// across nodes.
 class RateLimitMiddleware : public Middleware
 {
 public:
-    RateLimitMiddleware(int maxTokens = 10, double refillPerSec = 10.0 / 60.0)
-        : maxTokens_(maxTokens), refillPerSec_(refillPerSec)
-    {
-    }
-    void before(HttpRequest& request) override;
+    /// Default: 10 requests/min per user for /api/chat/*, in-process buckets.
+    RateLimitMiddleware(int maxTokens = 10, double refillPerSec = 10.0 / 60.0);
+    explicit RateLimitMiddleware(std::vector<RateLimitRule> rules);
+
+    bool before(HttpRequest& request, HttpResponse* response) override;
+    bool appliesTo(std::string_view routePattern) const override;
     void after(HttpResponse& response) override {}
 
 private:
-    common::TokenBucket& getBucket(long long userId);
-    std::mutex mutex_;
-    std::unordered_map<long long, std::unique_ptr<common::TokenBucket>> buckets_;
-    int maxTokens_;
-    double refillPerSec_;
+    const RateLimitRule* matchRule(std::string_view path) const;
+
+    std::vector<RateLimitRule> rules_;
 };
 
 }  // namespace middleware
-}  // namespace http
\ No newline at end of file
+}  // namespace http
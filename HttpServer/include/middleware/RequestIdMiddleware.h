@@ -6,15 +6,14 @@ namespace http
 {
 namespace middleware
 {
+/// 为每个请求确定 X-Request-Id（见 common::generateRequestId），写入日志上下文并回显到响应头；
+/// 处理器把它带到工作线程，随 LLM / MCP 调用与 call_logs 传递。
 class RequestIdMiddleware : public Middleware
 {
 public:
     RequestIdMiddleware() = default;
-    void before(HttpRequest& request) override;
+    bool before(HttpRequest& request, HttpResponse* response) override;
     void after(HttpResponse& response) override;
-
-private:
-    static std::string generateUuid();
 };
 };  // namespace middleware
 }  // namespace http
\ No newline at end of file
@@ -16,8 +16,9 @@ namespace middleware
 class SecurityHeadersMiddleware : public Middleware
 {
 public:
-    void before(HttpRequest&) override
+    bool before(HttpRequest&, HttpResponse*) override
     { /* no-op: 不拦截请求 */
+        return true;
     }
 
     /**
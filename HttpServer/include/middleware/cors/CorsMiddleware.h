@@ -20,10 +20,12 @@ public:
     explicit CorsMiddleware(const CorsConfig& config = CorsConfig::defaultConfig());
 
     /**
-     * @brief 在请求进入时执行 CORS 相关处理。
+     * @brief 在请求进入时执行 CORS 相关处理；预检请求直接写入响应并终止。
      * @param request HTTP 请求对象。
+     * @param response HTTP 响应对象。
+     * @return 预检请求返回 false，其余返回 true。
      */
-    void before(HttpRequest& request) override;
+    bool before(HttpRequest& request, HttpResponse* response) override;
 
     /**
      * @brief 在响应返回前追加 CORS 响应头。
@@ -37,7 +39,7 @@ public:
      * @param delimiter 分隔符。
      * @return 拼接后的字符串。
      */
-    std::string join(const std::vector<std::string>& strings, const std::string& delimiter);
+    static std::string join(const std::vector<std::string>& strings, const std::string& delimiter);
 
 private:
     /**
@@ -61,8 +63,13 @@ private:
      */
     void addCorsHeaders(HttpResponse& response, const std::string& origin);
 
+    // 按配置编码 CORS 响应头
+    HeaderTemplate buildCorsHeaders(const std::string& origin) const;
+
 private:
     CorsConfig config_;
+    HeaderTemplate responseHeaders_;  // after() 使用的预编码 CORS 头部
+
 };
 
 }  // namespace middleware
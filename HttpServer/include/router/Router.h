@@ -1,10 +1,10 @@
 #pragma once
+#include <array>
 #include <functional>
 #include <iostream>
 #include <memory>
-#include <regex>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 #include "../http/HttpRequest.h"
@@ -13,65 +13,65 @@
 
 namespace http
 {
+namespace middleware
+{
+class MiddlewareChain;
+}  // namespace middleware
+
 namespace router
 {
 
 // 选择注册对象式的路由处理器还是注册回调函数式的处理器取决于处理器执行的复杂程度
 // 如果是简单的处理可以注册回调函数，否则注册对象式路由处理器(对象中可封装多个相关函数)
 // 二者注册其一即可
+//
+// 路由表是按请求方法划分的压缩前缀树（radix tree），匹配代价与路径长度成正比，与路由数量无关。
+// 支持三类片段，同一位置的优先级为：静态 > 命名参数 > 通配符
+//   - 静态片段：  /chat/history
+//   - 命名参数：  /css/:file        匹配一个非空路径段（不含 '/'）
+//   - 通配符：    /assets/*path     匹配剩余全部路径（可含 '/'），只能位于模式末尾
 class Router
 {
 public:
     using HandlerPtr = std::shared_ptr<RouterHandler>;
     using HandlerCallback = std::function<void(const HttpRequest&, HttpResponse*)>;
 
-    // 路由键（请求方法 + URI）
-    struct RouteKey
+    static constexpr size_t kMaxParams = 8;  // 单条路由允许的参数个数上限
+
+    // 一条已注册的路由
+    struct RouteTarget
     {
-        HttpRequest::Method method;
-        std::string path;
-
-        // 比较两个路由键是否相等。
-        //
-        // Args:
-        //   other: 需要比较的另一个路由键。
-        //
-        // Returns:
-        //   如果方法和路径都相同则返回 true，否则返回 false。
-        bool operator==(const RouteKey& other) const
-        {
-            return method == other.method && path == other.path;
-        }
+        std::string pattern;                  // 注册时的原始模式，便于日志
+        std::vector<std::string> paramNames;  // 参数名（按出现顺序，通配符名也计入）
+        HandlerPtr handler;                   // 对象式处理器（优先）
+        HandlerCallback callback;             // 回调式处理器
+        // 作用于该路由的中间件，由 HttpServer 启动时按模式预先挑选，中间件组合相同的路由共享同一条链
+        std::shared_ptr<const middleware::MiddlewareChain> middlewares;
     };
 
-    // 为 RouteKey 定义哈希函数
-    struct RouteKeyHash
+    // 路由匹配结果。参数值为指向请求路径的 view，整个结构位于栈上，匹配过程不分配内存。
+    struct RouteMatch
     {
-        // size_t operator()(const RouteKey& key) const
-        // {
-        //     return std::hash<int>{}(static_cast<int>(key.method)) ^
-        //            std::hash<std::string>{}(key.path);
-        // }
-        // 计算路由键的哈希值，用于 unordered_map 索引。
-        //
-        // Args:
-        //   key: 需要计算哈希的路由键。
-        //
-        // Returns:
-        //   结合方法和路径后的哈希值。
-        size_t operator()(const RouteKey& key) const
-        {
-            size_t methodHash = std::hash<int>{}(static_cast<int>(key.method));
-            size_t pathHash = std::hash<std::string>{}(key.path);
-            return methodHash * 31 + pathHash;
-        }
+        const RouteTarget* target = nullptr;
+        std::array<std::string_view, kMaxParams> values;
+        size_t count = 0;
     };
 
+    Router();
+    ~Router();
+
+    // 深拷贝前缀树，处理器对象与原路由表共享。
+    // 供 SO_REUSEPORT 多 acceptor 模式下每个 acceptor 持有独立的路由快照，匹配时不共享树节点内存。
+    //
+    // Returns:
+    //   与当前路由表等价的新路由表。
+    std::unique_ptr<Router> clone() const;
+
     // 注册路由处理器
     //
     // Args:
     //   method: HTTP 请求方法。
-    //   path: 需要精确匹配的路径。
+    //   path: 路径模式，可为纯静态路径，也可含 ":name" / "*name" 片段。
     //   handler: 处理该路由的处理器对象。
     void registerHandler(HttpRequest::Method method, const std::string& path, HandlerPtr handler);
 
@@ -79,11 +79,11 @@ public:
     //
     // Args:
     //   method: HTTP 请求方法。
-    //   path: 需要精确匹配的路径。
+    //   path: 路径模式，同 registerHandler。
     //   callback: 处理该路由的回调函数。
     void registerCallback(HttpRequest::Method method, const std::string& path, const HandlerCallback& callback);
 
-    // 注册动态路由处理器
+    // 注册动态路由处理器（历史接口名，现与 registerHandler 共用前缀树，不再编译正则）
     //
     // Args:
     //   method: HTTP 请求方法。
@@ -91,11 +91,10 @@ public:
     //   handler: 处理该路由的处理器对象。
     void addRegexHandler(HttpRequest::Method method, const std::string& path, HandlerPtr handler)
     {
-        std::regex pathRegex = convertToRegex(path);
-        regexHandlers_.emplace_back(method, pathRegex, handler);
+        registerHandler(method, path, std::move(handler));
     }
 
-    // 注册动态路由处理函数
+    // 注册动态路由处理函数（历史接口名，同 addRegexHandler）
     //
     // Args:
     //   method: HTTP 请求方法。
@@ -103,77 +102,76 @@ public:
     //   callback: 处理该路由的回调函数。
     void addRegexCallback(HttpRequest::Method method, const std::string& path, const HandlerCallback& callback)
     {
-        std::regex pathRegex = convertToRegex(path);
-        regexCallbacks_.emplace_back(method, pathRegex, callback);
+        registerCallback(method, path, callback);
     }
 
-    // 处理请求
+    // 只查找、不执行的无分配匹配接口。
+    //
+    // Args:
+    //   method: HTTP 请求方法。
+    //   path: 请求路径（不含查询串）。
+    //   match: 输出匹配结果，参数值指向 path。
+    //
+    // Returns:
+    //   找到路由返回 true，否则返回 false。
+    bool match(HttpRequest::Method method, std::string_view path, RouteMatch* match) const;
+
+    // 执行匹配到的处理器并写入路径参数，供先 match、执行中间件后再分发的调用方使用。
     //
     // Args:
+    //   m: match() 的结果，其参数值须仍指向 req 的路径。
     //   req: 输入的 HTTP 请求。
     //   resp: 输出的 HTTP 响应指针。
+    void dispatch(const RouteMatch& m, HttpRequest& req, HttpResponse* resp);
+
+    // 遍历全部已注册的路由项。
+    //
+    // Args:
+    //   fn: 对每个路由项调用一次，可修改其中间件链。
+    void forEachRoute(const std::function<void(RouteTarget&)>& fn);
+
+    // 处理请求，路径参数直接写入 req（不复制请求）
+    //
+    // Args:
+    //   req: 输入的 HTTP 请求，匹配成功后携带路径参数。
+    //   resp: 输出的 HTTP 响应指针。
     //
     // Returns:
     //   如果找到匹配路由并完成处理则返回 true，否则返回 false。
-    bool route(const HttpRequest& req, HttpResponse* resp);
+    bool route(HttpRequest& req, HttpResponse* resp);
 
-private:
-    // 将路径模式转换为正则表达式，支持匹配路径参数。
+    // 处理只读请求（兼容旧接口）。有路径参数时需要复制一次请求。
     //
     // Args:
-    //   pathPattern: 含路径参数的模式字符串。
+    //   req: 输入的 HTTP 请求。
+    //   resp: 输出的 HTTP 响应指针。
     //
     // Returns:
-    //   用于匹配实际路径的正则表达式。
-    std::regex convertToRegex(const std::string& pathPattern)
-    {  // 将路径模式转换为正则表达式，支持匹配任意路径参数
-        std::string regexPattern =
-            "^" + std::regex_replace(pathPattern, std::regex(R"(/:([^/]+))"), R"(/([^/]+))") + "$";
-        return std::regex(regexPattern);
-    }
+    //   如果找到匹配路由并完成处理则返回 true，否则返回 false。
+    bool route(const HttpRequest& req, HttpResponse* resp);
 
-    // 提取路径参数并写入请求对象。
+private:
+    struct Node;
+
+    // 查找或创建模式对应的路由项。
     //
     // Args:
-    //   match: 正则匹配结果。
-    //   request: 需要写入参数的请求对象。
-    void extractPathParameters(const std::smatch& match, HttpRequest& request)
-    {
-        // Assuming the first match is the full path, parameters start from index 1
-        for (size_t i = 1; i < match.size(); ++i)
-        {
-            request.setPathParameters("param" + std::to_string(i), match[i].str());
-        }
-    }
+    //   method: HTTP 请求方法。
+    //   path: 路径模式。
+    //
+    // Returns:
+    //   路由项指针；模式非法时返回 nullptr。
+    RouteTarget* insert(HttpRequest::Method method, const std::string& path);
 
-private:
-    struct RouteCallbackObj
-    {
-        HttpRequest::Method method_;
-        std::regex pathRegex_;
-        HandlerCallback callback_;
-        RouteCallbackObj(HttpRequest::Method method, std::regex pathRegex, const HandlerCallback& callback)
-            : method_(method), pathRegex_(pathRegex), callback_(callback)
-        {
-        }
-    };
+    // 递归复制子树；RouteTarget 按值复制，处理器 shared_ptr 与回调随之共享。
+    static std::unique_ptr<Node> cloneNode(const std::unique_ptr<Node>& node);
 
-    struct RouteHandlerObj
-    {
-        HttpRequest::Method method_;
-        std::regex pathRegex_;
-        HandlerPtr handler_;
-        RouteHandlerObj(HttpRequest::Method method, std::regex pathRegex, HandlerPtr handler)
-            : method_(method), pathRegex_(pathRegex), handler_(handler)
-        {
-        }
-    };
+    static void forEachNode(Node* node, const std::function<void(RouteTarget&)>& fn);
 
-    std::unordered_map<RouteKey, HandlerPtr, RouteKeyHash> handlers_;        // 精准匹配
-    std::unordered_map<RouteKey, HandlerCallback, RouteKeyHash> callbacks_;  // 精准匹配
-    std::vector<RouteHandlerObj> regexHandlers_;                             // 正则匹配
-    std::vector<RouteCallbackObj> regexCallbacks_;                           // 正则匹配
+private:
+    static constexpr size_t kMethodCount = HttpRequest::kOptions + 1;
+    std::array<std::unique_ptr<Node>, kMethodCount> roots_;  // 每个请求方法一棵树
 };
 
 }  // namespace router
-}  // namespace http
\ No newline at end of file
+}  // namespace http
@@ -1,13 +1,18 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
 namespace http
 {
 
+class HttpResponse;
+
 namespace session
 {
 
@@ -26,6 +31,14 @@ public:
     bool isExpired() const;
     void refresh();  // 刷新过期时间
 
+    // 距过期的剩余秒数（向上取整），已过期时 <= 0
+    int64_t expiresInSec() const;
+
+    int getMaxAge() const
+    {
+        return maxAge_;
+    }
+
     void setManager(SessionManager* sessionManager)
     {
         sessionManager_ = sessionManager;
@@ -36,18 +49,45 @@ public:
         return sessionManager_;
     }
 
-    // 数据存取
+    // 是否已写入存储。SessionManager 为没有有效 Cookie 的请求创建的会话起初只存在于本次请求，
+    // 首次 setValue 时才写入存储并下发 Set-Cookie，只读的匿名请求不占用存储。
+    bool isPersisted() const
+    {
+        return persisted_.load(std::memory_order_acquire);
+    }
+
+    // 数据存取（可被同一会话的并发请求在不同 IO 线程调用）
     void setValue(const std::string& key, const std::string& value);
     std::string getValue(const std::string& key) const;
     void remove(const std::string& key);
     void clear();
 
+    // 编码为紧凑的二进制格式（版本号、maxAge 与各键值对，均为 varint 长度前缀），
+    // 供 Redis 等跨进程存储使用。
+    std::string serialize() const;
+
+    // 从 serialize() 的输出还原会话；数据不合法时返回 nullptr。
+    // 还原出的会话视为已持久化，过期时间从当前时刻起按 maxAge 重新计算。
+    static std::shared_ptr<Session> deserialize(const std::string& sessionId, const std::string& bytes);
+
+private:
+    friend class SessionManager;
+
+    // 由 SessionManager 调用：记录首次写入时下发 Set-Cookie 的响应（仅在处理请求期间有效）
+    void setPendingCookie(HttpResponse* resp);
+
+    // 标记为已持久化；返回本次调用前尚未持久化时登记的响应，否则返回 nullptr
+    HttpResponse* markPersisted();
+
 private:
     std::string sessionId_;
+    mutable std::mutex mutex_;  // 保护 data_ 与 pendingCookie_
     std::unordered_map<std::string, std::string> data_;
-    std::chrono::system_clock::time_point expiryTime_;
-    int maxAge_;  // 过期时间（秒）
+    std::atomic<int64_t> expiryMs_{0};  // steady_clock 毫秒
+    int maxAge_;                        // 过期时间（秒）
     SessionManager* sessionManager_;
+    std::atomic<bool> persisted_{false};
+    HttpResponse* pendingCookie_ = nullptr;
 };
 
 }  // namespace session
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <memory>
-#include <random>
 
 #include "../http/HttpRequest.h"
 #include "../http/HttpResponse.h"
@@ -23,6 +22,9 @@ public:
 
     // 从请求中获取或创建会话。
     //
+    // 新建的会话只存在于本次请求：首次 setValue 时才写入存储并向 resp 写 Set-Cookie，
+    // 因此只读会话的匿名请求不占用存储。首次写入须在请求处理期间（resp 有效时）进行。
+    //
     // Args:
     //   req: HTTP 请求对象。
     //   resp: HTTP 响应对象，用于回写 Set-Cookie。
@@ -31,23 +33,44 @@ public:
     //   获取到的会话对象；若不存在则创建新的会话并返回。
     std::shared_ptr<Session> getSession(const HttpRequest& req, HttpResponse* resp);
 
+    // 按会话 ID 获取或创建会话，语义同 getSession(req, resp)。
+    //
+    // 供请求对象已失效的异步处理使用：在 IO 线程中先用 getSessionIdFromCookie 取出 ID，完成时再调用本方法。
+    //
+    // Args:
+    //   sessionId: Cookie 中的会话 ID，可为空。
+    //   resp: HTTP 响应对象，用于回写 Set-Cookie。
+    //
+    // Returns:
+    //   获取到的会话对象；若不存在或已过期则创建新的会话并返回。
+    std::shared_ptr<Session> getSession(const std::string& sessionId, HttpResponse* resp);
+
+    // 从请求头中提取会话 ID。
+    //
+    // Args:
+    //   req: HTTP 请求对象。
+    //
+    // Returns:
+    //   提取到的会话 ID；若不存在则返回空字符串。
+    static std::string getSessionIdFromCookie(const HttpRequest& req);
+
     // 销毁指定会话。
     //
     // Args:
     //   sessionId: 需要销毁的会话 ID。
     void destroySession(const std::string& sessionId);
 
-    // 清理过期会话。
-    void cleanExpiredSessions();
+    // 立即清理过期会话（内存存储另有后台线程按时间轮清理）。
+    //
+    // Returns:
+    //   清理的会话数。
+    size_t cleanExpiredSessions();
 
-    // 更新会话数据。
+    // 更新会话数据；尚未持久化的会话在此首次写入存储并下发 Set-Cookie。
     //
     // Args:
     //   session: 需要保存的会话对象。
-    void updateSession(std::shared_ptr<Session> session)
-    {
-        storage_->save(session);
-    }
+    void updateSession(std::shared_ptr<Session> session);
 
 private:
     // 生成新的会话 ID。
@@ -56,15 +79,6 @@ private:
     //   生成的会话 ID 字符串。
     std::string generateSessionId();
 
-    // 从请求头中提取会话 ID。
-    //
-    // Args:
-    //   req: HTTP 请求对象。
-    //
-    // Returns:
-    //   提取到的会话 ID；若不存在则返回空字符串。
-    std::string getSessionIdFromCookie(const HttpRequest& req);
-
     // 将会话 ID 写入响应 Cookie。
     //
     // Args:
@@ -74,7 +88,6 @@ private:
 
 private:
     std::unique_ptr<SessionStorage> storage_;
-    std::mt19937 rng_;  // 用于生成随机会话id
 };
 
 }  // namespace session
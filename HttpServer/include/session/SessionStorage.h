@@ -1,6 +1,13 @@
 #pragma once
+#include <atomic>
+#include <condition_variable>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
+#include "../http/TimingWheel.h"
 #include "Session.h"
 
 namespace http
@@ -34,25 +41,52 @@ public:
     // Args:
     //   sessionId: 需要删除的会话 ID。
     virtual void remove(const std::string& sessionId) = 0;
+
+    // 立即清理全部过期会话。
+    //
+    // Returns:
+    //   清理的会话数；不支持主动清理的存储返回 0。
+    virtual size_t removeExpired()
+    {
+        return 0;
+    }
 };
 
 // 基于内存的会话存储实现
+//
+// 按会话 ID 哈希分片，每片一把锁、一条 LRU 链表和一个过期时间轮，不同 IO 线程访问不同会话时
+// 基本不争用。后台线程每秒推进各分片的时间轮，过期会话无需等到再次被访问才释放；总数超过上限时
+// 淘汰所在分片中最久未访问的会话。
 class MemorySessionStorage : public SessionStorage
 {
 public:
+    static constexpr size_t kDefaultMaxSessions = 100000;
+    static constexpr size_t kDefaultShards = 16;
+
+    // 创建内存会话存储。
+    //
+    // Args:
+    //   maxSessions: 会话总数上限，按分片均分；0 表示不限制。
+    //   shards: 分片数，至少为 1。
+    //   expiryThread: 是否启动后台过期清理线程；为 false 时只能经 removeExpired() 清理。
+    explicit MemorySessionStorage(size_t maxSessions = kDefaultMaxSessions,
+                                  size_t shards = kDefaultShards,
+                                  bool expiryThread = true);
+    ~MemorySessionStorage() override;
+
     // 保存会话数据到内存。
     //
     // Args:
     //   session: 需要保存的会话对象。
     void save(std::shared_ptr<Session> session) override;
 
-    // 从内存中加载会话。
+    // 从内存中加载会话，命中时移到 LRU 链表头部。
     //
     // Args:
     //   sessionId: 目标会话 ID。
     //
     // Returns:
-    //   找到的会话对象；若不存在则返回空指针。
+    //   找到的会话对象；若不存在或已过期则返回空指针。
     std::shared_ptr<Session> load(const std::string& sessionId) override;
 
     // 从内存中移除会话。
@@ -61,8 +95,58 @@ public:
     //   sessionId: 需要删除的会话 ID。
     void remove(const std::string& sessionId) override;
 
+    // 遍历全部分片清理过期会话。
+    size_t removeExpired() override;
+
+    // 当前会话数。
+    size_t size() const;
+
+    // 因超过上限被淘汰的累计会话数。
+    uint64_t evictedCount() const
+    {
+        return evicted_.load(std::memory_order_relaxed);
+    }
+
 private:
-    std::unordered_map<std::string, std::shared_ptr<Session>> sessions_;
+    using LruList = std::list<std::shared_ptr<Session>>;
+
+    struct Entry
+    {
+        LruList::iterator lru;
+        uint64_t token;  // 插入序号，时间轮据此识别同一会话被删除后重新插入的情况
+    };
+
+    struct Shard
+    {
+        explicit Shard(TimingWheel<Session>::ExpireCallback onExpire) : wheel(kWheelSlots, std::move(onExpire)) {}
+
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Entry> index;
+        LruList lru;  // 头部为最近访问
+        TimingWheel<Session> wheel;
+        uint64_t nextToken = 0;
+    };
+
+    static constexpr size_t kWheelSlots = 64;  // 1 s/格
+
+    Shard& shardFor(const std::string& sessionId);
+
+    // 时间轮到期回调，在持有分片锁时调用；返回仍需等待的秒数
+    int onExpire(Shard& shard, const std::shared_ptr<Session>& session, uint64_t token);
+
+    // 以下函数须持有分片锁
+    void eraseLocked(Shard& shard, std::unordered_map<std::string, Entry>::iterator it);
+
+    void expiryLoop();
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    size_t maxPerShard_;
+    std::atomic<uint64_t> evicted_{0};
+
+    std::thread expiryThread_;
+    std::mutex stopMutex_;
+    std::condition_variable stopCv_;
+    bool stopping_ = false;
 };
 
 }  // namespace session
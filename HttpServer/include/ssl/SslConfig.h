@@ -56,6 +56,16 @@ public:
     {
         sessionCacheSize_ = size;
     }
+    // 会话票据密钥轮换周期（秒）：当前密钥签发，上一把密钥仍可解密；0 表示关闭会话票据
+    void setTicketKeyRotation(int seconds)
+    {
+        ticketKeyRotation_ = seconds;
+    }
+    // 动态记录大小：空闲后先发小记录（单个 TCP 段可解密），累计发送一定量后切换为 16KB 记录
+    void setDynamicRecordSizing(bool on)
+    {
+        dynamicRecordSizing_ = on;
+    }
 
     // Getters
     const std::string& getCertificateFile() const
@@ -94,6 +104,14 @@ public:
     {
         return sessionCacheSize_;
     }
+    int getTicketKeyRotation() const
+    {
+        return ticketKeyRotation_;
+    }
+    bool getDynamicRecordSizing() const
+    {
+        return dynamicRecordSizing_;
+    }
 
 private:
     std::string certFile_;    // 证书文件
@@ -105,6 +123,8 @@ private:
     int verifyDepth_;         // 验证深度
     int sessionTimeout_;      // 会话超时时间
     long sessionCacheSize_;   // 会话缓存大小
+    int ticketKeyRotation_;   // 票据密钥轮换周期（秒）
+    bool dynamicRecordSizing_;  // 是否启用动态记录大小
 };
 
 }  // namespace ssl
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 #include <memory>
 #include <muduo/base/noncopyable.h>
 #include <muduo/net/Buffer.h>
@@ -59,9 +60,10 @@ public:
     /**
      * 处理接收到的网络数据
      * @param conn TCP连接指针
-     * @param buf 接收到的加密数据缓冲区
+     * @param buf 接收到的加密数据缓冲区，调用后被清空
      * @param time 数据接收时间戳
-     * 根据连接状态处理数据：握手阶段处理握手协议，已建立连接阶段解密数据
+     * 根据连接状态处理数据：握手阶段推进握手协议，已建立连接阶段把全部可读记录解密追加到
+     * getDecryptedBuffer()，上层未消费的数据保留到下次。设置了消息回调时以解密缓冲区回调
      */
     void onRead(const TcpConnectionPtr& conn, BufferPtr buf, muduo::Timestamp time);
 
@@ -76,7 +78,7 @@ public:
 
     /**
      * 获取解密后的数据缓冲区
-     * @return 指向解密缓冲区的指针，包含已解密的应用程序数据
+     * @return 指向解密缓冲区的指针，包含已解密、尚未被上层消费的应用程序数据
      */
     muduo::net::Buffer* getDecryptedBuffer()
     {
@@ -125,6 +127,17 @@ public:
     }
 
 private:
+    static constexpr size_t kReadChunkBytes = 16 * 1024;  ///< 单次 SSL_read 预留空间，等于 TLS 记录上限
+    static constexpr size_t kSmallRecordBytes = 1369;      ///< 小记录明文上限：加上记录开销后放得进一个 1460 字节的 TCP 段
+    static constexpr size_t kRecordBoostThreshold = 128 * 1024;  ///< 空闲后累计发送超过该值改用最大记录
+    static constexpr std::chrono::milliseconds kRecordIdleReset{1000};  ///< 空闲超过该时长回到小记录
+
+    /**
+     * 把写 BIO 中积累的密文一次性发送到底层连接
+     * 握手消息与 SSL_write 的输出都经由此处写出
+     */
+    void flushWriteBio();
+
     /**
      * 处理SSL握手过程
      * 执行SSL_do_handshake，处理握手状态转换和错误情况
@@ -174,6 +187,8 @@ private:
     muduo::net::Buffer writeBuffer_;      ///< 写缓冲区：存储要发送的加密数据
     muduo::net::Buffer decryptedBuffer_;  ///< 解密缓冲区：存储解密后的应用数据
     MessageCallback messageCallback_;     ///< 消息回调：处理解密后的应用层数据
+    size_t boostedBytes_ = 0;             ///< 本轮（空闲后）已加密发送的明文字节
+    std::chrono::steady_clock::time_point lastSendTime_;  ///< 上次发送时间，用于判断空闲
 };
 
 }  // namespace ssl
\ No newline at end of file
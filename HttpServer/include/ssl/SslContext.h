@@ -1,9 +1,12 @@
 #pragma once
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <muduo/base/noncopyable.h>
 #include <openssl/ssl.h>
 
 #include "SslConfig.h"
+#include "SslStats.h"
 
 namespace ssl
 {
@@ -20,15 +23,69 @@ public:
         return ctx_;
     }
 
+    const SslConfig& config() const
+    {
+        return config_;
+    }
+
+    // 握手与票据计数，由本上下文创建的所有连接共享
+    SslSessionStats& stats()
+    {
+        return stats_;
+    }
+    const SslSessionStats& stats() const
+    {
+        return stats_;
+    }
+
 private:
+    // 会话票据密钥：name 写入票据明文头部，用于解密时找回密钥
+    struct TicketKey
+    {
+        unsigned char name[16];
+        unsigned char aesKey[32];
+        unsigned char hmacKey[32];
+        int64_t createdSec;
+    };
+
     bool loadCertificates();
     bool setupProtocol();
     void setupSessionCache();
+    void setupSessionTickets();
     static void handleSslError(const char* msg);
 
+    // 生成一把新的票据密钥
+    static bool generateTicketKey(TicketKey* key, int64_t nowSec);
+
+    // 当前密钥满一个周期时轮换，调用方须持有 ticketMutex_。
+    // 返回值：生成密钥失败时返回 false（继续使用旧密钥）。
+    bool rotateTicketKeysLocked(int64_t nowSec);
+
+    // 取当前签发用的密钥，到期时先轮换。
+    // 返回值：生成密钥失败时返回 false。
+    bool currentTicketKey(TicketKey* out);
+
+    // 按名称查找可解密的密钥，到期时同样先轮换。
+    // 返回值：1 为当前密钥，2 为上一把密钥（票据需重新签发），0 为未找到。
+    int findTicketKey(const unsigned char* name, TicketKey* out);
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    static int ticketKeyCallback(SSL* ssl,
+                                 unsigned char* keyName,
+                                 unsigned char* iv,
+                                 EVP_CIPHER_CTX* cipherCtx,
+                                 EVP_MAC_CTX* macCtx,
+                                 int enc);
+#endif
+
 private:
     SSL_CTX* ctx_;      // SSL上下文
     SslConfig config_;  // SSL配置
+    SslSessionStats stats_;
+
+    std::mutex ticketMutex_;         // 多个 IO 线程并发握手时保护下面的密钥
+    TicketKey ticketKeys_[2]{};      // [0] 当前密钥，[1] 上一把密钥
+    bool hasPreviousKey_{false};
 };
 
-}  // namespace ssl
\ No newline at end of file
+}  // namespace ssl
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ssl
+{
+
+/**
+ * @brief TLS 握手与会话票据的累计计数，IO 线程并发递增，任意线程读取
+ *
+ * 会话复用率 = resumed / (full + resumed)。票据计数只反映票据本身的处理结果：
+ * 票据解密成功后仍可能因套件不符等原因退回完整握手。
+ */
+class SslSessionStats
+{
+public:
+    enum Handshake
+    {
+        kFull,     // 完整握手
+        kResumed,  // 会话复用（会话缓存或票据）
+        kFailed,   // 握手失败
+        kHandshakeCount,
+    };
+
+    enum Ticket
+    {
+        kIssued,      // 签发新票据
+        kDecrypted,   // 当前密钥解密成功
+        kRenewed,     // 旧密钥解密成功，随后以当前密钥重新签发
+        kUnknownKey,  // 密钥已轮换出窗口或并非本服务签发，退回完整握手
+        kTicketCount,
+    };
+
+    void countHandshake(Handshake kind)
+    {
+        handshakes_[kind].fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t handshakes(Handshake kind) const
+    {
+        return handshakes_[kind].load(std::memory_order_relaxed);
+    }
+
+    void countTicket(Ticket result)
+    {
+        tickets_[result].fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t tickets(Ticket result) const
+    {
+        return tickets_[result].load(std::memory_order_relaxed);
+    }
+
+    // 指标标签名，例如 "resumed"、"unknown_key"
+    static const char* name(Handshake kind)
+    {
+        static const char* const kNames[] = {"full", "resumed", "failed"};
+        return kNames[kind];
+    }
+    static const char* name(Ticket result)
+    {
+        static const char* const kNames[] = {"issued", "decrypted", "renewed", "unknown_key"};
+        return kNames[result];
+    }
+
+private:
+    std::atomic<uint64_t> handshakes_[kHandshakeCount]{};
+    std::atomic<uint64_t> tickets_[kTicketCount]{};
+};
+
+}  // namespace ssl
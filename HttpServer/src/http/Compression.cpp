@@ -0,0 +1,390 @@
+#include "http/Compression.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAS_BROTLI
+#include <brotli/encode.h>
+#endif
+
+namespace http
+{
+
+namespace
+{
+
+std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+    {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+    {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+#ifdef HAS_ZLIB
+// windowBits：15 为 zlib 封装（Content-Encoding: deflate），+16 为 gzip 封装
+int windowBits(ContentEncoding encoding, int bits)
+{
+    return encoding == ContentEncoding::kGzip ? bits + 16 : bits;
+}
+
+// 以 flush 方式压缩 in 并把输出追加到 out，直到 zlib 不再产生输出
+bool deflateAppend(z_stream* zs, std::string_view in, int flush, std::string* out)
+{
+    zs->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs->avail_in = static_cast<uInt>(in.size());
+    size_t chunk = deflateBound(zs, in.size()) + 16;
+    while (true)
+    {
+        size_t offset = out->size();
+        out->resize(offset + chunk);
+        zs->next_out = reinterpret_cast<Bytef*>(&(*out)[offset]);
+        zs->avail_out = static_cast<uInt>(chunk);
+        int rc = deflate(zs, flush);
+        out->resize(offset + chunk - zs->avail_out);
+        if (rc == Z_STREAM_END) return true;
+        if (rc != Z_OK && rc != Z_BUF_ERROR) return false;
+        if (zs->avail_out != 0) return zs->avail_in == 0;
+    }
+}
+#endif
+
+}  // namespace
+
+std::string_view contentEncodingName(ContentEncoding encoding)
+{
+    switch (encoding)
+    {
+        case ContentEncoding::kGzip:
+            return "gzip";
+        case ContentEncoding::kDeflate:
+            return "deflate";
+        case ContentEncoding::kBrotli:
+            return "br";
+        default:
+            return "";
+    }
+}
+
+bool compressionAvailable(ContentEncoding encoding)
+{
+    switch (encoding)
+    {
+        case ContentEncoding::kIdentity:
+            return true;
+        case ContentEncoding::kGzip:
+        case ContentEncoding::kDeflate:
+#ifdef HAS_ZLIB
+            return true;
+#else
+            return false;
+#endif
+        case ContentEncoding::kBrotli:
+#ifdef HAS_BROTLI
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+AcceptEncoding AcceptEncoding::parse(std::string_view header)
+{
+    // 先记为 -1 表示未出现，最后按 "*" 或缺省规则补齐
+    double identity = -1, gzip = -1, deflate = -1, br = -1, star = -1;
+    while (!header.empty())
+    {
+        size_t comma = header.find(',');
+        std::string_view item = trim(header.substr(0, comma));
+        header = comma == std::string_view::npos ? std::string_view() : header.substr(comma + 1);
+
+        double weight = 1.0;
+        size_t semi = item.find(';');
+        std::string_view name = trim(item.substr(0, semi));
+        if (semi != std::string_view::npos)
+        {
+            std::string_view param = trim(item.substr(semi + 1));
+            if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=')
+            {
+                weight = std::atof(std::string(param.substr(2)).c_str());
+            }
+        }
+        if (name == "br")
+            br = weight;
+        else if (name == "gzip" || name == "x-gzip")
+            gzip = weight;
+        else if (name == "deflate")
+            deflate = weight;
+        else if (name == "identity")
+            identity = weight;
+        else if (name == "*")
+            star = weight;
+    }
+
+    AcceptEncoding result;
+    double others = star >= 0 ? star : 0;
+    result.identity = identity >= 0 ? identity : (star >= 0 ? star : 1.0);
+    result.gzip = gzip >= 0 ? gzip : others;
+    result.deflate = deflate >= 0 ? deflate : others;
+    result.br = br >= 0 ? br : others;
+    return result;
+}
+
+double AcceptEncoding::q(ContentEncoding encoding) const
+{
+    switch (encoding)
+    {
+        case ContentEncoding::kGzip:
+            return gzip;
+        case ContentEncoding::kDeflate:
+            return deflate;
+        case ContentEncoding::kBrotli:
+            return br;
+        default:
+            return identity;
+    }
+}
+
+ContentEncoding negotiateEncoding(std::string_view acceptEncoding, bool allowBrotli)
+{
+    if (acceptEncoding.empty()) return ContentEncoding::kIdentity;
+    AcceptEncoding accept = AcceptEncoding::parse(acceptEncoding);
+    ContentEncoding best = ContentEncoding::kIdentity;
+    double bestQ = 0;
+    const ContentEncoding order[] = {ContentEncoding::kBrotli, ContentEncoding::kGzip, ContentEncoding::kDeflate,
+                                     ContentEncoding::kIdentity};
+    for (ContentEncoding enc : order)
+    {
+        if (enc == ContentEncoding::kBrotli && !allowBrotli) continue;
+        if (compressionAvailable(enc) && accept.q(enc) > bestQ)
+        {
+            best = enc;
+            bestQ = accept.q(enc);
+        }
+    }
+    return best;
+}
+
+bool CompressionOptions::compressible(std::string_view contentType) const
+{
+    for (const auto& prefix : contentTypes)
+    {
+        if (contentType.compare(0, prefix.size(), prefix) == 0) return true;
+    }
+    return false;
+}
+
+// ─── Compressor ──────────────────────────────────────────────────────
+
+struct Compressor::State
+{
+#ifdef HAS_ZLIB
+    struct Stream
+    {
+        z_stream zs;
+        bool initialized = false;
+        int level = 0;
+    };
+    Stream gzip;
+    Stream deflate;
+#endif
+};
+
+Compressor::Compressor() : state_(new State) {}
+
+Compressor::~Compressor()
+{
+#ifdef HAS_ZLIB
+    if (state_->gzip.initialized) deflateEnd(&state_->gzip.zs);
+    if (state_->deflate.initialized) deflateEnd(&state_->deflate.zs);
+#endif
+}
+
+bool Compressor::compress(ContentEncoding encoding, int level, std::string_view in, std::string* out)
+{
+    out->clear();
+    switch (encoding)
+    {
+#ifdef HAS_ZLIB
+        case ContentEncoding::kGzip:
+        case ContentEncoding::kDeflate:
+        {
+            State::Stream& s = encoding == ContentEncoding::kGzip ? state_->gzip : state_->deflate;
+            if (!s.initialized)
+            {
+                std::memset(&s.zs, 0, sizeof s.zs);
+                if (deflateInit2(&s.zs, level, Z_DEFLATED, windowBits(encoding, 15), 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                {
+                    return false;
+                }
+                s.initialized = true;
+                s.level = level;
+            }
+            else
+            {
+                deflateReset(&s.zs);
+                if (s.level != level && deflateParams(&s.zs, level, Z_DEFAULT_STRATEGY) == Z_OK) s.level = level;
+            }
+            // 一次 Z_FINISH 即可：输出缓冲按 deflateBound 预留
+            out->resize(deflateBound(&s.zs, in.size()));
+            s.zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+            s.zs.avail_in = static_cast<uInt>(in.size());
+            s.zs.next_out = reinterpret_cast<Bytef*>(&(*out)[0]);
+            s.zs.avail_out = static_cast<uInt>(out->size());
+            int rc = deflate(&s.zs, Z_FINISH);
+            out->resize(s.zs.total_out);
+            return rc == Z_STREAM_END;
+        }
+#endif
+#ifdef HAS_BROTLI
+        case ContentEncoding::kBrotli:
+        {
+            size_t size = BrotliEncoderMaxCompressedSize(in.size());
+            if (size == 0) return false;
+            out->resize(size);
+            if (!BrotliEncoderCompress(level, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, in.size(),
+                                       reinterpret_cast<const uint8_t*>(in.data()), &size,
+                                       reinterpret_cast<uint8_t*>(&(*out)[0])))
+            {
+                return false;
+            }
+            out->resize(size);
+            return true;
+        }
+#endif
+        default:
+            return false;
+    }
+}
+
+Compressor& Compressor::threadLocal()
+{
+    static thread_local Compressor compressor;
+    return compressor;
+}
+
+// ─── StreamCompressor ────────────────────────────────────────────────
+
+struct StreamCompressor::State
+{
+#ifdef HAS_ZLIB
+    z_stream zs;
+#endif
+#ifdef HAS_BROTLI
+    BrotliEncoderState* br = nullptr;
+#endif
+    bool ok = false;
+};
+
+StreamCompressor::StreamCompressor(ContentEncoding encoding, int level) : encoding_(encoding), state_(new State)
+{
+    switch (encoding)
+    {
+#ifdef HAS_ZLIB
+        case ContentEncoding::kGzip:
+        case ContentEncoding::kDeflate:
+            std::memset(&state_->zs, 0, sizeof state_->zs);
+            // 4 KiB 窗口 + memLevel 5：每流约 32 KiB
+            state_->ok = deflateInit2(&state_->zs, level, Z_DEFLATED, windowBits(encoding, 12), 5,
+                                      Z_DEFAULT_STRATEGY) == Z_OK;
+            break;
+#endif
+#ifdef HAS_BROTLI
+        case ContentEncoding::kBrotli:
+            state_->br = BrotliEncoderCreateInstance(nullptr, nullptr, nullptr);
+            if (state_->br)
+            {
+                BrotliEncoderSetParameter(state_->br, BROTLI_PARAM_QUALITY, static_cast<uint32_t>(level));
+                BrotliEncoderSetParameter(state_->br, BROTLI_PARAM_LGWIN, 16);
+                BrotliEncoderSetParameter(state_->br, BROTLI_PARAM_MODE, BROTLI_MODE_TEXT);
+                state_->ok = true;
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+StreamCompressor::~StreamCompressor()
+{
+    if (!state_->ok) return;
+#ifdef HAS_ZLIB
+    if (encoding_ == ContentEncoding::kGzip || encoding_ == ContentEncoding::kDeflate) deflateEnd(&state_->zs);
+#endif
+#ifdef HAS_BROTLI
+    if (encoding_ == ContentEncoding::kBrotli) BrotliEncoderDestroyInstance(state_->br);
+#endif
+}
+
+bool StreamCompressor::ok() const
+{
+    return state_->ok;
+}
+
+#ifdef HAS_BROTLI
+namespace
+{
+
+bool brotliAppend(BrotliEncoderState* br, std::string_view in, BrotliEncoderOperation op, std::string* out)
+{
+    size_t availIn = in.size();
+    const uint8_t* nextIn = reinterpret_cast<const uint8_t*>(in.data());
+    do
+    {
+        size_t availOut = 0;
+        if (!BrotliEncoderCompressStream(br, op, &availIn, &nextIn, &availOut, nullptr, nullptr)) return false;
+        size_t size = 0;
+        const uint8_t* data = BrotliEncoderTakeOutput(br, &size);
+        out->append(reinterpret_cast<const char*>(data), size);
+    } while (availIn > 0 || BrotliEncoderHasMoreOutput(br) ||
+             (op == BROTLI_OPERATION_FINISH && !BrotliEncoderIsFinished(br)));
+    return true;
+}
+
+}  // namespace
+#endif
+
+bool StreamCompressor::write(std::string_view in, std::string* out)
+{
+    if (!state_->ok) return false;
+#ifdef HAS_ZLIB
+    if (encoding_ == ContentEncoding::kGzip || encoding_ == ContentEncoding::kDeflate)
+    {
+        return deflateAppend(&state_->zs, in, Z_SYNC_FLUSH, out);
+    }
+#endif
+#ifdef HAS_BROTLI
+    if (encoding_ == ContentEncoding::kBrotli) return brotliAppend(state_->br, in, BROTLI_OPERATION_FLUSH, out);
+#endif
+    return false;
+}
+
+bool StreamCompressor::finish(std::string* out)
+{
+    if (!state_->ok) return false;
+#ifdef HAS_ZLIB
+    if (encoding_ == ContentEncoding::kGzip || encoding_ == ContentEncoding::kDeflate)
+    {
+        return deflateAppend(&state_->zs, std::string_view(), Z_FINISH, out);
+    }
+#endif
+#ifdef HAS_BROTLI
+    if (encoding_ == ContentEncoding::kBrotli)
+    {
+        return brotliAppend(state_->br, std::string_view(), BROTLI_OPERATION_FINISH, out);
+    }
+#endif
+    return false;
+}
+
+}  // namespace http
@@ -0,0 +1,317 @@
+#include "http/FileBody.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <muduo/net/Buffer.h>
+#include <muduo/net/EventLoop.h>
+
+#include "Logging/Logger.h"
+#include "ssl/SslConnection.h"
+
+namespace http
+{
+
+namespace
+{
+
+// 解析十进制非负整数，整个字符串都必须是数字
+bool parseUint(std::string_view s, uint64_t* out)
+{
+    if (s.empty() || s.size() > 19)
+    {
+        return false;
+    }
+    uint64_t v = 0;
+    for (char c : s)
+    {
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        v = v * 10 + static_cast<uint64_t>(c - '0');
+    }
+    *out = v;
+    return true;
+}
+
+// 比较两个 socket 地址（仅 IPv4 / IPv6 的地址与端口）
+bool sameAddress(const struct sockaddr* a, const struct sockaddr* b)
+{
+    if (a->sa_family != b->sa_family)
+    {
+        return false;
+    }
+    if (a->sa_family == AF_INET)
+    {
+        auto* x = reinterpret_cast<const struct sockaddr_in*>(a);
+        auto* y = reinterpret_cast<const struct sockaddr_in*>(b);
+        return x->sin_port == y->sin_port && x->sin_addr.s_addr == y->sin_addr.s_addr;
+    }
+    if (a->sa_family == AF_INET6)
+    {
+        auto* x = reinterpret_cast<const struct sockaddr_in6*>(a);
+        auto* y = reinterpret_cast<const struct sockaddr_in6*>(b);
+        return x->sin6_port == y->sin6_port && std::memcmp(&x->sin6_addr, &y->sin6_addr, sizeof x->sin6_addr) == 0;
+    }
+    return false;
+}
+
+// 一次文件发送的进度，由连接的 WriteCompleteCallback 持有
+struct FileTransfer
+{
+    std::shared_ptr<const FileBody> body;
+    uint64_t offset;
+    uint64_t remaining;
+    int socketFd;
+    ssl::SslConnection* sslConn;
+    FileSender::CompleteCallback onComplete;
+    std::unique_ptr<char[]> chunk;  // 拷贝路径的分段缓冲，首次用到时分配
+};
+
+// pread 一个有界分段并交给连接（SSL 时先加密）。
+// 返回值：读取失败或文件被截断时返回 false。
+bool sendChunk(FileTransfer* t, const muduo::net::TcpConnectionPtr& conn)
+{
+    if (!t->chunk)
+    {
+        t->chunk.reset(new char[FileSender::kChunkBytes]);
+    }
+    size_t want = static_cast<size_t>(std::min<uint64_t>(t->remaining, FileSender::kChunkBytes));
+    ssize_t n = ::pread(t->body->fd(), t->chunk.get(), want, static_cast<off_t>(t->offset));
+    if (n <= 0)
+    {
+        return false;
+    }
+    if (t->sslConn)
+    {
+        t->sslConn->send(t->chunk.get(), static_cast<size_t>(n));
+    }
+    else
+    {
+        conn->send(t->chunk.get(), static_cast<int>(n));
+    }
+    t->offset += static_cast<uint64_t>(n);
+    t->remaining -= static_cast<uint64_t>(n);
+    return true;
+}
+
+// t 按值传入：完成时会清除持有它的 WriteCompleteCallback
+void pump(std::shared_ptr<FileTransfer> t, const muduo::net::TcpConnectionPtr& conn)
+{
+    if (!conn->connected() || !t->onComplete)
+    {
+        return;
+    }
+    size_t budget = FileSender::kPumpBudgetBytes;
+    while (t->remaining > 0)
+    {
+        if (conn->outputBuffer()->readableBytes() > 0)
+        {
+            return;  // 等待输出缓冲区清空后的 WriteCompleteCallback
+        }
+        if (budget == 0)
+        {
+            // 让出 IO 线程，下一轮事件循环继续
+            conn->getLoop()->queueInLoop([t, conn]() { pump(t, conn); });
+            return;
+        }
+        uint64_t before = t->remaining;
+        if (t->socketFd >= 0 && !t->sslConn)
+        {
+            off_t off = static_cast<off_t>(t->offset);
+            size_t want = static_cast<size_t>(std::min<uint64_t>(t->remaining, budget));
+            ssize_t n = ::sendfile(t->socketFd, t->body->fd(), &off, want);
+            if (n > 0)
+            {
+                t->offset += static_cast<uint64_t>(n);
+                t->remaining -= static_cast<uint64_t>(n);
+                budget -= std::min(budget, static_cast<size_t>(n));
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+            {
+                SPDLOG_WARN_TAG("HTTP") << "[FileSender] sendfile failed: "
+                                        << (n == 0 ? "file truncated" : strerror(errno));
+                conn->forceClose();
+                return;
+            }
+            // socket 已写满：补发一个分段进输出缓冲区，由 muduo 关注 EPOLLOUT 并在清空后回调
+        }
+        if (!sendChunk(t.get(), conn))
+        {
+            SPDLOG_WARN_TAG("HTTP") << "[FileSender] read failed at offset " << t->offset;
+            conn->forceClose();
+            return;
+        }
+        budget -= std::min(budget, static_cast<size_t>(before - t->remaining));
+    }
+
+    conn->setWriteCompleteCallback(muduo::net::WriteCompleteCallback());
+    FileSender::CompleteCallback done = std::move(t->onComplete);
+    t->onComplete = nullptr;
+    done(conn);
+}
+
+}  // namespace
+
+std::shared_ptr<FileBody> FileBody::open(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        ::close(fd);
+        return nullptr;
+    }
+    return std::shared_ptr<FileBody>(new FileBody(fd, static_cast<uint64_t>(st.st_size), st.st_mtime));
+}
+
+FileBody::FileBody(int fd, uint64_t fileSize, time_t mtime)
+    : fd_(fd), fileSize_(fileSize), mtime_(mtime), offset_(0), length_(fileSize)
+{
+}
+
+FileBody::~FileBody()
+{
+    ::close(fd_);
+}
+
+ByteRangeResult parseByteRange(std::string_view header, uint64_t fileSize, uint64_t* offset, uint64_t* length)
+{
+    constexpr std::string_view kPrefix = "bytes=";
+    if (header.size() <= kPrefix.size() || header.substr(0, kPrefix.size()) != kPrefix ||
+        header.find(',') != std::string_view::npos)
+    {
+        return ByteRangeResult::kNone;  // 多区间（multipart/byteranges）不支持，按完整响应处理
+    }
+    std::string_view spec = header.substr(kPrefix.size());
+    size_t dash = spec.find('-');
+    if (dash == std::string_view::npos)
+    {
+        return ByteRangeResult::kNone;
+    }
+    std::string_view first = spec.substr(0, dash);
+    std::string_view last = spec.substr(dash + 1);
+
+    uint64_t start = 0;
+    uint64_t end = 0;
+    if (first.empty())
+    {
+        // 后缀区间：最后 n 字节
+        uint64_t suffix = 0;
+        if (!parseUint(last, &suffix))
+        {
+            return ByteRangeResult::kNone;
+        }
+        if (suffix == 0 || fileSize == 0)
+        {
+            return ByteRangeResult::kUnsatisfiable;
+        }
+        start = fileSize - std::min(suffix, fileSize);
+        end = fileSize - 1;
+    }
+    else
+    {
+        if (!parseUint(first, &start))
+        {
+            return ByteRangeResult::kNone;
+        }
+        if (last.empty())
+        {
+            end = fileSize == 0 ? 0 : fileSize - 1;
+        }
+        else if (!parseUint(last, &end) || end < start)
+        {
+            return ByteRangeResult::kNone;
+        }
+        if (start >= fileSize)
+        {
+            return ByteRangeResult::kUnsatisfiable;
+        }
+        end = std::min(end, fileSize - 1);
+    }
+    *offset = start;
+    *length = end - start + 1;
+    return ByteRangeResult::kSatisfiable;
+}
+
+void FileSender::start(const muduo::net::TcpConnectionPtr& conn,
+                       std::shared_ptr<const FileBody> body,
+                       int socketFd,
+                       ssl::SslConnection* sslConn,
+                       CompleteCallback onComplete)
+{
+    auto t = std::make_shared<FileTransfer>();
+    t->offset = body->offset();
+    t->remaining = body->length();
+    t->body = std::move(body);
+    t->socketFd = socketFd;
+    t->sslConn = sslConn;
+    t->onComplete = std::move(onComplete);
+    // 回调只捕获进度对象，不捕获连接本身，避免 conn → callback → conn 的引用环
+    conn->setWriteCompleteCallback([t](const muduo::net::TcpConnectionPtr& c) { pump(t, c); });
+    pump(t, conn);
+}
+
+int FileSender::resolveSocketFd(const muduo::net::TcpConnectionPtr& conn)
+{
+    DIR* dir = ::opendir("/proc/self/fd");
+    if (!dir)
+    {
+        return -1;
+    }
+    const struct sockaddr* local = conn->localAddress().getSockAddr();
+    const struct sockaddr* peer = conn->peerAddress().getSockAddr();
+    int found = -1;
+    while (struct dirent* ent = ::readdir(dir))
+    {
+        char* end = nullptr;
+        long fd = std::strtol(ent->d_name, &end, 10);
+        if (end == ent->d_name || *end != '\0' || fd == ::dirfd(dir))
+        {
+            continue;
+        }
+        struct stat st;
+        if (::fstat(static_cast<int>(fd), &st) != 0 || !S_ISSOCK(st.st_mode))
+        {
+            continue;
+        }
+        struct sockaddr_storage addr;
+        socklen_t len = sizeof addr;
+        if (::getpeername(static_cast<int>(fd), reinterpret_cast<struct sockaddr*>(&addr), &len) != 0 ||
+            !sameAddress(reinterpret_cast<struct sockaddr*>(&addr), peer))
+        {
+            continue;
+        }
+        len = sizeof addr;
+        if (::getsockname(static_cast<int>(fd), reinterpret_cast<struct sockaddr*>(&addr), &len) == 0 &&
+            sameAddress(reinterpret_cast<struct sockaddr*>(&addr), local))
+        {
+            found = static_cast<int>(fd);
+            break;
+        }
+    }
+    ::closedir(dir);
+    return found;
+}
+
+}  // namespace http
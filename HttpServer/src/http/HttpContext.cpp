@@ -1,12 +1,103 @@
 #include "../../include/http/HttpContext.h"
 
+#include <algorithm>
+
 using namespace muduo;
 using namespace muduo::net;
 
 namespace http
 {
 
+const ConnectionLimits HttpContext::kDefaultLimits;
+
+namespace
+{
+
+// 解析十进制 Content-Length，不抛异常（std::stoi 遇到非法输入会抛出）。
+bool parseContentLength(std::string_view value, uint64_t* out)
+{
+    if (value.empty() || value.size() > 19)
+    {
+        return false;
+    }
+    uint64_t n = 0;
+    for (char c : value)
+    {
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        n = n * 10 + static_cast<uint64_t>(c - '0');
+    }
+    *out = n;
+    return true;
+}
+
+// 解析 chunk 长度行："1a3f[;ext=val]"，忽略 chunk 扩展。
+bool parseChunkSize(const char* begin, const char* end, uint64_t* out)
+{
+    uint64_t n = 0;
+    int digits = 0;
+    const char* p = begin;
+    for (; p < end; ++p)
+    {
+        char c = *p;
+        int v;
+        if (c >= '0' && c <= '9')
+        {
+            v = c - '0';
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            v = c - 'a' + 10;
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            v = c - 'A' + 10;
+        }
+        else
+        {
+            break;
+        }
+        if (++digits > 15)  // 防溢出，单个 chunk 不可能超过 2^60
+        {
+            return false;
+        }
+        n = (n << 4) | static_cast<uint64_t>(v);
+    }
+    while (p < end && (*p == ' ' || *p == '\t'))
+    {
+        ++p;
+    }
+    if (digits == 0 || (p != end && *p != ';'))
+    {
+        return false;
+    }
+    *out = n;
+    return true;
+}
+
+// Transfer-Encoding 的最后一个编码是否为 chunked（大小写不敏感）。
+bool isChunked(std::string_view te)
+{
+    while (!te.empty() && (te.back() == ' ' || te.back() == '\t'))
+    {
+        te.remove_suffix(1);
+    }
+    size_t comma = te.rfind(',');
+    std::string_view last = comma == std::string_view::npos ? te : te.substr(comma + 1);
+    while (!last.empty() && (last.front() == ' ' || last.front() == '\t'))
+    {
+        last.remove_prefix(1);
+    }
+    return http::headerNameEquals(last, "chunked");
+}
+
+}  // namespace
+
 // 将报文解析出来将关键信息封装到HttpRequest对象里面去
+// 请求行与每个请求头各拷贝一次进 arena（Buffer 在 retrieve 后会被复用，不能直接引用），
+// 之后的方法/路径/头字段全部是 arena 上的 view；请求体边收边追加到 body_，完成后整体移动进请求。
 bool HttpContext::parseRequest(Buffer* buf, Timestamp receiveTime)
 {
     bool ok = true;  // 解析每行请求格式是否正确
@@ -16,9 +107,17 @@ bool HttpContext::parseRequest(Buffer* buf, Timestamp receiveTime)
         if (state_ == kExpectRequestLine)
         {
             const char* crlf = buf->findCRLF();  // 注意这个返回值边界可能有错
-            if (crlf)
+            size_t maxLine = limits_->maxRequestLineBytes;
+            size_t lineBytes = crlf ? static_cast<size_t>(crlf - buf->peek()) : buf->readableBytes();
+            if (maxLine > 0 && lineBytes > maxLine)
+            {
+                ok = fail(kRequestLineTooLong);  // 没等到 CRLF 就已超限也立即拒绝，不再继续攒数据
+                hasMore = false;
+            }
+            else if (crlf)
             {
-                ok = processRequestLine(buf->peek(), crlf);
+                std::string_view line = arena_.copy(buf->peek(), static_cast<size_t>(crlf - buf->peek()));
+                ok = processRequestLine(line.data(), line.data() + line.size());
                 if (ok)
                 {
                     request_.setReceiveTime(receiveTime);
@@ -38,46 +137,33 @@ bool HttpContext::parseRequest(Buffer* buf, Timestamp receiveTime)
         else if (state_ == kExpectHeaders)
         {
             const char* crlf = buf->findCRLF();
-            if (crlf)
+            size_t maxHeader = limits_->maxHeaderBytes;
+            size_t lineBytes = crlf ? static_cast<size_t>(crlf - buf->peek()) + 2 : buf->readableBytes();
+            if (maxHeader > 0 && headerBytes_ + lineBytes > maxHeader)
+            {
+                ok = fail(kHeaderTooLarge);
+                hasMore = false;
+            }
+            else if (crlf)
             {
+                headerBytes_ += lineBytes;
                 const char* colon = std::find(buf->peek(), crlf, ':');
-                if (colon < crlf)
+                size_t maxCount = limits_->maxHeaderCount;
+                if (colon < crlf && maxCount > 0 && request_.headers().size() >= maxCount)
+                {
+                    ok = fail(kTooManyHeaders);
+                    hasMore = false;
+                }
+                else if (colon < crlf)
                 {
-                    request_.addHeader(buf->peek(), colon, crlf);
+                    std::string_view line = arena_.copy(buf->peek(), static_cast<size_t>(crlf - buf->peek()));
+                    request_.addHeader(line.data(), line.data() + (colon - buf->peek()), line.data() + line.size());
                 }
                 else if (buf->peek() == crlf)
                 {
                     // 空行，结束Header
-                    // 根据请求方法和Content-Length判断是否需要继续读取body
-                    if (request_.method() == HttpRequest::kPost || request_.method() == HttpRequest::kPut)
-                    {
-                        std::string contentLength = request_.getHeader("Content-Length");
-                        if (!contentLength.empty())
-                        {
-                            request_.setContentLength(std::stoi(contentLength));
-                            if (request_.contentLength() > 0)
-                            {
-                                state_ = kExpectBody;
-                            }
-                            else
-                            {
-                                state_ = kGotAll;
-                                hasMore = false;
-                            }
-                        }
-                        else
-                        {
-                            // POST/PUT 请求没有 Content-Length，是HTTP语法错误
-                            ok = false;
-                            hasMore = false;
-                        }
-                    }
-                    else
-                    {
-                        // GET/HEAD/DELETE 等方法直接完成（没有请求体）
-                        state_ = kGotAll;
-                        hasMore = false;
-                    }
+                    ok = onHeadersComplete();
+                    hasMore = ok && state_ != kGotAll;
                 }
                 else
                 {
@@ -93,25 +179,168 @@ bool HttpContext::parseRequest(Buffer* buf, Timestamp receiveTime)
         }
         else if (state_ == kExpectBody)
         {
-            // 检查缓冲区中是否有足够的数据
-            if (buf->readableBytes() < request_.contentLength())
+            // 边收边拷贝：请求体不必在 Buffer 中攒齐，body_ 预先 reserve 到 Content-Length，只拷贝一次
+            size_t remaining = static_cast<size_t>(request_.contentLength()) - body_.size();
+            size_t n = std::min(remaining, buf->readableBytes());
+            body_.append(buf->peek(), n);
+            buf->retrieve(n);
+
+            if (body_.size() < request_.contentLength())
             {
-                hasMore = false;  // 数据不完整，等待更多数据
-                return true;
+                return true;  // 数据不完整，等待更多数据
             }
 
-            // 只读取 Content-Length 指定的长度
-            std::string body(buf->peek(), buf->peek() + request_.contentLength());
-            request_.setBody(body);
+            request_.setBody(std::move(body_));
+            body_ = std::string();
+            state_ = kGotAll;
+            hasMore = false;
+        }
+        else if (state_ >= kExpectChunkSize && state_ <= kExpectTrailers)
+        {
+            ok = parseChunked(buf, &hasMore);
+            if (!ok)
+            {
+                hasMore = false;
+            }
+        }
+        else
+        {
+            hasMore = false;
+        }
+    }
+    if (!ok && error_ == kNoError)
+    {
+        error_ = kBadRequest;
+    }
+    return ok;  // ok为false代表报文语法解析错误，原因见 error()
+}
+
+bool HttpContext::onHeadersComplete()
+{
+    // 根据请求方法和Content-Length判断是否需要继续读取body
+    std::string_view contentLength = request_.headerView("Content-Length");
+    std::string_view transferEncoding = request_.headerView("Transfer-Encoding");
+    if (!transferEncoding.empty())
+    {
+        // 同时出现 Content-Length 与 Transfer-Encoding 是请求走私的典型手法，直接拒绝；
+        // 除 chunked 以外的传输编码不支持
+        if (!contentLength.empty() || !isChunked(transferEncoding))
+        {
+            return false;
+        }
+        state_ = kExpectChunkSize;
+        return true;
+    }
 
-            // 准确移动读指针
-            buf->retrieve(request_.contentLength());
+    if (request_.method() == HttpRequest::kPost || request_.method() == HttpRequest::kPut)
+    {
+        if (contentLength.empty())
+        {
+            // POST/PUT 既没有 Content-Length 也不是 chunked，无法确定请求体边界
+            return false;
+        }
+    }
+    else if (contentLength.empty())
+    {
+        // GET/HEAD/DELETE 等方法直接完成（没有请求体）
+        state_ = kGotAll;
+        return true;
+    }
 
+    uint64_t length = 0;
+    if (!parseContentLength(contentLength, &length))
+    {
+        return false;
+    }
+    if (limits_->maxBodyBytes > 0 && length > limits_->maxBodyBytes)
+    {
+        return fail(kBodyTooLarge);
+    }
+    request_.setContentLength(length);
+    if (length > 0)
+    {
+        // 预留上限防止伪造的超大 Content-Length 直接触发大块分配
+        constexpr uint64_t kMaxBodyReserve = 1024 * 1024;
+        body_.reserve(static_cast<size_t>(std::min(length, kMaxBodyReserve)));
+        state_ = kExpectBody;
+    }
+    else
+    {
+        state_ = kGotAll;
+    }
+    return true;
+}
+
+bool HttpContext::parseChunked(Buffer* buf, bool* hasMore)
+{
+    if (state_ == kExpectChunkSize)
+    {
+        const char* crlf = buf->findCRLF();
+        if (!crlf)
+        {
+            *hasMore = false;
+            return true;
+        }
+        uint64_t size = 0;
+        if (!parseChunkSize(buf->peek(), crlf, &size))
+        {
+            return false;
+        }
+        if (limits_->maxBodyBytes > 0 && size > limits_->maxBodyBytes - body_.size())
+        {
+            return fail(kBodyTooLarge);
+        }
+        buf->retrieveUntil(crlf + 2);
+        chunkRemaining_ = size;
+        state_ = size > 0 ? kExpectChunkData : kExpectTrailers;
+    }
+    else if (state_ == kExpectChunkData)
+    {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(chunkRemaining_, buf->readableBytes()));
+        body_.append(buf->peek(), n);
+        buf->retrieve(n);
+        chunkRemaining_ -= n;
+        if (chunkRemaining_ > 0)
+        {
+            *hasMore = false;  // 等待本 chunk 剩余数据
+            return true;
+        }
+        state_ = kExpectChunkCRLF;
+    }
+    else if (state_ == kExpectChunkCRLF)
+    {
+        if (buf->readableBytes() < 2)
+        {
+            *hasMore = false;
+            return true;
+        }
+        if (buf->peek()[0] != '\r' || buf->peek()[1] != '\n')
+        {
+            return false;
+        }
+        buf->retrieve(2);
+        state_ = kExpectChunkSize;
+    }
+    else  // kExpectTrailers：trailer 字段直接丢弃，遇到空行结束
+    {
+        const char* crlf = buf->findCRLF();
+        if (!crlf)
+        {
+            *hasMore = false;
+            return true;
+        }
+        bool last = (crlf == buf->peek());
+        buf->retrieveUntil(crlf + 2);
+        if (last)
+        {
+            request_.setContentLength(body_.size());
+            request_.setBody(std::move(body_));
+            body_ = std::string();
             state_ = kGotAll;
-            hasMore = false;
+            *hasMore = false;
         }
     }
-    return ok;  // ok为false代表报文语法解析错误
+    return true;
 }
 
 // 解析请求行
@@ -0,0 +1,121 @@
+#include "http/HttpHeaders.h"
+
+#include "http/HttpRequest.h"
+
+namespace http
+{
+
+void ResponseHeaders::set(std::string_view name, std::string_view value)
+{
+    size_t i = indexOf(name);
+    if (i < size())
+    {
+        // 原位替换值，其后字段整体平移
+        Slot& field = slot(i);
+        size_t valueOffset = field.offset + field.nameLen + 2;
+        encoded_.replace(valueOffset, field.valueLen, value.data(), value.size());
+        int64_t delta = static_cast<int64_t>(value.size()) - static_cast<int64_t>(field.valueLen);
+        field.valueLen = static_cast<uint32_t>(value.size());
+        for (size_t j = i + 1; j < size(); ++j)
+        {
+            slot(j).offset = static_cast<uint32_t>(slot(j).offset + delta);
+        }
+        return;
+    }
+
+    Slot field{static_cast<uint32_t>(encoded_.size()), static_cast<uint32_t>(name.size()),
+               static_cast<uint32_t>(value.size())};
+    encoded_.append(name.data(), name.size());
+    encoded_.append(": ", 2);
+    encoded_.append(value.data(), value.size());
+    encoded_.append("\r\n", 2);
+    if (inlineSize_ < kInlineCapacity)
+    {
+        inline_[inlineSize_++] = field;
+    }
+    else
+    {
+        overflow_.push_back(field);
+    }
+}
+
+bool ResponseHeaders::erase(std::string_view name)
+{
+    size_t i = indexOf(name);
+    size_t n = size();
+    if (i == n)
+    {
+        return false;
+    }
+    const Slot removed = slot(i);
+    size_t lineSize = removed.nameLen + removed.valueLen + 4;  // ": " + "\r\n"
+    encoded_.erase(removed.offset, lineSize);
+    // 后续字段前移一位，保持"内联区未满则溢出区为空"以维持插入顺序
+    for (size_t j = i + 1; j < n; ++j)
+    {
+        Slot moved = slot(j);
+        moved.offset = static_cast<uint32_t>(moved.offset - lineSize);
+        slot(j - 1) = moved;
+    }
+    if (overflow_.empty())
+    {
+        --inlineSize_;
+    }
+    else
+    {
+        overflow_.pop_back();
+    }
+    return true;
+}
+
+std::optional<std::string_view> ResponseHeaders::find(std::string_view name) const
+{
+    size_t i = indexOf(name);
+    if (i == size())
+    {
+        return std::nullopt;
+    }
+    return (*this)[i].value;
+}
+
+ResponseHeaders::Field ResponseHeaders::operator[](size_t i) const
+{
+    const Slot& field = slot(i);
+    std::string_view line(encoded_);
+    return Field{line.substr(field.offset, field.nameLen), line.substr(field.offset + field.nameLen + 2, field.valueLen)};
+}
+
+size_t ResponseHeaders::indexOf(std::string_view name) const
+{
+    size_t n = size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Slot& field = slot(i);
+        if (headerNameEquals(std::string_view(encoded_).substr(field.offset, field.nameLen), name))
+        {
+            return i;
+        }
+    }
+    return n;
+}
+
+HeaderTemplate::HeaderTemplate(std::initializer_list<std::pair<std::string_view, std::string_view>> fields)
+{
+    for (const auto& field : fields)
+    {
+        add(field.first, field.second);
+    }
+}
+
+HeaderTemplate& HeaderTemplate::add(std::string_view name, std::string_view value)
+{
+    std::string block = block_ ? *block_ : std::string();
+    block.append(name.data(), name.size());
+    block.append(": ", 2);
+    block.append(value.data(), value.size());
+    block.append("\r\n", 2);
+    block_ = std::make_shared<const std::string>(std::move(block));
+    return *this;
+}
+
+}  // namespace http
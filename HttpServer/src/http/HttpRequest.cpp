@@ -5,38 +5,100 @@
 namespace http
 {
 
-void HttpRequest::setReceiveTime(muduo::Timestamp t)
+namespace
 {
-    receiveTime_ = t;
+
+inline char toLowerAscii(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
 }
 
-bool HttpRequest::setMethod(const char* start, const char* end)
+inline bool isHeaderSpace(char c)
 {
-    assert(method_ == kInvalid);
-    std::string m(start, end);  // [start, end)
-    if (m == "GET")
-    {
-        method_ = kGet;
-    }
-    else if (m == "POST")
-    {
-        method_ = kPost;
-    }
-    else if (m == "PUT")
-    {
-        method_ = kPut;
-    }
-    else if (m == "DELETE")
+    return c == ' ' || c == '\t';
+}
+
+}  // namespace
+
+bool headerNameEquals(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size())
     {
-        method_ = kDelete;
+        return false;
     }
-    else if (m == "OPTIONS")
+    for (size_t i = 0; i < a.size(); ++i)
     {
-        method_ = kOptions;
+        if (toLowerAscii(a[i]) != toLowerAscii(b[i]))
+        {
+            return false;
+        }
     }
-    else
+    return true;
+}
+
+void HttpRequest::clear()
+{
+    method_ = kInvalid;
+    version_ = "Unknown";
+    path_ = std::string_view();
+    query_ = std::string_view();
+    pathParameters_.clear();
+    pathParams_.clear();
+    receiveTime_ = muduo::Timestamp();
+    headers_.clear();
+    extraHeaders_.clear();
+    content_.clear();
+    contentLength_ = 0;
+    authUserId_ = 0;
+    authRole_.clear();
+}
+
+void HttpRequest::setReceiveTime(muduo::Timestamp t)
+{
+    receiveTime_ = t;
+}
+
+bool HttpRequest::setMethod(const char* start, const char* end)
+{
+    assert(method_ == kInvalid);
+    // 按长度分派后逐字节比较，不构造临时 std::string
+    std::string_view m(start, static_cast<size_t>(end - start));
+    switch (m.size())
     {
-        method_ = kInvalid;
+        case 3:
+            if (m == "GET")
+            {
+                method_ = kGet;
+            }
+            else if (m == "PUT")
+            {
+                method_ = kPut;
+            }
+            break;
+        case 4:
+            if (m == "POST")
+            {
+                method_ = kPost;
+            }
+            else if (m == "HEAD")
+            {
+                method_ = kHead;
+            }
+            break;
+        case 6:
+            if (m == "DELETE")
+            {
+                method_ = kDelete;
+            }
+            break;
+        case 7:
+            if (m == "OPTIONS")
+            {
+                method_ = kOptions;
+            }
+            break;
+        default:
+            break;
     }
 
     return method_ != kInvalid;
@@ -44,7 +106,7 @@ bool HttpRequest::setMethod(const char* start, const char* end)
 
 void HttpRequest::setPath(const char* start, const char* end)
 {
-    path_.assign(start, end);
+    path_ = std::string_view(start, static_cast<size_t>(end - start));
 }
 
 void HttpRequest::setPathParameters(const std::string& key, const std::string& value)
@@ -54,6 +116,32 @@ void HttpRequest::setPathParameters(const std::string& key, const std::string& v
 
 std::string HttpRequest::getPathParameters(const std::string& key) const
 {
+    for (const auto& param : pathParams_)
+    {
+        if (param.name == key)
+        {
+            return std::string(param.value);
+        }
+    }
+    // 旧版正则路由按位置命名为 param1、param2…
+    if (key.size() > 5 && key.compare(0, 5, "param") == 0)
+    {
+        size_t index = 0;
+        for (size_t i = 5; i < key.size(); ++i)
+        {
+            if (key[i] < '0' || key[i] > '9')
+            {
+                index = 0;
+                break;
+            }
+            index = index * 10 + static_cast<size_t>(key[i] - '0');
+        }
+        if (index >= 1 && index <= pathParams_.size())
+        {
+            return std::string(pathParams_[index - 1].value);
+        }
+    }
+
     auto it = pathParameters_.find(key);
     if (it != pathParameters_.end())
     {
@@ -64,84 +152,98 @@ std::string HttpRequest::getPathParameters(const std::string& key) const
 
 std::string HttpRequest::getQueryParameters(const std::string& key) const
 {
-    auto it = queryParameters_.find(key);
-    if (it != queryParameters_.end())
+    // 查询参数很少被读取，按需线性扫描 query_，同名参数取最后一个（与旧的 map 覆盖语义一致）
+    std::string_view result;
+    bool found = false;
+    size_t prev = 0;
+    while (prev <= query_.size())
     {
-        return it->second;
+        size_t pos = query_.find('&', prev);
+        if (pos == std::string_view::npos)
+        {
+            pos = query_.size();
+        }
+        std::string_view pair = query_.substr(prev, pos - prev);
+        size_t equalPos = pair.find('=');
+        if (equalPos != std::string_view::npos && pair.substr(0, equalPos) == key)
+        {
+            result = pair.substr(equalPos + 1);
+            found = true;
+        }
+        prev = pos + 1;
     }
-    return "";
+    return found ? std::string(result) : std::string();
 }
 
 // 这是从问号后面分割参数
 void HttpRequest::setQueryParameters(const char* start, const char* end)
 {
-    std::string argumentStr(start, end);
-    std::string::size_type pos = 0;
-    std::string::size_type prev = 0;
-
-    // 按 & 分割多个参数
-    while ((pos = argumentStr.find('&', prev)) != std::string::npos)
-    {
-        std::string pair = argumentStr.substr(prev, pos - prev);
-        std::string::size_type equalPos = pair.find('=');
-
-        if (equalPos != std::string::npos)
-        {
-            std::string key = pair.substr(0, equalPos);
-            std::string value = pair.substr(equalPos + 1);
-            queryParameters_[key] = value;
-        }
-
-        prev = pos + 1;
-    }
-
-    // 处理最后一个参数
-    std::string lastPair = argumentStr.substr(prev);
-    std::string::size_type equalPos = lastPair.find('=');
-    if (equalPos != std::string::npos)
-    {
-        std::string key = lastPair.substr(0, equalPos);
-        std::string value = lastPair.substr(equalPos + 1);
-        queryParameters_[key] = value;
-    }
+    query_ = std::string_view(start, static_cast<size_t>(end - start));
 }
 
 void HttpRequest::addHeader(const char* start, const char* colon, const char* end)
 {
-    std::string key(start, colon);
+    std::string_view key(start, static_cast<size_t>(colon - start));
     ++colon;
-    while (colon < end && isspace(*colon))
+    while (colon < end && isHeaderSpace(*colon))
     {
         ++colon;
     }
-    std::string value(colon, end);
-    while (!value.empty() && isspace(value[value.size() - 1]))  // 消除尾部空格
+    while (end > colon && isHeaderSpace(*(end - 1)))  // 消除尾部空格
+    {
+        --end;
+    }
+    headers_.push_back(HttpHeaderField{key, std::string_view(colon, static_cast<size_t>(end - colon))});
+}
+
+void HttpRequest::addHeader(const std::string& key, const std::string& value)
+{
+    for (auto& kv : extraHeaders_)
     {
-        value.resize(value.size() - 1);
+        if (headerNameEquals(kv.first, key))
+        {
+            kv.second = value;
+            return;
+        }
     }
-    headers_[key] = value;
+    extraHeaders_.emplace_back(key, value);
 }
 
-std::string HttpRequest::getHeader(const std::string& field) const
+std::string_view HttpRequest::headerView(std::string_view field) const
 {
-    std::string result;
-    auto it = headers_.find(field);
-    if (it != headers_.end())
+    for (const auto& kv : extraHeaders_)
     {
-        result = it->second;
+        if (headerNameEquals(kv.first, field))
+        {
+            return kv.second;
+        }
+    }
+    // 头字段通常不超过二三十个，线性扫描比建哈希表更快；倒序以保持“后出现者覆盖”语义
+    for (auto it = headers_.rbegin(); it != headers_.rend(); ++it)
+    {
+        if (headerNameEquals(it->name, field))
+        {
+            return it->value;
+        }
     }
-    return result;
+    return std::string_view();
 }
 
 void HttpRequest::swap(HttpRequest& that)
 {
     std::swap(method_, that.method_);
     std::swap(path_, that.path_);
+    std::swap(query_, that.query_);
     std::swap(pathParameters_, that.pathParameters_);
-    std::swap(queryParameters_, that.queryParameters_);
+    std::swap(pathParams_, that.pathParams_);
     std::swap(version_, that.version_);
     std::swap(headers_, that.headers_);
+    std::swap(extraHeaders_, that.extraHeaders_);
     std::swap(receiveTime_, that.receiveTime_);
+    std::swap(content_, that.content_);
+    std::swap(contentLength_, that.contentLength_);
+    std::swap(authUserId_, that.authUserId_);
+    std::swap(authRole_, that.authRole_);
 }
 
 }  // namespace http
\ No newline at end of file
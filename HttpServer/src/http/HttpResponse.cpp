@@ -1,40 +1,153 @@
 #include "../../include/http/HttpResponse.h"
 
+#include <charconv>
+
+#include "http/HttpRequest.h"
+
 namespace http
 {
 
+namespace
+{
+
+constexpr std::string_view kDefaultVersion = "HTTP/1.1";
+constexpr std::string_view kContentLengthPrefix = "Content-Length: ";
+
+}  // namespace
+
+void HttpResponse::setContentType(std::string_view contentType)
+{
+    std::string_view line = headers::contentTypeLine(contentType);
+    if (!line.empty())
+    {
+        contentTypeLine_ = line;
+        headers_.erase("Content-Type");
+    }
+    else
+    {
+        contentTypeLine_ = std::string_view();
+        headers_.set("Content-Type", contentType);
+    }
+}
+
+std::string_view HttpResponse::getContentType() const
+{
+    if (!contentTypeLine_.empty())
+    {
+        // 预编码整行 "Content-Type: <type>\r\n"
+        constexpr size_t kPrefix = sizeof("Content-Type: ") - 1;
+        return contentTypeLine_.substr(kPrefix, contentTypeLine_.size() - kPrefix - 2);
+    }
+    return headers_.find("Content-Type").value_or(std::string_view());
+}
+
+void HttpResponse::addHeader(std::string_view key, std::string_view value)
+{
+    // Content-Type / Content-Length 有专用槽位，经 addHeader 设置时同样落到槽位上，保证不重复输出
+    if (headerNameEquals(key, "Content-Type"))
+    {
+        setContentType(value);
+        return;
+    }
+    if (headerNameEquals(key, "Content-Length"))
+    {
+        uint64_t length = 0;
+        auto res = std::from_chars(value.data(), value.data() + value.size(), length);
+        if (res.ec == std::errc() && res.ptr == value.data() + value.size())
+        {
+            setContentLength(length);
+            return;
+        }
+    }
+    headers_.set(key, value);
+}
+
+void HttpResponse::addRawHeaders(std::string_view lines)
+{
+    if (rawHeaderCount_ < kMaxRawHeaders)
+    {
+        rawHeaders_[rawHeaderCount_++] = lines;
+    }
+    else
+    {
+        rawOverflow_.append(lines.data(), lines.size());
+    }
+}
+
 void HttpResponse::appendToBuffer(muduo::net::Buffer* outputBuf) const
 {
-    // 组装状态行
-    char buf[32];
-    snprintf(buf, sizeof buf, "%s %d ", httpVersion_.c_str(), statusCode_);
+    std::string_view version = httpVersion_.empty() ? kDefaultVersion : std::string_view(httpVersion_);
+    std::string_view suffix = statusLineSuffix(statusCode_);
+    // 状态短语与标准短语一致（或未设置）时直接使用预编码的状态行
+    bool standardLine = !suffix.empty() && (statusMessage_.empty() || statusMessage_ == reasonPhrase(statusCode_));
 
-    outputBuf->append(buf);
-    outputBuf->append(statusMessage_);
-    outputBuf->append("\r\n");
+    // 预留足够空间，之后各段 append 不再触发扩容
+    const std::string* body = fileBody_ ? nullptr : (sharedBody_ ? sharedBody_.get() : &body_);
+    size_t estimate = version.size() + suffix.size() + statusMessage_.size() + 16 +
+                      headers::kConnectionKeepAlive.size() + contentTypeLine_.size() + kContentLengthPrefix.size() +
+                      24 + headers_.encodedSize() + rawOverflow_.size() + (headerBlock_ ? headerBlock_->size() : 0) +
+                      2 + (body ? body->size() : 0);
+    for (size_t i = 0; i < rawHeaderCount_; ++i)
+    {
+        estimate += rawHeaders_[i].size();
+    }
+    outputBuf->ensureWritableBytes(estimate);
 
-    // 输出连接相关头部
-    if (closeConnection_)
+    // 状态行
+    outputBuf->append(version.data(), version.size());
+    if (standardLine)
     {
-        outputBuf->append("Connection: close\r\n");
+        outputBuf->append(suffix.data(), suffix.size());
     }
     else
     {
-        outputBuf->append("Connection: Keep-Alive\r\n");
+        char code[16];
+        code[0] = ' ';
+        char* end = std::to_chars(code + 1, code + sizeof code - 1, static_cast<int>(statusCode_)).ptr;
+        *end++ = ' ';
+        outputBuf->append(code, static_cast<size_t>(end - code));
+        outputBuf->append(statusMessage_);
+        outputBuf->append("\r\n", 2);
     }
 
-    // 输出自定义响应头
-    for (const auto& header : headers_)
+    // 输出连接相关头部
+    std::string_view connection = closeConnection_ ? headers::kConnectionClose : headers::kConnectionKeepAlive;
+    outputBuf->append(connection.data(), connection.size());
+
+    if (!contentTypeLine_.empty())
+    {
+        outputBuf->append(contentTypeLine_.data(), contentTypeLine_.size());
+    }
+    if (contentLength_ >= 0)
+    {
+        char num[24];
+        char* end = std::to_chars(num, num + sizeof num, contentLength_).ptr;
+        outputBuf->append(kContentLengthPrefix.data(), kContentLengthPrefix.size());
+        outputBuf->append(num, static_cast<size_t>(end - num));
+        outputBuf->append("\r\n", 2);
+    }
+
+    // 输出自定义响应头、预编码头部与模板
+    headers_.appendTo(outputBuf);
+    for (size_t i = 0; i < rawHeaderCount_; ++i)
     {
-        outputBuf->append(header.first);
-        outputBuf->append(": ");
-        outputBuf->append(header.second);
-        outputBuf->append("\r\n");
+        outputBuf->append(rawHeaders_[i].data(), rawHeaders_[i].size());
     }
-    outputBuf->append("\r\n");
+    if (!rawOverflow_.empty())
+    {
+        outputBuf->append(rawOverflow_);
+    }
+    if (headerBlock_)
+    {
+        outputBuf->append(headerBlock_->data(), headerBlock_->size());
+    }
+    outputBuf->append("\r\n", 2);
 
-    // 输出响应体
-    outputBuf->append(body_);
+    // 输出响应体（文件响应体由 FileSender 在头部之后单独发送）
+    if (body)
+    {
+        outputBuf->append(body->data(), body->size());
+    }
 }
 
 void HttpResponse::setStatusLine(const std::string& version,
@@ -46,4 +159,4 @@ void HttpResponse::setStatusLine(const std::string& version,
     statusMessage_ = statusMessage;
 }
 
-}  // namespace http
\ No newline at end of file
+}  // namespace http
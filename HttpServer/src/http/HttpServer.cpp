@@ -1,14 +1,63 @@
 #include "../../include/http/HttpServer.h"
 
+#include <pthread.h>
+#include <sched.h>
+
 #include <any>
+#include <chrono>
 #include <functional>
+#include <future>
+#include <map>
 #include <memory>
+#include <thread>
 
 #include "Logging/Logger.h"
 
 namespace http
 {
 
+namespace
+{
+
+constexpr std::string_view k400Response = "HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n";
+constexpr std::string_view k408Response =
+    "HTTP/1.1 408 Request Timeout\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+constexpr std::string_view k413Response =
+    "HTTP/1.1 413 Content Too Large\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+constexpr std::string_view k414Response =
+    "HTTP/1.1 414 URI Too Long\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+constexpr std::string_view k431Response =
+    "HTTP/1.1 431 Request Header Fields Too Large\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+
+int64_t nowSec()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// 当前 IO 线程所属 acceptor 的路由快照；主 acceptor 的线程为空，使用 router_
+thread_local router::Router* t_router = nullptr;
+
+// 把当前线程绑定到 index 对应的 CPU（按 CPU 数取模）
+void pinCurrentThread(int index)
+{
+    unsigned int cpus = std::thread::hardware_concurrency();
+    if (cpus == 0)
+    {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<unsigned int>(index) % cpus, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0)
+    {
+        SPDLOG_WARN_TAG("HTTP") << "pthread_setaffinity_np failed for acceptor " << index << ": " << rc;
+    }
+}
+
+}  // namespace
+
 // 默认http回应函数
 void defaultHttpCallback(const HttpRequest&, HttpResponse* resp)
 {
@@ -21,19 +70,120 @@ HttpServer::HttpServer(int port, const std::string& name, bool useSSL, muduo::ne
     : listenAddr_(port),
       server_(&mainLoop_, listenAddr_, name, option),
       useSSL_(useSSL),
+      option_(option),
       httpCallback_(std::bind(&HttpServer::handleRequest, this, std::placeholders::_1, std::placeholders::_2))
 {
     initialize();
 }
 
+HttpServer::~HttpServer()
+{
+    // muduo 要求 TcpServer 在其事件循环线程内析构；析构时回收它的 IO 线程池，
+    // 之后才能退出 acceptor 线程、释放仍可能被 t_router 引用的路由快照
+    for (auto& acceptor : acceptors_)
+    {
+        muduo::net::EventLoop* loop = acceptor->server->getLoop();
+        std::promise<void> destroyed;
+        loop->runInLoop(
+            [&acceptor, &destroyed]()
+            {
+                acceptor->server.reset();
+                destroyed.set_value();
+            });
+        destroyed.get_future().wait();
+        acceptor->thread.reset();
+        acceptor->router.reset();
+    }
+    acceptors_.clear();
+}
+
 // 服务器运行函数
 void HttpServer::start()
 {
     SPDLOG_WARN_TAG("HTTP") << "HttpServer[" << server_.name() << "] starts listening on" << server_.ipPort();
+    compileMiddlewares();  // 须在克隆路由快照之前
+    if (acceptorNum_ > 1)
+    {
+        startAcceptors();
+    }
     server_.start();
     mainLoop_.loop();
 }
 
+void HttpServer::compileMiddlewares()
+{
+    std::map<std::vector<const middleware::Middleware*>, std::shared_ptr<const middleware::MiddlewareChain>> chains;
+    size_t routes = 0;
+    router_.forEachRoute(
+        [&](router::Router::RouteTarget& target)
+        {
+            auto chain = middlewareChain_.compile(target.pattern);
+            std::vector<const middleware::Middleware*> key;
+            for (const auto& m : chain->middlewares())
+            {
+                key.push_back(m.get());
+            }
+            auto& shared = chains[key];
+            if (!shared)
+            {
+                shared = std::move(chain);
+            }
+            target.middlewares = shared;
+            ++routes;
+            SPDLOG_DEBUG_TAG("HTTP") << "Route " << target.pattern << ": " << shared->size() << " middlewares";
+        });
+    // 未匹配路由的请求（404、CORS 预检）没有路由模式可供挑选，统一只经过不限定作用范围的中间件
+    fallbackChain_ = middlewareChain_.compile(std::string_view());
+    SPDLOG_INFO_TAG("HTTP") << "Compiled middleware for " << routes << " routes (" << chains.size()
+                            << " distinct chains, " << fallbackChain_->size() << " for unmatched requests)";
+}
+
+void HttpServer::startAcceptors()
+{
+    if (option_ != muduo::net::TcpServer::kReusePort)
+    {
+        SPDLOG_WARN_TAG("HTTP") << "acceptors=" << acceptorNum_ << " requires kReusePort; using a single acceptor";
+        return;
+    }
+
+    // IO 线程按 acceptor 平均分配，余数给靠前的 acceptor
+    auto share = [this](int i) { return threadNum_ / acceptorNum_ + (i < threadNum_ % acceptorNum_ ? 1 : 0); };
+    server_.setThreadNum(share(0));
+
+    for (int i = 1; i < acceptorNum_; ++i)
+    {
+        auto acceptor = std::make_unique<Acceptor>();
+        acceptor->router = router_.clone();
+        bool pin = pinAcceptors_;
+        acceptor->thread = std::make_unique<muduo::net::EventLoopThread>(
+            [pin, i](muduo::net::EventLoop*)
+            {
+                if (pin)
+                {
+                    pinCurrentThread(i);
+                }
+            },
+            server_.name() + "-acceptor" + std::to_string(i));
+        muduo::net::EventLoop* loop = acceptor->thread->startLoop();
+
+        // 新的 TcpServer 构造时即以 SO_REUSEPORT 绑定同一端口
+        acceptor->server = std::make_unique<muduo::net::TcpServer>(
+            loop, listenAddr_, server_.name() + "#" + std::to_string(i), muduo::net::TcpServer::kReusePort);
+        muduo::net::TcpServer* server = acceptor->server.get();
+        server->setConnectionCallback(std::bind(&HttpServer::onConnection, this, std::placeholders::_1));
+        server->setMessageCallback(std::bind(&HttpServer::onMessage, this, std::placeholders::_1,
+                                             std::placeholders::_2, std::placeholders::_3));
+        server->setThreadInitCallback(
+            std::bind(&HttpServer::onAcceptorThreadInit, this, std::placeholders::_1, acceptor->router.get()));
+        server->setThreadNum(share(i));
+        // TcpServer::start 需在其事件循环线程内调用（线程池启动会检查所属线程）
+        loop->runInLoop([server]() { server->start(); });
+        acceptors_.push_back(std::move(acceptor));
+    }
+    SPDLOG_WARN_TAG("HTTP") << "HttpServer[" << server_.name() << "] " << acceptorNum_
+                            << " SO_REUSEPORT acceptors, " << threadNum_ << " IO threads";
+}
+
 void HttpServer::initialize()
 {
     // 设置回调函数：如果有新连接，调用 onConnection 函数
@@ -42,6 +192,27 @@ void HttpServer::initialize()
     // 设置回调函数：如果有新数据，调用 onMessage 函数
     server_.setMessageCallback(
         std::bind(&HttpServer::onMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+
+    // 每个 IO 线程启动时创建自己的时间轮
+    server_.setThreadInitCallback(std::bind(&HttpServer::onThreadInit, this, std::placeholders::_1));
+}
+
+void HttpServer::onThreadInit(muduo::net::EventLoop* loop)
+{
+    auto wheel = std::make_unique<ConnectionWheel>(
+        kWheelSlots, std::bind(&HttpServer::onTimeout, this, std::placeholders::_1, std::placeholders::_2));
+    ConnectionWheel* raw = wheel.get();
+    {
+        std::lock_guard<std::mutex> lock(wheelsMutex_);
+        wheels_[loop] = std::move(wheel);
+    }
+    loop->runEvery(1.0, [raw]() { raw->tick(); });
+}
+
+void HttpServer::onAcceptorThreadInit(muduo::net::EventLoop* loop, router::Router* router)
+{
+    t_router = router;
+    onThreadInit(loop);
 }
 
 void HttpServer::setSslConfig(const ssl::SslConfig& config)
@@ -61,21 +232,40 @@ void HttpServer::onConnection(const muduo::net::TcpConnectionPtr& conn)
 {
     if (conn->connected())
     {
+        HttpContext context(&limits_);
+        {
+            std::lock_guard<std::mutex> lock(wheelsMutex_);
+            auto it = wheels_.find(conn->getLoop());
+            if (it != wheels_.end())
+            {
+                context.setTimingWheel(it->second.get());
+            }
+        }
+        conn->setContext(context);
+        // 新连接须在 headerTimeout 内发完第一个请求的头部（TLS 握手也计入），防止只建连不发数据
+        HttpContext* ctx = boost::any_cast<HttpContext>(conn->getMutableContext());
         if (useSSL_)
         {
-            auto sslConn = std::make_unique<ssl::SslConnection>(conn, sslCtx_.get());
-            sslConn->setMessageCallback(std::bind(&HttpServer::onMessage, this, std::placeholders::_1,
-                                                  std::placeholders::_2, std::placeholders::_3));
-            sslConns_[conn] = std::move(sslConn);
-            sslConns_[conn]->startHandshake();
+            // TLS 状态随连接的 context 存放，读写路径按连接直接取用，不经全局表与锁
+            auto sslConn = std::make_shared<ssl::SslConnection>(conn, sslCtx_.get());
+            ctx->setSslConnection(sslConn);
+            sslConn->startHandshake();
+        }
+        uint64_t token = ctx->enterPhase(HttpContext::kPhaseHeader, nowSec());
+        if (ctx->timingWheel() && limits_.headerTimeoutSec > 0)
+        {
+            ctx->timingWheel()->schedule(conn, token, limits_.headerTimeoutSec);
         }
-        conn->setContext(HttpContext());
     }
     else
     {
-        if (useSSL_)
+        // SslConnection 与未完成的 deferred 响应都持有 conn，置空以打破 conn → context → ... → conn 的引用环；
+        // 仍持有 ResponseWriter 的异步 Handler 会在写出前发现连接已断开
+        HttpContext* ctx = boost::any_cast<HttpContext>(conn->getMutableContext());
+        if (ctx)
         {
-            sslConns_.erase(conn);
+            ctx->setSslConnection(nullptr);
+            ctx->setDeferredResponse(nullptr);
         }
     }
 }
@@ -86,111 +276,379 @@ void HttpServer::onMessage(const muduo::net::TcpConnectionPtr& conn,
 {
     try
     {
-        // 这层判断只是代表是否支持ssl
-        if (useSSL_)
+        // HttpContext对象用于解析出buf中的请求报文，并把报文的关键信息封装到HttpRequest对象中
+        HttpContext* context = boost::any_cast<HttpContext>(conn->getMutableContext());
+        if (ssl::SslConnection* sslConn = context->sslConnection().get())
         {
-            SPDLOG_INFO_TAG("HTTP") << "onMessage useSSL_ is true";
-            // 1.查找对应的SSL连接
-            auto it = sslConns_.find(conn);
-            if (it != sslConns_.end())
+            // HTTPS：密文交给连接自己的 SslConnection，解析其解密缓冲区（半个请求会留在其中）
+            if (buf != sslConn->getDecryptedBuffer())
+            {
+                sslConn->onRead(conn, buf, receiveTime);
+            }
+            if (!sslConn->isHandshakeCompleted())
             {
-                SPDLOG_INFO_TAG("HTTP") << "onMessage sslConns_ is not empty";
-                // 2. SSL连接处理数据
-                it->second->onRead(conn, buf, receiveTime);
+                return;
+            }
+            buf = sslConn->getDecryptedBuffer();
+        }
+        uint64_t timerToken = context->timerToken();
 
-                // 3. 如果 SSL 握手还未完成，直接返回
-                if (!it->second->isHandshakeCompleted())
+        // 流水线（pipelining）：一次读事件中可能到达多个完整请求，逐个解析并按序应答，
+        // 不再让后续请求等待下一次读事件
+        while (buf->readableBytes() > 0)
+        {
+            if (context->responsePending())
+            {
+                break;  // 文件响应体发送中，后续请求留在缓冲区，发完后由 sendFileResponse 续上
+            }
+            if (!context->parseRequest(buf, receiveTime))  // 解析一个http请求
+            {
+                // 如果解析http报文过程中出错：超限的按规则计数并回复对应状态码
+                switch (context->error())
                 {
-                    SPDLOG_INFO_TAG("HTTP") << "onMessage sslConns_ is not empty";
-                    return;
+                    case HttpContext::kRequestLineTooLong:
+                        reapStats_.increment(ReapReason::kRequestLineTooLong);
+                        rejectConnection(conn, k414Response);
+                        break;
+                    case HttpContext::kHeaderTooLarge:
+                        reapStats_.increment(ReapReason::kHeaderTooLarge);
+                        rejectConnection(conn, k431Response);
+                        break;
+                    case HttpContext::kTooManyHeaders:
+                        reapStats_.increment(ReapReason::kTooManyHeaders);
+                        rejectConnection(conn, k431Response);
+                        break;
+                    case HttpContext::kBodyTooLarge:
+                        reapStats_.increment(ReapReason::kBodyTooLarge);
+                        rejectConnection(conn, k413Response);
+                        break;
+                    default:
+                        rejectConnection(conn, k400Response);
+                        break;
                 }
-
-                // 4. 从SSL连接的解密缓冲区获取数据
-                muduo::net::Buffer* decryptedBuf = it->second->getDecryptedBuffer();
-                if (decryptedBuf->readableBytes() == 0) return;  // 没有解密后的数据
-
-                // 5. 使用解密后的数据进行HTTP 处理
-                buf = decryptedBuf;  // 将 buf 指向解密后的数据
-                SPDLOG_INFO_TAG("HTTP") << "onMessage decryptedBuf is not empty";
+                context->enterPhase(HttpContext::kPhaseNone, nowSec());
+                buf->retrieveAll();
+                return;
+            }
+            // 如果buf缓冲区中解析出一个完整的数据包才封装响应报文
+            if (!context->gotAll())
+            {
+                break;  // 剩余数据不足一个请求，等待更多数据
+            }
+            bool keepGoing = onRequest(conn, context->request());
+            context->reset();
+            if (!keepGoing)
+            {
+                // 连接即将关闭，或 deferred 响应尚未发送完毕：后续请求留在缓冲区，
+                // 避免其响应插到异步响应（如 SSE 流）之前
+                break;
             }
         }
-        // HttpContext对象用于解析出buf中的请求报文，并把报文的关键信息封装到HttpRequest对象中
-        HttpContext* context = boost::any_cast<HttpContext>(conn->getMutableContext());
-        if (!context->parseRequest(buf, receiveTime))  // 解析一个http请求
+        // 响应未发完期间不解析后续请求：积压超过单个请求的上限（头部 + 请求体）时暂停读取，
+        // 由 resumeConnection 恢复，避免客户端在长响应（如 SSE 流）期间持续灌入数据耗尽内存
+        if (context->responsePending() && !context->readPaused() &&
+            buf->readableBytes() > limits_.maxHeaderBytes + limits_.maxBodyBytes)
         {
-            // 如果解析http报文过程中出错
-            conn->send("HTTP/1.1 400 Bad Request\r\n\r\n");
-            conn->shutdown();
+            SPDLOG_WARN_TAG("HTTP") << "Input backlog " << buf->readableBytes()
+                                    << " bytes while response pending, pausing read on " << conn->name();
+            context->setReadPaused(true);
+            conn->stopRead();
         }
-        // 如果buf缓冲区中解析出一个完整的数据包才封装响应报文
-        if (context->gotAll())
+        // 本轮交给异步 Handler 的连接不计时（SSE 等长响应期间客户端本就不发数据），收到新数据后再恢复
+        if (context->timeoutPhase() != HttpContext::kPhaseNone || context->timerToken() == timerToken)
         {
-            onRequest(conn, context->request());
-            context->reset();
+            updateTimeout(conn, context, buf->readableBytes() > 0);
         }
     }
     catch (const std::exception& e)
     {
         // 捕获异常，返回错误信息
         SPDLOG_ERROR_TAG("HTTP") << "Exception in onMessage: " << e.what();
-        conn->send("HTTP/1.1 400 Bad Request\r\n\r\n");
-        conn->shutdown();
+        rejectConnection(conn, k400Response);
     }
 }
 
-void HttpServer::onRequest(const muduo::net::TcpConnectionPtr& conn, const HttpRequest& req)
+void HttpServer::updateTimeout(const muduo::net::TcpConnectionPtr& conn, HttpContext* context, bool partialInput)
 {
-    const std::string& connection = req.getHeader("Connection");
+    HttpContext::TimeoutPhase phase = HttpContext::kPhaseKeepAlive;
+    int timeout = limits_.keepAliveTimeoutSec;
+    if (context->responsePending())
+    {
+        phase = HttpContext::kPhaseNone;  // 文件响应体发送中，由 FileSender 完成回调重新计时
+        timeout = 0;
+    }
+    else if (context->readingBody())
+    {
+        phase = HttpContext::kPhaseBody;
+        timeout = limits_.bodyTimeoutSec;
+    }
+    else if (context->inProgress() || partialInput)
+    {
+        phase = HttpContext::kPhaseHeader;
+        timeout = limits_.headerTimeoutSec;
+    }
+
+    int64_t now = nowSec();
+    if (phase == context->timeoutPhase())
+    {
+        context->touch(now);
+        return;
+    }
+    uint64_t token = context->enterPhase(phase, now);
+    if (timeout > 0 && context->timingWheel())
+    {
+        context->timingWheel()->schedule(conn, token, timeout);
+    }
+}
+
+int HttpServer::onTimeout(const muduo::net::TcpConnectionPtr& conn, uint64_t token)
+{
+    if (!conn->connected())
+    {
+        return 0;
+    }
+    HttpContext* context = boost::any_cast<HttpContext>(conn->getMutableContext());
+    if (!context || context->timerToken() != token)
+    {
+        return 0;  // 连接已切换到其他计时阶段
+    }
+
+    int timeout = 0;
+    ReapReason reason;
+    switch (context->timeoutPhase())
+    {
+        case HttpContext::kPhaseHeader:
+            timeout = limits_.headerTimeoutSec;
+            reason = ReapReason::kHeaderTimeout;
+            break;
+        case HttpContext::kPhaseBody:
+            timeout = limits_.bodyTimeoutSec;
+            reason = ReapReason::kBodyTimeout;
+            break;
+        case HttpContext::kPhaseKeepAlive:
+            timeout = limits_.keepAliveTimeoutSec;
+            reason = ReapReason::kIdleTimeout;
+            break;
+        default:
+            return 0;
+    }
+
+    int64_t now = nowSec();
+    int64_t elapsed = now - context->phaseSince();
+    if (elapsed < timeout)
+    {
+        return static_cast<int>(timeout - elapsed);  // 期间有数据到达，顺延
+    }
+
+    reapStats_.increment(reason);
+    context->enterPhase(HttpContext::kPhaseNone, now);
+    SPDLOG_DEBUG_TAG("HTTP") << "Reaping connection " << conn->name() << ": " << ConnectionReapStats::name(reason);
+    if (reason == ReapReason::kIdleTimeout)
+    {
+        conn->forceClose();
+    }
+    else
+    {
+        rejectConnection(conn, k408Response);
+    }
+    return 0;
+}
+
+void HttpServer::rejectConnection(const muduo::net::TcpConnectionPtr& conn, std::string_view response)
+{
+    ssl::SslConnection* sslConn = boost::any_cast<HttpContext>(conn->getMutableContext())->sslConnection().get();
+    if (sslConn)
+    {
+        if (sslConn->isHandshakeCompleted())
+        {
+            sslConn->send(response.data(), response.size());
+        }
+    }
+    else
+    {
+        conn->send(response.data(), static_cast<int>(response.size()));
+    }
+    conn->shutdown();
+    // 对端收到响应后不关闭（慢速攻击的常见行为）时，不能无限等待半关闭的连接
+    conn->forceCloseWithDelay(1.0);
+}
+
+bool HttpServer::onRequest(const muduo::net::TcpConnectionPtr& conn, HttpRequest& req)
+{
+    std::string_view connection = req.headerView("Connection");
     bool close = ((connection == "close") || (req.getVersion() == "HTTP/1.0" && connection != "Keep-Alive"));
     HttpResponse response(close);
+    HttpContext* context = boost::any_cast<HttpContext>(conn->getMutableContext());
     response.setConnection(conn);  // 注入连接指针，异步模式下 Handler 可使用
+    response.setWriter(ResponseWriter(conn, context->sslConnection(), this));
 
     httpCallback_(req, &response);
 
-    // 异步模式：Handler 已标记 deferred，由 Handler 自行发送响应
+    // 异步模式：Handler 已标记 deferred，由 Handler 自行发送响应。保留响应对象（含中间件写入的头）
+    // 供 ResponseWriter::complete() 填写；完成前不解析后续流水线请求
     if (response.isDeferred())
+    {
+        context->enterPhase(HttpContext::kPhaseNone, nowSec());
+        context->setResponsePending(true);
+        context->setDeferredResponse(std::make_shared<HttpResponse>(std::move(response)));
+        return false;
+    }
+
+    return sendResponse(conn, context, response);
+}
+
+void HttpServer::completeDeferred(const muduo::net::TcpConnectionPtr& conn,
+                                  const std::function<void(HttpResponse*)>& fill)
+{
+    if (!conn->connected())
     {
         return;
     }
+    HttpContext* context = boost::any_cast<HttpContext>(conn->getMutableContext());
+    std::shared_ptr<HttpResponse> response = context->takeDeferredResponse();
+    if (!response)
+    {
+        return;  // 重复调用，或流式响应（未保留响应对象）
+    }
+    fill(response.get());
+    response->setDeferred(false);
+    context->setResponsePending(false);
+    if (sendResponse(conn, context, *response))
+    {
+        resumeConnection(conn, context);
+    }
+}
+
+void HttpServer::resumeConnection(const muduo::net::TcpConnectionPtr& conn, HttpContext* context)
+{
+    if (context->readPaused())
+    {
+        context->setReadPaused(false);
+        conn->startRead();
+    }
+    updateTimeout(conn, context, false);
+    // 等待期间到达的流水线请求留在输入缓冲区：放到下一轮事件循环继续处理，
+    // 避免在 onMessage 尚未 reset 解析状态时重入
+    conn->getLoop()->queueInLoop(
+        [this, conn]()
+        {
+            if (!conn->connected())
+            {
+                return;
+            }
+            HttpContext* ctx = boost::any_cast<HttpContext>(conn->getMutableContext());
+            muduo::net::Buffer* pending =
+                ctx->sslConnection() ? ctx->sslConnection()->getDecryptedBuffer() : conn->inputBuffer();
+            if (pending->readableBytes() > 0)
+            {
+                onMessage(conn, pending, muduo::Timestamp::now());
+            }
+        });
+}
 
-    // 同步模式：立即发送响应
+bool HttpServer::sendResponse(const muduo::net::TcpConnectionPtr& conn, HttpContext* context, HttpResponse& response)
+{
+    // 同步模式：立即发送响应（同一连接上按请求到达顺序写出）
     muduo::net::Buffer buf;
     response.appendToBuffer(&buf);
     // LOG_DEBUG << "Sending response (" << buf.readableBytes() << " bytes)";
 
-    conn->send(&buf);
+    if (response.fileBody())
+    {
+        sendFileResponse(conn, response, &buf);
+        return false;
+    }
+    if (ssl::SslConnection* sslConn = context->sslConnection().get())
+    {
+        sslConn->send(buf.peek(), buf.readableBytes());
+    }
+    else
+    {
+        conn->send(&buf);
+    }
     if (response.closeConnection())
     {
         conn->shutdown();
+        return false;
+    }
+    return true;
+}
+
+void HttpServer::sendFileResponse(const muduo::net::TcpConnectionPtr& conn,
+                                  const HttpResponse& response,
+                                  muduo::net::Buffer* header)
+{
+    HttpContext* context = boost::any_cast<HttpContext>(conn->getMutableContext());
+    // 连接断开时 context 才释放 SslConnection，而 FileSender 只在连接存活期间写出，裸指针足够
+    ssl::SslConnection* sslConn = context->sslConnection().get();
+
+    if (sslConn)
+    {
+        sslConn->send(header->peek(), header->readableBytes());
+    }
+    else
+    {
+        conn->send(header);
+        if (context->socketFd() == HttpContext::kSocketFdUnknown)
+        {
+            context->setSocketFd(FileSender::resolveSocketFd(conn));
+        }
     }
+
+    context->setResponsePending(true);
+    bool close = response.closeConnection();
+    FileSender::start(conn, response.fileBody(), context->socketFd(), sslConn,
+                      [this, close](const muduo::net::TcpConnectionPtr& c)
+                      {
+                          HttpContext* ctx = boost::any_cast<HttpContext>(c->getMutableContext());
+                          ctx->setResponsePending(false);
+                          if (close)
+                          {
+                              c->shutdown();
+                              return;
+                          }
+                          resumeConnection(c, ctx);
+                      });
 }
 
 // 执行请求对应的路由处理函数
-void HttpServer::handleRequest(const HttpRequest& req, HttpResponse* resp)
+void HttpServer::handleRequest(HttpRequest& req, HttpResponse* resp)
 {
     try
     {
-        // 处理请求前的中间件
-        HttpRequest mutableReq = req;
-        // 中间件前置
-        middlewareChain_.processBefore(mutableReq);
+        router::Router& router = t_router ? *t_router : router_;
+        router::Router::RouteMatch match;
+        bool matched = router.match(req.method(), req.pathView(), &match) &&
+                       (match.target->handler || match.target->callback);
 
-        // 路由处理
-        if (!router_.route(mutableReq, resp))
+        // 已匹配的路由使用启动时挑选好的中间件链，未匹配的请求（404、CORS 预检）共用启动时编译的兜底链；
+        // 只有 start() 之后注册的路由才按路由模式临时挑选
+        std::shared_ptr<const middleware::MiddlewareChain> adhoc;
+        const middleware::MiddlewareChain* chain = matched ? match.target->middlewares.get() : fallbackChain_.get();
+        if (!chain)
         {
-            SPDLOG_DEBUG_TAG("HTTP") << "No route matched: " << req.method() << " " << req.path();
-            resp->setStatusCode(HttpResponse::k404NotFound);
-            resp->setStatusMessage("Not Found");
-            resp->setCloseConnection(true);
+            adhoc = middlewareChain_.compile(matched ? std::string_view(match.target->pattern) : req.pathView());
+            chain = adhoc.get();
         }
 
-        // 处理响应后的中间件
-        middlewareChain_.processAfter(*resp);
-    }
-    catch (const HttpResponse& res)
-    {
-        // 处理中间件抛出的响应（如CORS预检请求）
-        *resp = res;
+        size_t passed = 0;
+        if (chain->processBefore(req, resp, &passed))
+        {
+            if (matched)
+            {
+                router.dispatch(match, req, resp);
+            }
+            else
+            {
+                SPDLOG_DEBUG_TAG("HTTP") << "No route matched: " << req.method() << " " << req.path();
+                resp->setStatusCode(HttpResponse::k404NotFound);
+                resp->setStatusMessage("Not Found");
+                resp->setCloseConnection(true);
+            }
+        }
+
+        // 处理响应后的中间件（中途终止时只包括已通过的中间件）
+        chain->processAfter(*resp, passed);
     }
     catch (const std::exception& e)
     {
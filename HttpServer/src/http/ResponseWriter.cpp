@@ -0,0 +1,60 @@
+#include "http/ResponseWriter.h"
+
+#include "http/HttpServer.h"
+#include "ssl/SslConnection.h"
+
+namespace http
+{
+
+void ResponseWriter::send(std::string data) const
+{
+    if (!conn_)
+    {
+        return;
+    }
+    // SslConnection 不是线程安全的，加密与写出都放在 IO 线程
+    conn_->getLoop()->runInLoop(
+        [conn = conn_, sslConn = sslConn_, data = std::move(data)]()
+        {
+            if (!conn->connected())
+            {
+                return;
+            }
+            if (sslConn)
+            {
+                sslConn->send(data.data(), data.size());
+            }
+            else
+            {
+                conn->send(data);
+            }
+        });
+}
+
+void ResponseWriter::shutdown() const
+{
+    if (!conn_)
+    {
+        return;
+    }
+    conn_->getLoop()->runInLoop(
+        [conn = conn_]()
+        {
+            if (conn->connected())
+            {
+                conn->shutdown();
+            }
+        });
+}
+
+void ResponseWriter::complete(std::function<void(HttpResponse*)> fill) const
+{
+    if (!conn_ || !server_)
+    {
+        return;
+    }
+    conn_->getLoop()->runInLoop([conn = conn_, server = server_, fill = std::move(fill)]()
+                                { server->completeDeferred(conn, fill); });
+}
+
+}  // namespace http
@@ -0,0 +1,188 @@
+#include "http/SseStream.h"
+
+#include <charconv>
+#include <chrono>
+
+namespace http
+{
+
+namespace
+{
+
+int64_t steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+SseStream::SseStream(std::string key, long long owner, Options options)
+    : key_(std::move(key)), owner_(owner), options_(options), detachedAtMs_(steadyNowMs())
+{
+}
+
+uint64_t SseStream::publish(std::string payload)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t seq = nextSeq_++;
+    detachIfClosedLocked(steadyNowMs());
+    if (sink_) sink_->event(eventId(key_, seq), payload);
+
+    bytes_ += payload.size();
+    frames_.push_back(Frame{seq, std::move(payload)});
+    while (!frames_.empty() && (frames_.size() > options_.maxFrames || bytes_ > options_.maxBytes))
+    {
+        bytes_ -= frames_.front().payload.size();
+        frames_.pop_front();
+    }
+    return seq;
+}
+
+bool SseStream::attach(std::shared_ptr<SseSink> sink, uint64_t lastSeq)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (abandonedLocked(steadyNowMs()) || lastSeq >= nextSeq_) return false;
+    // lastSeq 之后的第一帧须仍在环中（全部帧都已发过时无需补发）
+    uint64_t oldest = frames_.empty() ? nextSeq_ : frames_.front().seq;
+    if (lastSeq + 1 < oldest) return false;
+
+    if (sink_ && sink_ != sink) sink_->close();
+    for (const auto& frame : frames_)
+    {
+        if (frame.seq > lastSeq) sink->event(eventId(key_, frame.seq), frame.payload);
+    }
+    if (finished_)
+    {
+        sink->close();
+        sink_.reset();
+        return true;
+    }
+    sink_ = std::move(sink);
+    return true;
+}
+
+void SseStream::finish()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+    finishedAtMs_ = steadyNowMs();
+    if (sink_)
+    {
+        sink_->close();
+        sink_.reset();
+    }
+}
+
+bool SseStream::abandoned() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return abandonedLocked(steadyNowMs());
+}
+
+bool SseStream::writable() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    detachIfClosedLocked(steadyNowMs());
+    return !sink_ || sink_->writable();
+}
+
+bool SseStream::expired(int64_t nowMs) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (finished_) return nowMs - finishedAtMs_ >= options_.graceMs;
+    return abandonedLocked(nowMs);
+}
+
+void SseStream::detachIfClosedLocked(int64_t nowMs) const
+{
+    if (sink_ && !sink_->connected())
+    {
+        sink_.reset();
+        detachedAtMs_ = nowMs;
+    }
+}
+
+bool SseStream::abandonedLocked(int64_t nowMs) const
+{
+    if (abandoned_) return true;
+    if (finished_) return false;
+    detachIfClosedLocked(nowMs);
+    if (!sink_ && nowMs - detachedAtMs_ >= options_.graceMs) abandoned_ = true;
+    return abandoned_;
+}
+
+std::string SseStream::eventId(std::string_view key, uint64_t seq)
+{
+    std::string id;
+    id.reserve(key.size() + 21);
+    id.append(key);
+    id.push_back(':');
+    id.append(std::to_string(seq));
+    return id;
+}
+
+bool SseStream::parseEventId(std::string_view id, std::string* key, uint64_t* seq)
+{
+    size_t colon = id.rfind(':');
+    if (colon == std::string_view::npos || colon == 0 || colon + 1 == id.size()) return false;
+    const char* first = id.data() + colon + 1;
+    const char* last = id.data() + id.size();
+    auto [ptr, ec] = std::from_chars(first, last, *seq);
+    if (ec != std::errc() || ptr != last) return false;
+    key->assign(id.data(), colon);
+    return true;
+}
+
+SseStreamRegistry::SseStreamRegistry(Options options) : options_(options), lastSweepMs_(steadyNowMs()) {}
+
+std::shared_ptr<SseStream> SseStreamRegistry::create(std::string key, long long owner)
+{
+    auto stream = std::make_shared<SseStream>(key, owner, options_.stream);
+    int64_t now = steadyNowMs();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (now - lastSweepMs_ >= options_.sweepIntervalMs) sweepLocked(now);
+    streams_[std::move(key)] = stream;
+    return stream;
+}
+
+std::shared_ptr<SseStream> SseStreamRegistry::find(const std::string& key, long long owner) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(key);
+    if (it == streams_.end() || it->second->owner() != owner || it->second->expired(steadyNowMs())) return nullptr;
+    return it->second;
+}
+
+size_t SseStreamRegistry::sweep()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sweepLocked(steadyNowMs());
+}
+
+size_t SseStreamRegistry::sweepLocked(int64_t nowMs)
+{
+    lastSweepMs_ = nowMs;
+    size_t removed = 0;
+    for (auto it = streams_.begin(); it != streams_.end();)
+    {
+        if (it->second->expired(nowMs))
+        {
+            it = streams_.erase(it);
+            ++removed;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+size_t SseStreamRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return streams_.size();
+}
+
+}  // namespace http
@@ -0,0 +1,225 @@
+#include "http/SseWriter.h"
+
+#include <chrono>
+
+#include "Logging/Logger.h"
+
+namespace http
+{
+
+namespace
+{
+
+int64_t steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+std::shared_ptr<SseWriter> SseWriter::open(ResponseWriter writer, Options options)
+{
+    std::shared_ptr<SseWriter> sse(new SseWriter(std::move(writer), options));
+    if (sse->writer_)
+    {
+        sse->writer_.getLoop()->runInLoop([sse]() { sse->start(); });
+    }
+    else
+    {
+        sse->closed_ = true;
+    }
+    return sse;
+}
+
+SseWriter::SseWriter(ResponseWriter writer, Options options) : writer_(std::move(writer)), options_(options)
+{
+    pending_.reserve(options_.flushBytes);
+    if (options_.encoding != ContentEncoding::kIdentity)
+    {
+        compressor_ = std::make_unique<StreamCompressor>(options_.encoding, options_.compressionLevel);
+    }
+}
+
+SseWriter::~SseWriter()
+{
+    // 未经 close() 就释放时停掉心跳；start() / finish() 都持有 shared_ptr，此处读取 heartbeat_ 不会与之并发
+    if (heartbeatActive_) writer_.getLoop()->cancel(heartbeat_);
+}
+
+void SseWriter::start()
+{
+    const auto& conn = writer_.connection();
+    if (!conn->connected())
+    {
+        closed_ = true;
+        return;
+    }
+    lastOutputMs_ = steadyNowMs();
+
+    std::weak_ptr<SseWriter> weak = shared_from_this();
+    conn->setHighWaterMarkCallback(
+        [weak](const muduo::net::TcpConnectionPtr&, size_t)
+        {
+            if (auto self = weak.lock())
+            {
+                if (!self->paused_.exchange(true)) self->pausedSinceMs_ = steadyNowMs();
+            }
+        },
+        options_.highWaterMark);
+    conn->setWriteCompleteCallback(
+        [weak](const muduo::net::TcpConnectionPtr&)
+        {
+            auto self = weak.lock();
+            if (self && self->paused_.exchange(false) && self->options_.onWritable) self->options_.onWritable();
+        });
+
+    if (options_.heartbeatSec > 0)
+    {
+        heartbeat_ = conn->getLoop()->runEvery(options_.heartbeatSec,
+                                               [weak]()
+                                               {
+                                                   if (auto self = weak.lock()) self->tick();
+                                               });
+        heartbeatActive_ = true;
+    }
+}
+
+bool SseWriter::data(std::string_view payload)
+{
+    return append(std::string_view(), payload);
+}
+
+bool SseWriter::event(std::string_view id, std::string_view payload)
+{
+    return append(id, payload);
+}
+
+bool SseWriter::append(std::string_view id, std::string_view payload)
+{
+    if (!connected()) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!id.empty())
+    {
+        pending_.append("id: ");
+        pending_.append(id);
+        pending_.push_back('\n');
+    }
+    pending_.append("data: ");
+    pending_.append(payload);
+    pending_.append("\n\n");
+    scheduleFlush(pending_.size() >= options_.flushBytes);
+    return true;
+}
+
+void SseWriter::scheduleFlush(bool now)
+{
+    auto self = shared_from_this();
+    if (now)
+    {
+        if (urgentScheduled_) return;
+        urgentScheduled_ = true;
+        writer_.getLoop()->queueInLoop([self]() { self->flush(); });
+    }
+    else
+    {
+        if (timerScheduled_ || urgentScheduled_) return;
+        timerScheduled_ = true;
+        writer_.getLoop()->runAfter(options_.flushIntervalMs / 1000.0, [self]() { self->flush(); });
+    }
+}
+
+void SseWriter::flush()
+{
+    std::string out;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out.swap(pending_);
+        pending_.reserve(options_.flushBytes);
+        timerScheduled_ = false;
+        urgentScheduled_ = false;
+    }
+    if (out.empty()) return;
+    if (!writer_.connected())
+    {
+        closed_ = true;
+        return;
+    }
+    lastOutputMs_ = steadyNowMs();
+    write(std::move(out));
+}
+
+void SseWriter::write(std::string data)
+{
+    if (compressor_)
+    {
+        std::string compressed;
+        if (!compressor_->write(data, &compressed))
+        {
+            // 压缩流已损坏，客户端无法继续解码
+            SPDLOG_ERROR_TAG("SSE") << "Stream compression failed, closing: " << writer_.connection()->name();
+            closed_ = true;
+            writer_.connection()->forceClose();
+            return;
+        }
+        data.swap(compressed);
+    }
+    writer_.send(std::move(data));  // 已在 IO 线程，直接写出
+}
+
+void SseWriter::tick()
+{
+    if (!writer_.connected())
+    {
+        closed_ = true;
+        finish();
+        return;
+    }
+    int64_t now = steadyNowMs();
+    if (paused_ && options_.stallTimeoutSec > 0 && now - pausedSinceMs_ >= options_.stallTimeoutSec * 1000)
+    {
+        SPDLOG_WARN_TAG("SSE") << "Client stalled for " << (now - pausedSinceMs_) / 1000
+                               << "s, closing stream: " << writer_.connection()->name();
+        closed_ = true;
+        writer_.connection()->forceClose();
+        finish();
+        return;
+    }
+    if (now - lastOutputMs_ >= options_.heartbeatSec * 1000)
+    {
+        lastOutputMs_ = now;
+        write(": ping\n\n");
+    }
+}
+
+void SseWriter::close()
+{
+    if (closed_.exchange(true) || !writer_) return;
+    auto self = shared_from_this();
+    writer_.getLoop()->runInLoop(
+        [self]()
+        {
+            self->flush();
+            if (self->compressor_ && self->writer_.connected())
+            {
+                std::string tail;
+                if (self->compressor_->finish(&tail)) self->writer_.send(std::move(tail));
+            }
+            self->finish();
+            self->writer_.shutdown();
+        });
+}
+
+void SseWriter::finish()
+{
+    if (heartbeatActive_)
+    {
+        writer_.getLoop()->cancel(heartbeat_);
+        heartbeatActive_ = false;
+    }
+    const auto& conn = writer_.connection();
+    conn->setHighWaterMarkCallback(muduo::net::HighWaterMarkCallback(), options_.highWaterMark);
+    conn->setWriteCompleteCallback(muduo::net::WriteCompleteCallback());
+}
+
+}  // namespace http
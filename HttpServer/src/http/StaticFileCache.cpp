@@ -0,0 +1,378 @@
+#include "http/StaticFileCache.h"
+
+#include <sys/stat.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAS_BROTLI
+#include <brotli/encode.h>
+#endif
+
+#include "Logging/Logger.h"
+#include "http/Compression.h"
+
+namespace http
+{
+
+namespace
+{
+
+int64_t nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+bool isCompressible(const std::string& mime)
+{
+    return mime.compare(0, 5, "text/") == 0 || mime.find("javascript") != std::string::npos ||
+           mime.find("json") != std::string::npos || mime.find("xml") != std::string::npos;  // 含 image/svg+xml
+}
+
+// FNV-1a 64，用于生成内容 ETag（非安全用途）
+uint64_t fnv1a(const std::string& data)
+{
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : data)
+    {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+bool parseHttpDate(std::string_view s, time_t* out)
+{
+    char buf[64];
+    if (s.size() >= sizeof buf)
+    {
+        return false;
+    }
+    std::memcpy(buf, s.data(), s.size());
+    buf[s.size()] = '\0';
+    struct tm tmv;
+    std::memset(&tmv, 0, sizeof tmv);
+    const char* end = strptime(buf, "%a, %d %b %Y %H:%M:%S GMT", &tmv);
+    if (!end)
+    {
+        return false;
+    }
+    *out = timegm(&tmv);
+    return true;
+}
+
+std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+    {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+    {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+#ifdef HAS_ZLIB
+bool gzipCompress(const std::string& in, std::string* out)
+{
+    z_stream zs;
+    std::memset(&zs, 0, sizeof zs);
+    // windowBits 15 + 16 → 输出 gzip 封装
+    if (deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return false;
+    }
+    out->resize(deflateBound(&zs, in.size()));
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&(*out)[0]);
+    zs.avail_out = static_cast<uInt>(out->size());
+    int rc = deflate(&zs, Z_FINISH);
+    out->resize(zs.total_out);
+    deflateEnd(&zs);
+    return rc == Z_STREAM_END;
+}
+#endif
+
+#ifdef HAS_BROTLI
+bool brotliCompress(const std::string& in, std::string* out)
+{
+    size_t size = BrotliEncoderMaxCompressedSize(in.size());
+    if (size == 0)
+    {
+        return false;
+    }
+    out->resize(size);
+    // 静态资源只压一次，用较高质量；11 对 MB 级文件过慢，取 9
+    if (!BrotliEncoderCompress(9, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, in.size(),
+                               reinterpret_cast<const uint8_t*>(in.data()), &size,
+                               reinterpret_cast<uint8_t*>(&(*out)[0])))
+    {
+        return false;
+    }
+    out->resize(size);
+    return true;
+}
+#endif
+
+// 条目占用的字节数（原始 + 各压缩变体）
+uint64_t entryBytes(const StaticFileCache::Entry& entry)
+{
+    uint64_t n = 0;
+    for (const auto& v : entry.variants)
+    {
+        n += v.body ? v.body->size() : 0;
+    }
+    return n;
+}
+
+const char* encodingName(StaticFileCache::Encoding enc)
+{
+    switch (enc)
+    {
+        case StaticFileCache::kGzip:
+            return "gzip";
+        case StaticFileCache::kBrotli:
+            return "br";
+        default:
+            return "";
+    }
+}
+
+}  // namespace
+
+std::string StaticFileCache::httpDate(time_t t)
+{
+    struct tm tmv;
+    gmtime_r(&t, &tmv);
+    char buf[64];
+    size_t n = strftime(buf, sizeof buf, "%a, %d %b %Y %H:%M:%S GMT", &tmv);
+    return std::string(buf, n);
+}
+
+StaticFileCache::StaticFileCache(Options options) : options_(options) {}
+
+StaticFileCache::EntryPtr StaticFileCache::lookup(const std::string& filePath, const std::string& mimeType)
+{
+    int64_t now = nowMs();
+    std::shared_ptr<Entry> cached;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = entries_.find(filePath);
+        if (it != entries_.end())
+        {
+            cached = it->second;
+        }
+    }
+    if (cached && now - cached->checkedAtMs.load(std::memory_order_relaxed) < options_.revalidateMs)
+    {
+        return cached;
+    }
+
+    struct stat st;
+    if (::stat(filePath.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        if (cached)
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            auto it = entries_.find(filePath);
+            if (it != entries_.end() && it->second == cached)
+            {
+                totalBytes_.fetch_sub(entryBytes(*cached), std::memory_order_relaxed);
+                entries_.erase(it);
+            }
+        }
+        return nullptr;
+    }
+
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+    if (cached && cached->mtime == st.st_mtime && cached->size == size)
+    {
+        cached->checkedAtMs.store(now, std::memory_order_relaxed);
+        return cached;
+    }
+
+    // 预算按原始大小的两倍估算（各压缩变体之和不超过原始大小）；超限的文件交给调用方直接读盘
+    uint64_t reclaim = cached ? entryBytes(*cached) : 0;
+    if (size > options_.maxFileBytes || totalBytes_.load(std::memory_order_relaxed) - reclaim + size * 2 >
+                                            options_.maxTotalBytes)
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Entry> entry = load(filePath, mimeType, st.st_mtime, size);
+    if (!entry)
+    {
+        return nullptr;
+    }
+    entry->checkedAtMs.store(now, std::memory_order_relaxed);
+
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto& slot = entries_[filePath];
+        if (slot)
+        {
+            totalBytes_.fetch_sub(entryBytes(*slot), std::memory_order_relaxed);
+        }
+        slot = entry;
+        totalBytes_.fetch_add(entryBytes(*entry), std::memory_order_relaxed);
+    }
+    SPDLOG_DEBUG_TAG("HTTP") << "[StaticCache] Loaded " << filePath << " (" << size << " bytes, total "
+                             << totalBytes_.load() << ")";
+    return entry;
+}
+
+std::shared_ptr<StaticFileCache::Entry> StaticFileCache::load(const std::string& filePath,
+                                                              const std::string& mimeType,
+                                                              time_t mtime,
+                                                              uint64_t size)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file)
+    {
+        return nullptr;
+    }
+    auto raw = std::make_shared<std::string>();
+    raw->resize(size);
+    if (size > 0 && !file.read(&(*raw)[0], static_cast<std::streamsize>(size)))
+    {
+        return nullptr;  // 读取期间文件被截断，下次请求重试
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->path = filePath;
+    entry->mtime = mtime;
+    entry->size = size;
+    entry->lastModified = httpDate(mtime);
+
+    char tag[48];
+    snprintf(tag, sizeof tag, "%llx-%016llx", static_cast<unsigned long long>(size),
+             static_cast<unsigned long long>(fnv1a(*raw)));
+    entry->etag = std::string("\"") + tag + "\"";
+
+    bool compressible = isCompressible(mimeType) && size >= options_.minCompressBytes;
+    entry->variants[kIdentity].body = raw;
+#ifdef HAS_ZLIB
+    if (compressible)
+    {
+        auto gz = std::make_shared<std::string>();
+        if (gzipCompress(*raw, gz.get()) && gz->size() < raw->size())
+        {
+            entry->variants[kGzip].body = gz;
+        }
+    }
+#endif
+#ifdef HAS_BROTLI
+    if (compressible)
+    {
+        auto br = std::make_shared<std::string>();
+        if (brotliCompress(*raw, br.get()) && br->size() < raw->size())
+        {
+            entry->variants[kBrotli].body = br;
+        }
+    }
+#endif
+
+    // 预拼头部块：命中时直接整体追加进输出缓冲区
+    std::string cacheControl = "Cache-Control: public, max-age=" + std::to_string(options_.maxAgeSec) + "\r\n";
+    std::string vary = compressible ? "Vary: Accept-Encoding\r\n" : "";
+    for (int i = 0; i < kEncodingCount; ++i)
+    {
+        Variant& v = entry->variants[i];
+        if (!v.body)
+        {
+            continue;
+        }
+        auto enc = static_cast<Encoding>(i);
+        // 强 ETag 需区分内容编码（RFC 7232 §2.3.3）
+        v.etag = enc == kIdentity ? entry->etag
+                                  : entry->etag.substr(0, entry->etag.size() - 1) + "-" + encodingName(enc) + "\"";
+        std::string common = "ETag: " + v.etag + "\r\nLast-Modified: " + entry->lastModified + "\r\n" +
+                             cacheControl + vary;
+
+        std::string ok = "Content-Type: " + mimeType + "\r\nContent-Length: " + std::to_string(v.body->size()) +
+                         "\r\n" + common;
+        if (enc != kIdentity)
+        {
+            ok += std::string("Content-Encoding: ") + encodingName(enc) + "\r\n";
+        }
+        else
+        {
+            ok += "Accept-Ranges: bytes\r\n";  // Range 请求只对 identity 表示生效
+        }
+        v.headers = std::make_shared<const std::string>(std::move(ok));
+        v.notModified = std::make_shared<const std::string>(std::move(common));
+    }
+    return entry;
+}
+
+StaticFileCache::Encoding StaticFileCache::negotiate(const Entry& entry, std::string_view acceptEncoding)
+{
+    AcceptEncoding accept = AcceptEncoding::parse(acceptEncoding);
+    double q[kEncodingCount];
+    q[kIdentity] = accept.identity;
+    q[kGzip] = accept.gzip;
+    q[kBrotli] = accept.br;
+
+    Encoding best = kIdentity;
+    double bestQ = 0;
+    // 同 q 值时偏好压缩率更高的编码
+    const Encoding order[] = {kBrotli, kGzip, kIdentity};
+    for (Encoding enc : order)
+    {
+        if (entry.variants[enc].body && q[enc] > bestQ)
+        {
+            best = enc;
+            bestQ = q[enc];
+        }
+    }
+    return best;
+}
+
+bool StaticFileCache::notModified(const Entry& entry, std::string_view ifNoneMatch, std::string_view ifModifiedSince)
+{
+    if (!ifNoneMatch.empty())
+    {
+        // If-None-Match 使用弱比较：忽略 W/ 前缀
+        while (!ifNoneMatch.empty())
+        {
+            size_t comma = ifNoneMatch.find(',');
+            std::string_view tag = trim(ifNoneMatch.substr(0, comma));
+            ifNoneMatch = comma == std::string_view::npos ? std::string_view() : ifNoneMatch.substr(comma + 1);
+            if (tag == "*")
+            {
+                return true;
+            }
+            if (tag.size() > 2 && tag[0] == 'W' && tag[1] == '/')
+            {
+                tag.remove_prefix(2);
+            }
+            for (const auto& v : entry.variants)
+            {
+                if (v.body && tag == v.etag)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;  // 有 If-None-Match 时忽略 If-Modified-Since（RFC 7232 §6）
+    }
+    if (!ifModifiedSince.empty())
+    {
+        time_t since = 0;
+        return parseHttpDate(ifModifiedSince, &since) && entry.mtime <= since;
+    }
+    return false;
+}
+
+}  // namespace http
@@ -1,8 +1,7 @@
 #include "http/StaticFileHandler.h"
 
 #include <algorithm>
-#include <fstream>
-#include <sstream>
+#include <cstdio>
 
 #include "Logging/Logger.h"
 #include "http/HttpRequest.h"
@@ -11,12 +10,14 @@
 namespace http
 {
 
-StaticFileHandler::StaticFileHandler(const std::string& resourceRoot) : resourceRoot_(resourceRoot) {}
+StaticFileHandler::StaticFileHandler(const std::string& resourceRoot, StaticFileCache::Options cacheOptions)
+    : resourceRoot_(resourceRoot), cache_(cacheOptions)
+{
+}
 
 void StaticFileHandler::handle(const HttpRequest& req, HttpResponse* resp)
 {
     std::string urlPath = req.path();
-    SPDLOG_INFO_TAG("HTTP") << "[StaticFile] Request: " << urlPath;
     if (!isPathSafe(urlPath))
     {
         SPDLOG_WARN_TAG("HTTP") << "[StaticFile] Unsafe path rejected: " << urlPath;
@@ -25,25 +26,115 @@ void StaticFileHandler::handle(const HttpRequest& req, HttpResponse* resp)
         return;
     }
     std::string filePath = resourceRoot_ + "web" + urlPath;
-    SPDLOG_INFO_TAG("HTTP") << "[StaticFile] Resolved to: " << filePath;
-    std::ifstream file(filePath, std::ios::binary);
-    if (!file)
+    std::string mime = getMimeType(urlPath);
+
+    StaticFileCache::EntryPtr entry = cache_.lookup(filePath, mime);
+    std::string_view range = req.headerView("Range");
+    if (!entry || !range.empty())
+    {
+        // 大文件 / 未缓存文件 / 区间请求：引用 fd，由 HttpServer 以 sendfile 或有界分段发送
+        serveFile(req, filePath, mime, entry.get(), resp);
+        return;
+    }
+
+    // 命中：按 Accept-Encoding 选取预压缩变体，头部与响应体均直接引用缓存，无文件 IO
+    StaticFileCache::Encoding enc = StaticFileCache::negotiate(*entry, req.headerView("Accept-Encoding"));
+    const StaticFileCache::Variant& variant = entry->variants[enc];
+    resp->setVersion(req.getVersion());
+    if (StaticFileCache::notModified(*entry, req.headerView("If-None-Match"), req.headerView("If-Modified-Since")))
+    {
+        // 304：只带所选变体的校验头，不带响应体
+        resp->setStatusCode(HttpResponse::k304NotModified);
+        resp->setStatusMessage("Not Modified");
+        resp->setHeaderBlock(variant.notModified);
+        return;
+    }
+    resp->setStatusCode(HttpResponse::k200Ok);
+    resp->setStatusMessage("OK");
+    resp->setHeaderBlock(variant.headers);
+    resp->setSharedBody(variant.body);
+    SPDLOG_DEBUG_TAG("HTTP") << "[StaticFile] Cache hit " << urlPath << " encoding=" << enc
+                             << " bytes=" << variant.body->size();
+}
+
+void StaticFileHandler::serveFile(const HttpRequest& req,
+                                  const std::string& filePath,
+                                  const std::string& mime,
+                                  const StaticFileCache::Entry* entry,
+                                  HttpResponse* resp)
+{
+    std::shared_ptr<FileBody> body = FileBody::open(filePath);
+    if (!body)
     {
         SPDLOG_WARN_TAG("HTTP") << "[StaticFile] File not found: " << filePath;
         resp->setStatusCode(HttpResponse::k404NotFound);
         resp->setBody("404 Not Found");
         return;
     }
-    std::ostringstream ss;
-    ss << file.rdbuf();
-    std::string content = ss.str();
-    SPDLOG_INFO_TAG("HTTP") << "[StaticFile] Served " << content.size() << " bytes, MIME: " << getMimeType(urlPath);
+
+    // 校验器：缓存条目用内容 ETag；未缓存的大文件用 size + mtime（不为求 ETag 读全文件）
+    std::string lastModified = StaticFileCache::httpDate(body->mtime());
+    std::string etag;
+    if (entry && entry->mtime == body->mtime() && entry->size == body->fileSize())
+    {
+        etag = entry->etag;
+    }
+    else
+    {
+        char buf[48];
+        snprintf(buf, sizeof buf, "\"%llx-%llx\"", static_cast<unsigned long long>(body->fileSize()),
+                 static_cast<unsigned long long>(body->mtime()));
+        etag = buf;
+    }
+
     resp->setVersion(req.getVersion());
-    resp->setStatusMessage("OK");
-    resp->setContentType(getMimeType(urlPath));
-    resp->setContentLength(content.size());
-    resp->setBody(content);
-    resp->setStatusCode(HttpResponse::k200Ok);
+    resp->setContentType(mime);
+    resp->addHeader("Accept-Ranges", "bytes");
+    resp->addHeader("ETag", etag);
+    resp->addHeader("Last-Modified", lastModified);
+    resp->addHeader("Cache-Control", "public, max-age=" + std::to_string(cache_.options().maxAgeSec));
+    if (req.headerView("If-None-Match") == etag)
+    {
+        resp->setStatusCode(HttpResponse::k304NotModified);
+        resp->setStatusMessage("Not Modified");
+        return;
+    }
+
+    uint64_t offset = 0;
+    uint64_t length = body->fileSize();
+    ByteRangeResult range = ByteRangeResult::kNone;
+    std::string_view rangeHeader = req.headerView("Range");
+    std::string_view ifRange = req.headerView("If-Range");
+    // If-Range 与当前校验器不一致时忽略 Range，返回完整内容（RFC 7233 §3.2）
+    if (!rangeHeader.empty() && (ifRange.empty() || ifRange == etag || ifRange == lastModified))
+    {
+        range = parseByteRange(rangeHeader, body->fileSize(), &offset, &length);
+    }
+
+    if (range == ByteRangeResult::kUnsatisfiable)
+    {
+        resp->setStatusCode(HttpResponse::k416RangeNotSatisfiable);
+        resp->setStatusMessage("Range Not Satisfiable");
+        resp->addHeader("Content-Range", "bytes */" + std::to_string(body->fileSize()));
+        resp->setContentLength(0);
+        return;
+    }
+    if (range == ByteRangeResult::kSatisfiable)
+    {
+        resp->setStatusCode(HttpResponse::k206PartialContent);
+        resp->setStatusMessage("Partial Content");
+        resp->addHeader("Content-Range", "bytes " + std::to_string(offset) + "-" + std::to_string(offset + length - 1) +
+                                             "/" + std::to_string(body->fileSize()));
+    }
+    else
+    {
+        resp->setStatusCode(HttpResponse::k200Ok);
+        resp->setStatusMessage("OK");
+    }
+    body->setRange(offset, length);
+    resp->setContentLength(length);
+    resp->setFileBody(std::move(body));
+    SPDLOG_DEBUG_TAG("HTTP") << "[StaticFile] File body " << filePath << " offset=" << offset << " length=" << length;
 }
 
 bool StaticFileHandler::isPathSafe(const std::string& path)
@@ -9,19 +9,20 @@ namespace http
 namespace middleware
 {
 
-void AdminAuthMiddleware::before(HttpRequest& request)
+bool AdminAuthMiddleware::appliesTo(std::string_view routePattern) const
 {
-    std::string path = request.path();
-
     // Only intercept /admin/* paths
-    if (path.size() < 6 || path.substr(0, 6) != "/admin") return;
+    return routePattern.substr(0, 6) == "/admin";
+}
 
-    std::string role = request.getHeader("X-Auth-Role");
+bool AdminAuthMiddleware::before(HttpRequest& request, HttpResponse* response)
+{
+    const std::string& role = request.authRole();
     if (role != "admin")
     {
-        SPDLOG_WARN_TAG("AUTH") << "Admin access denied for role='" << role << "' path=" << path;
+        SPDLOG_WARN_TAG("AUTH") << "Admin access denied for role='" << role << "' path=" << request.path();
 
-        HttpResponse resp(false);
+        HttpResponse& resp = *response;
         resp.setStatusCode(HttpResponse::k403Forbidden);
         resp.setStatusMessage("Forbidden");
         resp.setContentType("application/json");
@@ -34,10 +35,11 @@ void AdminAuthMiddleware::before(HttpRequest& request)
         std::string bodyStr = body.dump();
         resp.setContentLength(bodyStr.size());
         resp.setBody(bodyStr);
-        throw resp;
+        return false;
     }
 
-    SPDLOG_DEBUG_TAG("AUTH") << "Admin access granted for path=" << path;
+    SPDLOG_DEBUG_TAG("AUTH") << "Admin access granted for path=" << request.path();
+    return true;
 }
 
 }  // namespace middleware
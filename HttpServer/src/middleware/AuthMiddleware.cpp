@@ -1,90 +1,87 @@
 #include "middleware/AuthMiddleware.h"
 
-#include <sstream>
-
-#include "Auth/JwtService.h"
-
 namespace http
 {
 namespace middleware
 {
 
-AuthMiddleware::AuthMiddleware()
+namespace
 {
-    common::JwtService jwtService;
-    secret_ = jwtService.secret();
+
+void writeUnauthorized(HttpResponse* resp, const char* message)
+{
+    resp->setStatusCode(HttpResponse::k401Unauthorized);
+    resp->setStatusMessage("Unauthorized");
+    resp->setContentType("application/json");
+    json body;
+    body["success"] = false;
+    body["error"]["code"] = 401;
+    body["error"]["message"] = message;
+    std::string bodyStr = body.dump();
+    resp->setContentLength(bodyStr.size());
+    resp->setBody(bodyStr);
 }
 
-bool AuthMiddleware::isPublicPath(const std::string& path)
+}  // namespace
+
+AuthMiddleware::AuthMiddleware(Mode mode) : mode_(mode) {}
+
+bool AuthMiddleware::isPublicPath(std::string_view path)
 {
     return path == "/api/invite/verify" || path == "/api/verify/send" || path == "/api/verify/check" ||
            path == "/login" || path == "/register" || path == "/" || path == "/entry";
 }
 
-std::string AuthMiddleware::extractJwtFromCookie(const HttpRequest& request)
+std::string_view AuthMiddleware::extractJwtFromCookie(const HttpRequest& request)
 {
-    std::string cookie = request.getHeader("Cookie");
+    std::string_view cookie = request.headerView("Cookie");
     if (cookie.empty()) return {};
 
     // Parse: "jwt=<token>; other=val"
     size_t pos = cookie.find("jwt=");
-    if (pos == std::string::npos) return {};
+    if (pos == std::string_view::npos) return {};
 
     pos += 4;  // skip "jwt="
     size_t end = cookie.find(';', pos);
-    if (end == std::string::npos) return cookie.substr(pos);
+    if (end == std::string_view::npos) return cookie.substr(pos);
     return cookie.substr(pos, end - pos);
 }
 
-void AuthMiddleware::before(HttpRequest& request)
+bool AuthMiddleware::appliesTo(std::string_view routePattern) const
 {
+    if (mode_ == Mode::kOptional)
+    {
+        return routePattern.substr(0, 5) == "/chat";
+    }
     // Protect /api/* and /admin/* paths — both need JWT authentication
-    std::string path = request.path();
-    bool isApi = path.size() >= 4 && path.substr(0, 4) == "/api";
-    bool isAdmin = path.size() >= 6 && path.substr(0, 6) == "/admin";
-    if (!isApi && !isAdmin) return;
-    if (isPublicPath(path)) return;
+    bool isApi = routePattern.substr(0, 4) == "/api";
+    bool isAdmin = routePattern.substr(0, 6) == "/admin";
+    return (isApi || isAdmin) && !isPublicPath(routePattern);
+}
 
+bool AuthMiddleware::before(HttpRequest& request, HttpResponse* response)
+{
     // Extract JWT from cookie
-    std::string token = extractJwtFromCookie(request);
+    std::string_view token = extractJwtFromCookie(request);
     if (token.empty())
     {
-        HttpResponse resp(false);
-        resp.setStatusCode(HttpResponse::k401Unauthorized);
-        resp.setStatusMessage("Unauthorized");
-        resp.setContentType("application/json");
-        json body;
-        body["success"] = false;
-        body["error"]["code"] = 401;
-        body["error"]["message"] = "Authentication required";
-        std::string bodyStr = body.dump();
-        resp.setContentLength(bodyStr.size());
-        resp.setBody(bodyStr);
-        throw resp;
+        if (mode_ == Mode::kOptional) return true;
+        writeUnauthorized(response, "Authentication required");
+        return false;
     }
 
-    // Verify JWT
-    common::JwtService jwtService(secret_);
-    json payload = jwtService.verify(token);
-    if (payload.empty())
+    // Verify JWT (per-thread cache of verified tokens)
+    common::JwtClaims claims;
+    if (!jwt_.verifyClaims(token, &claims))
     {
-        HttpResponse resp(false);
-        resp.setStatusCode(HttpResponse::k401Unauthorized);
-        resp.setStatusMessage("Unauthorized");
-        resp.setContentType("application/json");
-        json body;
-        body["success"] = false;
-        body["error"]["code"] = 401;
-        body["error"]["message"] = "Invalid or expired token";
-        std::string bodyStr = body.dump();
-        resp.setContentLength(bodyStr.size());
-        resp.setBody(bodyStr);
-        throw resp;
+        if (mode_ == Mode::kOptional) return true;
+        writeUnauthorized(response, "Invalid or expired token");
+        return false;
     }
 
-    // Attach user info as custom headers for downstream handlers
-    request.addHeader("X-Auth-UserId", std::to_string(payload["sub"].get<long long>()));
-    request.addHeader("X-Auth-Role", payload["role"].get<std::string>());
+    // Attach verified identity for downstream middleware and handlers
+    request.setAuth(claims.userId, std::move(claims.role));
+    return true;
 }
 
 }  // namespace middleware
@@ -0,0 +1,75 @@
+#include "middleware/CompressionMiddleware.h"
+
+namespace http
+{
+namespace middleware
+{
+
+namespace
+{
+
+constexpr std::string_view kVary = "Vary: Accept-Encoding\r\n";
+
+std::string_view encodingHeader(ContentEncoding encoding)
+{
+    switch (encoding)
+    {
+        case ContentEncoding::kGzip:
+            return "Content-Encoding: gzip\r\n";
+        case ContentEncoding::kDeflate:
+            return "Content-Encoding: deflate\r\n";
+        case ContentEncoding::kBrotli:
+            return "Content-Encoding: br\r\n";
+        default:
+            return std::string_view();
+    }
+}
+
+}  // namespace
+
+CompressionMiddleware::CompressionMiddleware(CompressionOptions options) : options_(std::move(options)) {}
+
+bool CompressionMiddleware::before(HttpRequest& request, HttpResponse* response)
+{
+    if (response && options_.enabled)
+    {
+        response->setAcceptedEncoding(negotiateEncoding(request.headerView("Accept-Encoding"), options_.brotli));
+    }
+    return true;
+}
+
+void CompressionMiddleware::after(HttpResponse& response)
+{
+    if (!options_.enabled || response.isDeferred() || response.fileBody() || response.hasSharedBody()) return;
+
+    HttpResponse::HttpStatusCode status = response.getStatusCode();
+    if (status == HttpResponse::k204NoContent || status == HttpResponse::k206PartialContent ||
+        status == HttpResponse::k304NotModified)
+    {
+        return;
+    }
+    const std::string& body = response.getBody();
+    if (body.size() < options_.minBytes || !options_.compressible(response.getContentType()) ||
+        response.findHeader("Content-Encoding"))
+    {
+        return;
+    }
+
+    // 可压缩的响应随 Accept-Encoding 变化，即使本次未压缩也要告知缓存
+    response.addRawHeaders(kVary);
+    ContentEncoding encoding = response.acceptedEncoding();
+    if (encoding == ContentEncoding::kIdentity) return;
+
+    std::string compressed;
+    if (!Compressor::threadLocal().compress(encoding, options_.level(encoding), body, &compressed) ||
+        compressed.size() >= body.size())
+    {
+        return;
+    }
+    response.setContentLength(compressed.size());
+    response.setBody(std::move(compressed));
+    response.addRawHeaders(encodingHeader(encoding));
+}
+
+}  // namespace middleware
+}  // namespace http
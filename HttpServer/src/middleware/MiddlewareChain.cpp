@@ -1,5 +1,7 @@
 #include "../../include/middleware/MiddlewareChain.h"
 
+#include <algorithm>
+
 #include "Logging/Logger.h"
 
 namespace http
@@ -9,28 +11,47 @@ namespace middleware
 
 void MiddlewareChain::addMiddleware(std::shared_ptr<Middleware> middleware)
 {
-    middlewares_.push_back(middleware);
+    if (middleware)
+    {
+        middlewares_.push_back(std::move(middleware));
+    }
+}
+
+std::shared_ptr<const MiddlewareChain> MiddlewareChain::compile(std::string_view routePattern) const
+{
+    auto chain = std::make_shared<MiddlewareChain>();
+    for (const auto& middleware : middlewares_)
+    {
+        if (middleware->appliesTo(routePattern))
+        {
+            chain->middlewares_.push_back(middleware);
+        }
+    }
+    return chain;
 }
 
-void MiddlewareChain::processBefore(HttpRequest& request)
+bool MiddlewareChain::processBefore(HttpRequest& request, HttpResponse* response, size_t* passed) const
 {
-    for (auto& middleware : middlewares_)
+    size_t i = 0;
+    for (; i < middlewares_.size(); ++i)
     {
-        middleware->before(request);
+        if (!middlewares_[i]->before(request, response))
+        {
+            break;
+        }
     }
+    *passed = i;
+    return i == middlewares_.size();
 }
 
-void MiddlewareChain::processAfter(HttpResponse& response)
+void MiddlewareChain::processAfter(HttpResponse& response, size_t count) const
 {
     try
     {
         // 反向处理响应，以保持中间件的正确执行顺序
-        for (auto it = middlewares_.rbegin(); it != middlewares_.rend(); ++it)
+        for (size_t i = std::min(count, middlewares_.size()); i > 0; --i)
         {
-            if (*it)
-            {  // 添加空指针检查
-                (*it)->after(response);
-            }
+            middlewares_[i - 1]->after(response);
         }
     }
     catch (const std::exception& e)
@@ -1,6 +1,7 @@
 #include "middleware/RateLimitMiddleware.h"
 
-#include <memory>
+#include <algorithm>
+#include <cmath>
 
 #include "Common/Http/ApiResult.h"
 #include "Logging/Logger.h"
@@ -10,52 +11,61 @@ namespace http
 namespace middleware
 {
 
-common::TokenBucket& RateLimitMiddleware::getBucket(long long userId)
+RateLimitMiddleware::RateLimitMiddleware(int maxTokens, double refillPerSec)
+    : RateLimitMiddleware({RateLimitRule{"/api/chat", {{"*", common::RateLimit{maxTokens, refillPerSec}}},
+                                         std::make_shared<common::ShardedRateLimiter>()}})
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = buckets_.find(userId);
-    if (it == buckets_.end())
+}
+
+RateLimitMiddleware::RateLimitMiddleware(std::vector<RateLimitRule> rules) : rules_(std::move(rules)) {}
+
+const RateLimitRule* RateLimitMiddleware::matchRule(std::string_view path) const
+{
+    for (const auto& rule : rules_)
     {
-        it = buckets_.emplace(userId, std::make_unique<common::TokenBucket>(maxTokens_, refillPerSec_)).first;
+        if (path.substr(0, rule.routePrefix.size()) == rule.routePrefix) return &rule;
     }
-    return *it->second;
+    return nullptr;
 }
 
-void RateLimitMiddleware::before(HttpRequest& request)
+bool RateLimitMiddleware::appliesTo(std::string_view routePattern) const
 {
-    // Only limit /api/chat/* routes
-    std::string path = request.path();
-    if (path.find("/api/chat") != 0) return;
+    // 路由模式的字面前缀与请求路径一致，按同样的前缀规则挑选
+    return matchRule(routePattern) != nullptr;
+}
 
-    long long userId = 0;
-    std::string uidStr = request.getHeader("X-Auth-UserId");
-    if (!uidStr.empty())
-    {
-        try
-        {
-            userId = std::stoll(uidStr);
-        }
-        catch (...)
-        {
-        }
-    }
-    if (userId == 0) return;  // unauthenticated, skip (AuthMiddleware handles 401)
+bool RateLimitMiddleware::before(HttpRequest& request, HttpResponse* response)
+{
+    long long userId = request.authUserId();
+    if (userId == 0) return true;  // unauthenticated, skip (AuthMiddleware handles 401)
+
+    const RateLimitRule* rule = matchRule(request.pathView());
+    if (!rule || !rule->limiter) return true;
+    auto tier = rule->tiers.find(request.authRole());
+    if (tier == rule->tiers.end()) tier = rule->tiers.find("*");
+    if (tier == rule->tiers.end()) return true;
 
-    auto& bucket = getBucket(userId);
-    if (!bucket.consume(1))
+    const common::RateLimit& limit = tier->second;
+    int64_t retryAfterNs = 0;
+    if (!rule->limiter->acquire(userId, limit, 1, &retryAfterNs))
     {
-        SPDLOG_WARN_TAG("RATE") << "Rate limit exceeded for userId=" << userId;
-        HttpResponse resp(false);
+        SPDLOG_WARN_TAG("RATE") << "Rate limit exceeded for userId=" << userId << " on " << rule->routePrefix;
+        int perMinute = static_cast<int>(std::lround(limit.perSec * 60));
+        long long retryAfterSec = std::max<long long>(1, (retryAfterNs + 999999999LL) / 1000000000LL);
+        HttpResponse& resp = *response;
         resp.setStatusCode(HttpResponse::k429TooManyRequests);
         resp.setStatusMessage("Too Many Requests");
         resp.setContentType("application/json");
-        json body = common::ApiResult::fail(429, "Rate limit exceeded. Max 10 requests per minute.").toJson();
+        json body = common::ApiResult::fail(429, "Rate limit exceeded. Max " + std::to_string(perMinute) +
+                                                     " requests per minute.")
+                        .toJson();
         std::string bodyStr = body.dump();
         resp.setContentLength(bodyStr.size());
         resp.setBody(bodyStr);
-        resp.addHeader("Retry-After", "6");
-        throw resp;
+        resp.addHeader("Retry-After", std::to_string(retryAfterSec));
+        return false;
     }
+    return true;
 }
 
 }  // namespace middleware
@@ -1,40 +1,25 @@
 #include "middleware/RequestIdMiddleware.h"
 
-#include <chrono>
-#include <fstream>
-#include <sstream>
-
 #include "Common/Logging/LogContext.h"
+#include "Common/Logging/RequestId.h"
 
 namespace http
 {
 namespace middleware
 {
 
-std::string RequestIdMiddleware::generateUuid()
-{
-    std::ifstream f("/proc/sys/kernel/random/uuid");
-    if (f)
-    {
-        std::string uuid;
-        std::getline(f, uuid);
-        if (!uuid.empty()) return uuid;
-    }
-    auto now = std::chrono::system_clock::now();
-    auto ts = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
-    return "req-" + std::to_string(ts);
-}
-
-void RequestIdMiddleware::before(HttpRequest& request)
+bool RequestIdMiddleware::before(HttpRequest& request, HttpResponse*)
 {
+    // 沿用上游（nginx / 调用方）传入的 ID；缺失或含非法字符时生成新的，保证可安全转发与入库
     std::string req_id = request.getHeader("X-Request-Id");
-    if (req_id.empty())
+    if (!common::isValidRequestId(req_id))
     {
-        req_id = generateUuid();
+        req_id = common::generateRequestId();
         request.addHeader("X-Request-Id", req_id);
     }
-    std::string uid = request.getHeader("X-Auth-UserId");
+    std::string uid = request.authUserId() != 0 ? std::to_string(request.authUserId()) : std::string();
     common::setLogContext(req_id, uid);
+    return true;
 }
 
 void RequestIdMiddleware::after(HttpResponse& response)
@@ -11,39 +11,37 @@ namespace http
 namespace middleware
 {
 
-CorsMiddleware::CorsMiddleware(const CorsConfig& config) : config_(config) {}
+CorsMiddleware::CorsMiddleware(const CorsConfig& config) : config_(config)
+{
+    // 普通响应的 CORS 头只取决于配置：允许所有源时为 "*"，否则为第一个允许的源；构造时编码一次
+    if (!config_.allowedOrigins.empty())
+    {
+        bool any = std::find(config_.allowedOrigins.begin(), config_.allowedOrigins.end(), "*") !=
+                   config_.allowedOrigins.end();
+        responseHeaders_ = buildCorsHeaders(any ? "*" : config_.allowedOrigins[0]);
+    }
+}
 
-void CorsMiddleware::before(HttpRequest& request)
+bool CorsMiddleware::before(HttpRequest& request, HttpResponse* response)
 {
     SPDLOG_DEBUG_TAG("HTTP") << "CorsMiddleware::before - Processing request";
 
     if (request.method() == HttpRequest::Method::kOptions)
     {
         SPDLOG_INFO_TAG("HTTP") << "Processing CORS preflight request";
-        HttpResponse response;
-        handlePreflightRequest(request, response);
-        throw response;
+        handlePreflightRequest(request, *response);
+        return false;
     }
+    return true;
 }
 
 void CorsMiddleware::after(HttpResponse& response)
 {
     SPDLOG_DEBUG_TAG("HTTP") << "CorsMiddleware::after - Processing response";
 
-    // 直接添加CORS头，简化处理逻辑
-    if (!config_.allowedOrigins.empty())
+    if (responseHeaders_.block())
     {
-        // 如果允许所有源
-        if (std::find(config_.allowedOrigins.begin(), config_.allowedOrigins.end(), "*") !=
-            config_.allowedOrigins.end())
-        {
-            addCorsHeaders(response, "*");
-        }
-        else
-        {
-            // 添加第一个允许的源
-            addCorsHeaders(response, config_.allowedOrigins[0]);
-        }
+        response.addRawHeaders(*responseHeaders_.block());
     }
 }
 
@@ -76,25 +74,7 @@ void CorsMiddleware::addCorsHeaders(HttpResponse& response, const std::string& o
 {
     try
     {
-        response.addHeader("Access-Control-Allow-Origin", origin);
-
-        if (config_.allowCredentials)
-        {
-            response.addHeader("Access-Control-Allow-Credentials", "true");
-        }
-
-        if (!config_.allowedMethods.empty())
-        {
-            response.addHeader("Access-Control-Allow-Methods", join(config_.allowedMethods, ", "));
-        }
-
-        if (!config_.allowedHeaders.empty())
-        {
-            response.addHeader("Access-Control-Allow-Headers", join(config_.allowedHeaders, ", "));
-        }
-
-        response.addHeader("Access-Control-Max-Age", std::to_string(config_.maxAge));
-
+        response.setHeaderTemplate(buildCorsHeaders(origin));
         SPDLOG_DEBUG_TAG("HTTP") << "CORS headers added successfully";
     }
     catch (const std::exception& e)
@@ -103,6 +83,30 @@ void CorsMiddleware::addCorsHeaders(HttpResponse& response, const std::string& o
     }
 }
 
+HeaderTemplate CorsMiddleware::buildCorsHeaders(const std::string& origin) const
+{
+    HeaderTemplate headers;
+    headers.add("Access-Control-Allow-Origin", origin);
+
+    if (config_.allowCredentials)
+    {
+        headers.add("Access-Control-Allow-Credentials", "true");
+    }
+
+    if (!config_.allowedMethods.empty())
+    {
+        headers.add("Access-Control-Allow-Methods", join(config_.allowedMethods, ", "));
+    }
+
+    if (!config_.allowedHeaders.empty())
+    {
+        headers.add("Access-Control-Allow-Headers", join(config_.allowedHeaders, ", "));
+    }
+
+    headers.add("Access-Control-Max-Age", std::to_string(config_.maxAge));
+    return headers;
+}
+
 // 工具函数：将字符串数组连接成单个字符串
 std::string CorsMiddleware::join(const std::vector<std::string>& strings, const std::string& delimiter)
 {
@@ -7,81 +7,341 @@ namespace http
 namespace router
 {
 
-void Router::registerHandler(HttpRequest::Method method, const std::string& path, HandlerPtr handler)
+// 前缀树节点。静态子节点按首字符索引；参数与通配符子节点各至多一个，
+// 参数名不存于树上而是存于 RouteTarget，因此 "/task/:taskId" 与 "/task/:id/x" 可以共存。
+struct Router::Node
+{
+    std::string prefix;                          // 压缩后的静态片段
+    std::string indices;                         // children[i]->prefix[0]，匹配时线性扫描
+    std::vector<std::unique_ptr<Node>> children;  // 静态子节点
+    std::unique_ptr<Node> paramChild;            // ":name"
+    std::unique_ptr<Node> wildcardChild;         // "*name"
+    std::unique_ptr<RouteTarget> target;         // 终止于此节点的路由
+};
+
+namespace
+{
+
+size_t commonPrefix(std::string_view a, std::string_view b)
 {
-    RouteKey key{method, path};
-    if (handlers_.find(key) != handlers_.end())
+    size_t n = std::min(a.size(), b.size());
+    size_t i = 0;
+    while (i < n && a[i] == b[i])
     {
-        SPDLOG_ERROR_TAG("HTTP") << "Router::registerHandler: handler already exists";
-        return;
+        ++i;
     }
-    handlers_[key] = std::move(handler);
+    return i;
 }
 
-void Router::registerCallback(HttpRequest::Method method, const std::string& path, const HandlerCallback& callback)
+}  // namespace
+
+Router::Router() = default;
+Router::~Router() = default;
+
+std::unique_ptr<Router::Node> Router::cloneNode(const std::unique_ptr<Node>& node)
 {
-    RouteKey key{method, path};
-    callbacks_[key] = std::move(callback);
+    if (!node)
+    {
+        return nullptr;
+    }
+    auto copy = std::make_unique<Node>();
+    copy->prefix = node->prefix;
+    copy->indices = node->indices;
+    copy->children.reserve(node->children.size());
+    for (const auto& child : node->children)
+    {
+        copy->children.push_back(cloneNode(child));
+    }
+    copy->paramChild = cloneNode(node->paramChild);
+    copy->wildcardChild = cloneNode(node->wildcardChild);
+    if (node->target)
+    {
+        copy->target = std::make_unique<RouteTarget>(*node->target);
+    }
+    return copy;
 }
 
-bool Router::route(const HttpRequest& req, HttpResponse* resp)
+std::unique_ptr<Router> Router::clone() const
 {
-    RouteKey key{req.method(), req.path()};
+    auto copy = std::make_unique<Router>();
+    for (size_t i = 0; i < kMethodCount; ++i)
+    {
+        copy->roots_[i] = cloneNode(roots_[i]);
+    }
+    return copy;
+}
 
-    // 查找处理器
-    auto handlerIt = handlers_.find(key);
-    if (handlerIt != handlers_.end())
+Router::RouteTarget* Router::insert(HttpRequest::Method method, const std::string& path)
+{
+    if (method <= HttpRequest::kInvalid || static_cast<size_t>(method) >= kMethodCount || path.empty() ||
+        path[0] != '/')
     {
-        // 执行处理器
-        handlerIt->second->handle(req, resp);
-        return true;
+        SPDLOG_ERROR_TAG("HTTP") << "Router: invalid route " << path;
+        return nullptr;
     }
 
-    // 查找回调函数
-    auto callbackIt = callbacks_.find(key);
-    if (callbackIt != callbacks_.end())
+    std::unique_ptr<Node>& root = roots_[method];
+    if (!root)
     {
-        // 执行回调函数
-        callbackIt->second(req, resp);
-        return true;
+        root = std::make_unique<Node>();
     }
 
-    // 查找动态路由处理器
-    for (const auto& [method, pathRegex, handler] : regexHandlers_)
+    Node* node = root.get();
+    std::vector<std::string> paramNames;
+    std::string_view rest(path);
+    while (!rest.empty())
     {
-        std::smatch match;
-        std::string pathStr(req.path());
-        // 如果方法匹配并且动态路由匹配，则执行处理器
-        if (method == req.method() && std::regex_match(pathStr, match, pathRegex))
+        if (rest[0] == ':' || rest[0] == '*')
         {
-            // Extract path parameters and add them to the request
-            HttpRequest newReq(req);  // 因为这里需要用这一次所以是可以改的
-            extractPathParameters(match, newReq);
+            bool wildcard = rest[0] == '*';
+            size_t end = wildcard ? rest.size() : rest.find('/');
+            if (end == std::string_view::npos)
+            {
+                end = rest.size();
+            }
+            if (end == 1 || paramNames.size() == kMaxParams)
+            {
+                SPDLOG_ERROR_TAG("HTTP") << "Router: bad parameter in route " << path;
+                return nullptr;
+            }
+            if (wildcard && rest.find('/') != std::string_view::npos)
+            {
+                SPDLOG_ERROR_TAG("HTTP") << "Router: wildcard must be the last segment: " << path;
+                return nullptr;
+            }
+            paramNames.emplace_back(rest.substr(1, end - 1));
+            std::unique_ptr<Node>& child = wildcard ? node->wildcardChild : node->paramChild;
+            if (!child)
+            {
+                child = std::make_unique<Node>();
+            }
+            node = child.get();
+            rest.remove_prefix(end);
+            continue;
+        }
 
-            handler->handle(newReq, resp);
-            return true;
+        // 静态片段：取到下一个参数/通配符为止，插入压缩前缀树
+        size_t end = rest.find_first_of(":*");
+        std::string_view text = rest.substr(0, end);
+        rest.remove_prefix(text.size());
+        while (!text.empty())
+        {
+            size_t idx = node->indices.find(text[0]);
+            if (idx == std::string::npos)
+            {
+                auto child = std::make_unique<Node>();
+                child->prefix.assign(text);
+                node->indices.push_back(text[0]);
+                node->children.push_back(std::move(child));
+                node = node->children.back().get();
+                break;
+            }
+            Node* child = node->children[idx].get();
+            size_t common = commonPrefix(child->prefix, text);
+            if (common < child->prefix.size())
+            {
+                // 分裂：child 的公共前缀部分提为新的中间节点
+                auto mid = std::make_unique<Node>();
+                mid->prefix = child->prefix.substr(0, common);
+                child->prefix.erase(0, common);
+                mid->indices.push_back(child->prefix[0]);
+                mid->children.push_back(std::move(node->children[idx]));
+                node->children[idx] = std::move(mid);
+                child = node->children[idx].get();
+            }
+            node = child;
+            text.remove_prefix(common);
         }
     }
 
-    // 查找动态路由回调函数
-    for (const auto& [method, pathRegex, callback] : regexCallbacks_)
+    if (!node->target)
+    {
+        node->target = std::make_unique<RouteTarget>();
+        node->target->pattern = path;
+        node->target->paramNames = std::move(paramNames);
+    }
+    return node->target.get();
+}
+
+void Router::registerHandler(HttpRequest::Method method, const std::string& path, HandlerPtr handler)
+{
+    RouteTarget* target = insert(method, path);
+    if (!target)
+    {
+        return;
+    }
+    if (target->handler)
     {
-        std::smatch match;
-        std::string pathStr(req.path());
-        // 如果方法匹配并且动态路由匹配，则执行回调函数
-        if (method == req.method() && std::regex_match(pathStr, match, pathRegex))
+        SPDLOG_ERROR_TAG("HTTP") << "Router::registerHandler: handler already exists";
+        return;
+    }
+    target->handler = std::move(handler);
+}
+
+void Router::registerCallback(HttpRequest::Method method, const std::string& path, const HandlerCallback& callback)
+{
+    RouteTarget* target = insert(method, path);
+    if (target)
+    {
+        target->callback = callback;
+    }
+}
+
+namespace
+{
+
+// 回溯匹配：静态 > 参数 > 通配符。调用时 node->prefix 已被消费。
+template <typename NodeT, typename MatchT>
+bool matchNode(const NodeT* node, std::string_view path, MatchT* m)
+{
+    if (path.empty())
+    {
+        if (node->target)
+        {
+            m->target = node->target.get();
+            return true;
+        }
+        // "/assets/*path" 允许匹配 "/assets/"（通配符为空）
+        if (node->wildcardChild && node->wildcardChild->target)
         {
-            // Extract path parameters and add them to the request
-            HttpRequest newReq(req);  // 因为这里需要用这一次所以是可以改的
-            extractPathParameters(match, newReq);
+            m->values[m->count++] = path;
+            m->target = node->wildcardChild->target.get();
+            return true;
+        }
+        return false;
+    }
 
-            callback(newReq, resp);
+    size_t idx = node->indices.find(path[0]);
+    if (idx != std::string::npos)
+    {
+        const NodeT* child = node->children[idx].get();
+        const std::string& prefix = child->prefix;
+        if (path.size() >= prefix.size() && path.compare(0, prefix.size(), prefix) == 0 &&
+            matchNode(child, path.substr(prefix.size()), m))
+        {
             return true;
         }
     }
 
+    if (node->paramChild && m->count < m->values.size())
+    {
+        size_t end = path.find('/');
+        if (end == std::string_view::npos)
+        {
+            end = path.size();
+        }
+        if (end > 0)
+        {
+            size_t saved = m->count;
+            m->values[m->count++] = path.substr(0, end);
+            if (matchNode(node->paramChild.get(), path.substr(end), m))
+            {
+                return true;
+            }
+            m->count = saved;
+        }
+    }
+
+    if (node->wildcardChild && node->wildcardChild->target && m->count < m->values.size())
+    {
+        m->values[m->count++] = path;
+        m->target = node->wildcardChild->target.get();
+        return true;
+    }
     return false;
 }
 
+}  // namespace
+
+bool Router::match(HttpRequest::Method method, std::string_view path, RouteMatch* m) const
+{
+    m->target = nullptr;
+    m->count = 0;
+    if (method <= HttpRequest::kInvalid || static_cast<size_t>(method) >= kMethodCount || !roots_[method])
+    {
+        return false;
+    }
+    return matchNode(roots_[method].get(), path, m);
+}
+
+void Router::dispatch(const RouteMatch& m, HttpRequest& req, HttpResponse* resp)
+{
+    const RouteTarget& target = *m.target;
+    for (size_t i = 0; i < m.count && i < target.paramNames.size(); ++i)
+    {
+        req.addPathParameter(target.paramNames[i], m.values[i]);
+    }
+    if (target.handler)
+    {
+        target.handler->handle(req, resp);
+    }
+    else
+    {
+        target.callback(req, resp);
+    }
+}
+
+void Router::forEachNode(Node* node, const std::function<void(RouteTarget&)>& fn)
+{
+    if (!node)
+    {
+        return;
+    }
+    if (node->target)
+    {
+        fn(*node->target);
+    }
+    for (const auto& child : node->children)
+    {
+        forEachNode(child.get(), fn);
+    }
+    forEachNode(node->paramChild.get(), fn);
+    forEachNode(node->wildcardChild.get(), fn);
+}
+
+void Router::forEachRoute(const std::function<void(RouteTarget&)>& fn)
+{
+    for (auto& root : roots_)
+    {
+        forEachNode(root.get(), fn);
+    }
+}
+
+bool Router::route(HttpRequest& req, HttpResponse* resp)
+{
+    RouteMatch m;
+    if (!match(req.method(), req.pathView(), &m) || (!m.target->handler && !m.target->callback))
+    {
+        return false;
+    }
+    dispatch(m, req, resp);
+    return true;
+}
+
+bool Router::route(const HttpRequest& req, HttpResponse* resp)
+{
+    RouteMatch m;
+    if (!match(req.method(), req.pathView(), &m) || (!m.target->handler && !m.target->callback))
+    {
+        return false;
+    }
+    if (m.count == 0)
+    {
+        // 无路径参数：无需修改请求，直接以只读方式分发
+        if (m.target->handler)
+        {
+            m.target->handler->handle(req, resp);
+        }
+        else
+        {
+            m.target->callback(req, resp);
+        }
+        return true;
+    }
+    HttpRequest newReq(req);
+    dispatch(m, newReq, resp);
+    return true;
+}
+
 }  // namespace router
-}  // namespace http
\ No newline at end of file
+}  // namespace http
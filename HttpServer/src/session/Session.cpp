@@ -7,6 +7,56 @@ namespace http
 namespace session
 {
 
+namespace
+{
+
+int64_t steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+constexpr uint8_t kCodecVersion = 1;
+
+void putVarint(std::string& out, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+bool getVarint(const std::string& in, size_t& pos, uint64_t& v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7)
+    {
+        uint8_t byte = static_cast<uint8_t>(in[pos++]);
+        v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool getString(const std::string& in, size_t& pos, std::string& out)
+{
+    uint64_t len = 0;
+    if (!getVarint(in, pos, len) || len > in.size() - pos)
+    {
+        return false;
+    }
+    out.assign(in, pos, static_cast<size_t>(len));
+    pos += static_cast<size_t>(len);
+    return true;
+}
+
+}  // namespace
+
 Session::Session(const std::string& sessionId, SessionManager* sessionManager, int maxAge)
     : sessionId_(sessionId), maxAge_(maxAge), sessionManager_(sessionManager)
 {
@@ -16,20 +66,29 @@ Session::Session(const std::string& sessionId, SessionManager* sessionManager, i
 // 检查会话是否已过期
 bool Session::isExpired() const
 {
-    return std::chrono::system_clock::now() > expiryTime_;
+    return steadyNowMs() > expiryMs_.load(std::memory_order_relaxed);
 }
 
 // 刷新会话的过期时间
 void Session::refresh()
 {
-    expiryTime_ = std::chrono::system_clock::now() + std::chrono::seconds(maxAge_);
+    expiryMs_.store(steadyNowMs() + static_cast<int64_t>(maxAge_) * 1000, std::memory_order_relaxed);
+}
+
+int64_t Session::expiresInSec() const
+{
+    int64_t remainingMs = expiryMs_.load(std::memory_order_relaxed) - steadyNowMs();
+    return remainingMs > 0 ? (remainingMs + 999) / 1000 : 0;
 }
 
 // 设置会话数据
 void Session::setValue(const std::string& key, const std::string& value)
 {
-    data_[key] = value;
-    // 如果设置了manager，自动保存更改
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        data_[key] = value;
+    }
+    // 如果设置了manager，自动保存更改（匿名会话在此首次写入存储）
     if (sessionManager_)
     {
         sessionManager_->updateSession(shared_from_this());
@@ -39,6 +98,7 @@ void Session::setValue(const std::string& key, const std::string& value)
 // 获取会话数据
 std::string Session::getValue(const std::string& key) const
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto it = data_.find(key);
     return it != data_.end() ? it->second : std::string();
 }
@@ -46,14 +106,85 @@ std::string Session::getValue(const std::string& key) const
 // 删除会话数据
 void Session::remove(const std::string& key)
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     data_.erase(key);
 }
 
 // 清空会话数据
 void Session::clear()
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     data_.clear();
 }
 
+std::string Session::serialize() const
+{
+    std::string out;
+    out.push_back(static_cast<char>(kCodecVersion));
+    putVarint(out, static_cast<uint64_t>(maxAge_ > 0 ? maxAge_ : 0));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    putVarint(out, data_.size());
+    for (const auto& [key, value] : data_)
+    {
+        putVarint(out, key.size());
+        out.append(key);
+        putVarint(out, value.size());
+        out.append(value);
+    }
+    return out;
+}
+
+std::shared_ptr<Session> Session::deserialize(const std::string& sessionId, const std::string& bytes)
+{
+    if (bytes.empty() || static_cast<uint8_t>(bytes[0]) != kCodecVersion)
+    {
+        return nullptr;
+    }
+    size_t pos = 1;
+    uint64_t maxAge = 0;
+    uint64_t count = 0;
+    if (!getVarint(bytes, pos, maxAge) || !getVarint(bytes, pos, count) || maxAge > INT32_MAX)
+    {
+        return nullptr;
+    }
+
+    auto session = std::make_shared<Session>(sessionId, nullptr, static_cast<int>(maxAge));
+    std::string key;
+    std::string value;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        if (!getString(bytes, pos, key) || !getString(bytes, pos, value))
+        {
+            return nullptr;
+        }
+        session->data_[key] = value;
+    }
+    if (pos != bytes.size())
+    {
+        return nullptr;
+    }
+    session->persisted_.store(true, std::memory_order_release);
+    return session;
+}
+
+void Session::setPendingCookie(HttpResponse* resp)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pendingCookie_ = resp;
+}
+
+HttpResponse* Session::markPersisted()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (persisted_.exchange(true, std::memory_order_acq_rel))
+    {
+        return nullptr;
+    }
+    HttpResponse* resp = pendingCookie_;
+    pendingCookie_ = nullptr;
+    return resp;
+}
+
 }  // namespace session
 }  // namespace http
\ No newline at end of file
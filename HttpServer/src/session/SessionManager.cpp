@@ -1,25 +1,28 @@
 #include "session/SessionManager.h"
 
+#include <openssl/rand.h>
+
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 
 namespace http
 {
 namespace session
 {
 
-// 初始化会话管理器，设置会话存储对象和随机数生成器
-SessionManager::SessionManager(std::unique_ptr<SessionStorage> storage)
-    : storage_(std::move(storage)), rng_(std::random_device{}())  // 初始化随机数生成器，用于生成随机的会话ID
-{
-}
+// 初始化会话管理器，设置会话存储对象
+SessionManager::SessionManager(std::unique_ptr<SessionStorage> storage) : storage_(std::move(storage)) {}
 
 // 从请求中获取或创建会话，也就是说，如果请求中包含会话ID，则从存储中加载会话，否则创建一个新的会话
 std::shared_ptr<Session> SessionManager::getSession(const HttpRequest& req, HttpResponse* resp)
 {
-    std::string sessionId = getSessionIdFromCookie(req);
+    return getSession(getSessionIdFromCookie(req), resp);
+}
 
+std::shared_ptr<Session> SessionManager::getSession(const std::string& sessionId, HttpResponse* resp)
+{
     std::shared_ptr<Session> session;
 
     if (!sessionId.empty())
@@ -29,32 +32,45 @@ std::shared_ptr<Session> SessionManager::getSession(const HttpRequest& req, Http
 
     if (!session || session->isExpired())
     {
-        sessionId = generateSessionId();
-        session = std::make_shared<Session>(sessionId, this);
-        setSessionCookie(sessionId, resp);
-    }
-    else
-    {
-        session->setManager(this);  // 为现有会话设置管理器
+        // 暂不写入存储，也不下发 Cookie，等 Handler 真正写入数据时由 updateSession 完成
+        session = std::make_shared<Session>(generateSessionId(), this);
+        session->setPendingCookie(resp);
+        return session;
     }
 
-    session->refresh();
-    storage_->save(session);  // 这里可能有问题，需要确保正确保存会话
+    session->setManager(this);  // 为现有会话设置管理器
+    session->refresh();         // 存储中保存的就是该对象，刷新过期时间即可，无需重新保存
     return session;
 }
 
+void SessionManager::updateSession(std::shared_ptr<Session> session)
+{
+    if (HttpResponse* resp = session->markPersisted())
+    {
+        setSessionCookie(session->getId(), resp);
+    }
+    storage_->save(std::move(session));
+}
+
 // 生成唯一的会话标识符，确保会话的唯一性和安全性
 std::string SessionManager::generateSessionId()
 {
-    std::stringstream ss;
-    std::uniform_int_distribution<> dist(0, 15);
+    // 会话 ID 即登录凭证，必须取自 CSPRNG：mt19937 的输出可以反推内部状态，进而预测其他会话的 ID
+    unsigned char bytes[16];
+    if (RAND_bytes(bytes, sizeof(bytes)) != 1)
+    {
+        throw std::runtime_error("RAND_bytes failed to generate session id");
+    }
 
     // 生成32个字符的会话ID，每个字符是一个十六进制数字
-    for (int i = 0; i < 32; ++i)
+    static const char kHex[] = "0123456789abcdef";
+    std::string id(32, '0');
+    for (size_t i = 0; i < sizeof(bytes); ++i)
     {
-        ss << std::hex << dist(rng_);
+        id[i * 2] = kHex[bytes[i] >> 4];
+        id[i * 2 + 1] = kHex[bytes[i] & 0xF];
     }
-    return ss.str();
+    return id;
 }
 
 void SessionManager::destroySession(const std::string& sessionId)
@@ -62,11 +78,9 @@ void SessionManager::destroySession(const std::string& sessionId)
     storage_->remove(sessionId);
 }
 
-void SessionManager::cleanExpiredSessions()
+size_t SessionManager::cleanExpiredSessions()
 {
-    // 注意：这个实现依赖于具体的存储实现
-    // 对于内存存储，可以在加载时检查是否过期
-    // 对于其他存储的实现，可能需要定期清理过期会话
+    return storage_->removeExpired();
 }
 
 std::string SessionManager::getSessionIdFromCookie(const HttpRequest& req)
@@ -1,6 +1,6 @@
 #include "../include/session/SessionStorage.h"
 
-#include <iostream>
+#include <functional>
 
 namespace http
 {
@@ -8,38 +8,167 @@ namespace http
 namespace session
 {
 
-void MemorySessionStorage::save(std::shared_ptr<Session> session)
+MemorySessionStorage::MemorySessionStorage(size_t maxSessions, size_t shards, bool expiryThread)
 {
-    // 创建会话副本并存储
-    sessions_[session->getId()] = session;
+    size_t count = shards > 0 ? shards : 1;
+    maxPerShard_ = maxSessions > 0 ? (maxSessions + count - 1) / count : 0;
+    shards_.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        shards_.push_back(std::make_unique<Shard>([this, i](const std::shared_ptr<Session>& session, uint64_t token)
+                                                  { return onExpire(*shards_[i], session, token); }));
+    }
+    if (expiryThread)
+    {
+        expiryThread_ = std::thread(&MemorySessionStorage::expiryLoop, this);
+    }
 }
 
-// 通过会话ID从存储中加载会话
-std::shared_ptr<Session> MemorySessionStorage::load(const std::string& sessionId)
+MemorySessionStorage::~MemorySessionStorage()
 {
-    auto it = sessions_.find(sessionId);
-    if (it != sessions_.end())
+    if (expiryThread_.joinable())
     {
-        if (!it->second->isExpired())
         {
-            return it->second;
+            std::lock_guard<std::mutex> lock(stopMutex_);
+            stopping_ = true;
         }
-        else
+        stopCv_.notify_one();
+        expiryThread_.join();
+    }
+}
+
+MemorySessionStorage::Shard& MemorySessionStorage::shardFor(const std::string& sessionId)
+{
+    return *shards_[std::hash<std::string>{}(sessionId) % shards_.size()];
+}
+
+void MemorySessionStorage::save(std::shared_ptr<Session> session)
+{
+    Shard& shard = shardFor(session->getId());
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(session->getId());
+    if (it != shard.index.end())
+    {
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru);
+        if (*it->second.lru == session)
         {
-            // 如果会话已过期，则从存储中移除
-            sessions_.erase(it);
+            return;  // 同一对象：只更新访问顺序
         }
+        // 换成了新对象：时间轮只持有旧对象的 weak_ptr，需以新令牌重新登记
+        *it->second.lru = session;
+        it->second.token = ++shard.nextToken;
+        shard.wheel.schedule(session, it->second.token, static_cast<int>(session->expiresInSec()));
+        return;
     }
 
-    // 如果会话不存在或已过期，则返回nullptr
-    return nullptr;
+    if (maxPerShard_ > 0 && shard.index.size() >= maxPerShard_)
+    {
+        eraseLocked(shard, shard.index.find(shard.lru.back()->getId()));
+        evicted_.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t token = ++shard.nextToken;
+    shard.lru.push_front(session);
+    shard.index.emplace(session->getId(), Entry{shard.lru.begin(), token});
+    shard.wheel.schedule(session, token, static_cast<int>(session->expiresInSec()));
+}
+
+// 通过会话ID从存储中加载会话
+std::shared_ptr<Session> MemorySessionStorage::load(const std::string& sessionId)
+{
+    Shard& shard = shardFor(sessionId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(sessionId);
+    if (it == shard.index.end())
+    {
+        return nullptr;
+    }
+    if ((*it->second.lru)->isExpired())
+    {
+        // 如果会话已过期，则从存储中移除
+        eraseLocked(shard, it);
+        return nullptr;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru);
+    return *it->second.lru;
 }
 
 // 通过会话ID从存储中移除会话
 void MemorySessionStorage::remove(const std::string& sessionId)
 {
-    sessions_.erase(sessionId);
+    Shard& shard = shardFor(sessionId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(sessionId);
+    if (it != shard.index.end())
+    {
+        eraseLocked(shard, it);
+    }
+}
+
+size_t MemorySessionStorage::removeExpired()
+{
+    size_t removed = 0;
+    for (auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (auto it = shard->index.begin(); it != shard->index.end();)
+        {
+            auto next = std::next(it);
+            if ((*it->second.lru)->isExpired())
+            {
+                eraseLocked(*shard, it);
+                ++removed;
+            }
+            it = next;
+        }
+    }
+    return removed;
+}
+
+size_t MemorySessionStorage::size() const
+{
+    size_t total = 0;
+    for (const auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total += shard->index.size();
+    }
+    return total;
+}
+
+int MemorySessionStorage::onExpire(Shard& shard, const std::shared_ptr<Session>& session, uint64_t token)
+{
+    auto it = shard.index.find(session->getId());
+    if (it == shard.index.end() || it->second.token != token)
+    {
+        return 0;  // 已删除，或删除后又以新登记插入
+    }
+    int64_t remaining = session->expiresInSec();
+    if (remaining > 0)
+    {
+        return static_cast<int>(remaining);  // 期间被访问过，顺延
+    }
+    eraseLocked(shard, it);
+    return 0;
+}
+
+void MemorySessionStorage::eraseLocked(Shard& shard, std::unordered_map<std::string, Entry>::iterator it)
+{
+    shard.lru.erase(it->second.lru);
+    shard.index.erase(it);
+}
+
+void MemorySessionStorage::expiryLoop()
+{
+    std::unique_lock<std::mutex> lock(stopMutex_);
+    while (!stopCv_.wait_for(lock, std::chrono::seconds(1), [this]() { return stopping_; }))
+    {
+        for (auto& shard : shards_)
+        {
+            std::lock_guard<std::mutex> shardLock(shard->mutex);
+            shard->wheel.tick();
+        }
+    }
 }
 
 }  // namespace session
-}  // namespace http
\ No newline at end of file
+}  // namespace http
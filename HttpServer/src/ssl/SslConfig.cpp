@@ -8,7 +8,9 @@ SslConfig::SslConfig()
       verifyClient_(false),
       verifyDepth_(4),
       sessionTimeout_(300),
-      sessionCacheSize_(20480L)
+      sessionCacheSize_(20480L),
+      ticketKeyRotation_(3600),
+      dynamicRecordSizing_(true)
 {
 }
 
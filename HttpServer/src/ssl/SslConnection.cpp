@@ -2,6 +2,10 @@
 
 #include <openssl/err.h>
 
+#include <algorithm>
+#include <climits>
+#include <chrono>
+
 #include "Logging/Logger.h"
 
 namespace ssl
@@ -52,16 +56,18 @@ SslConnection::SslConnection(const TcpConnectionPtr& conn, SslContext* ctx)
     // 设置 SSL 选项
     SSL_set_mode(ssl_, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
     SSL_set_mode(ssl_, SSL_MODE_ENABLE_PARTIAL_WRITE);
-
-    // 设置连接回调
-    conn_->setMessageCallback(
-        std::bind(&SslConnection::onRead, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
 }
 
 SslConnection::~SslConnection()
 {
     if (ssl_)
     {
+        if (state_ == SSLState::ESTABLISHED)
+        {
+            // 连接多为直接关闭而非收发 close_notify；不标记关闭的话 SSL_free 会把会话
+            // 从服务端缓存移除，客户端再来只能完整握手
+            SSL_set_shutdown(ssl_, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+        }
         SSL_free(ssl_);  // 这会同时释放 BIO
     }
 }
@@ -80,72 +86,112 @@ void SslConnection::send(const void* data, size_t len)
         return;
     }
 
-    int written = SSL_write(ssl_, data, len);
-    if (written <= 0)
+    // 动态记录大小：空闲一段时间后的首批数据按小记录发送，使每条记录落在单个 TCP 段内、
+    // 客户端收到即可解密（SSE 首包、小响应的首字节延迟）；累计发送足够多后改用 16KB 大记录，
+    // 减少批量传输的记录开销与加密调用次数
+    bool dynamic = ctx_->config().getDynamicRecordSizing();
+    if (dynamic)
     {
-        int err = SSL_get_error(ssl_, written);
-        SPDLOG_ERROR_TAG("SSL") << "SSL_write failed: " << ERR_error_string(err, nullptr);
-        return;
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastSendTime_ > kRecordIdleReset)
+        {
+            boostedBytes_ = 0;
+        }
+        lastSendTime_ = now;
     }
 
-    char buf[4096];
-    int pending;
-    while ((pending = BIO_pending(writeBio_)) > 0)
+    // 开启了 PARTIAL_WRITE，大块数据可能分多次写入；内存 BIO 不会阻塞，循环直到全部加密
+    const char* p = static_cast<const char*>(data);
+    while (len > 0)
     {
-        int bytes = BIO_read(writeBio_, buf, std::min(pending, static_cast<int>(sizeof(buf))));
-        if (bytes > 0)
+        size_t limit = INT_MAX;
+        if (dynamic && boostedBytes_ < kRecordBoostThreshold)
+        {
+            limit = kSmallRecordBytes;
+        }
+        int written = SSL_write(ssl_, p, static_cast<int>(std::min(len, limit)));
+        if (written <= 0)
         {
-            conn_->send(buf, bytes);
+            int err = SSL_get_error(ssl_, written);
+            SPDLOG_ERROR_TAG("SSL") << "SSL_write failed: " << ERR_error_string(err, nullptr);
+            break;
         }
+        p += written;
+        len -= static_cast<size_t>(written);
+        boostedBytes_ += static_cast<size_t>(written);
     }
+    flushWriteBio();
 }
 
 void SslConnection::onRead(const TcpConnectionPtr& conn, BufferPtr buf, muduo::Timestamp time)
 {
+    // 密文整体交给读 BIO，由 OpenSSL 自行切分记录；不完整的记录留在 BIO 中等下次补齐
+    BIO_write(readBio_, buf->peek(), static_cast<int>(buf->readableBytes()));
+    buf->retrieveAll();
+
     if (state_ == SSLState::HANDSHAKE)
     {
-        // 将数据写入 BIO
-        BIO_write(readBio_, buf->peek(), buf->readableBytes());
-        buf->retrieve(buf->readableBytes());
         handleHandshake();
+    }
+    if (state_ != SSLState::ESTABLISHED)
+    {
         return;
     }
-    else if (state_ == SSLState::ESTABLISHED)
+
+    // 解密全部可读记录，追加到 decryptedBuffer_；上层未消费的半个请求留在其中
+    size_t before = decryptedBuffer_.readableBytes();
+    for (;;)
     {
-        // 解密数据
-        char decryptedData[4096];
-        int ret = SSL_read(ssl_, decryptedData, sizeof(decryptedData));
-        if (ret > 0)
+        decryptedBuffer_.ensureWritableBytes(kReadChunkBytes);
+        int ret = SSL_read(ssl_, decryptedBuffer_.beginWrite(), static_cast<int>(decryptedBuffer_.writableBytes()));
+        if (ret <= 0)
         {
-            // 创建新的 Buffer 存储解密后的数据
-            muduo::net::Buffer decryptedBuffer;
-            decryptedBuffer.append(decryptedData, ret);
-
-            // 调用上层回调处理解密后的数据
-            if (messageCallback_)
+            int err = SSL_get_error(ssl_, ret);
+            if (err == SSL_ERROR_ZERO_RETURN)
             {
-                messageCallback_(conn, &decryptedBuffer, time);
+                conn_->shutdown();  // 对端发来 close_notify
             }
+            else if (err != SSL_ERROR_WANT_READ)
+            {
+                handleError(getLastError(ret));
+            }
+            break;
         }
+        decryptedBuffer_.hasWritten(static_cast<size_t>(ret));
+    }
+    // TLS 1.3 的 NewSessionTicket、KeyUpdate 等可能在读取时产生待发数据
+    flushWriteBio();
+
+    if (messageCallback_ && decryptedBuffer_.readableBytes() > before)
+    {
+        messageCallback_(conn, &decryptedBuffer_, time);
+    }
+}
+
+void SslConnection::flushWriteBio()
+{
+    // 直接取出内存 BIO 中的全部密文，一次交给连接，不再逐 4KB 拷贝
+    char* data = nullptr;
+    long pending = BIO_get_mem_data(writeBio_, &data);
+    if (pending > 0)
+    {
+        conn_->send(data, static_cast<int>(pending));
+        (void)BIO_reset(writeBio_);
     }
 }
 
 void SslConnection::handleHandshake()
 {
     int ret = SSL_do_handshake(ssl_);
+    // 握手消息写在内存 BIO 中，须主动发给对端
+    flushWriteBio();
 
     if (ret == 1)
     {
         state_ = SSLState::ESTABLISHED;
-        SPDLOG_INFO_TAG("SSL") << "SSL handshake completed successfully";
-        SPDLOG_INFO_TAG("SSL") << "Using cipher: " << SSL_get_cipher(ssl_);
-        SPDLOG_INFO_TAG("SSL") << "Protocol version: " << SSL_get_version(ssl_);
-
-        // 握手完成后，确保设置了正确的回调
-        if (!messageCallback_)
-        {
-            SPDLOG_WARN_TAG("SSL") << "No message callback set after SSL handshake";
-        }
+        ctx_->stats().countHandshake(SSL_session_reused(ssl_) ? SslSessionStats::kResumed : SslSessionStats::kFull);
+        SPDLOG_DEBUG_TAG("SSL") << "SSL handshake completed, cipher: " << SSL_get_cipher(ssl_)
+                                << ", protocol: " << SSL_get_version(ssl_);
         return;
     }
 
@@ -164,6 +210,8 @@ void SslConnection::handleHandshake()
             unsigned long errCode = ERR_get_error();
             ERR_error_string_n(errCode, errBuf, sizeof(errBuf));
             SPDLOG_ERROR_TAG("SSL") << "SSL handshake failed: " << errBuf;
+            ctx_->stats().countHandshake(SslSessionStats::kFailed);
+            state_ = SSLState::ERROR;
             conn_->shutdown();  // 关闭连接
             break;
         }
@@ -1,6 +1,14 @@
 #include "../../include/ssl/SslContext.h"
 
 #include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#endif
+
+#include <cstring>
+#include <ctime>
 
 #include "Logging/Logger.h"
 
@@ -14,6 +22,7 @@ SslContext::~SslContext()
     {
         SSL_CTX_free(ctx_);
     }
+    OPENSSL_cleanse(ticketKeys_, sizeof(ticketKeys_));
 }
 
 bool SslContext::initialize()
@@ -48,6 +57,7 @@ bool SslContext::initialize()
 
     // 设置会话缓存
     setupSessionCache();
+    setupSessionTickets();
 
     SPDLOG_INFO_TAG("SSL") << "SSL context initialized successfully";
     return true;
@@ -130,6 +140,145 @@ void SslContext::setupSessionCache()
     SSL_CTX_set_timeout(ctx_, config_.getSessionTimeout());
 }
 
+void SslContext::setupSessionTickets()
+{
+    if (config_.getTicketKeyRotation() <= 0)
+    {
+        SSL_CTX_set_options(ctx_, SSL_OP_NO_TICKET);
+        return;
+    }
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    // 无状态票据：会话状态由客户端保存，复用时无需查服务端缓存，多进程 / 多 acceptor 之间也能互认
+    if (!generateTicketKey(&ticketKeys_[0], static_cast<int64_t>(std::time(nullptr))))
+    {
+        SPDLOG_WARN_TAG("SSL") << "Failed to generate session ticket key, using OpenSSL default ticket keys";
+        return;
+    }
+    SSL_CTX_set_app_data(ctx_, this);
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx_, &SslContext::ticketKeyCallback);
+#else
+    SPDLOG_WARN_TAG("SSL") << "Session ticket key rotation requires OpenSSL 3.0, using OpenSSL default ticket keys";
+#endif
+}
+
+bool SslContext::generateTicketKey(TicketKey* key, int64_t nowSec)
+{
+    if (RAND_bytes(key->name, sizeof(key->name)) != 1 || RAND_bytes(key->aesKey, sizeof(key->aesKey)) != 1 ||
+        RAND_bytes(key->hmacKey, sizeof(key->hmacKey)) != 1)
+    {
+        return false;
+    }
+    key->createdSec = nowSec;
+    return true;
+}
+
+bool SslContext::rotateTicketKeysLocked(int64_t nowSec)
+{
+    int64_t age = nowSec - ticketKeys_[0].createdSec;
+    int rotation = config_.getTicketKeyRotation();
+    if (age < rotation)
+    {
+        return true;
+    }
+    TicketKey next;
+    if (!generateTicketKey(&next, nowSec))
+    {
+        return false;
+    }
+    // 密钥自创建起至多可解密两个周期；长时间无人握手时当前密钥也已过期，不再保留为上一把
+    hasPreviousKey_ = age < 2 * static_cast<int64_t>(rotation);
+    ticketKeys_[1] = ticketKeys_[0];
+    ticketKeys_[0] = next;
+    OPENSSL_cleanse(&next, sizeof(next));
+    SPDLOG_INFO_TAG("SSL") << "Session ticket key rotated";
+    return true;
+}
+
+bool SslContext::currentTicketKey(TicketKey* out)
+{
+    std::lock_guard<std::mutex> lock(ticketMutex_);
+    if (!rotateTicketKeysLocked(static_cast<int64_t>(std::time(nullptr))))
+    {
+        return false;
+    }
+    *out = ticketKeys_[0];
+    return true;
+}
+
+int SslContext::findTicketKey(const unsigned char* name, TicketKey* out)
+{
+    std::lock_guard<std::mutex> lock(ticketMutex_);
+    rotateTicketKeysLocked(static_cast<int64_t>(std::time(nullptr)));
+    if (std::memcmp(name, ticketKeys_[0].name, sizeof(ticketKeys_[0].name)) == 0)
+    {
+        *out = ticketKeys_[0];
+        return 1;
+    }
+    if (hasPreviousKey_ && std::memcmp(name, ticketKeys_[1].name, sizeof(ticketKeys_[1].name)) == 0)
+    {
+        *out = ticketKeys_[1];
+        return 2;
+    }
+    return 0;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+int SslContext::ticketKeyCallback(SSL* ssl,
+                                  unsigned char* keyName,
+                                  unsigned char* iv,
+                                  EVP_CIPHER_CTX* cipherCtx,
+                                  EVP_MAC_CTX* macCtx,
+                                  int enc)
+{
+    auto* self = static_cast<SslContext*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+    TicketKey key;
+    int ret = 1;
+    if (enc)
+    {
+        if (!self->currentTicketKey(&key) || RAND_bytes(iv, EVP_MAX_IV_LENGTH) != 1)
+        {
+            return -1;
+        }
+        std::memcpy(keyName, key.name, sizeof(key.name));
+        if (EVP_EncryptInit_ex(cipherCtx, EVP_aes_256_cbc(), nullptr, key.aesKey, iv) != 1)
+        {
+            OPENSSL_cleanse(&key, sizeof(key));
+            return -1;
+        }
+        self->stats_.countTicket(SslSessionStats::kIssued);
+    }
+    else
+    {
+        ret = self->findTicketKey(keyName, &key);
+        if (ret == 0)
+        {
+            self->stats_.countTicket(SslSessionStats::kUnknownKey);
+            return 0;  // 退回完整握手并签发新票据
+        }
+        if (EVP_DecryptInit_ex(cipherCtx, EVP_aes_256_cbc(), nullptr, key.aesKey, iv) != 1)
+        {
+            OPENSSL_cleanse(&key, sizeof(key));
+            return -1;
+        }
+        self->stats_.countTicket(ret == 1 ? SslSessionStats::kDecrypted : SslSessionStats::kRenewed);
+        // TLS 1.3 的票据应只用一次：返回 1 时 OpenSSL 复用后不再签发新票据，客户端下次重连只能完整握手
+        if (SSL_version(ssl) >= TLS1_3_VERSION)
+        {
+            ret = 2;
+        }
+    }
+
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key.hmacKey, sizeof(key.hmacKey)),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>("SHA256"), 0),
+        OSSL_PARAM_construct_end(),
+    };
+    int macOk = EVP_MAC_CTX_set_params(macCtx, params);
+    OPENSSL_cleanse(&key, sizeof(key));
+    return macOk == 1 ? ret : -1;
+}
+#endif
+
 void SslContext::handleSslError(const char* msg)
 {
     char buf[256];
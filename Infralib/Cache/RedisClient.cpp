@@ -1,5 +1,6 @@
 #include "RedisClient.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "Common/Logging/Logger.h"
@@ -9,6 +10,19 @@ namespace infra
 namespace cache
 {
 
+namespace
+{
+
+constexpr std::chrono::milliseconds kMinReconnectBackoff{100};
+constexpr std::chrono::milliseconds kMaxReconnectBackoff{5000};
+
+struct timeval toTimeval(int ms)
+{
+    return {ms / 1000, (ms % 1000) * 1000};
+}
+
+}  // namespace
+
 RedisClient::~RedisClient()
 {
     if (ctx_)
@@ -26,8 +40,7 @@ bool RedisClient::connect(const std::string& host, int port, const std::string&
     password_ = password;
     db_ = db;
 
-    struct timeval timeout = {2, 0};  // 2s 连接超时
-    ctx_ = redisConnectWithTimeout(host.c_str(), port, timeout);
+    ctx_ = redisConnectWithTimeout(host.c_str(), port, connectTimeout_);
 
     if (!ctx_ || ctx_->err)
     {
@@ -40,6 +53,8 @@ bool RedisClient::connect(const std::string& host, int port, const std::string&
         connected_ = false;
         return false;
     }
+    // 命令超时：Redis 卡住时调用方最多阻塞 commandTimeout_，而不是无限等待
+    redisSetTimeout(ctx_, commandTimeout_);
 
     // AUTH
     if (!password_.empty())
@@ -69,17 +84,36 @@ bool RedisClient::connect(const std::string& host, int port, const std::string&
     return true;
 }
 
-void RedisClient::ensureConnected()
+void RedisClient::setTimeouts(int connectMs, int commandMs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    connectTimeout_ = toTimeval(connectMs);
+    commandTimeout_ = toTimeval(commandMs);
+}
+
+bool RedisClient::ensureConnected()
 {
     // 保存连接状态，出现错误时自动重连。
-    if (connected_ && ctx_ && !ctx_->err) return;
+    if (connected_ && ctx_ && !ctx_->err) return true;
     if (ctx_)
     {
         redisFree(ctx_);
         ctx_ = nullptr;
     }
     connected_ = false;
-    connect(host_, port_, password_, db_);
+
+    // 重连退避：Redis 不可用期间调用直接失败，不在每次调用上都持锁等待一次连接超时
+    auto now = std::chrono::steady_clock::now();
+    if (now < nextReconnect_) return false;
+    if (connect(host_, port_, password_, db_))
+    {
+        reconnectBackoff_ = std::chrono::milliseconds(0);
+        return true;
+    }
+    reconnectBackoff_ = reconnectBackoff_.count() == 0 ? kMinReconnectBackoff
+                                                       : std::min(reconnectBackoff_ * 2, kMaxReconnectBackoff);
+    nextReconnect_ = now + reconnectBackoff_;
+    return false;
 }
 
 void RedisClient::freeReply(redisReply* reply)
@@ -91,7 +125,7 @@ std::string RedisClient::get(const std::string& key)
 {
     // 所有 Redis 命令都在内部加锁，避免多线程并发访问同一个 hiredis ctx。
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return {};
 
     auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "GET %s", key.c_str()));
     if (!reply) return {};
@@ -105,7 +139,7 @@ std::string RedisClient::get(const std::string& key)
 bool RedisClient::set(const std::string& key, const std::string& value)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return false;
 
     auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "SET %s %b", key.c_str(), value.data(), value.size()));
     bool ok = reply && reply->type == REDIS_REPLY_STATUS;
@@ -116,7 +150,7 @@ bool RedisClient::set(const std::string& key, const std::string& value)
 bool RedisClient::setex(const std::string& key, int ttlSeconds, const std::string& value)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return false;
 
     auto* reply = static_cast<redisReply*>(
         redisCommand(ctx_, "SETEX %s %d %b", key.c_str(), ttlSeconds, value.data(), value.size()));
@@ -128,7 +162,7 @@ bool RedisClient::setex(const std::string& key, int ttlSeconds, const std::strin
 int RedisClient::del(const std::string& key)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return 0;
 
     auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "DEL %s", key.c_str()));
     int count = (reply && reply->type == REDIS_REPLY_INTEGER) ? static_cast<int>(reply->integer) : 0;
@@ -139,7 +173,7 @@ int RedisClient::del(const std::string& key)
 bool RedisClient::expire(const std::string& key, int ttlSeconds)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return false;
 
     auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "EXPIRE %s %d", key.c_str(), ttlSeconds));
     bool ok = reply && reply->type == REDIS_REPLY_INTEGER && reply->integer == 1;
@@ -147,10 +181,34 @@ bool RedisClient::expire(const std::string& key, int ttlSeconds)
     return ok;
 }
 
+int RedisClient::expireBatch(const std::vector<std::string>& keys, int ttlSeconds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ensureConnected() || keys.empty()) return 0;
+
+    for (const auto& key : keys)
+        redisAppendCommand(ctx_, "EXPIRE %b %d", key.data(), key.size(), ttlSeconds);
+
+    int count = 0;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        redisReply* reply = nullptr;
+        if (redisGetReply(ctx_, reinterpret_cast<void**>(&reply)) != REDIS_OK)
+        {
+            SPDLOG_WARN_TAG("REDIS") << "Pipeline EXPIRE failed: " << ctx_->errstr;
+            connected_ = false;
+            break;
+        }
+        if (reply->type == REDIS_REPLY_INTEGER && reply->integer == 1) ++count;
+        freeReply(reply);
+    }
+    return count;
+}
+
 bool RedisClient::exists(const std::string& key)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return false;
 
     auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "EXISTS %s", key.c_str()));
     bool ok = reply && reply->type == REDIS_REPLY_INTEGER && reply->integer == 1;
@@ -161,7 +219,7 @@ bool RedisClient::exists(const std::string& key)
 long long RedisClient::llen(const std::string& key)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return 0;
 
     auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "LLEN %s", key.c_str()));
     long long len = (reply && reply->type == REDIS_REPLY_INTEGER) ? reply->integer : 0;
@@ -172,7 +230,7 @@ long long RedisClient::llen(const std::string& key)
 std::vector<std::string> RedisClient::lrange(const std::string& key, long long start, long long end)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return {};
 
     std::vector<std::string> result;
     auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "LRANGE %s %lld %lld", key.c_str(), start, end));
@@ -188,7 +246,7 @@ std::vector<std::string> RedisClient::lrange(const std::string& key, long long s
 bool RedisClient::lpush(const std::string& key, const std::string& value)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return false;
 
     auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "LPUSH %s %b", key.c_str(), value.data(), value.size()));
     bool ok = reply && reply->type == REDIS_REPLY_INTEGER;
@@ -199,7 +257,7 @@ bool RedisClient::lpush(const std::string& key, const std::string& value)
 bool RedisClient::ltrim(const std::string& key, long long start, long long end)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return false;
 
     auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "LTRIM %s %lld %lld", key.c_str(), start, end));
     bool ok = reply && reply->type == REDIS_REPLY_STATUS;
@@ -210,7 +268,7 @@ bool RedisClient::ltrim(const std::string& key, long long start, long long end)
 bool RedisClient::hset(const std::string& key, const std::string& field, const std::string& value)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return false;
 
     auto* reply = static_cast<redisReply*>(
         redisCommand(ctx_, "HSET %s %s %b", key.c_str(), field.c_str(), value.data(), value.size()));
@@ -222,7 +280,7 @@ bool RedisClient::hset(const std::string& key, const std::string& field, const s
 std::string RedisClient::hget(const std::string& key, const std::string& field)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return {};
 
     auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "HGET %s %s", key.c_str(), field.c_str()));
     std::string result;
@@ -234,7 +292,7 @@ std::string RedisClient::hget(const std::string& key, const std::string& field)
 std::vector<std::pair<std::string, std::string>> RedisClient::hgetall(const std::string& key)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return {};
 
     std::vector<std::pair<std::string, std::string>> result;
     auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "HGETALL %s", key.c_str()));
@@ -251,7 +309,7 @@ std::vector<std::pair<std::string, std::string>> RedisClient::hgetall(const std:
 bool RedisClient::ping()
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    ensureConnected();
+    if (!ensureConnected()) return false;
 
     auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "PING"));
     bool ok = reply && reply->type == REDIS_REPLY_STATUS && std::strcmp(reply->str, "PONG") == 0;
@@ -259,5 +317,88 @@ bool RedisClient::ping()
     return ok;
 }
 
+std::string RedisClient::loadScript(const std::string& script)
+{
+    auto* reply = static_cast<redisReply*>(redisCommand(ctx_, "SCRIPT LOAD %b", script.data(), script.size()));
+    std::string sha;
+    if (reply && reply->type == REDIS_REPLY_STRING)
+        sha.assign(reply->str, reply->len);
+    else
+        SPDLOG_WARN_TAG("REDIS") << "SCRIPT LOAD failed: " << (reply && reply->str ? reply->str : "null");
+    freeReply(reply);
+    return sha;
+}
+
+redisReply* RedisClient::evalsha(const std::string& sha, const std::vector<std::string>& keys,
+                                 const std::vector<std::string>& args)
+{
+    std::string numKeys = std::to_string(keys.size());
+    std::vector<const char*> argv;
+    std::vector<size_t> argvlen;
+    argv.reserve(3 + keys.size() + args.size());
+    argvlen.reserve(argv.capacity());
+    auto push = [&](const std::string& s) {
+        argv.push_back(s.data());
+        argvlen.push_back(s.size());
+    };
+    static const std::string kCommand = "EVALSHA";
+    push(kCommand);
+    push(sha);
+    push(numKeys);
+    for (const auto& k : keys) push(k);
+    for (const auto& a : args) push(a);
+    return static_cast<redisReply*>(
+        redisCommandArgv(ctx_, static_cast<int>(argv.size()), argv.data(), argvlen.data()));
+}
+
+bool RedisClient::evalInts(const std::string& script, const std::vector<std::string>& keys,
+                           const std::vector<std::string>& args, std::vector<long long>* out)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ensureConnected()) return false;
+
+    std::string& sha = scriptShas_[script];
+    if (sha.empty()) sha = loadScript(script);
+    if (sha.empty()) return false;
+
+    auto* reply = evalsha(sha, keys, args);
+    if (reply && reply->type == REDIS_REPLY_ERROR && std::strncmp(reply->str, "NOSCRIPT", 8) == 0)
+    {
+        freeReply(reply);
+        sha = loadScript(script);
+        if (sha.empty()) return false;
+        reply = evalsha(sha, keys, args);
+    }
+
+    bool ok = false;
+    if (reply && reply->type == REDIS_REPLY_INTEGER)
+    {
+        out->assign(1, reply->integer);
+        ok = true;
+    }
+    else if (reply && reply->type == REDIS_REPLY_ARRAY)
+    {
+        out->clear();
+        ok = true;
+        for (size_t i = 0; i < reply->elements; ++i)
+        {
+            if (reply->element[i]->type != REDIS_REPLY_INTEGER)
+            {
+                ok = false;
+                break;
+            }
+            out->push_back(reply->element[i]->integer);
+        }
+    }
+    else
+    {
+        SPDLOG_WARN_TAG("REDIS") << "EVALSHA failed: "
+                                 << (reply && reply->type == REDIS_REPLY_ERROR ? reply->str : ctx_->errstr);
+        if (!reply) connected_ = false;
+    }
+    freeReply(reply);
+    return ok;
+}
+
 }  // namespace cache
 }  // namespace infra
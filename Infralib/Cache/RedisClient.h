@@ -3,15 +3,18 @@
  * @brief hiredis C 库的 C++ RAII 封装
  *
  * 同步阻塞调用，由调用方放入 ThreadPool 异步执行。
- * 自动重连 + Pipeline 批量支持。
+ * 自动重连 + Pipeline 批量支持。连接与命令均有超时；重连失败后按指数退避，
+ * 退避期间的调用直接失败，不再逐次阻塞一个连接超时。
  */
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <hiredis/hiredis.h>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace infra
@@ -35,6 +38,13 @@ public:
      */
     bool connect(const std::string& host, int port, const std::string& password, int db);
 
+    /**
+     * @brief 设置连接超时与命令读写超时（毫秒），对之后建立的连接生效，须在 connect() 之前调用
+     *
+     * 缺省连接 2s、命令 1s。命令超时后连接标记为出错，下次调用时重连。
+     */
+    void setTimeouts(int connectMs, int commandMs);
+
     /**
      * @brief 获取字符串值
      * @return 值；key 不存在返回空字符串
@@ -62,6 +72,12 @@ public:
      */
     bool expire(const std::string& key, int ttlSeconds);
 
+    /**
+     * @brief 以 Pipeline 批量设置 TTL，一次往返完成
+     * @return 成功续期的 key 数量（不存在的 key 不计）
+     */
+    int expireBatch(const std::vector<std::string>& keys, int ttlSeconds);
+
     /**
      * @brief 检查 key 是否存在
      */
@@ -107,6 +123,17 @@ public:
      */
     bool ping();
 
+    /**
+     * @brief 执行 Lua 脚本并取整数数组结果
+     *
+     * 以 EVALSHA 调用，脚本 SHA 首次使用时经 SCRIPT LOAD 取得并缓存；服务端返回 NOSCRIPT
+     * （重启或 SCRIPT FLUSH）时重新加载一次再执行。
+     * @param out 接收结果：脚本返回整数时为单元素，返回数组时按顺序取各整数元素
+     * @return false 表示连接失败或脚本报错
+     */
+    bool evalInts(const std::string& script, const std::vector<std::string>& keys,
+                  const std::vector<std::string>& args, std::vector<long long>* out);
+
     /**
      * @brief 是否已连接
      */
@@ -116,8 +143,11 @@ public:
     }
 
 private:
-    void ensureConnected();
+    bool ensureConnected();
     void freeReply(redisReply* reply);
+    redisReply* evalsha(const std::string& sha, const std::vector<std::string>& keys,
+                        const std::vector<std::string>& args);
+    std::string loadScript(const std::string& script);
 
     redisContext* ctx_ = nullptr;
     bool connected_ = false;
@@ -126,6 +156,11 @@ private:
     int port_ = 6379;
     std::string password_;
     int db_ = 0;
+    struct timeval connectTimeout_ = {2, 0};
+    struct timeval commandTimeout_ = {1, 0};
+    std::chrono::milliseconds reconnectBackoff_{0};         // 0 表示上次连接成功
+    std::chrono::steady_clock::time_point nextReconnect_;  // 退避结束前不再尝试重连
+    std::unordered_map<std::string, std::string> scriptShas_;  // 脚本 → SHA1，受 mutex_ 保护
 };
 
 }  // namespace cache
@@ -0,0 +1,111 @@
+#include "RedisRateLimiter.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Common/Logging/Logger.h"
+
+namespace infra
+{
+namespace cache
+{
+
+namespace
+{
+
+// KEYS[1] 桶 key；ARGV[1] 单个令牌的补充间隔（微秒），ARGV[2] 突发容量，ARGV[3] 本次消费数
+// 返回 {1, 0} 放行，{0, 需等待的微秒数} 拒绝
+// Redis 5 之前须先声明按命令复制，才能在写操作前调用 TIME；之后的版本该调用为空操作
+const std::string kGcraScript = R"lua(
+if redis.replicate_commands then redis.replicate_commands() end
+local t = redis.call('TIME')
+local now = tonumber(t[1]) * 1000000 + tonumber(t[2])
+local interval = tonumber(ARGV[1])
+local tolerance = interval * tonumber(ARGV[2])
+local tat = tonumber(redis.call('GET', KEYS[1])) or now
+if tat < now then tat = now end
+local newTat = tat + interval * tonumber(ARGV[3])
+local excess = newTat - now - tolerance
+if excess > 0 then return {0, excess} end
+redis.call('SET', KEYS[1], string.format('%.0f', newTat), 'PX', math.ceil((newTat - now) / 1000) + 1)
+return {1, 0}
+)lua";
+
+// 与 common::gcra 的上限一致（约 11.5 天），单位微秒
+constexpr long long kMaxIntervalUs = 1000000000000LL;
+
+long long intervalUs(double perSec)
+{
+    if (perSec <= 0) return kMaxIntervalUs;
+    return std::clamp<long long>(static_cast<long long>(1e6 / perSec), 1, kMaxIntervalUs);
+}
+
+}  // namespace
+
+RedisRateLimiter::RedisRateLimiter(std::shared_ptr<RedisClient> redis) : RedisRateLimiter(std::move(redis), Options())
+{
+}
+
+RedisRateLimiter::RedisRateLimiter(std::shared_ptr<RedisClient> redis, Options options)
+    : RedisRateLimiter(std::vector<std::shared_ptr<RedisClient>>{std::move(redis)}, std::move(options))
+{
+}
+
+RedisRateLimiter::RedisRateLimiter(std::vector<std::shared_ptr<RedisClient>> pool, Options options)
+    : pool_(std::move(pool)), options_(std::move(options)), fallback_(options_.fallbackShards)
+{
+}
+
+bool RedisRateLimiter::acquire(long long key, const common::RateLimit& limit, int n, int64_t* retryAfterNs)
+{
+    int64_t now = common::gcra::nowNs();
+    if (tryRedis(now))
+    {
+        RedisClient& redis = *pool_[next_.fetch_add(1, std::memory_order_relaxed) % pool_.size()];
+        std::vector<long long> result;
+        if (redis.evalInts(kGcraScript, {options_.keyPrefix + std::to_string(key)},
+                           {std::to_string(intervalUs(limit.perSec)), std::to_string(std::max(limit.burst, 0)),
+                            std::to_string(n)},
+                           &result) &&
+            result.size() == 2)
+        {
+            onRedisSuccess();
+            if (result[0] == 1) return true;
+            if (retryAfterNs) *retryAfterNs = static_cast<int64_t>(result[1]) * 1000;
+            return false;
+        }
+        onRedisFailure(now);
+    }
+    return fallback_.acquire(key, limit, n, retryAfterNs);
+}
+
+bool RedisRateLimiter::tryRedis(int64_t nowNs)
+{
+    if (!degraded_.load(std::memory_order_acquire)) return true;
+    int64_t retryAt = retryAtNs_.load(std::memory_order_acquire);
+    if (nowNs < retryAt) return false;
+    // 到期后只放一个请求去探测：抢到的请求把下次探测时间推后一个退避周期
+    return retryAtNs_.compare_exchange_strong(retryAt, nowNs + backoffNs_.load(std::memory_order_relaxed));
+}
+
+void RedisRateLimiter::onRedisFailure(int64_t nowNs)
+{
+    const int64_t minNs = static_cast<int64_t>(options_.backoffMinMs) * 1000000;
+    const int64_t maxNs = static_cast<int64_t>(options_.backoffMaxMs) * 1000000;
+    int64_t backoff = degraded_.load(std::memory_order_acquire)
+                          ? std::min(backoffNs_.load(std::memory_order_relaxed) * 2, maxNs)
+                          : minNs;
+    backoffNs_.store(backoff, std::memory_order_relaxed);
+    retryAtNs_.store(nowNs + backoff, std::memory_order_release);
+    if (!degraded_.exchange(true, std::memory_order_acq_rel))
+        SPDLOG_WARN_TAG("RATE") << "Redis rate limiter unavailable — falling back to per-node buckets";
+}
+
+void RedisRateLimiter::onRedisSuccess()
+{
+    if (degraded_.load(std::memory_order_relaxed) && degraded_.exchange(false, std::memory_order_acq_rel))
+        SPDLOG_INFO_TAG("RATE") << "Redis rate limiter recovered";
+}
+
+}  // namespace cache
+}  // namespace infra
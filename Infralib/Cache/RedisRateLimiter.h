@@ -0,0 +1,71 @@
+/**
+ * @file RedisRateLimiter.h
+ * @brief 基于 Redis 的 GCRA 限流，多实例共享同一用户的额度
+ *
+ * 每个 key 在 Redis 中只存一个 TAT（理论到达时间，微秒），由 Lua 脚本原子地判定并推进；
+ * 时间取 Redis 服务端 TIME，各实例时钟偏差不影响结果。桶回满时 key 恰好过期，
+ * 空闲用户不占 Redis 内存。Redis 不可用时退回进程内 ShardedRateLimiter（各实例各自限流）。
+ *
+ * 判定在中间件 before() 中同步执行，因此：请求在一小组连接间轮转，不在单个连接的锁上排队；
+ * 一次失败即熔断，熔断期间直接走本地限流，按指数退避放行单个请求探测 Redis，成功后恢复。
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/RateLimit/RateLimiter.h"
+#include "Infralib/Cache/RedisClient.h"
+
+namespace infra
+{
+namespace cache
+{
+
+class RedisRateLimiter : public common::RateLimiter
+{
+public:
+    struct Options
+    {
+        std::string keyPrefix = "ratelimit:";  // 每条规则一个实例时各用不同前缀，如 "ratelimit:/api/chat:"
+        size_t fallbackShards = common::ShardedRateLimiter::kDefaultShards;  // 退回本地限流时的分片数
+        int backoffMinMs = 100;   // 熔断后首次探测 Redis 的间隔
+        int backoffMaxMs = 5000;  // 连续探测失败时间隔翻倍的上限
+    };
+
+    /**
+     * @param redis 限流专用的 Redis 连接（每次限流判定一次往返，不宜与业务缓存共用；多条规则可共用）
+     */
+    explicit RedisRateLimiter(std::shared_ptr<RedisClient> redis);
+    RedisRateLimiter(std::shared_ptr<RedisClient> redis, Options options);
+
+    /**
+     * @param pool 限流专用的一组 Redis 连接，判定轮流使用；不得为空
+     */
+    RedisRateLimiter(std::vector<std::shared_ptr<RedisClient>> pool, Options options);
+
+    /**
+     * @brief 在 Redis 上执行 GCRA 判定；脚本执行失败或处于熔断期间时改由本地限流器判定
+     */
+    bool acquire(long long key, const common::RateLimit& limit, int n = 1, int64_t* retryAfterNs = nullptr) override;
+
+private:
+    /// 熔断中且未到探测时间，或已有其他请求在探测时返回 false
+    bool tryRedis(int64_t nowNs);
+    void onRedisFailure(int64_t nowNs);
+    void onRedisSuccess();
+
+    std::vector<std::shared_ptr<RedisClient>> pool_;
+    Options options_;
+    common::ShardedRateLimiter fallback_;
+    std::atomic<size_t> next_{0};           // 轮转下标
+    std::atomic<bool> degraded_{false};     // 熔断中
+    std::atomic<int64_t> retryAtNs_{0};     // 熔断中：下次探测的 steady_clock 时间
+    std::atomic<int64_t> backoffNs_{0};     // 熔断中：当前探测间隔
+};
+
+}  // namespace cache
+}  // namespace infra
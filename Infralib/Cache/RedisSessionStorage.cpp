@@ -0,0 +1,220 @@
+#include "RedisSessionStorage.h"
+
+#include <chrono>
+#include <vector>
+
+#include "Common/Logging/Logger.h"
+
+namespace infra
+{
+namespace cache
+{
+
+using http::session::Session;
+
+namespace
+{
+
+int64_t steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int ttlOf(const Session& session)
+{
+    return session.getMaxAge() > 0 ? session.getMaxAge() : 1;
+}
+
+}  // namespace
+
+RedisSessionStorage::RedisSessionStorage(std::shared_ptr<RedisClient> redis)
+    : RedisSessionStorage(std::move(redis), Options())
+{
+}
+
+RedisSessionStorage::RedisSessionStorage(std::shared_ptr<RedisClient> redis, Options options)
+    : redis_(std::move(redis)), options_(std::move(options))
+{
+    flushThread_ = std::thread([this]() { flushLoop(); });
+}
+
+RedisSessionStorage::~RedisSessionStorage()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    stopCv_.notify_all();
+    flushThread_.join();
+    flushTouches();
+}
+
+std::string RedisSessionStorage::makeKey(const std::string& sessionId) const
+{
+    return options_.keyPrefix + sessionId;
+}
+
+void RedisSessionStorage::save(std::shared_ptr<Session> session)
+{
+    // 数据写入须立即可见：用户可能在本实例登录后，下一个请求就被 nginx 转发到另一个实例
+    if (!redis_->setex(makeKey(session->getId()), ttlOf(*session), session->serialize()))
+    {
+        SPDLOG_WARN_TAG("SESSION") << "Redis SETEX failed for session " << session->getId();
+    }
+
+    int64_t now = steadyNowMs();
+    std::lock_guard<std::mutex> lock(mutex_);
+    pendingTouches_.erase(session->getId());  // SETEX 已带上完整 TTL
+    std::string id = session->getId();
+    insertLocked(id, std::move(session), now, now);
+}
+
+std::shared_ptr<Session> RedisSessionStorage::load(const std::string& sessionId)
+{
+    int64_t now = steadyNowMs();
+    int64_t touchedMs = -1;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = near_.find(sessionId);
+        if (it != near_.end())
+        {
+            NearEntry& entry = it->second;
+            if (now - entry.fetchedMs < options_.nearCacheTtlMs && !entry.session->isExpired())
+            {
+                if (now - entry.touchedMs >= static_cast<int64_t>(options_.touchIntervalSec) * 1000)
+                {
+                    entry.touchedMs = now;
+                    pendingTouches_[sessionId] = ttlOf(*entry.session);
+                }
+                return entry.session;
+            }
+            touchedMs = entry.touchedMs;
+        }
+    }
+
+    std::string bytes = redis_->get(makeKey(sessionId));
+    std::shared_ptr<Session> session = bytes.empty() ? nullptr : Session::deserialize(sessionId, bytes);
+    if (!session && !bytes.empty())
+    {
+        SPDLOG_WARN_TAG("SESSION") << "Discarding undecodable session " << sessionId;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!session)
+    {
+        near_.erase(sessionId);
+        pendingTouches_.erase(sessionId);
+        return nullptr;
+    }
+    // GET 不会延长 TTL：首次读到（例如本实例刚启动）或距上次续期已超过间隔时登记续期
+    if (touchedMs < 0 || now - touchedMs >= static_cast<int64_t>(options_.touchIntervalSec) * 1000)
+    {
+        touchedMs = now;
+        pendingTouches_[sessionId] = ttlOf(*session);
+    }
+    insertLocked(sessionId, session, touchedMs, now);
+    return session;
+}
+
+void RedisSessionStorage::remove(const std::string& sessionId)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        near_.erase(sessionId);
+        pendingTouches_.erase(sessionId);
+    }
+    redis_->del(makeKey(sessionId));
+}
+
+size_t RedisSessionStorage::removeExpired()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sweepLocked(steadyNowMs());
+}
+
+size_t RedisSessionStorage::nearCacheSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return near_.size();
+}
+
+void RedisSessionStorage::insertLocked(const std::string& sessionId, std::shared_ptr<Session> session,
+                                       int64_t touchedMs, int64_t nowMs)
+{
+    auto it = near_.find(sessionId);
+    if (it == near_.end() && options_.nearCacheMaxEntries > 0 && near_.size() >= options_.nearCacheMaxEntries)
+    {
+        if (sweepLocked(nowMs) == 0)
+        {
+            near_.erase(near_.begin());  // 全部仍有效时随意丢弃一条，下次访问回源 Redis 即可
+        }
+    }
+    NearEntry& entry = near_[sessionId];
+    entry.session = std::move(session);
+    entry.fetchedMs = nowMs;
+    entry.touchedMs = touchedMs;
+}
+
+size_t RedisSessionStorage::sweepLocked(int64_t nowMs)
+{
+    size_t removed = 0;
+    for (auto it = near_.begin(); it != near_.end();)
+    {
+        if (nowMs - it->second.fetchedMs >= options_.nearCacheTtlMs)
+        {
+            it = near_.erase(it);
+            ++removed;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+void RedisSessionStorage::flushTouches()
+{
+    std::unordered_map<std::string, int> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending.swap(pendingTouches_);
+    }
+    if (pending.empty())
+    {
+        return;
+    }
+
+    // 同一 TTL 的会话合并为一次 Pipeline
+    std::unordered_map<int, std::vector<std::string>> byTtl;
+    for (const auto& [sessionId, ttl] : pending)
+    {
+        byTtl[ttl].push_back(makeKey(sessionId));
+    }
+    for (const auto& [ttl, keys] : byTtl)
+    {
+        int renewed = redis_->expireBatch(keys, ttl);
+        SPDLOG_DEBUG_TAG("SESSION") << "Renewed " << renewed << "/" << keys.size() << " sessions";
+    }
+}
+
+void RedisSessionStorage::flushLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        stopCv_.wait_for(lock, std::chrono::seconds(1));
+        if (stopping_)
+        {
+            break;
+        }
+        sweepLocked(steadyNowMs());
+        lock.unlock();
+        flushTouches();
+        lock.lock();
+    }
+}
+
+}  // namespace cache
+}  // namespace infra
@@ -0,0 +1,107 @@
+/**
+ * @file RedisSessionStorage.h
+ * @brief 基于 Redis 的 HTTP 会话存储，多实例共享登录态
+ *
+ * 会话以 Session::serialize() 的二进制格式存为带 TTL 的字符串，任意实例都能读到，
+ * nginx 无需粘性会话。本地再挂一层短 TTL 的近端缓存，同一会话的连续请求不必每次访问 Redis；
+ * 访问续期（刷新 TTL）按会话限频，由后台线程以 Pipeline 批量 EXPIRE 写回。
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "HttpServer/include/session/SessionStorage.h"
+#include "Infralib/Cache/RedisClient.h"
+
+namespace infra
+{
+namespace cache
+{
+
+class RedisSessionStorage : public http::session::SessionStorage
+{
+public:
+    struct Options
+    {
+        std::string keyPrefix = "httpsession:";  // 与 SessionCache 的 "session:" 前缀区分
+        int nearCacheTtlMs = 2000;               // 近端缓存有效期，即其他实例写入 / 注销后本实例的最大可见延迟
+        size_t nearCacheMaxEntries = 10000;      // 近端缓存条目上限
+        int touchIntervalSec = 60;               // 同一会话两次续期写回的最小间隔
+    };
+
+    /**
+     * @param redis 会话专用的 Redis 连接（RedisClient 内部串行化，不宜与业务缓存共用）
+     */
+    explicit RedisSessionStorage(std::shared_ptr<RedisClient> redis);
+    RedisSessionStorage(std::shared_ptr<RedisClient> redis, Options options);
+    ~RedisSessionStorage() override;
+
+    /**
+     * @brief 写入 Redis（SETEX，TTL 为会话 maxAge）并更新近端缓存
+     */
+    void save(std::shared_ptr<http::session::Session> session) override;
+
+    /**
+     * @brief 近端缓存命中且未超过有效期时直接返回，否则从 Redis 读取并解码
+     * @return 会话；Redis 中不存在或数据不合法时返回 nullptr
+     */
+    std::shared_ptr<http::session::Session> load(const std::string& sessionId) override;
+
+    /**
+     * @brief 从 Redis 与近端缓存中删除
+     */
+    void remove(const std::string& sessionId) override;
+
+    /**
+     * @brief 清理已超过有效期的近端缓存条目；Redis 中的过期由 TTL 完成
+     * @return 清理的近端缓存条目数
+     */
+    size_t removeExpired() override;
+
+    /**
+     * @brief 立即写回待续期的会话
+     */
+    void flushTouches();
+
+    /**
+     * @brief 近端缓存当前条目数
+     */
+    size_t nearCacheSize() const;
+
+private:
+    struct NearEntry
+    {
+        std::shared_ptr<http::session::Session> session;
+        int64_t fetchedMs;  // 从 Redis 读取或写入 Redis 的时刻
+        int64_t touchedMs;  // 上次登记续期的时刻
+    };
+
+    std::string makeKey(const std::string& sessionId) const;
+
+    // 以下函数须持有 mutex_
+    void insertLocked(const std::string& sessionId, std::shared_ptr<http::session::Session> session, int64_t touchedMs,
+                      int64_t nowMs);
+    size_t sweepLocked(int64_t nowMs);
+
+    void flushLoop();
+
+    std::shared_ptr<RedisClient> redis_;
+    Options options_;
+
+    mutable std::mutex mutex_;  // 保护 near_ 与 pendingTouches_
+    std::unordered_map<std::string, NearEntry> near_;
+    std::unordered_map<std::string, int> pendingTouches_;  // sessionId → TTL 秒
+
+    std::thread flushThread_;
+    std::condition_variable stopCv_;
+    bool stopping_ = false;
+};
+
+}  // namespace cache
+}  // namespace infra
@@ -0,0 +1,131 @@
+// 建连速率基准：单 acceptor 与 SO_REUSEPORT 多 acceptor 的对比。
+// 每种模式在子进程中启动 HttpServer，父进程用多个客户端线程反复"建连 → 请求 → 读到对端关闭"，
+// 统计每秒完成的连接数。
+// 用法：./bench_accept [seconds] [clients] [acceptors] [ioThreads]
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "http/HttpServer.h"
+
+namespace
+{
+
+constexpr uint16_t kPort = 18088;
+const char kRequest[] = "GET /ping HTTP/1.1\r\nHost: bench\r\nConnection: close\r\n\r\n";
+
+pid_t startServer(int acceptors, int ioThreads)
+{
+    pid_t pid = ::fork();
+    if (pid != 0)
+    {
+        return pid;
+    }
+    auto option = acceptors > 1 ? muduo::net::TcpServer::kReusePort : muduo::net::TcpServer::kNoReusePort;
+    http::HttpServer server(kPort, "bench", false, option);
+    server.setThreadNum(ioThreads);
+    server.setAcceptorNum(acceptors);
+    server.Get("/ping",
+               [](const http::HttpRequest&, http::HttpResponse* resp)
+               {
+                   resp->setStatusLine("HTTP/1.1", http::HttpResponse::k200Ok, "OK");
+                   resp->setContentType("text/plain");
+                   resp->setContentLength(4);
+                   resp->setBody("pong");
+               });
+    server.start();
+    ::_exit(0);
+}
+
+// 完成一次短连接请求；成功返回 true
+bool oneConnection(const sockaddr_in& addr)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool ok = ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof addr) == 0 &&
+              ::send(fd, kRequest, sizeof kRequest - 1, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof kRequest - 1);
+    char buf[512];
+    ssize_t n = 0;
+    size_t total = 0;
+    while (ok && (n = ::recv(fd, buf, sizeof buf, 0)) > 0)
+    {
+        total += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    return ok && total > 0;
+}
+
+double run(const char* name, int acceptors, int ioThreads, int seconds, int clients)
+{
+    pid_t pid = startServer(acceptors, ioThreads);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));  // 等待监听就绪
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(kPort);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    std::atomic<bool> stop{false};
+    std::atomic<long> done{0};
+    std::atomic<long> failed{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < clients; ++i)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    (oneConnection(addr) ? done : failed).fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    stop = true;
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ::kill(pid, SIGKILL);
+    ::waitpid(pid, nullptr, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    double rate = done.load() / sec;
+    std::printf("%-24s %10.0f conn/s  (ok=%ld failed=%ld)\n", name, rate, done.load(), failed.load());
+    return rate;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    int seconds = argc > 1 ? std::atoi(argv[1]) : 5;
+    int clients = argc > 2 ? std::atoi(argv[2]) : 32;
+    int acceptors = argc > 3 ? std::atoi(argv[3]) : 4;
+    int ioThreads = argc > 4 ? std::atoi(argv[4]) : 4;
+
+    std::printf("clients: %d  io threads: %d  (port %u)\n", clients, ioThreads, kPort);
+    double before = run("single acceptor", 1, ioThreads, seconds, clients);
+    char name[32];
+    std::snprintf(name, sizeof name, "%d reuseport acceptors", acceptors);
+    double after = run(name, acceptors, ioThreads, seconds, clients);
+    std::printf("speedup: %.2fx\n", after / before);
+    return 0;
+}
@@ -0,0 +1,86 @@
+// 动态响应压缩基准：每秒压缩的响应数与压缩率。
+// 对比每次响应 deflateInit2 / deflateEnd（一次性压缩的朴素写法）与每线程复用 z_stream 的 Compressor。
+// 用法：./bench_compression [bodyKB] [responses]
+
+#include <zlib.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "http/Compression.h"
+
+namespace
+{
+
+// 近似 /chat/history 的 dump(4) 输出
+std::string historyBody(size_t targetBytes)
+{
+    std::string body = "{\n    \"data\": {\n        \"messages\": [\n";
+    for (size_t i = 0; body.size() < targetBytes; ++i)
+    {
+        body += "            {\n                \"content\": \"第 " + std::to_string(i) +
+                " 条消息，内容长度不一，包含一些重复的短语和数字 " + std::to_string(i * 7919) +
+                "\",\n                \"is_user\": " + (i % 2 ? "true" : "false") +
+                ",\n                \"ts\": " + std::to_string(1700000000000 + i * 1000) + "\n            },\n";
+    }
+    return body + "        ]\n    }\n}";
+}
+
+bool freshGzip(const std::string& in, std::string* out)
+{
+    z_stream zs;
+    std::memset(&zs, 0, sizeof zs);
+    if (deflateInit2(&zs, 6, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+    out->resize(deflateBound(&zs, in.size()));
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&(*out)[0]);
+    zs.avail_out = static_cast<uInt>(out->size());
+    int rc = deflate(&zs, Z_FINISH);
+    out->resize(zs.total_out);
+    deflateEnd(&zs);
+    return rc == Z_STREAM_END;
+}
+
+template <typename Fn>
+double run(const char* name, const std::string& body, int responses, Fn&& compress)
+{
+    std::string out;
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < responses; ++i)
+    {
+        compress(body, &out);
+        total += out.size();
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rate = responses / sec;
+    std::printf("%-16s %10.0f resp/s  ratio %.3f\n", name, rate, double(total) / responses / body.size());
+    return rate;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    size_t kb = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 8;
+    int responses = argc > 2 ? std::atoi(argv[2]) : 5000;
+    std::string body = historyBody(kb * 1024);
+
+    std::printf("body: %zu bytes  responses: %d\n", body.size(), responses);
+    double before = run("init per resp", body, responses, freshGzip);
+    double after = run("thread-local", body, responses,
+                       [](const std::string& in, std::string* out)
+                       { return http::Compressor::threadLocal().compress(http::ContentEncoding::kGzip, 6, in, out); });
+    std::printf("speedup: %.2fx\n", after / before);
+    if (http::compressionAvailable(http::ContentEncoding::kBrotli))
+    {
+        run("br q4", body, responses,
+            [](const std::string& in, std::string* out)
+            { return http::Compressor::threadLocal().compress(http::ContentEncoding::kBrotli, 4, in, out); });
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+// HTTP 请求解析微基准：对比旧版（std::map 头 + 临时 string + 请求体双拷贝）与 arena 零拷贝解析。
+// 用法：./bench_http_parser [iterations]
+// 只测解析本身（Buffer → HttpRequest），不含网络与路由。
+
+#include <muduo/net/Buffer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+
+#include "http/HttpContext.h"
+
+namespace
+{
+
+const char kStreamRequest[] =
+    "POST /chat/send-stream HTTP/1.1\r\n"
+    "Host: rain.example.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/126.0 Safari/537.36\r\n"
+    "Accept: text/event-stream\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Accept-Language: zh-CN,zh;q=0.9,en;q=0.8\r\n"
+    "Content-Type: application/json\r\n"
+    "Origin: https://rain.example.com\r\n"
+    "Referer: https://rain.example.com/chat\r\n"
+    "Cookie: sessionId=3f2a9c0d8e7b6a5f4e3d2c1b0a998877; jwt=eyJhbGciOiJIUzI1NiJ9.eyJzdWIiOjEsInJvbGUiOiJ1c2VyIn0.sig\r\n"
+    "Connection: keep-alive\r\n"
+    "Content-Length: 117\r\n"
+    "\r\n"
+    "{\"question\":\"请解释一下 Reactor 模型\",\"sessionId\":\"1718000000000\",\"provider\":\"aliyun\",\"modelType\":\"qwen-plus\"}";
+
+const char kStaticRequest[] =
+    "GET /css/style.css HTTP/1.1\r\n"
+    "Host: rain.example.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/126.0 Safari/537.36\r\n"
+    "Accept: text/css,*/*;q=0.1\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Accept-Language: zh-CN,zh;q=0.9,en;q=0.8\r\n"
+    "Referer: https://rain.example.com/chat\r\n"
+    "Cookie: sessionId=3f2a9c0d8e7b6a5f4e3d2c1b0a998877; jwt=eyJhbGciOiJIUzI1NiJ9.eyJzdWIiOjEsInJvbGUiOiJ1c2VyIn0.sig\r\n"
+    "If-None-Match: \"5e1f-18f0c2a3b40\"\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n";
+
+// 旧版解析逻辑的等价实现，仅用于对比
+struct LegacyRequest
+{
+    std::string method;
+    std::string path;
+    std::string version;
+    std::map<std::string, std::string> headers;
+    std::string body;
+};
+
+bool legacyParse(muduo::net::Buffer* buf, LegacyRequest* req)
+{
+    const char* crlf = buf->findCRLF();
+    if (!crlf) return false;
+    const char* sp1 = std::find(buf->peek(), crlf, ' ');
+    const char* sp2 = std::find(sp1 + 1, crlf, ' ');
+    req->method = std::string(buf->peek(), sp1);
+    req->path.assign(sp1 + 1, sp2);
+    req->version = std::string(sp2 + 1, crlf);
+    buf->retrieveUntil(crlf + 2);
+    while ((crlf = buf->findCRLF()) != nullptr)
+    {
+        if (buf->peek() == crlf)
+        {
+            buf->retrieveUntil(crlf + 2);
+            break;
+        }
+        const char* colon = std::find(buf->peek(), crlf, ':');
+        std::string key(buf->peek(), colon);
+        ++colon;
+        while (colon < crlf && isspace(*colon)) ++colon;
+        std::string value(colon, crlf);
+        req->headers[key] = value;
+        buf->retrieveUntil(crlf + 2);
+    }
+    auto it = req->headers.find("Content-Length");
+    if (it != req->headers.end())
+    {
+        size_t len = std::stoul(it->second);
+        std::string body(buf->peek(), buf->peek() + len);
+        req->body = body;
+        buf->retrieve(len);
+    }
+    return true;
+}
+
+template <typename Fn>
+double run(const char* name, const std::string& raw, long iterations, Fn&& fn)
+{
+    muduo::net::Buffer buf;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i)
+    {
+        buf.append(raw.data(), raw.size());
+        fn(&buf);
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rps = iterations / sec;
+    std::printf("%-28s %10.0f req/s  %7.1f ns/req\n", name, rps, sec * 1e9 / iterations);
+    return rps;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    long iterations = argc > 1 ? std::atol(argv[1]) : 1000000;
+
+    const struct
+    {
+        const char* label;
+        std::string raw;
+    } cases[] = {{"send-stream", kStreamRequest}, {"static-file", kStaticRequest}};
+
+    for (const auto& c : cases)
+    {
+        std::printf("== %s (%zu bytes)\n", c.label, c.raw.size());
+        double before = run("  legacy (map + copies)", c.raw, iterations,
+                            [](muduo::net::Buffer* buf)
+                            {
+                                LegacyRequest req;
+                                legacyParse(buf, &req);
+                            });
+
+        http::HttpContext ctx;
+        double after = run("  arena (string_view)", c.raw, iterations,
+                           [&ctx](muduo::net::Buffer* buf)
+                           {
+                               ctx.parseRequest(buf, muduo::Timestamp());
+                               if (!ctx.gotAll()) std::abort();
+                               ctx.reset();
+                           });
+        std::printf("  speedup: %.2fx\n", after / before);
+    }
+    return 0;
+}
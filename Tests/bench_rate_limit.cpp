@@ -0,0 +1,114 @@
+// 限流基准：多个 IO 线程并发对不同用户做限流判定。
+// 对比旧实现（全局互斥锁 + userId → TokenBucket 表）与分片读写锁 + CAS 的 ShardedRateLimiter；
+// 默认依次在 16 / 32 / 64 线程下运行，也可指定单一线程数。
+// 用法：./bench_rate_limit [threads] [opsPerThread] [users] [shards]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/RateLimit/RateLimiter.h"
+#include "Common/RateLimit/TokenBucket.h"
+
+using common::RateLimit;
+using common::ShardedRateLimiter;
+using common::TokenBucket;
+
+namespace
+{
+
+// 旧 RateLimitMiddleware 的查找方式：每次判定都经过同一把互斥锁
+class GlobalMutexLimiter
+{
+public:
+    explicit GlobalMutexLimiter(RateLimit limit) : limit_(limit) {}
+
+    bool acquire(long long userId)
+    {
+        TokenBucket* bucket;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = buckets_.find(userId);
+            if (it == buckets_.end())
+                it = buckets_.emplace(userId, std::make_unique<TokenBucket>(limit_.burst, limit_.perSec)).first;
+            bucket = it->second.get();
+        }
+        return bucket->consume();
+    }
+
+private:
+    RateLimit limit_;
+    std::mutex mutex_;
+    std::unordered_map<long long, std::unique_ptr<TokenBucket>> buckets_;
+};
+
+template <typename Fn>
+double run(const char* name, int threads, int ops, int users, Fn&& acquire)
+{
+    std::atomic<long> admitted{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(
+            [&, t]()
+            {
+                std::mt19937 rng(t);
+                std::uniform_int_distribution<int> pick(1, users);
+                long local = 0;
+                for (int i = 0; i < ops; ++i)
+                    if (acquire(pick(rng))) ++local;
+                admitted.fetch_add(local);
+            });
+    }
+    for (auto& w : workers)
+    {
+        w.join();
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rate = static_cast<double>(threads) * ops / sec;
+    std::printf("%-16s %12.0f checks/s  (admitted %ld)\n", name, rate, admitted.load());
+    return rate;
+}
+
+void compare(int threads, int ops, int users, size_t shards)
+{
+    RateLimit limit{10, 10.0 / 60.0};
+    std::printf("threads: %d  ops/thread: %d  users: %d\n", threads, ops, users);
+
+    GlobalMutexLimiter global(limit);
+    double before = run("global mutex", threads, ops, users, [&](long long uid) { return global.acquire(uid); });
+
+    ShardedRateLimiter sharded(shards);
+    char name[32];
+    std::snprintf(name, sizeof name, "%zu shards + CAS", shards);
+    double after = run(name, threads, ops, users,
+                       [&](long long uid) { return sharded.acquire(uid, limit); });
+    std::printf("speedup: %.2fx\n\n", after / before);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    int threads = argc > 1 ? std::atoi(argv[1]) : 0;
+    int ops = argc > 2 ? std::atoi(argv[2]) : 200000;
+    int users = argc > 3 ? std::atoi(argv[3]) : 10000;
+    size_t shards = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : ShardedRateLimiter::kDefaultShards;
+
+    if (threads > 0)
+    {
+        compare(threads, ops, users, shards);
+        return 0;
+    }
+    for (int n : {16, 32, 64}) compare(n, ops, users, shards);
+    return 0;
+}
@@ -0,0 +1,86 @@
+// 流式请求体构建基准：模拟长会话中每轮工具调用都要重新组装请求体的场景。
+// 对比原写法（拷贝 messages_ + 头部插入人设 + buildRequest 构建 json 树 + dump）与 SerializedHistory 拼接。
+// 用法：./bench_request_builder [messages] [rounds]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "llm/AIStrategy.h"
+#include "llm/SerializedHistory.h"
+
+namespace
+{
+
+const char* kSystemPrompt = "你是 Dr.Rain，一位专业的 AI 医疗健康助手。你基于医学知识提供健康咨询、症状分析、用药参考和生活方式建议。";
+
+std::vector<Message> session(size_t n)
+{
+    std::vector<Message> messages;
+    for (size_t i = 0; messages.size() < n; ++i)
+    {
+        messages.push_back({"user", "第 " + std::to_string(i) + " 个问题：最近总是头疼，晚上睡不好，需要注意什么？", "", "", 1});
+        messages.push_back({"assistant",
+                            "头痛伴随睡眠不佳可能与压力、作息或颈椎问题有关。建议：\n1. 规律作息\n2. 减少屏幕时间\n"
+                            "3. 若持续超过两周或伴随呕吐、视物模糊，请及时就医。",
+                            "qwen-plus", "", 2});
+    }
+    return messages;
+}
+
+template <typename Fn>
+double run(const char* name, int rounds, Fn&& build)
+{
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) bytes += build();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("  %-10s %10.1f us/request  (%zu bytes)\n", name, sec * 1e6 / rounds, bytes / rounds);
+    return sec;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 200;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 500;
+
+    AliyunStrategy strategy;
+    std::vector<Message> messages = session(count);
+    std::printf("%zu messages, %d rounds\n", messages.size(), rounds);
+
+    double before = run("legacy", rounds,
+                        [&]
+                        {
+                            std::vector<Message> snapshot = messages;
+                            snapshot.insert(snapshot.begin(), {"system", kSystemPrompt, "", ""});
+                            json payload = strategy.buildRequest(snapshot, json::array(), "qwen-plus");
+                            payload["stream"] = true;
+                            return payload.dump().size();
+                        });
+
+    SerializedHistory history;
+    const std::string systemPrompt = SerializedHistory::toJson({"system", kSystemPrompt}).dump();
+    double after = run("serialized", rounds,
+                       [&]
+                       {
+                           history.sync(messages);
+                           RequestEnvelope env = strategy.streamEnvelope("qwen-plus");
+                           std::string_view rest = history.range(0);
+                           std::string body;
+                           body.reserve(env.head.size() + systemPrompt.size() + rest.size() + env.tail.size() + 3);
+                           body += env.head;
+                           body += '[';
+                           body += systemPrompt;
+                           body += ',';
+                           body += rest;
+                           body += ']';
+                           body += env.tail;
+                           return body.size();
+                       });
+    std::printf("  speedup: %.1fx\n", before / after);
+    return 0;
+}
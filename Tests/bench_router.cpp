@@ -0,0 +1,143 @@
+// 路由匹配微基准：旧版（std::regex 线性扫描）与前缀树路由在 100+ 条路由下的对比。
+// 用法：./bench_router [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "router/Router.h"
+
+using http::HttpRequest;
+using http::router::Router;
+
+namespace
+{
+
+// 与业务注册表相近的路由集合，外加按资源批量生成的 REST 路由，总数 > 100
+std::vector<std::string> buildPatterns()
+{
+    std::vector<std::string> patterns = {
+        "/",
+        "/entry",
+        "/register",
+        "/health",
+        "/metrics",
+        "/login",
+        "/api/invite/verify",
+        "/api/verify/send",
+        "/api/verify/check",
+        "/api/feedback",
+        "/user/logout",
+        "/chat",
+        "/chat/send-stream",
+        "/chat/sessions",
+        "/chat/history",
+        "/chat/tts",
+        "/chat/update-title",
+        "/chat/delete-session",
+        "/upload",
+        "/upload/send",
+        "/api/chat/models",
+        "/api/user/apikey",
+        "/api/user/password",
+        "/mcp",
+        "/admin/dashboard",
+        "/admin/logs",
+        "/admin/sse",
+        "/admin/api/users",
+        "/admin/api/users/toggle",
+        "/admin/api/feedback",
+        "/admin/api/invite-codes",
+        "/admin/api/invite-codes/create",
+        "/admin/api/invite-codes/toggle",
+        "/css/:file",
+        "/js/:file",
+        "/task/:taskId/status",
+    };
+    const char* resources[] = {"users", "sessions", "messages", "models", "keys", "codes", "feedback", "logs",
+                               "tasks", "files", "tools", "prompts", "agents", "plugins", "quotas", "audits"};
+    for (const char* r : resources)
+    {
+        std::string base = std::string("/api/v1/") + r;
+        patterns.push_back(base);
+        patterns.push_back(base + "/:id");
+        patterns.push_back(base + "/:id/history");
+        patterns.push_back(base + "/:id/stats");
+        patterns.push_back(base + "/search");
+    }
+    patterns.push_back("/assets/*path");  // 通配符必须最后（旧正则版中为 /assets/:path）
+    return patterns;
+}
+
+struct RegexRoute
+{
+    std::regex re;
+};
+
+std::regex toRegex(const std::string& pattern)
+{
+    std::string p = std::regex_replace(pattern, std::regex(R"(/:([^/]+))"), R"(/([^/]+))");
+    p = std::regex_replace(p, std::regex(R"(/\*[^/]+)"), R"(/(.*))");
+    return std::regex("^" + p + "$");
+}
+
+template <typename Fn>
+double run(const char* name, long iterations, const std::vector<std::string>& paths, Fn&& fn)
+{
+    size_t hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i)
+    {
+        hits += fn(paths[static_cast<size_t>(i) % paths.size()]);
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-24s %12.0f lookups/s  %8.1f ns/lookup  (hits=%zu)\n", name, iterations / sec,
+                sec * 1e9 / iterations, hits);
+    return iterations / sec;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    long iterations = argc > 1 ? std::atol(argv[1]) : 1000000;
+    std::vector<std::string> patterns = buildPatterns();
+
+    Router router;
+    std::vector<RegexRoute> regexRoutes;
+    for (const auto& p : patterns)
+    {
+        router.registerCallback(HttpRequest::kGet, p, [](const HttpRequest&, http::HttpResponse*) {});
+        regexRoutes.push_back(RegexRoute{toRegex(p)});
+    }
+
+    // 典型流量：静态资源为主，夹杂业务接口与未命中路径
+    const std::vector<std::string> paths = {
+        "/css/style.css",       "/js/chat.js",         "/assets/images/logo.png", "/assets/fonts/inter.woff2",
+        "/chat/send-stream",    "/chat/sessions",      "/api/v1/audits/42/stats", "/task/abc123/status",
+        "/admin/api/feedback",  "/api/v1/users/search", "/favicon.ico",           "/api/v1/unknown/1",
+    };
+
+    std::printf("routes: %zu\n", patterns.size());
+    double before = run("regex linear scan", iterations / 10, paths,
+                        [&regexRoutes](const std::string& path)
+                        {
+                            std::smatch m;
+                            for (const auto& r : regexRoutes)
+                            {
+                                if (std::regex_match(path, m, r.re)) return 1;
+                            }
+                            return 0;
+                        });
+    double after = run("radix tree", iterations, paths,
+                       [&router](const std::string& path)
+                       {
+                           Router::RouteMatch m;
+                           return router.match(HttpRequest::kGet, path, &m) ? 1 : 0;
+                       });
+    std::printf("speedup: %.1fx\n", after / before);
+    return 0;
+}
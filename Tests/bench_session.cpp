@@ -0,0 +1,93 @@
+// 会话查找基准：多个 IO 线程并发经 SessionManager::getSession 查找已登录会话。
+// 对比单分片（等价于一把全局锁）与多分片锁条带化；另有一定比例的匿名请求（无 Cookie），
+// 用于确认匿名流量不再增加存储中的会话数。
+// 用法：./bench_session [threads] [opsPerThread] [sessions] [shards]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "session/SessionManager.h"
+#include "session/SessionStorage.h"
+
+using http::HttpRequest;
+using http::HttpResponse;
+using http::session::MemorySessionStorage;
+using http::session::SessionManager;
+
+namespace
+{
+
+double run(const char* name, size_t shards, int threads, int ops, int sessions)
+{
+    auto storage = std::make_unique<MemorySessionStorage>(sessions * 2, shards, true);
+    MemorySessionStorage* raw = storage.get();
+    SessionManager manager(std::move(storage));
+
+    // 预先登录 sessions 个会话，记下各自的 Cookie
+    std::vector<HttpRequest> requests(sessions);
+    for (int i = 0; i < sessions; ++i)
+    {
+        HttpRequest anonymous;
+        HttpResponse resp;
+        auto session = manager.getSession(anonymous, &resp);
+        session->setValue("userId", std::to_string(i));
+        session->setValue("isLoggedIn", "true");
+        requests[i].addHeader("Cookie", "theme=dark; sessionId=" + session->getId());
+    }
+
+    std::atomic<long> checksum{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(
+            [&, t]()
+            {
+                std::mt19937 rng(t);
+                std::uniform_int_distribution<int> pick(0, sessions - 1);
+                HttpRequest anonymous;
+                long local = 0;
+                for (int i = 0; i < ops; ++i)
+                {
+                    HttpResponse resp;
+                    // 每 10 个请求中 1 个没有 Cookie
+                    const HttpRequest& req = (i % 10 == 0) ? anonymous : requests[pick(rng)];
+                    auto session = manager.getSession(req, &resp);
+                    local += static_cast<long>(session->getValue("isLoggedIn").size());
+                }
+                checksum.fetch_add(local);
+            });
+    }
+    for (auto& w : workers)
+    {
+        w.join();
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rate = static_cast<double>(threads) * ops / sec;
+    std::printf("%-16s %12.0f lookups/s  stored=%zu  (checksum %ld)\n", name, rate, raw->size(), checksum.load());
+    return rate;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    int threads = argc > 1 ? std::atoi(argv[1]) : 8;
+    int ops = argc > 2 ? std::atoi(argv[2]) : 500000;
+    int sessions = argc > 3 ? std::atoi(argv[3]) : 10000;
+    size_t shards = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : MemorySessionStorage::kDefaultShards;
+
+    std::printf("threads: %d  ops/thread: %d  sessions: %d\n", threads, ops, sessions);
+    double before = run("1 shard", 1, threads, ops, sessions);
+    char name[32];
+    std::snprintf(name, sizeof name, "%zu shards", shards);
+    double after = run(name, shards, threads, ops, sessions);
+    std::printf("speedup: %.2fx\n", after / before);
+    return 0;
+}
@@ -0,0 +1,213 @@
+// 流式响应解析基准：回放按各厂商实际 chunk 格式构造的 SSE 流，统计每秒处理的 token 数。
+// 对比原 StreamWriteCallback 的写法（逐行 substr + 每个 chunk 完整 json::parse）与 StreamDeltaParser。
+// 用法：./bench_stream_parser [tokens] [rounds]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "llm/StreamDeltaParser.h"
+
+namespace
+{
+
+// 回放的流：按网络分片后的数据块
+struct Recording
+{
+    const char* name;
+    std::vector<std::string> pieces;
+    size_t bytes = 0;
+    size_t tokens = 0;
+};
+
+const char* kTokens[] = {"你好", "，", "今天", "北京", "的天气", "晴", "，", "气温", " 18", "~", "25", "°C", "。",
+                         "Hello", " world", "!", " The", " quick", " brown", " fox", "\n", "- ", "**", "注意", "**"};
+
+// DashScope compatible-mode：UTF-8 原文，每帧带 usage / logprobs 等空字段
+std::string dashscopeFrame(const std::string& token)
+{
+    return "data: {\"choices\":[{\"delta\":{\"content\":" + json(token).dump() +
+           "},\"finish_reason\":null,\"index\":0,\"logprobs\":null}],\"object\":\"chat.completion.chunk\",\"usage\":"
+           "null,\"created\":1718000000,\"system_fingerprint\":null,\"model\":\"qwen-plus\",\"id\":\"chatcmpl-"
+           "8f1c2e4a-1b2c-9d3e-a4f5-0123456789ab\"}\n\n";
+}
+
+// OpenAI 风格：非 ASCII 以 \uXXXX 转义
+std::string openaiFrame(const std::string& token)
+{
+    return "data: {\"id\":\"chatcmpl-9abcDEF\",\"object\":\"chat.completion.chunk\",\"created\":1718000000,"
+           "\"model\":\"gpt-4o-mini\",\"system_fingerprint\":\"fp_0123456789\",\"choices\":[{\"index\":0,\"delta\":"
+           "{\"content\":" +
+           json(token).dump(-1, ' ', true) + "},\"logprobs\":null,\"finish_reason\":null}]}\n\n";
+}
+
+// 工具调用：arguments 每帧约 3 字节
+std::string toolFrame(size_t i, const std::string& piece)
+{
+    std::string head = i == 0 ? "\"id\":\"call_abc123\",\"type\":\"function\",\"function\":{\"name\":\"get_weather\","
+                              : "\"function\":{";
+    return "data: {\"id\":\"chatcmpl-1\",\"object\":\"chat.completion.chunk\",\"created\":1718000000,\"model\":"
+           "\"qwen-plus\",\"choices\":[{\"index\":0,\"delta\":{\"tool_calls\":[{\"index\":0," +
+           head + "\"arguments\":" + json(piece).dump() + "}}]},\"finish_reason\":null}]}\n\n";
+}
+
+// 按 TCP 读到的大小（数百字节到 1.5 KiB 不等）切分
+Recording record(const char* name, const std::string& stream, size_t tokens)
+{
+    Recording rec{name, {}, stream.size(), tokens};
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> size(200, 1500);
+    for (size_t i = 0; i < stream.size();)
+    {
+        size_t n = std::min(size(rng), stream.size() - i);
+        rec.pieces.push_back(stream.substr(i, n));
+        i += n;
+    }
+    return rec;
+}
+
+std::vector<Recording> recordings(size_t tokens)
+{
+    std::vector<Recording> out;
+    std::string ds, oa, tool;
+    for (size_t i = 0; i < tokens; ++i)
+    {
+        const std::string token = kTokens[i % (sizeof kTokens / sizeof kTokens[0])];
+        ds += dashscopeFrame(token);
+        oa += openaiFrame(token);
+    }
+    std::string args = "{\"city\": \"北京\", \"date\": \"2024-06-10\", \"unit\": \"celsius\"}";
+    size_t toolTokens = 0;
+    while (toolTokens < tokens)
+    {
+        for (size_t i = 0, next = 0; i < args.size(); i = next, ++toolTokens)
+        {
+            next = std::min(i + 3, args.size());
+            while (next < args.size() && (args[next] & 0xC0) == 0x80) ++next;  // 不切断 UTF-8 字符
+            tool += toolFrame(i, args.substr(i, next - i));
+        }
+    }
+    ds += "data: [DONE]\n\n";
+    oa += "data: [DONE]\n\n";
+    tool += "data: [DONE]\n\n";
+    out.push_back(record("dashscope", ds, tokens));
+    out.push_back(record("openai", oa, tokens));
+    out.push_back(record("tool_calls", tool, toolTokens));
+    return out;
+}
+
+// 原 StreamWriteCallback 的解析部分
+struct Legacy
+{
+    std::string buffer;
+    std::string fullContent;
+    std::map<int, json> toolCalls;
+
+    void feed(const std::string& data)
+    {
+        buffer.append(data);
+        std::string& buf = buffer;
+        size_t pos = 0;
+        while (true)
+        {
+            size_t nl = buf.find('\n', pos);
+            if (nl == std::string::npos) break;
+            std::string line = buf.substr(pos, nl - pos);
+            pos = nl + 1;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line == "data: [DONE]") continue;
+            if (line.substr(0, 6) != "data: ") continue;
+            std::string jsonStr = line.substr(6);
+            try
+            {
+                json chunk = json::parse(jsonStr);
+                if (chunk.contains("choices") && !chunk["choices"].empty())
+                {
+                    auto& delta = chunk["choices"][0]["delta"];
+                    if (delta.contains("content") && !delta["content"].is_null())
+                    {
+                        std::string token = delta["content"].get<std::string>();
+                        if (!token.empty()) fullContent += token;
+                    }
+                    if (delta.contains("tool_calls") && delta["tool_calls"].is_array())
+                    {
+                        for (const auto& tc : delta["tool_calls"])
+                        {
+                            int idx = tc.value("index", -1);
+                            if (idx < 0) continue;
+                            auto& merged = toolCalls[idx];
+                            if (!merged.contains("index")) merged["index"] = idx;
+                            if (tc.contains("id") && !tc["id"].is_null()) merged["id"] = tc["id"];
+                            if (tc.contains("type") && !tc["type"].is_null()) merged["type"] = tc["type"];
+                            if (tc.contains("function"))
+                            {
+                                auto& fn = tc["function"];
+                                if (!merged.contains("function")) merged["function"] = json::object();
+                                if (fn.contains("name") && !fn["name"].is_null())
+                                    merged["function"]["name"] = fn["name"];
+                                if (fn.contains("arguments"))
+                                {
+                                    std::string argsPiece = fn["arguments"].get<std::string>();
+                                    merged["function"]["arguments"] =
+                                        merged["function"].value("arguments", "") + argsPiece;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            catch (...)
+            {
+            }
+        }
+        buf = buf.substr(pos);
+    }
+};
+
+template <typename Fn>
+double run(const char* name, const Recording& rec, int rounds, Fn&& replay)
+{
+    size_t check = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) check += replay(rec);
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rate = rec.tokens * rounds / sec;
+    std::printf("  %-8s %12.0f tokens/s  %8.1f MB/s  (check %zu)\n", name, rate, rec.bytes * rounds / sec / 1e6,
+                check / rounds);
+    return rate;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    size_t tokens = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 2000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 50;
+
+    for (const Recording& rec : recordings(tokens))
+    {
+        std::printf("%s: %zu bytes, %zu frames, %zu pieces\n", rec.name, rec.bytes, rec.tokens, rec.pieces.size());
+        double before = run("legacy", rec, rounds,
+                            [](const Recording& r)
+                            {
+                                Legacy legacy;
+                                for (const auto& piece : r.pieces) legacy.feed(piece);
+                                return legacy.fullContent.size() + legacy.toolCalls.size();
+                            });
+        double after = run("delta", rec, rounds,
+                           [](const Recording& r)
+                           {
+                               StreamDeltaParser parser([](const std::string&) { return true; });
+                               for (const auto& piece : r.pieces) parser.feed(piece);
+                               StreamResult result = parser.finish();
+                               return result.content.size() + result.toolCalls.size();
+                           });
+        std::printf("  speedup: %.2fx\n", after / before);
+    }
+    return 0;
+}
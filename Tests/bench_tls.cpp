@@ -0,0 +1,319 @@
+// HTTPS 基准：大量并发 TLS 连接下的握手速率与请求吞吐。
+// 子进程启动开启 SSL 的 HttpServer（自签名证书在启动时生成），父进程用多个客户端线程：
+// - handshake 模式：反复"建连 → TLS 握手 → 一个请求 → 关闭"，统计每秒握手数；
+// - resumed 模式：同上，但每个线程带上次连接的会话（票据）重连，统计复用握手速率与复用率；
+// - keep-alive 模式：每个线程保持一条 TLS 连接连续发请求，统计每秒请求数与解密后的响应吞吐。
+// 用法：./bench_tls [seconds] [clients] [ioThreads] [bodyBytes]
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <openssl/err.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "http/HttpServer.h"
+
+namespace
+{
+
+constexpr uint16_t kPort = 18443;
+const char kCertFile[] = "/tmp/bench_tls_cert.pem";
+const char kKeyFile[] = "/tmp/bench_tls_key.pem";
+const char kRequest[] = "GET /data HTTP/1.1\r\nHost: bench\r\n\r\n";
+
+// 生成 P-256 自签名证书，避免基准依赖外部证书文件
+bool writeSelfSignedCert()
+{
+    EVP_PKEY* key = EVP_EC_gen("P-256");
+    X509* cert = X509_new();
+    if (!key || !cert)
+    {
+        return false;
+    }
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1,
+                               0);
+    X509_set_issuer_name(cert, name);
+    bool ok = X509_sign(cert, key, EVP_sha256()) > 0;
+
+    FILE* f = ok ? std::fopen(kCertFile, "w") : nullptr;
+    ok = f && PEM_write_X509(f, cert);
+    if (f)
+    {
+        std::fclose(f);
+    }
+    f = ok ? std::fopen(kKeyFile, "w") : nullptr;
+    ok = f && PEM_write_PrivateKey(f, key, nullptr, nullptr, 0, nullptr, nullptr);
+    if (f)
+    {
+        std::fclose(f);
+    }
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ok;
+}
+
+pid_t startServer(int ioThreads, size_t bodyBytes)
+{
+    pid_t pid = ::fork();
+    if (pid != 0)
+    {
+        return pid;
+    }
+    http::HttpServer server(kPort, "bench-tls", true);
+    ssl::SslConfig config;
+    config.setCertificateFile(kCertFile);
+    config.setPrivateKeyFile(kKeyFile);
+    server.setSslConfig(config);
+    server.setThreadNum(ioThreads);
+    auto body = std::make_shared<const std::string>(bodyBytes, 'x');
+    server.Get("/data",
+               [body](const http::HttpRequest&, http::HttpResponse* resp)
+               {
+                   resp->setStatusLine("HTTP/1.1", http::HttpResponse::k200Ok, "OK");
+                   resp->setContentType("application/octet-stream");
+                   resp->setContentLength(body->size());
+                   resp->setSharedBody(body);
+               });
+    server.start();
+    ::_exit(0);
+}
+
+class TlsClient
+{
+public:
+    explicit TlsClient(SSL_CTX* ctx) : ctx_(ctx) {}
+    ~TlsClient()
+    {
+        close();
+    }
+
+    // session 非空时尝试复用该会话
+    bool connect(const sockaddr_in& addr, SSL_SESSION* session = nullptr)
+    {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd_ < 0 || ::connect(fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof addr) != 0)
+        {
+            return false;
+        }
+        ssl_ = SSL_new(ctx_);
+        SSL_set_fd(ssl_, fd_);
+        if (session)
+        {
+            SSL_set_session(ssl_, session);
+        }
+        return SSL_connect(ssl_) == 1;
+    }
+
+    bool reused() const
+    {
+        return ssl_ && SSL_session_reused(ssl_);
+    }
+
+    // 取当前会话（TLS 1.3 的票据在首个响应之后才到达，应在 request() 之后调用）
+    SSL_SESSION* session() const
+    {
+        return ssl_ ? SSL_get1_session(ssl_) : nullptr;
+    }
+
+    // 发一个请求并读完响应（按 Content-Length），返回响应总字节数，失败返回 0
+    size_t request()
+    {
+        if (SSL_write(ssl_, kRequest, sizeof kRequest - 1) <= 0)
+        {
+            return 0;
+        }
+        std::string in;
+        char buf[16 * 1024];
+        size_t headerEnd = std::string::npos;
+        size_t expected = 0;
+        for (;;)
+        {
+            int n = SSL_read(ssl_, buf, sizeof buf);
+            if (n <= 0)
+            {
+                return 0;
+            }
+            in.append(buf, static_cast<size_t>(n));
+            if (headerEnd == std::string::npos)
+            {
+                headerEnd = in.find("\r\n\r\n");
+                if (headerEnd == std::string::npos)
+                {
+                    continue;
+                }
+                size_t pos = in.find("Content-Length: ");
+                expected = headerEnd + 4 + (pos == std::string::npos ? 0 : std::strtoul(in.c_str() + pos + 16, nullptr, 10));
+            }
+            if (in.size() >= expected)
+            {
+                return in.size();
+            }
+        }
+    }
+
+    void close()
+    {
+        if (ssl_)
+        {
+            // 不发 close_notify 直接释放会使会话失效，标记为已正常关闭以便复用
+            SSL_set_shutdown(ssl_, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+            SSL_free(ssl_);
+            ssl_ = nullptr;
+        }
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+private:
+    SSL_CTX* ctx_;
+    SSL* ssl_ = nullptr;
+    int fd_ = -1;
+};
+
+struct Result
+{
+    long ok = 0;
+    long failed = 0;
+    double bytes = 0;
+};
+
+template <typename Worker>
+Result runClients(int clients, int seconds, Worker worker)
+{
+    std::atomic<bool> stop{false};
+    std::atomic<long> ok{0};
+    std::atomic<long> failed{0};
+    std::atomic<long long> bytes{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < clients; ++i)
+    {
+        threads.emplace_back([&]() { worker(stop, ok, failed, bytes); });
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    stop = true;
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    return Result{ok.load(), failed.load(), static_cast<double>(bytes.load())};
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    int seconds = argc > 1 ? std::atoi(argv[1]) : 5;
+    int clients = argc > 2 ? std::atoi(argv[2]) : 64;
+    int ioThreads = argc > 3 ? std::atoi(argv[3]) : 4;
+    size_t bodyBytes = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 16 * 1024;
+
+    ::signal(SIGPIPE, SIG_IGN);
+    if (!writeSelfSignedCert())
+    {
+        std::fprintf(stderr, "failed to generate certificate\n");
+        return 1;
+    }
+    pid_t pid = startServer(ioThreads, bodyBytes);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));  // 等待监听就绪
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(kPort);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
+    std::printf("clients: %d  io threads: %d  body: %zu bytes  (port %u)\n", clients, ioThreads, bodyBytes, kPort);
+
+    Result hs = runClients(clients, seconds,
+                           [&](std::atomic<bool>& stop, std::atomic<long>& ok, std::atomic<long>& failed,
+                               std::atomic<long long>&)
+                           {
+                               while (!stop.load(std::memory_order_relaxed))
+                               {
+                                   TlsClient client(ctx);
+                                   bool done = client.connect(addr) && client.request() > 0;
+                                   (done ? ok : failed).fetch_add(1, std::memory_order_relaxed);
+                               }
+                           });
+    std::printf("%-12s %10.0f handshakes/s  (ok=%ld failed=%ld)\n", "handshake", hs.ok / double(seconds), hs.ok,
+                hs.failed);
+
+    Result resumed = runClients(clients, seconds,
+                                [&](std::atomic<bool>& stop, std::atomic<long>& ok, std::atomic<long>& failed,
+                                    std::atomic<long long>& reusedCount)
+                                {
+                                    SSL_SESSION* session = nullptr;
+                                    while (!stop.load(std::memory_order_relaxed))
+                                    {
+                                        TlsClient client(ctx);
+                                        bool done = client.connect(addr, session) && client.request() > 0;
+                                        (done ? ok : failed).fetch_add(1, std::memory_order_relaxed);
+                                        if (done && client.reused())
+                                        {
+                                            reusedCount.fetch_add(1, std::memory_order_relaxed);
+                                        }
+                                        if (done)
+                                        {
+                                            SSL_SESSION_free(session);
+                                            session = client.session();
+                                        }
+                                    }
+                                    SSL_SESSION_free(session);
+                                });
+    std::printf("%-12s %10.0f handshakes/s  reused %.1f%%  (ok=%ld failed=%ld)\n", "resumed",
+                resumed.ok / double(seconds), resumed.ok ? 100.0 * resumed.bytes / resumed.ok : 0.0, resumed.ok,
+                resumed.failed);
+
+    Result ka = runClients(clients, seconds,
+                           [&](std::atomic<bool>& stop, std::atomic<long>& ok, std::atomic<long>& failed,
+                               std::atomic<long long>& bytes)
+                           {
+                               TlsClient client(ctx);
+                               if (!client.connect(addr))
+                               {
+                                   failed.fetch_add(1, std::memory_order_relaxed);
+                                   return;
+                               }
+                               while (!stop.load(std::memory_order_relaxed))
+                               {
+                                   size_t n = client.request();
+                                   if (n == 0)
+                                   {
+                                       failed.fetch_add(1, std::memory_order_relaxed);
+                                       return;
+                                   }
+                                   ok.fetch_add(1, std::memory_order_relaxed);
+                                   bytes.fetch_add(static_cast<long long>(n), std::memory_order_relaxed);
+                               }
+                           });
+    std::printf("%-12s %10.0f req/s  %8.1f MB/s  (ok=%ld failed=%ld)\n", "keep-alive", ka.ok / double(seconds),
+                ka.bytes / seconds / (1024 * 1024), ka.ok, ka.failed);
+
+    SSL_CTX_free(ctx);
+    ::kill(pid, SIGKILL);
+    ::waitpid(pid, nullptr, 0);
+    return 0;
+}
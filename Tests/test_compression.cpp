@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <cstring>
+#include <string>
+
+#include "http/Compression.h"
+#include "middleware/CompressionMiddleware.h"
+
+using http::AcceptEncoding;
+using http::ContentEncoding;
+using http::Compressor;
+using http::HttpRequest;
+using http::HttpResponse;
+using http::StreamCompressor;
+using http::middleware::CompressionMiddleware;
+
+namespace
+{
+
+// 增量解压：每次 feed 返回本段解出的内容，用于验证流式压缩每次 write 后即可解码
+class Inflater
+{
+public:
+    explicit Inflater(ContentEncoding encoding)
+    {
+        std::memset(&zs_, 0, sizeof zs_);
+        inflateInit2(&zs_, encoding == ContentEncoding::kGzip ? 15 + 16 : 15);
+    }
+    ~Inflater()
+    {
+        inflateEnd(&zs_);
+    }
+
+    std::string feed(const std::string& in)
+    {
+        std::string out;
+        zs_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+        zs_.avail_in = static_cast<uInt>(in.size());
+        char buf[4096];
+        do
+        {
+            zs_.next_out = reinterpret_cast<Bytef*>(buf);
+            zs_.avail_out = sizeof buf;
+            rc_ = inflate(&zs_, Z_SYNC_FLUSH);
+            out.append(buf, sizeof buf - zs_.avail_out);
+        } while (zs_.avail_in > 0 && rc_ == Z_OK);
+        return out;
+    }
+
+    bool ended() const
+    {
+        return rc_ == Z_STREAM_END;
+    }
+
+private:
+    z_stream zs_;
+    int rc_ = Z_OK;
+};
+
+std::string jsonBody(size_t messages)
+{
+    std::string body = "{\"messages\": [";
+    for (size_t i = 0; i < messages; ++i)
+    {
+        if (i) body += ", ";
+        body += "{\"role\": \"user\", \"content\": \"message number " + std::to_string(i) + "\"}";
+    }
+    return body + "]}";
+}
+
+HttpRequest requestWith(std::string_view acceptEncoding)
+{
+    HttpRequest req;
+    if (!acceptEncoding.empty()) req.addHeader("Accept-Encoding", std::string(acceptEncoding));
+    return req;
+}
+
+}  // namespace
+
+TEST(CompressionTest, ParsesAcceptEncoding)
+{
+    AcceptEncoding a = AcceptEncoding::parse("gzip, deflate;q=0.5, br;q=0");
+    EXPECT_DOUBLE_EQ(a.gzip, 1.0);
+    EXPECT_DOUBLE_EQ(a.deflate, 0.5);
+    EXPECT_DOUBLE_EQ(a.br, 0.0);
+    EXPECT_DOUBLE_EQ(a.identity, 1.0);
+
+    AcceptEncoding star = AcceptEncoding::parse("*;q=0.3, identity;q=0");
+    EXPECT_DOUBLE_EQ(star.gzip, 0.3);
+    EXPECT_DOUBLE_EQ(star.identity, 0.0);
+}
+
+TEST(CompressionTest, NegotiatesAvailableEncoding)
+{
+    EXPECT_EQ(http::negotiateEncoding(""), ContentEncoding::kIdentity);
+    EXPECT_EQ(http::negotiateEncoding("identity"), ContentEncoding::kIdentity);
+    EXPECT_EQ(http::negotiateEncoding("gzip, deflate", false), ContentEncoding::kGzip);
+    EXPECT_EQ(http::negotiateEncoding("deflate"), ContentEncoding::kDeflate);
+    EXPECT_EQ(http::negotiateEncoding("gzip;q=0.2, deflate;q=0.8, identity;q=0.1"), ContentEncoding::kDeflate);
+    EXPECT_EQ(http::negotiateEncoding("gzip;q=0.5"), ContentEncoding::kIdentity);  // identity 缺省 q=1
+    EXPECT_EQ(http::negotiateEncoding("gzip, br", false), ContentEncoding::kGzip);
+    if (http::compressionAvailable(ContentEncoding::kBrotli))
+    {
+        EXPECT_EQ(http::negotiateEncoding("gzip, br"), ContentEncoding::kBrotli);
+    }
+}
+
+TEST(CompressionTest, CompressorRoundTripsAndReusesState)
+{
+    Compressor& compressor = Compressor::threadLocal();
+    for (ContentEncoding enc : {ContentEncoding::kGzip, ContentEncoding::kDeflate})
+    {
+        for (size_t n : {50, 500, 5})  // 同一状态连续复用，长度不同
+        {
+            std::string body = jsonBody(n);
+            std::string out;
+            ASSERT_TRUE(compressor.compress(enc, 6, body, &out));
+            EXPECT_LT(out.size(), body.size());
+            Inflater inflater(enc);
+            EXPECT_EQ(inflater.feed(out), body);
+            EXPECT_TRUE(inflater.ended());
+        }
+    }
+}
+
+TEST(CompressionTest, StreamCompressorFlushesEveryWrite)
+{
+    StreamCompressor stream(ContentEncoding::kGzip, 6);
+    ASSERT_TRUE(stream.ok());
+    Inflater inflater(ContentEncoding::kGzip);
+    std::string all;
+    for (int i = 0; i < 20; ++i)
+    {
+        std::string event = "data: {\"token\":\"t" + std::to_string(i) + "\"}\n\n";
+        std::string out;
+        ASSERT_TRUE(stream.write(event, &out));
+        EXPECT_EQ(inflater.feed(out), event);  // 不等后续数据即可解出
+        all += event;
+    }
+    std::string tail;
+    ASSERT_TRUE(stream.finish(&tail));
+    EXPECT_EQ(inflater.feed(tail), "");
+    EXPECT_TRUE(inflater.ended());
+}
+
+TEST(CompressionMiddlewareTest, CompressesLargeJson)
+{
+    CompressionMiddleware middleware;
+    HttpRequest req = requestWith("gzip, deflate");
+    HttpResponse resp(false);
+    ASSERT_TRUE(middleware.before(req, &resp));
+
+    std::string body = jsonBody(100);
+    resp.setStatusCode(HttpResponse::k200Ok);
+    resp.setContentType("application/json; charset=utf-8");
+    resp.setContentLength(body.size());
+    resp.setBody(body);
+    middleware.after(resp);
+
+    ASSERT_LT(resp.getBody().size(), body.size());
+    Inflater inflater(ContentEncoding::kGzip);
+    EXPECT_EQ(inflater.feed(resp.getBody()), body);
+
+    muduo::net::Buffer buf;
+    resp.appendToBuffer(&buf);
+    std::string wire = buf.retrieveAllAsString();
+    EXPECT_NE(wire.find("Content-Encoding: gzip\r\n"), std::string::npos);
+    EXPECT_NE(wire.find("Vary: Accept-Encoding\r\n"), std::string::npos);
+    EXPECT_NE(wire.find("Content-Length: " + std::to_string(resp.getBody().size()) + "\r\n"), std::string::npos);
+}
+
+TEST(CompressionMiddlewareTest, LeavesIneligibleResponsesAlone)
+{
+    CompressionMiddleware middleware;
+    std::string big = jsonBody(100);
+
+    auto run = [&](std::string_view accept, std::string_view type, const std::string& body, bool deferred)
+    {
+        HttpRequest req = requestWith(accept);
+        HttpResponse resp(false);
+        middleware.before(req, &resp);
+        resp.setStatusCode(HttpResponse::k200Ok);
+        resp.setContentType(type);
+        resp.setBody(body);
+        resp.setDeferred(deferred);
+        middleware.after(resp);
+        return resp.getBody();
+    };
+
+    EXPECT_EQ(run("", "application/json", big, false), big);                 // 客户端不接受压缩
+    EXPECT_EQ(run("gzip", "application/json", "{\"ok\":true}", false), "{\"ok\":true}");  // 太小
+    EXPECT_EQ(run("gzip", "image/png", big, false), big);                    // 类型不在白名单
+    EXPECT_EQ(run("gzip", "application/json", big, true), big);              // deferred
+}
+
+TEST(CompressionMiddlewareTest, EncodingFollowsResponseNotThread)
+{
+    CompressionMiddleware middleware;
+    std::string big = jsonBody(100);
+    HttpRequest gzipReq = requestWith("gzip");
+    HttpRequest plainReq = requestWith("");
+
+    // 两个请求交错执行 before/after：各自按自己的 Accept-Encoding 处理
+    HttpResponse gzipResp(false), plainResp(false);
+    middleware.before(gzipReq, &gzipResp);
+    middleware.before(plainReq, &plainResp);
+    EXPECT_EQ(gzipResp.acceptedEncoding(), ContentEncoding::kGzip);
+    EXPECT_EQ(plainResp.acceptedEncoding(), ContentEncoding::kIdentity);
+
+    for (HttpResponse* resp : {&gzipResp, &plainResp})
+    {
+        resp->setStatusCode(HttpResponse::k200Ok);
+        resp->setContentType("application/json");
+        resp->setBody(big);
+        middleware.after(*resp);
+    }
+    EXPECT_LT(gzipResp.getBody().size(), big.size());
+    EXPECT_EQ(plainResp.getBody(), big);
+
+    // 未经 before() 的响应不压缩
+    HttpResponse fresh(false);
+    fresh.setStatusCode(HttpResponse::k200Ok);
+    fresh.setContentType("application/json");
+    fresh.setBody(big);
+    middleware.after(fresh);
+    EXPECT_EQ(fresh.getBody(), big);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Crypto/CryptoPool.h"
+#include "Crypto/PasswordHash.h"
+
+using common::CryptoPool;
+using common::PasswordCost;
+
+TEST(CryptoPoolTest, RejectsWhenQueueFull)
+{
+    CryptoPool::Options options;
+    options.threads = 1;
+    options.maxQueue = 2;
+    CryptoPool pool(options);
+
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    std::promise<void> started;
+    ASSERT_TRUE(pool.submit(
+        [&]()
+        {
+            started.set_value();
+            gate.wait();
+        }));
+    started.get_future().wait();  // 唯一的工作线程已被占用
+
+    std::atomic<int> ran{0};
+    EXPECT_TRUE(pool.submit([&]() { ++ran; }));
+    EXPECT_TRUE(pool.submit([&]() { ++ran; }));
+    EXPECT_FALSE(pool.submit([&]() { ++ran; }));
+
+    CryptoPool::Stats busy = pool.stats();
+    EXPECT_EQ(busy.queued, 2u);
+    EXPECT_EQ(busy.running, 1u);
+    EXPECT_EQ(busy.rejected, 1u);
+
+    release.set_value();
+    while (pool.stats().completed < 3)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(ran.load(), 2);
+
+    CryptoPool::Stats done = pool.stats();
+    EXPECT_EQ(done.submitted, 3u);
+    EXPECT_EQ(done.queued, 0u);
+    EXPECT_EQ(done.running, 0u);
+    uint64_t bucketed = 0;
+    for (uint64_t n : done.latency) bucketed += n;
+    EXPECT_EQ(bucketed, 3u);
+    EXPECT_GT(done.waitSeconds, 0.0);
+}
+
+TEST(CryptoPoolTest, TaskExceptionDoesNotKillWorker)
+{
+    CryptoPool pool(CryptoPool::Options{1, 4});
+    ASSERT_TRUE(pool.submit([]() { throw std::runtime_error("boom"); }));
+    std::promise<int> result;
+    ASSERT_TRUE(pool.submit([&]() { result.set_value(42); }));
+    EXPECT_EQ(result.get_future().get(), 42);
+}
+
+TEST(PasswordHashTest, HashVerifyAndRehashOnProfileChange)
+{
+    common::configurePasswordHashing(PasswordCost::interactive(), 0);
+    std::string hash = common::hashPassword("correct horse");
+    EXPECT_EQ(hash.rfind("$argon2id$", 0), 0u);
+    EXPECT_TRUE(common::verifyPassword("correct horse", hash));
+    EXPECT_FALSE(common::verifyPassword("battery staple", hash));
+    EXPECT_FALSE(common::passwordNeedsRehash(hash));
+
+    common::configurePasswordHashing(PasswordCost::moderate(), 0);
+    EXPECT_TRUE(common::passwordNeedsRehash(hash));  // 档位调高后旧哈希需要升级
+    EXPECT_TRUE(common::passwordNeedsRehash("not-a-hash"));
+
+    PasswordCost cost = PasswordCost::moderate();
+    EXPECT_TRUE(PasswordCost::fromName("interactive", &cost));
+    EXPECT_EQ(cost.memLimit, PasswordCost::interactive().memLimit);
+    EXPECT_FALSE(PasswordCost::fromName("extreme", &cost));
+}
+
+TEST(PasswordHashTest, MemoryBudgetSerializesComputations)
+{
+    PasswordCost cost = PasswordCost::interactive();
+    common::configurePasswordHashing(cost, cost.memLimit);  // 预算只容纳一次计算
+    std::string hash = common::hashPassword("pw");
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> peak{0};
+    std::thread sampler(
+        [&]()
+        {
+            while (!stop)
+            {
+                size_t used = common::passwordMemoryInUse();
+                size_t prev = peak.load();
+                while (used > prev && !peak.compare_exchange_weak(prev, used))
+                {
+                }
+                std::this_thread::yield();
+            }
+        });
+
+    std::vector<std::thread> workers;
+    std::atomic<int> ok{0};
+    for (int i = 0; i < 3; ++i)
+    {
+        workers.emplace_back([&]() { ok += common::verifyPassword("pw", hash) ? 1 : 0; });
+    }
+    for (auto& t : workers) t.join();
+    stop = true;
+    sampler.join();
+
+    EXPECT_EQ(ok.load(), 3);
+    EXPECT_GT(peak.load(), 0u);
+    EXPECT_LE(peak.load(), cost.memLimit);
+    EXPECT_EQ(common::passwordMemoryInUse(), 0u);
+    common::configurePasswordHashing(PasswordCost::moderate(), 0);
+}
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "common/CurlEngine.h"
+
+namespace
+{
+
+// 用 file:// 传输验证引擎的调度与完成语义，不依赖网络
+class CurlEngineTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        path_ = "/tmp/curl_engine_test_" + std::to_string(::getpid()) + ".txt";
+        std::ofstream(path_) << content_;
+    }
+
+    void TearDown() override
+    {
+        std::remove(path_.c_str());
+    }
+
+    std::string url() const
+    {
+        return "file://" + path_;
+    }
+
+    static size_t append(void* data, size_t size, size_t nmemb, void* userp)
+    {
+        static_cast<std::string*>(userp)->append(static_cast<char*>(data), size * nmemb);
+        return size * nmemb;
+    }
+
+    static CURL* makeEasy(const std::string& url, std::string* out)
+    {
+        CURL* easy = curl_easy_init();
+        curl_easy_setopt(easy, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, append);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, out);
+        return easy;
+    }
+
+    std::string path_;
+    const std::string content_ = "{\"choices\":[{\"message\":{\"content\":\"hello\"}}]}";
+};
+
+}  // namespace
+
+TEST_F(CurlEngineTest, PerformBlocksUntilTransferCompletes)
+{
+    CurlEngine engine(CurlEngine::Options{});
+    std::string body;
+    CURL* easy = makeEasy(url(), &body);
+    EXPECT_EQ(engine.perform(easy), CURLE_OK);
+    EXPECT_EQ(body, content_);
+    EXPECT_EQ(engine.inflight(), 0u);
+
+    // 同一句柄可再次提交
+    body.clear();
+    EXPECT_EQ(engine.perform(easy), CURLE_OK);
+    EXPECT_EQ(body, content_);
+    curl_easy_cleanup(easy);
+}
+
+TEST_F(CurlEngineTest, ReportsTransferErrors)
+{
+    CurlEngine engine(CurlEngine::Options{});
+    std::string body;
+    CURL* easy = makeEasy("file:///nonexistent/curl_engine_test", &body);
+    EXPECT_EQ(engine.perform(easy), CURLE_FILE_COULDNT_READ_FILE);
+    curl_easy_cleanup(easy);
+
+    easy = makeEasy("nosuchproto://x", &body);
+    EXPECT_EQ(engine.perform(easy), CURLE_UNSUPPORTED_PROTOCOL);
+    curl_easy_cleanup(easy);
+}
+
+TEST_F(CurlEngineTest, SubmitCompletesAsynchronously)
+{
+    CurlEngine::Options options;
+    options.threads = 2;
+    CurlEngine engine(options);
+
+    const int kTransfers = 64;
+    std::vector<std::string> bodies(kTransfers);
+    std::vector<CURL*> handles;
+    std::mutex mutex;
+    std::condition_variable cv;
+    int done = 0;
+    int ok = 0;
+    std::thread::id caller = std::this_thread::get_id();
+    std::atomic<bool> onCaller{false};
+
+    for (int i = 0; i < kTransfers; ++i)
+    {
+        handles.push_back(makeEasy(url(), &bodies[i]));
+        engine.submit(handles.back(), [&](CURLcode code) {
+            if (std::this_thread::get_id() == caller) onCaller = true;
+            std::lock_guard<std::mutex> lock(mutex);
+            ok += code == CURLE_OK;
+            if (++done == kTransfers) cv.notify_one();
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(10), [&] { return done == kTransfers; }));
+    EXPECT_EQ(ok, kTransfers);
+    EXPECT_FALSE(onCaller);  // 完成回调在 worker 线程上
+    for (auto& body : bodies) EXPECT_EQ(body, content_);
+    for (CURL* easy : handles) curl_easy_cleanup(easy);
+}
+
+TEST_F(CurlEngineTest, ConcurrentPerformFromManyThreads)
+{
+    CurlEngine engine(CurlEngine::Options{});
+    std::atomic<int> ok{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 20; ++i)
+            {
+                std::string body;
+                CURL* easy = makeEasy(url(), &body);
+                if (engine.perform(easy) == CURLE_OK && body == content_) ++ok;
+                curl_easy_cleanup(easy);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(ok.load(), 8 * 20);
+}
+
+// 暂停的传输只在 worker 驱动时得到进度回调：wakeup() 让它立即恢复，不必等 curl_multi_poll 的 1s 超时。
+// file:// 不支持暂停，用回环上的一次性 HTTP 响应
+TEST_F(CurlEngineTest, WakeupResumesPausedTransferPromptly)
+{
+    int listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof addr;
+    ASSERT_EQ(::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), len), 0);
+    ASSERT_EQ(::listen(listenFd, 1), 0);
+    ASSERT_EQ(::getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &len), 0);
+    std::thread server([this, listenFd] {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        std::string request;
+        char buf[1024];
+        ssize_t n = 0;
+        while (request.find("\r\n\r\n") == std::string::npos && (n = ::recv(fd, buf, sizeof buf, 0)) > 0)
+        {
+            request.append(buf, static_cast<size_t>(n));
+        }
+        std::string response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(content_.size()) +
+                               "\r\nConnection: close\r\n\r\n" + content_;
+        ::send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+        while (::recv(fd, buf, sizeof buf, 0) > 0)
+        {
+        }
+        ::close(fd);
+    });
+
+    struct State
+    {
+        CURL* easy = nullptr;
+        std::string body;
+        std::atomic<bool> paused{false};
+        std::atomic<bool> writable{false};
+    } state;
+    state.easy = makeEasy("http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port)) + "/", &state.body);
+    curl_easy_setopt(state.easy, CURLOPT_WRITEDATA, &state);
+    curl_easy_setopt(state.easy, CURLOPT_WRITEFUNCTION,
+                     +[](void* data, size_t size, size_t nmemb, void* userp) -> size_t {
+                         auto* s = static_cast<State*>(userp);
+                         if (!s->writable)
+                         {
+                             s->paused = true;
+                             return CURL_WRITEFUNC_PAUSE;
+                         }
+                         s->body.append(static_cast<char*>(data), size * nmemb);
+                         return size * nmemb;
+                     });
+    curl_easy_setopt(state.easy, CURLOPT_XFERINFODATA, &state);
+    curl_easy_setopt(state.easy, CURLOPT_XFERINFOFUNCTION,
+                     +[](void* userp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) -> int {
+                         auto* s = static_cast<State*>(userp);
+                         if (s->paused && s->writable)
+                         {
+                             s->paused = false;
+                             curl_easy_pause(s->easy, CURLPAUSE_CONT);
+                         }
+                         return 0;
+                     });
+    curl_easy_setopt(state.easy, CURLOPT_NOPROGRESS, 0L);
+
+    CurlEngine engine(CurlEngine::Options{});
+    std::promise<CURLcode> result;
+    std::future<CURLcode> future = result.get_future();
+    engine.submit(state.easy, [&result](CURLcode code) { result.set_value(code); });
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!state.paused && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(state.paused);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));  // worker 已回到 curl_multi_poll
+
+    auto start = std::chrono::steady_clock::now();
+    state.writable = true;
+    engine.wakeup();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+    EXPECT_EQ(future.get(), CURLE_OK);
+    EXPECT_EQ(state.body, content_);
+
+    curl_easy_cleanup(state.easy);
+    server.join();
+    ::close(listenFd);
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <muduo/net/Buffer.h>
+
+#include <string>
+#include <vector>
+
+#include "http/HttpContext.h"
+
+using http::HttpContext;
+using http::HttpRequest;
+
+namespace
+{
+
+bool feed(HttpContext& ctx, const std::string& data)
+{
+    muduo::net::Buffer buf;
+    buf.append(data.data(), data.size());
+    return ctx.parseRequest(&buf, muduo::Timestamp::now());
+}
+
+}  // namespace
+
+TEST(HttpParserTest, RequestLineAndHeaders)
+{
+    HttpContext ctx;
+    ASSERT_TRUE(feed(ctx,
+                     "GET /chat/history?sessionId=42&x=1 HTTP/1.1\r\n"
+                     "Host: localhost\r\n"
+                     "content-type:  application/json  \r\n"
+                     "Cookie: jwt=abc\r\n"
+                     "\r\n"));
+    ASSERT_TRUE(ctx.gotAll());
+    const HttpRequest& req = ctx.request();
+    EXPECT_EQ(req.method(), HttpRequest::kGet);
+    EXPECT_EQ(req.path(), "/chat/history");
+    EXPECT_EQ(req.getVersion(), "HTTP/1.1");
+    EXPECT_EQ(req.getQueryParameters("sessionId"), "42");
+    EXPECT_EQ(req.getQueryParameters("x"), "1");
+    EXPECT_EQ(req.getQueryParameters("missing"), "");
+    // 头字段名大小写不敏感，值两端空白被去除
+    EXPECT_EQ(req.getHeader("Content-Type"), "application/json");
+    EXPECT_EQ(req.headerView("COOKIE"), "jwt=abc");
+    EXPECT_EQ(req.headers().size(), 3u);
+}
+
+TEST(HttpParserTest, BodyAcrossSegments)
+{
+    HttpContext ctx;
+    const std::string body = R"({"question":"hello"})";
+    const std::string head = "POST /chat/send-stream HTTP/1.1\r\nContent-Length: " + std::to_string(body.size()) +
+                             "\r\nContent-Type: application/json\r\n\r\n";
+
+    muduo::net::Buffer buf;
+    buf.append(head.data(), head.size());
+    buf.append(body.data(), 5);
+    ASSERT_TRUE(ctx.parseRequest(&buf, muduo::Timestamp::now()));
+    EXPECT_FALSE(ctx.gotAll());
+    buf.append(body.data() + 5, body.size() - 5);
+    ASSERT_TRUE(ctx.parseRequest(&buf, muduo::Timestamp::now()));
+    ASSERT_TRUE(ctx.gotAll());
+    EXPECT_EQ(ctx.request().getBody(), body);
+    EXPECT_EQ(buf.readableBytes(), 0u);
+}
+
+TEST(HttpParserTest, InjectedHeaderOverridesClient)
+{
+    HttpContext ctx;
+    ASSERT_TRUE(feed(ctx, "GET / HTTP/1.1\r\nX-Auth-UserId: 1\r\n\r\n"));
+    HttpRequest& req = ctx.request();
+    req.addHeader("X-Auth-UserId", "7");
+    EXPECT_EQ(req.getHeader("x-auth-userid"), "7");
+}
+
+TEST(HttpParserTest, ResetClearsPreviousRequest)
+{
+    HttpContext ctx;
+    ASSERT_TRUE(feed(ctx, "POST /a HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc"));
+    ASSERT_TRUE(ctx.gotAll());
+    ctx.reset();
+    ASSERT_TRUE(feed(ctx, "GET /b HTTP/1.0\r\n\r\n"));
+    ASSERT_TRUE(ctx.gotAll());
+    EXPECT_EQ(ctx.request().path(), "/b");
+    EXPECT_EQ(ctx.request().getVersion(), "HTTP/1.0");
+    EXPECT_TRUE(ctx.request().getBody().empty());
+    EXPECT_TRUE(ctx.request().getHeader("Content-Length").empty());
+}
+
+TEST(HttpParserTest, RejectsMalformed)
+{
+    HttpContext bad1;
+    EXPECT_FALSE(feed(bad1, "FOO / HTTP/1.1\r\n\r\n"));
+    HttpContext bad2;
+    EXPECT_FALSE(feed(bad2, "POST / HTTP/1.1\r\n\r\n"));  // 缺少 Content-Length
+    HttpContext bad3;
+    EXPECT_FALSE(feed(bad3, "POST / HTTP/1.1\r\nContent-Length: 12abc\r\n\r\n"));
+}
+
+TEST(HttpParserTest, PipelinedRequestsInOneBuffer)
+{
+    HttpContext ctx;
+    muduo::net::Buffer buf;
+    const std::string raw =
+        "GET /a HTTP/1.1\r\n\r\n"
+        "POST /b HTTP/1.1\r\nContent-Length: 2\r\n\r\nhi"
+        "GET /c HTTP/1.1\r\n\r\n";
+    buf.append(raw.data(), raw.size());
+
+    std::vector<std::string> paths;
+    while (buf.readableBytes() > 0)
+    {
+        ASSERT_TRUE(ctx.parseRequest(&buf, muduo::Timestamp::now()));
+        ASSERT_TRUE(ctx.gotAll());
+        paths.push_back(ctx.request().path());
+        if (paths.back() == "/b")
+        {
+            EXPECT_EQ(ctx.request().getBody(), "hi");
+        }
+        ctx.reset();
+    }
+    EXPECT_EQ(paths, (std::vector<std::string>{"/a", "/b", "/c"}));
+}
+
+TEST(HttpParserTest, ChunkedBodyIncremental)
+{
+    HttpContext ctx;
+    const std::string raw =
+        "POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "5\r\nhello\r\n"
+        "7;ext=1\r\n, world\r\n"
+        "0\r\nX-Trailer: t\r\n\r\n"
+        "GET /next HTTP/1.1\r\n\r\n";
+
+    // 逐字节投喂，验证状态机可在任意位置中断续传
+    muduo::net::Buffer buf;
+    size_t i = 0;
+    for (; i < raw.size() && !ctx.gotAll(); ++i)
+    {
+        buf.append(raw.data() + i, 1);
+        ASSERT_TRUE(ctx.parseRequest(&buf, muduo::Timestamp::now()));
+    }
+    ASSERT_TRUE(ctx.gotAll());
+    EXPECT_EQ(ctx.request().getBody(), "hello, world");
+    EXPECT_EQ(ctx.request().contentLength(), 12u);
+
+    ctx.reset();
+    buf.append(raw.data() + i, raw.size() - i);
+    ASSERT_TRUE(ctx.parseRequest(&buf, muduo::Timestamp::now()));
+    ASSERT_TRUE(ctx.gotAll());
+    EXPECT_EQ(ctx.request().path(), "/next");
+}
+
+TEST(HttpParserTest, ChunkedRejectsSmuggling)
+{
+    HttpContext both;
+    EXPECT_FALSE(feed(both, "POST / HTTP/1.1\r\nContent-Length: 3\r\nTransfer-Encoding: chunked\r\n\r\n"));
+    HttpContext gzip;
+    EXPECT_FALSE(feed(gzip, "POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n"));
+    HttpContext badSize;
+    EXPECT_FALSE(feed(badSize, "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n"));
+    HttpContext badCrlf;
+    EXPECT_FALSE(feed(badCrlf, "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n1\r\naXX"));
+}
+
+TEST(HttpParserTest, EnforcesSizeLimits)
+{
+    http::ConnectionLimits limits;
+    limits.maxRequestLineBytes = 32;
+    limits.maxHeaderBytes = 64;
+    limits.maxHeaderCount = 2;
+    limits.maxBodyBytes = 8;
+
+    HttpContext bad;
+    EXPECT_FALSE(feed(bad, "FOO / HTTP/1.1\r\n\r\n"));
+    EXPECT_EQ(bad.error(), HttpContext::kBadRequest);
+
+    // 请求行未等到 CRLF 即超限
+    HttpContext longLine(&limits);
+    EXPECT_FALSE(feed(longLine, "GET /" + std::string(64, 'a')));
+    EXPECT_EQ(longLine.error(), HttpContext::kRequestLineTooLong);
+
+    HttpContext bigHeader(&limits);
+    EXPECT_FALSE(feed(bigHeader, "GET / HTTP/1.1\r\nX-Pad: " + std::string(60, 'p')));
+    EXPECT_EQ(bigHeader.error(), HttpContext::kHeaderTooLarge);
+
+    HttpContext manyHeaders(&limits);
+    EXPECT_FALSE(feed(manyHeaders, "GET / HTTP/1.1\r\nA: 1\r\nB: 2\r\nC: 3\r\n\r\n"));
+    EXPECT_EQ(manyHeaders.error(), HttpContext::kTooManyHeaders);
+
+    HttpContext bigBody(&limits);
+    EXPECT_FALSE(feed(bigBody, "POST / HTTP/1.1\r\nContent-Length: 9\r\n\r\n"));
+    EXPECT_EQ(bigBody.error(), HttpContext::kBodyTooLarge);
+
+    HttpContext bigChunked(&limits);
+    EXPECT_FALSE(feed(bigChunked, "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nabcde\r\n4\r\n"));
+    EXPECT_EQ(bigChunked.error(), HttpContext::kBodyTooLarge);
+
+    HttpContext ok(&limits);
+    ASSERT_TRUE(feed(ok, "POST / HTTP/1.1\r\nContent-Length: 8\r\n\r\n12345678"));
+    EXPECT_TRUE(ok.gotAll());
+    EXPECT_EQ(ok.error(), HttpContext::kNoError);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "http/HttpHeaders.h"
+#include "http/HttpResponse.h"
+
+using http::HeaderTemplate;
+using http::HttpResponse;
+using http::ResponseHeaders;
+
+namespace
+{
+
+std::string serialize(const HttpResponse& resp)
+{
+    muduo::net::Buffer buf;
+    resp.appendToBuffer(&buf);
+    return buf.retrieveAllAsString();
+}
+
+}  // namespace
+
+TEST(HttpHeadersTest, StatusLineTable)
+{
+    static_assert(http::statusLineSuffix(200) == " 200 OK\r\n");
+    static_assert(http::reasonPhrase(404) == "Not Found");
+    EXPECT_TRUE(http::statusLineSuffix(299).empty());
+    EXPECT_TRUE(http::statusLineSuffix(42).empty());
+    EXPECT_TRUE(http::statusLineSuffix(600).empty());
+}
+
+TEST(HttpHeadersTest, ResponseHeadersOverflowKeepsOrder)
+{
+    ResponseHeaders headers;
+    for (int i = 0; i < 10; ++i)
+    {
+        headers.set("X-H" + std::to_string(i), std::to_string(i));
+    }
+    ASSERT_EQ(headers.size(), 10u);
+    headers.set("x-h9", "nine");
+    EXPECT_EQ(*headers.find("X-H9"), "nine");
+
+    EXPECT_TRUE(headers.erase("X-H0"));
+    EXPECT_FALSE(headers.erase("X-H0"));
+    ASSERT_EQ(headers.size(), 9u);
+    for (size_t i = 0; i < headers.size(); ++i)
+    {
+        EXPECT_EQ(headers[i].name, "X-H" + std::to_string(i + 1));
+    }
+}
+
+TEST(HttpHeadersTest, ResponseHeadersKeepEncodingConsistent)
+{
+    ResponseHeaders headers;
+    headers.set("ETag", "\"abc\"");
+    headers.set("Cache-Control", "no-cache");
+    headers.set("Vary", "Accept-Encoding");
+    EXPECT_FALSE(headers.find("X-Missing"));
+
+    headers.set("etag", "\"a-much-longer-entity-tag\"");  // 变长覆盖，后续字段随之平移
+    headers.set("Cache-Control", "max-age=1");
+    ASSERT_TRUE(headers.find("Vary"));
+    EXPECT_EQ(*headers.find("Vary"), "Accept-Encoding");
+
+    EXPECT_TRUE(headers.erase("Cache-Control"));
+    muduo::net::Buffer buf;
+    headers.appendTo(&buf);
+    EXPECT_EQ(buf.retrieveAllAsString(), "ETag: \"a-much-longer-entity-tag\"\r\nVary: Accept-Encoding\r\n");
+    EXPECT_EQ(headers.encodedSize(), 57u);
+    EXPECT_EQ(headers[1].name, "Vary");
+}
+
+TEST(HttpResponseTest, SerializesStandardResponse)
+{
+    HttpResponse resp(false);
+    resp.setStatusLine("HTTP/1.1", HttpResponse::k200Ok, "OK");
+    resp.setContentType("application/json");
+    resp.setContentLength(2);
+    resp.setBody("{}");
+    EXPECT_EQ(serialize(resp),
+              "HTTP/1.1 200 OK\r\n"
+              "Connection: Keep-Alive\r\n"
+              "Content-Type: application/json\r\n"
+              "Content-Length: 2\r\n"
+              "\r\n"
+              "{}");
+}
+
+TEST(HttpResponseTest, CustomReasonPhraseFallsBack)
+{
+    HttpResponse resp;
+    resp.setStatusLine("HTTP/1.0", HttpResponse::k400BadRequest, "Invalid JSON");
+    EXPECT_EQ(serialize(resp).substr(0, 31), "HTTP/1.0 400 Invalid JSON\r\nConn");
+}
+
+TEST(HttpResponseTest, ContentHeadersAreNotDuplicated)
+{
+    HttpResponse resp;
+    resp.setStatusLine("HTTP/1.1", HttpResponse::k200Ok, "OK");
+    resp.setContentType("application/json");
+    resp.addHeader("content-type", "application/x-custom");
+    resp.addHeader("Content-Length", "7");
+    resp.setContentLength(5);
+    std::string out = serialize(resp);
+    EXPECT_EQ(out.find("application/json"), std::string::npos);
+    EXPECT_NE(out.find("Content-Type: application/x-custom\r\n"), std::string::npos);
+    EXPECT_NE(out.find("Content-Length: 5\r\n"), std::string::npos);
+    EXPECT_EQ(out.find("Content-Length: 7"), std::string::npos);
+}
+
+TEST(HttpResponseTest, RawHeadersAndTemplate)
+{
+    HeaderTemplate tmpl{{"Cache-Control", "no-store"}, {"X-Robots-Tag", "noindex"}};
+    ASSERT_TRUE(tmpl.block());
+    EXPECT_EQ(*tmpl.block(), "Cache-Control: no-store\r\nX-Robots-Tag: noindex\r\n");
+
+    HttpResponse resp;
+    resp.setStatusLine("HTTP/1.1", HttpResponse::k204NoContent, "No Content");
+    for (int i = 0; i < 6; ++i)
+    {
+        resp.addRawHeaders("X-Raw: 1\r\n");
+    }
+    resp.setHeaderTemplate(tmpl);
+    std::string out = serialize(resp);
+
+    size_t count = 0;
+    for (size_t pos = out.find("X-Raw: 1\r\n"); pos != std::string::npos; pos = out.find("X-Raw: 1\r\n", pos + 1))
+    {
+        ++count;
+    }
+    EXPECT_EQ(count, 6u);
+    EXPECT_NE(out.find("X-Robots-Tag: noindex\r\n\r\n"), std::string::npos);
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+#include "Auth/Base64Url.h"
+#include "Auth/JwtService.h"
+
+using common::JwtClaims;
+using common::JwtService;
+
+namespace
+{
+
+std::string encode(const std::string& data)
+{
+    std::string out(common::base64url::encodedLength(data.size()), '\0');
+    out.resize(common::base64url::encode(data.data(), data.size(), out.data()));
+    return out;
+}
+
+bool decode(const std::string& in, std::string* out)
+{
+    out->assign(common::base64url::decodedMaxLength(in.size()), '\0');
+    size_t len = 0;
+    if (!common::base64url::decode(in, out->data(), &len)) return false;
+    out->resize(len);
+    return true;
+}
+
+}  // namespace
+
+TEST(Base64UrlTest, RoundTripsAllLengths)
+{
+    std::string data;
+    for (int i = 0; i < 64; ++i)
+    {
+        std::string back;
+        ASSERT_TRUE(decode(encode(data), &back));
+        EXPECT_EQ(back, data);
+        data.push_back(static_cast<char>(i * 37 + 251));
+    }
+    EXPECT_EQ(encode("\xfb\xff"), "-_8");
+    EXPECT_EQ(encode("hello"), "aGVsbG8");
+}
+
+TEST(Base64UrlTest, RejectsInvalidInput)
+{
+    std::string out;
+    EXPECT_FALSE(decode("aGVsbG8=", &out));  // 不接受填充
+    EXPECT_FALSE(decode("aGV+bG8", &out));   // 标准 Base64 字符
+    EXPECT_FALSE(decode("aGVsb", &out));     // 长度 4n+1 不可能出现
+    EXPECT_TRUE(decode("", &out));
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(JwtServiceTest, SignAndVerify)
+{
+    JwtService jwt("secret");
+    std::string token = jwt.sign(42, "admin");
+
+    json payload = jwt.verify(token);
+    ASSERT_FALSE(payload.empty());
+    EXPECT_EQ(payload["sub"].get<long long>(), 42);
+    EXPECT_EQ(payload["role"].get<std::string>(), "admin");
+
+    JwtClaims claims;
+    ASSERT_TRUE(jwt.verifyClaims(token, &claims));
+    EXPECT_EQ(claims.userId, 42);
+    EXPECT_EQ(claims.role, "admin");
+    EXPECT_GT(claims.exp, 0);
+
+    // 第二次命中缓存，结果一致
+    JwtClaims cached;
+    ASSERT_TRUE(jwt.verifyClaims(token, &cached));
+    EXPECT_EQ(cached.userId, 42);
+    EXPECT_EQ(cached.role, "admin");
+}
+
+TEST(JwtServiceTest, RejectsTamperedToken)
+{
+    JwtService jwt("secret");
+    std::string token = jwt.sign(7, "user");
+    JwtClaims claims;
+    ASSERT_TRUE(jwt.verifyClaims(token, &claims));
+
+    // 改写 payload 为 sub=8，签名不变
+    size_t dot1 = token.find('.');
+    size_t dot2 = token.find('.', dot1 + 1);
+    std::string payload;
+    ASSERT_TRUE(decode(token.substr(dot1 + 1, dot2 - dot1 - 1), &payload));
+    payload.replace(payload.find("\"sub\":7"), 7, "\"sub\":8");
+    std::string forged = token.substr(0, dot1 + 1) + encode(payload) + token.substr(dot2);
+    EXPECT_FALSE(jwt.verifyClaims(forged, &claims));
+    EXPECT_TRUE(jwt.verify(forged).empty());
+
+    std::string badSig = token;
+    badSig.back() = badSig.back() == 'A' ? 'B' : 'A';
+    EXPECT_FALSE(jwt.verifyClaims(badSig, &claims));
+    EXPECT_FALSE(jwt.verifyClaims(token.substr(0, dot2), &claims));
+    EXPECT_FALSE(jwt.verifyClaims("", &claims));
+}
+
+TEST(JwtServiceTest, CacheIsPrivateToSecret)
+{
+    JwtService a("secret-a");
+    JwtService b("secret-b");
+    std::string token = a.sign(1, "admin");
+
+    JwtClaims claims;
+    ASSERT_TRUE(a.verifyClaims(token, &claims));
+    // a 已缓存该令牌，b 的密钥不同，不得复用 a 的缓存结果
+    EXPECT_FALSE(b.verifyClaims(token, &claims));
+    EXPECT_TRUE(a.verifyClaims(token, &claims));
+}
+
+TEST(JwtServiceTest, ExpiredTokenRejectedEvenWhenCached)
+{
+    JwtService jwt("secret");
+    std::string token = jwt.sign(3, "user", 1);
+    JwtClaims claims;
+    ASSERT_TRUE(jwt.verifyClaims(token, &claims));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+    EXPECT_FALSE(jwt.verifyClaims(token, &claims));
+    EXPECT_TRUE(jwt.verify(token).empty());
+
+    EXPECT_FALSE(jwt.verifyClaims(jwt.sign(3, "user", -10), &claims));
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "middleware/AdminAuthMiddleware.h"
+#include "middleware/MiddlewareChain.h"
+#include "middleware/cors/CorsMiddleware.h"
+#include "router/Router.h"
+
+using http::HttpRequest;
+using http::HttpResponse;
+using http::middleware::Middleware;
+using http::middleware::MiddlewareChain;
+using http::router::Router;
+
+namespace
+{
+
+// 记录 before/after 调用顺序；prefix 非空时只作用于以其开头的路由，stop 为真时在 before 中终止
+class Probe : public Middleware
+{
+public:
+    Probe(std::string name, std::vector<std::string>* log, std::string prefix = "", bool stop = false)
+        : name_(std::move(name)), log_(log), prefix_(std::move(prefix)), stop_(stop)
+    {
+    }
+
+    bool before(HttpRequest& request, HttpResponse* response) override
+    {
+        log_->push_back(name_ + ".before");
+        request.addHeader("X-" + name_, "1");
+        if (stop_)
+        {
+            response->setStatusCode(HttpResponse::k401Unauthorized);
+            return false;
+        }
+        return true;
+    }
+
+    void after(HttpResponse&) override
+    {
+        log_->push_back(name_ + ".after");
+    }
+
+    bool appliesTo(std::string_view routePattern) const override
+    {
+        return routePattern.substr(0, prefix_.size()) == prefix_;
+    }
+
+private:
+    std::string name_;
+    std::vector<std::string>* log_;
+    std::string prefix_;
+    bool stop_;
+};
+
+}  // namespace
+
+TEST(MiddlewareChainTest, CompileSelectsByRoutePattern)
+{
+    std::vector<std::string> log;
+    MiddlewareChain all;
+    all.addMiddleware(std::make_shared<Probe>("cors", &log));
+    all.addMiddleware(std::make_shared<Probe>("auth", &log, "/api"));
+    all.addMiddleware(std::make_shared<Probe>("rate", &log, "/api/chat"));
+
+    EXPECT_EQ(all.compile("/assets/*path")->size(), 1u);
+    EXPECT_EQ(all.compile("/api/user/apikey")->size(), 2u);
+    EXPECT_EQ(all.compile("/api/chat/send")->size(), 3u);
+
+    // 静态资源路由只执行作用于它的中间件，且直接修改传入的请求
+    auto chain = all.compile("/assets/*path");
+    HttpRequest req;
+    HttpResponse resp;
+    size_t passed = 0;
+    EXPECT_TRUE(chain->processBefore(req, &resp, &passed));
+    EXPECT_EQ(passed, 1u);
+    EXPECT_EQ(req.getHeader("X-cors"), "1");
+    EXPECT_EQ(req.getHeader("X-auth"), "");
+    chain->processAfter(resp, passed);
+    EXPECT_EQ(log, (std::vector<std::string>{"cors.before", "cors.after"}));
+}
+
+TEST(MiddlewareChainTest, ShortCircuitRunsAfterOfPassedOnly)
+{
+    std::vector<std::string> log;
+    MiddlewareChain chain;
+    chain.addMiddleware(std::make_shared<Probe>("a", &log));
+    chain.addMiddleware(std::make_shared<Probe>("b", &log));
+    chain.addMiddleware(std::make_shared<Probe>("deny", &log, "", true));
+    chain.addMiddleware(std::make_shared<Probe>("c", &log));
+
+    HttpRequest req;
+    HttpResponse resp;
+    size_t passed = 0;
+    EXPECT_FALSE(chain.processBefore(req, &resp, &passed));
+    EXPECT_EQ(passed, 2u);
+    chain.processAfter(resp, passed);
+    EXPECT_EQ(log, (std::vector<std::string>{"a.before", "b.before", "deny.before", "b.after", "a.after"}));
+}
+
+TEST(MiddlewareChainTest, AdminAuthBoundToAdminRoutesOnly)
+{
+    http::middleware::AdminAuthMiddleware admin;
+    EXPECT_TRUE(admin.appliesTo("/admin/api/users"));
+    EXPECT_FALSE(admin.appliesTo("/api/chat/send"));
+    EXPECT_FALSE(admin.appliesTo("/"));
+
+    HttpRequest req;
+    const char kPath[] = "/admin/api/users";
+    req.setPath(kPath, kPath + sizeof kPath - 1);
+    HttpResponse resp;
+    EXPECT_FALSE(admin.before(req, &resp));
+
+    req.setAuth(1, "admin");
+    HttpResponse ok;
+    EXPECT_TRUE(admin.before(req, &ok));
+}
+
+TEST(MiddlewareChainTest, CorsPreflightWritesResponseInPlace)
+{
+    http::middleware::CorsConfig config = http::middleware::CorsConfig::defaultConfig();
+    config.allowedOrigins = {"http://localhost:8080"};
+    http::middleware::CorsMiddleware cors(config);
+
+    HttpRequest get;
+    const char kGet[] = "GET";
+    get.setMethod(kGet, kGet + 3);
+    HttpResponse resp;
+    EXPECT_TRUE(cors.before(get, &resp));
+
+    HttpRequest preflight;
+    const char kOptions[] = "OPTIONS";
+    preflight.setMethod(kOptions, kOptions + 7);
+    preflight.addHeader("Origin", "http://localhost:8080");
+    HttpResponse pre;
+    EXPECT_FALSE(cors.before(preflight, &pre));
+    EXPECT_EQ(pre.getStatusCode(), HttpResponse::k204NoContent);
+}
+
+TEST(MiddlewareChainTest, RouterForEachRouteVisitsAllTargets)
+{
+    Router router;
+    auto noop = [](const HttpRequest&, HttpResponse*) {};
+    router.registerCallback(HttpRequest::kGet, "/", noop);
+    router.registerCallback(HttpRequest::kGet, "/css/:file", noop);
+    router.registerCallback(HttpRequest::kGet, "/assets/*path", noop);
+    router.registerCallback(HttpRequest::kPost, "/api/chat/send", noop);
+
+    MiddlewareChain all;
+    std::vector<std::string> log;
+    all.addMiddleware(std::make_shared<Probe>("auth", &log, "/api"));
+    std::vector<std::string> seen;
+    router.forEachRoute(
+        [&](Router::RouteTarget& target)
+        {
+            seen.push_back(target.pattern);
+            target.middlewares = all.compile(target.pattern);
+        });
+    EXPECT_EQ(seen.size(), 4u);
+
+    Router::RouteMatch m;
+    ASSERT_TRUE(router.match(HttpRequest::kPost, "/api/chat/send", &m));
+    EXPECT_EQ(m.target->middlewares->size(), 1u);
+    ASSERT_TRUE(router.match(HttpRequest::kGet, "/assets/app.js", &m));
+    EXPECT_EQ(m.target->middlewares->size(), 0u);
+}
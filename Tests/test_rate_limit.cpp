@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Common/RateLimit/RateLimiter.h"
+#include "Common/RateLimit/TokenBucket.h"
+#include "middleware/RateLimitMiddleware.h"
+
+using common::RateLimit;
+using common::ShardedRateLimiter;
+using common::TokenBucket;
+using http::HttpRequest;
+using http::HttpResponse;
+using http::middleware::RateLimitMiddleware;
+using http::middleware::RateLimitRule;
+
+namespace
+{
+
+// 补充极慢（约 11.5 天一个令牌），测试期间相当于不补充
+constexpr double kNoRefill = 1e-9;
+
+// setPath 只记录 view，path 须为字面量
+HttpRequest makeRequest(std::string_view path, long long userId, const std::string& role)
+{
+    HttpRequest req;
+    req.setPath(path.data(), path.data() + path.size());
+    req.setAuth(userId, role);
+    return req;
+}
+
+}  // namespace
+
+TEST(TokenBucketTest, AllowsBurstThenRejects)
+{
+    TokenBucket bucket(5, kNoRefill);
+    for (int i = 0; i < 5; ++i) EXPECT_TRUE(bucket.consume());
+    int64_t retryAfterNs = 0;
+    EXPECT_FALSE(bucket.consume(1, &retryAfterNs));
+    EXPECT_GT(retryAfterNs, 0);
+    EXPECT_FALSE(bucket.idle());
+
+    bucket.reset();
+    EXPECT_TRUE(bucket.idle());
+    EXPECT_TRUE(bucket.consume(5));
+    EXPECT_FALSE(bucket.consume());
+}
+
+TEST(TokenBucketTest, RefillsOverTime)
+{
+    std::atomic<int64_t> tat{0};
+    RateLimit limit{2, 10.0};  // 100ms 一个令牌
+    int64_t now = 1000000000LL;
+    EXPECT_TRUE(common::gcra::consume(tat, limit, 2, now));
+    int64_t retryAfterNs = 0;
+    EXPECT_FALSE(common::gcra::consume(tat, limit, 1, now, &retryAfterNs));
+    EXPECT_EQ(retryAfterNs, 100000000LL);
+    EXPECT_TRUE(common::gcra::consume(tat, limit, 1, now + 100000000LL));
+    EXPECT_FALSE(common::gcra::isIdle(tat, now + 100000000LL));
+    EXPECT_TRUE(common::gcra::isIdle(tat, now + 300000000LL));
+}
+
+TEST(TokenBucketTest, ConcurrentConsumeNeverOverAdmits)
+{
+    // 旧实现 load/store 分离，并发下会多放行；CAS 之后放行数恰好等于容量
+    constexpr int kBurst = 1000;
+    TokenBucket bucket(kBurst, kNoRefill);
+    std::atomic<int> admitted{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 16; ++t)
+    {
+        threads.emplace_back(
+            [&]()
+            {
+                for (int i = 0; i < 500; ++i)
+                    if (bucket.consume()) admitted.fetch_add(1);
+            });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(admitted.load(), kBurst);
+}
+
+TEST(ShardedRateLimiterTest, KeysAreIndependent)
+{
+    ShardedRateLimiter limiter(4);
+    RateLimit limit{2, kNoRefill};
+    EXPECT_TRUE(limiter.acquire(1, limit));
+    EXPECT_TRUE(limiter.acquire(1, limit));
+    EXPECT_FALSE(limiter.acquire(1, limit));
+    EXPECT_TRUE(limiter.acquire(2, limit));
+    EXPECT_EQ(limiter.size(), 2u);
+}
+
+TEST(ShardedRateLimiterTest, ReclaimsOnlyFullBuckets)
+{
+    ShardedRateLimiter limiter(4);
+    RateLimit slow{1, kNoRefill};
+    RateLimit fast{1, 1e9};  // 1ns 回满
+    EXPECT_TRUE(limiter.acquire(1, slow));
+    EXPECT_TRUE(limiter.acquire(2, fast));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    EXPECT_EQ(limiter.reclaimIdle(), 1u);
+    EXPECT_EQ(limiter.size(), 1u);
+    // 未回满的桶保留原状态
+    EXPECT_FALSE(limiter.acquire(1, slow));
+}
+
+TEST(ShardedRateLimiterTest, ReclaimsPeriodicallyOnInsert)
+{
+    ShardedRateLimiter limiter(1, 0);  // 间隔 0：每次插入新 key 都顺带回收
+    RateLimit fast{1, 1e9};
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(limiter.acquire(i, fast));
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+    }
+    EXPECT_LE(limiter.size(), 2u);
+}
+
+TEST(RateLimitMiddlewareTest, DefaultLimitsChatPerUser)
+{
+    RateLimitMiddleware mw(2, kNoRefill);
+    EXPECT_TRUE(mw.appliesTo("/api/chat/send"));
+    EXPECT_FALSE(mw.appliesTo("/api/admin/users"));
+
+    HttpRequest req = makeRequest("/api/chat/send", 7, "user");
+    HttpResponse resp;
+    EXPECT_TRUE(mw.before(req, &resp));
+    EXPECT_TRUE(mw.before(req, &resp));
+    EXPECT_FALSE(mw.before(req, &resp));
+    EXPECT_EQ(resp.getStatusCode(), HttpResponse::k429TooManyRequests);
+
+    HttpRequest other = makeRequest("/api/chat/send", 8, "user");
+    HttpResponse otherResp;
+    EXPECT_TRUE(mw.before(other, &otherResp));
+
+    HttpRequest anonymous = makeRequest("/api/chat/send", 0, "");
+    EXPECT_TRUE(mw.before(anonymous, &otherResp));
+}
+
+TEST(RateLimitMiddlewareTest, TiersAndRoutes)
+{
+    std::vector<RateLimitRule> rules = {
+        {"/api/chat/upload", {{"*", RateLimit{1, kNoRefill}}}, std::make_shared<ShardedRateLimiter>()},
+        {"/api/chat",
+         {{"user", RateLimit{1, kNoRefill}}, {"admin", RateLimit{3, kNoRefill}}},
+         std::make_shared<ShardedRateLimiter>()},
+    };
+    RateLimitMiddleware mw(rules);
+
+    HttpResponse resp;
+    HttpRequest user = makeRequest("/api/chat/send", 1, "user");
+    EXPECT_TRUE(mw.before(user, &resp));
+    EXPECT_FALSE(mw.before(user, &resp));
+
+    HttpRequest admin = makeRequest("/api/chat/send", 2, "admin");
+    for (int i = 0; i < 3; ++i) EXPECT_TRUE(mw.before(admin, &resp));
+    EXPECT_FALSE(mw.before(admin, &resp));
+
+    // 未配置的档位不限流
+    HttpRequest org = makeRequest("/api/chat/send", 3, "org");
+    for (int i = 0; i < 10; ++i) EXPECT_TRUE(mw.before(org, &resp));
+
+    // 首条匹配的规则生效，且与 /api/chat 的额度相互独立
+    HttpRequest upload = makeRequest("/api/chat/upload", 1, "user");
+    EXPECT_TRUE(mw.before(upload, &resp));
+    EXPECT_FALSE(mw.before(upload, &resp));
+}
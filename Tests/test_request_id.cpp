@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "Common/Logging/RequestId.h"
+
+namespace
+{
+
+uint64_t timestampOf(const std::string& id)
+{
+    // 前 48 位为毫秒时间戳：8 个十六进制字符 + '-' + 4 个十六进制字符
+    return std::stoull(id.substr(0, 8) + id.substr(9, 4), nullptr, 16);
+}
+
+}  // namespace
+
+TEST(RequestIdTest, HasUuidV7Layout)
+{
+    std::string id = common::generateRequestId();
+    ASSERT_EQ(id.size(), common::kRequestIdLength);
+    EXPECT_EQ(id[8], '-');
+    EXPECT_EQ(id[13], '-');
+    EXPECT_EQ(id[18], '-');
+    EXPECT_EQ(id[23], '-');
+    EXPECT_EQ(id[14], '7');                                          // 版本
+    EXPECT_NE(std::string("89ab").find(id[19]), std::string::npos);  // 变体 10xx
+    EXPECT_TRUE(common::isValidRequestId(id));
+
+    auto nowMs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count());
+    uint64_t ts = timestampOf(id);
+    EXPECT_LE(ts, nowMs + 1);
+    EXPECT_GE(ts + 1000, nowMs);
+}
+
+TEST(RequestIdTest, StrictlyIncreasingWithinThread)
+{
+    std::string prev = common::generateRequestId();
+    for (int i = 0; i < 200000; ++i)
+    {
+        std::string next = common::generateRequestId();
+        ASSERT_LT(prev, next);
+        prev = std::move(next);
+    }
+}
+
+TEST(RequestIdTest, UniqueAcrossThreads)
+{
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 50000;
+    std::vector<std::vector<std::string>> ids(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back(
+            [&ids, t]()
+            {
+                ids[t].reserve(kPerThread);
+                for (int i = 0; i < kPerThread; ++i) ids[t].push_back(common::generateRequestId());
+            });
+    }
+    for (auto& th : threads) th.join();
+
+    std::unordered_set<std::string> all;
+    for (const auto& v : ids) all.insert(v.begin(), v.end());
+    EXPECT_EQ(all.size(), static_cast<size_t>(kThreads) * kPerThread);
+}
+
+TEST(RequestIdTest, ValidatesClientSuppliedIds)
+{
+    EXPECT_TRUE(common::isValidRequestId("abc-123_X.y:z"));
+    EXPECT_FALSE(common::isValidRequestId(""));
+    EXPECT_FALSE(common::isValidRequestId(std::string(65, 'a')));
+    EXPECT_FALSE(common::isValidRequestId("bad id"));
+    EXPECT_FALSE(common::isValidRequestId("x\r\nSet-Cookie: a=b"));
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "router/Router.h"
+
+using http::HttpRequest;
+using http::HttpResponse;
+using http::router::Router;
+
+namespace
+{
+
+// 回调把命中的模式名写进响应体，便于断言
+Router::HandlerCallback tag(const std::string& name)
+{
+    return [name](const HttpRequest&, HttpResponse* resp) { resp->setBody(name); };
+}
+
+std::string matchPattern(const Router& router, HttpRequest::Method method, const std::string& path)
+{
+    Router::RouteMatch m;
+    return router.match(method, path, &m) ? m.target->pattern : std::string();
+}
+
+}  // namespace
+
+TEST(RouterTest, StaticParamWildcardPriority)
+{
+    Router router;
+    router.registerCallback(HttpRequest::kGet, "/chat", tag("chat"));
+    router.registerCallback(HttpRequest::kGet, "/chat/sessions", tag("sessions"));
+    router.registerCallback(HttpRequest::kGet, "/css/:file", tag("css"));
+    router.registerCallback(HttpRequest::kGet, "/assets/images/:file", tag("images"));
+    router.registerCallback(HttpRequest::kGet, "/assets/*path", tag("assets"));
+    router.registerCallback(HttpRequest::kGet, "/task/:taskId/status", tag("task"));
+    router.registerCallback(HttpRequest::kPost, "/chat", tag("post-chat"));
+
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/chat"), "/chat");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/chat/sessions"), "/chat/sessions");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kPost, "/chat"), "/chat");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/chat/"), "");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/css/app.css"), "/css/:file");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/css/"), "");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/css/a/b.css"), "");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/assets/images/logo.png"), "/assets/images/:file");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/assets/images/uploads/x.png"), "/assets/*path");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/assets/fonts/a.woff2"), "/assets/*path");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/task/abc/status"), "/task/:taskId/status");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/task/abc"), "");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kDelete, "/chat"), "");
+}
+
+TEST(RouterTest, ParamsWrittenIntoRequest)
+{
+    Router router;
+    std::string seen;
+    router.registerCallback(HttpRequest::kGet, "/task/:taskId/status",
+                            [&seen](const HttpRequest& req, HttpResponse*)
+                            { seen = req.getPathParameters("taskId") + "|" + req.getPathParameters("param1"); });
+
+    const std::string path = "/task/t-42/status";
+    HttpRequest req;
+    const std::string method = "GET";
+    ASSERT_TRUE(req.setMethod(method.data(), method.data() + method.size()));
+    req.setPath(path.data(), path.data() + path.size());
+
+    HttpResponse resp;
+    EXPECT_TRUE(router.route(req, &resp));
+    EXPECT_EQ(seen, "t-42|t-42");
+}
+
+TEST(RouterTest, BacktracksFromStaticToParam)
+{
+    Router router;
+    router.registerCallback(HttpRequest::kGet, "/api/users/me/profile", tag("me"));
+    router.registerCallback(HttpRequest::kGet, "/api/users/:id", tag("user"));
+
+    Router::RouteMatch m;
+    ASSERT_TRUE(router.match(HttpRequest::kGet, "/api/users/me", &m));
+    EXPECT_EQ(m.target->pattern, "/api/users/:id");
+    ASSERT_EQ(m.count, 1u);
+    EXPECT_EQ(m.values[0], "me");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/api/users/mega"), "/api/users/:id");
+}
+
+TEST(RouterTest, CloneIsIndependentSnapshot)
+{
+    Router router;
+    router.registerCallback(HttpRequest::kGet, "/chat", tag("chat"));
+    router.registerCallback(HttpRequest::kGet, "/css/:file", tag("css"));
+    router.registerCallback(HttpRequest::kGet, "/assets/*path", tag("assets"));
+
+    std::unique_ptr<Router> snapshot = router.clone();
+    router.registerCallback(HttpRequest::kGet, "/later", tag("later"));
+
+    EXPECT_EQ(matchPattern(*snapshot, HttpRequest::kGet, "/chat"), "/chat");
+    EXPECT_EQ(matchPattern(*snapshot, HttpRequest::kGet, "/css/a.css"), "/css/:file");
+    EXPECT_EQ(matchPattern(*snapshot, HttpRequest::kGet, "/assets/x/y.png"), "/assets/*path");
+    EXPECT_EQ(matchPattern(*snapshot, HttpRequest::kGet, "/later"), "");
+    EXPECT_EQ(matchPattern(router, HttpRequest::kGet, "/later"), "/later");
+
+    const std::string path = "/css/a.css";
+    HttpRequest req;
+    const std::string method = "GET";
+    ASSERT_TRUE(req.setMethod(method.data(), method.data() + method.size()));
+    req.setPath(path.data(), path.data() + path.size());
+    HttpResponse resp;
+    ASSERT_TRUE(snapshot->route(req, &resp));
+    EXPECT_EQ(req.getPathParameters("file"), "a.css");
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "llm/AIStrategy.h"
+#include "llm/SerializedHistory.h"
+
+namespace
+{
+
+std::vector<Message> conversation()
+{
+    return {
+        {"user", "北京今天天气怎么样？", "", "", 1},
+        {"assistant", R"([{"id":"call_1","type":"function","function":{"name":"get_weather","arguments":"{}"}}])",
+         "qwen-plus", "tool_calls", 0},
+        {"tool", R"({"weather":"晴"})", "", "call_1", 0},
+        {"assistant", "晴，\"18~25°C\"\n", "qwen-plus", "", 2},
+    };
+}
+
+json toArray(const std::vector<Message>& messages)
+{
+    json arr = json::array();
+    for (const auto& m : messages) arr.push_back(SerializedHistory::toJson(m));
+    return arr;
+}
+
+std::string bracket(std::string_view range)
+{
+    return "[" + std::string(range) + "]";
+}
+
+}  // namespace
+
+TEST(SerializedHistoryTest, MatchesJsonArrayAndKeepsPrefixStable)
+{
+    std::vector<Message> messages = conversation();
+    SerializedHistory history;
+    EXPECT_EQ(history.range(0), "");
+
+    std::vector<Message> partial(messages.begin(), messages.begin() + 2);
+    history.sync(partial);
+    ASSERT_EQ(history.size(), 2u);
+    std::string before(history.range(0));
+    EXPECT_EQ(bracket(before), toArray(partial).dump());
+
+    history.sync(messages);
+    ASSERT_EQ(history.size(), 4u);
+    EXPECT_EQ(bracket(history.range(0)), toArray(messages).dump());
+    EXPECT_EQ(history.range(0).substr(0, before.size()), before);  // 追加不改动已有字节
+
+    std::vector<Message> tail(messages.begin() + 1, messages.end());
+    EXPECT_EQ(bracket(history.range(1)), toArray(tail).dump());
+    EXPECT_EQ(history.range(4), "");
+}
+
+TEST(SerializedHistoryTest, TruncateAllowsRewritingFromIndex)
+{
+    std::vector<Message> messages = conversation();
+    SerializedHistory history;
+    history.sync(messages);
+
+    messages.insert(messages.begin(), {"system", "[系统提示：图片中是一只猫]", "", "", 0});
+    history.truncate(0);
+    history.sync(messages);
+    EXPECT_EQ(bracket(history.range(0)), toArray(messages).dump());
+
+    messages[2].content = "[]";
+    history.truncate(2);
+    EXPECT_EQ(history.size(), 2u);
+    history.sync(messages);
+    EXPECT_EQ(bracket(history.range(0)), toArray(messages).dump());
+
+    history.truncate(10);  // 越界无操作
+    EXPECT_EQ(history.size(), messages.size());
+}
+
+TEST(StreamEnvelopeTest, BodyMatchesBuildRequestDump)
+{
+    std::vector<Message> messages = conversation();
+    SerializedHistory history;
+    history.sync(messages);
+    std::string array = bracket(history.range(0));
+
+    AliyunStrategy aliyun;
+    for (const std::string model : {"", "qwen-max"})
+    {
+        json payload = aliyun.buildRequest(messages, json::array(), model);
+        payload["stream"] = true;
+        RequestEnvelope env = aliyun.streamEnvelope(model);
+        EXPECT_EQ(env.head + array + env.tail, payload.dump()) << "model=" << model;
+    }
+
+    AliyunRAGStrategy rag;
+    json payload = rag.buildRequest(messages, json::array(), "");
+    payload["stream"] = true;
+    RequestEnvelope env = rag.streamEnvelope("");
+    EXPECT_EQ(env.head + array + env.tail, payload.dump());
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "session/SessionManager.h"
+#include "session/SessionStorage.h"
+
+using http::HttpRequest;
+using http::HttpResponse;
+using http::session::MemorySessionStorage;
+using http::session::Session;
+using http::session::SessionManager;
+
+namespace
+{
+
+std::string serialize(const HttpResponse& resp)
+{
+    muduo::net::Buffer buf;
+    resp.appendToBuffer(&buf);
+    return buf.retrieveAllAsString();
+}
+
+std::shared_ptr<Session> makeSession(const std::string& id, int maxAge = 3600)
+{
+    return std::make_shared<Session>(id, nullptr, maxAge);
+}
+
+}  // namespace
+
+TEST(SessionManagerTest, AnonymousSessionPersistsOnFirstWrite)
+{
+    auto storage = std::make_unique<MemorySessionStorage>(100, 4, false);
+    MemorySessionStorage* raw = storage.get();
+    SessionManager manager(std::move(storage));
+
+    HttpRequest req;
+    HttpResponse readOnly;
+    readOnly.setStatusLine("HTTP/1.1", HttpResponse::k200Ok, "OK");
+    auto transient = manager.getSession(req, &readOnly);
+    EXPECT_EQ(transient->getValue("userId"), "");
+    EXPECT_FALSE(transient->isPersisted());
+    EXPECT_EQ(raw->size(), 0u);
+    EXPECT_EQ(serialize(readOnly).find("Set-Cookie"), std::string::npos);
+
+    HttpResponse login;
+    login.setStatusLine("HTTP/1.1", HttpResponse::k200Ok, "OK");
+    auto session = manager.getSession(req, &login);
+    session->setValue("userId", "42");
+    session->setValue("isLoggedIn", "true");
+    EXPECT_TRUE(session->isPersisted());
+    EXPECT_EQ(raw->size(), 1u);
+    std::string out = serialize(login);
+    ASSERT_NE(out.find("Set-Cookie: sessionId=" + session->getId()), std::string::npos);
+    EXPECT_EQ(out.find("Set-Cookie"), out.rfind("Set-Cookie"));  // 多次写入只下发一次
+
+    HttpRequest next;
+    next.addHeader("Cookie", "theme=dark; sessionId=" + session->getId());
+    HttpResponse resp;
+    auto loaded = manager.getSession(next, &resp);
+    EXPECT_EQ(loaded, session);
+    EXPECT_EQ(loaded->getValue("userId"), "42");
+}
+
+TEST(SessionManagerTest, GetSessionByIdMatchesCookieLookup)
+{
+    SessionManager manager(std::make_unique<MemorySessionStorage>(100, 4, false));
+    HttpResponse login;
+    login.setStatusLine("HTTP/1.1", HttpResponse::k200Ok, "OK");
+    auto session = manager.getSession(std::string(), &login);
+    session->setValue("userId", "7");
+
+    HttpRequest req;
+    req.addHeader("Cookie", "sessionId=" + session->getId() + "; theme=dark");
+    EXPECT_EQ(SessionManager::getSessionIdFromCookie(req), session->getId());
+
+    HttpResponse resp;
+    EXPECT_EQ(manager.getSession(session->getId(), &resp), session);
+    auto unknown = manager.getSession(std::string("no-such-session"), &resp);
+    EXPECT_NE(unknown, session);
+    EXPECT_FALSE(unknown->isPersisted());
+}
+
+TEST(MemorySessionStorageTest, EvictsLeastRecentlyUsedOverCap)
+{
+    MemorySessionStorage storage(3, 1, false);
+    storage.save(makeSession("a"));
+    storage.save(makeSession("b"));
+    storage.save(makeSession("c"));
+    ASSERT_NE(storage.load("a"), nullptr);  // a 变为最近访问
+    storage.save(makeSession("d"));
+
+    EXPECT_EQ(storage.size(), 3u);
+    EXPECT_EQ(storage.evictedCount(), 1u);
+    EXPECT_EQ(storage.load("b"), nullptr);
+    EXPECT_NE(storage.load("a"), nullptr);
+    EXPECT_NE(storage.load("d"), nullptr);
+}
+
+TEST(MemorySessionStorageTest, RemoveExpiredSweepsAllShards)
+{
+    MemorySessionStorage storage(0, 4, false);
+    for (int i = 0; i < 8; ++i)
+    {
+        storage.save(makeSession("short" + std::to_string(i), 0));
+        storage.save(makeSession("long" + std::to_string(i)));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(storage.removeExpired(), 8u);
+    EXPECT_EQ(storage.size(), 8u);
+    EXPECT_EQ(storage.load("short0"), nullptr);
+    EXPECT_NE(storage.load("long0"), nullptr);
+}
+
+TEST(MemorySessionStorageTest, BackgroundWheelReapsWithoutLookup)
+{
+    MemorySessionStorage storage(0, 2, true);
+    storage.save(makeSession("idle", 1));
+    auto active = makeSession("active", 1);
+    storage.save(active);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (storage.size() > 1)
+    {
+        // 只续期 active，idle 不再被访问，须由后台时间轮回收
+        active->refresh();
+        ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_NE(storage.load("active"), nullptr);
+}
+
+TEST(MemorySessionStorageTest, ConcurrentAccessStaysWithinCap)
+{
+    MemorySessionStorage storage(64, 8, false);
+    std::atomic<int> hits{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            [&, t]()
+            {
+                for (int i = 0; i < 2000; ++i)
+                {
+                    std::string id = "s" + std::to_string((t * 7919 + i) % 200);
+                    if (auto s = storage.load(id))
+                    {
+                        s->setValue("k", id);
+                        hits.fetch_add(1);
+                    }
+                    else
+                    {
+                        storage.save(makeSession(id));
+                    }
+                }
+            });
+    }
+    for (auto& th : threads)
+    {
+        th.join();
+    }
+    EXPECT_LE(storage.size(), 64u);
+    EXPECT_GT(hits.load(), 0);
+}
+
+TEST(SessionCodecTest, RoundTripsBinaryValues)
+{
+    Session session("abc", nullptr, 120);
+    session.setValue("userId", "42");
+    session.setValue("empty", "");
+    session.setValue(std::string(300, 'k'), std::string("a\0b", 3));
+
+    std::string bytes = session.serialize();
+    auto restored = Session::deserialize("abc", bytes);
+    ASSERT_NE(restored, nullptr);
+    EXPECT_EQ(restored->getId(), "abc");
+    EXPECT_EQ(restored->getMaxAge(), 120);
+    EXPECT_TRUE(restored->isPersisted());
+    EXPECT_EQ(restored->getValue("userId"), "42");
+    EXPECT_EQ(restored->getValue("empty"), "");
+    EXPECT_EQ(restored->getValue(std::string(300, 'k')), std::string("a\0b", 3));
+
+    EXPECT_EQ(Session::deserialize("abc", ""), nullptr);
+    EXPECT_EQ(Session::deserialize("abc", bytes.substr(0, bytes.size() - 1)), nullptr);
+    EXPECT_EQ(Session::deserialize("abc", bytes + "x"), nullptr);
+}
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "http/SseStream.h"
+
+using http::SseSink;
+using http::SseStream;
+using http::SseStreamRegistry;
+
+namespace
+{
+
+class FakeSink : public SseSink
+{
+public:
+    bool event(std::string_view id, std::string_view payload) override
+    {
+        if (!open) return false;
+        ids.emplace_back(id);
+        payloads.emplace_back(payload);
+        return true;
+    }
+    bool writable() const override
+    {
+        return open && !full;
+    }
+    bool connected() const override
+    {
+        return open;
+    }
+    void close() override
+    {
+        closed = true;
+        open = false;
+    }
+
+    std::vector<std::string> ids;
+    std::vector<std::string> payloads;
+    bool open = true;
+    bool full = false;
+    bool closed = false;
+};
+
+SseStream::Options smallOptions()
+{
+    SseStream::Options options;
+    options.maxFrames = 4;
+    options.maxBytes = 1024;
+    options.graceMs = 50;
+    return options;
+}
+
+}  // namespace
+
+TEST(SseStreamTest, EventIdRoundTrip)
+{
+    std::string id = SseStream::eventId("0190a1b2-0000-7000-8000-000000000001", 42);
+    EXPECT_EQ(id, "0190a1b2-0000-7000-8000-000000000001:42");
+
+    std::string key;
+    uint64_t seq = 0;
+    ASSERT_TRUE(SseStream::parseEventId(id, &key, &seq));
+    EXPECT_EQ(key, "0190a1b2-0000-7000-8000-000000000001");
+    EXPECT_EQ(seq, 42u);
+
+    EXPECT_FALSE(SseStream::parseEventId("", &key, &seq));
+    EXPECT_FALSE(SseStream::parseEventId("abc", &key, &seq));
+    EXPECT_FALSE(SseStream::parseEventId(":5", &key, &seq));
+    EXPECT_FALSE(SseStream::parseEventId("abc:", &key, &seq));
+    EXPECT_FALSE(SseStream::parseEventId("abc:5x", &key, &seq));
+}
+
+TEST(SseStreamTest, ForwardsLiveEventsWithSequentialIds)
+{
+    SseStream stream("k", 1, smallOptions());
+    auto sink = std::make_shared<FakeSink>();
+    ASSERT_TRUE(stream.attach(sink, 0));
+
+    EXPECT_EQ(stream.publish("a"), 1u);
+    EXPECT_EQ(stream.publish("b"), 2u);
+    EXPECT_EQ(sink->ids, std::vector<std::string>({"k:1", "k:2"}));
+    EXPECT_EQ(sink->payloads, std::vector<std::string>({"a", "b"}));
+
+    stream.finish();
+    EXPECT_TRUE(sink->closed);
+}
+
+TEST(SseStreamTest, ReplaysMissedFramesThenAttachesToLiveTail)
+{
+    SseStream stream("k", 1, smallOptions());
+    auto first = std::make_shared<FakeSink>();
+    stream.attach(first, 0);
+    stream.publish("a");
+    first->open = false;  // 客户端断开
+    stream.publish("b");
+    stream.publish("c");
+    EXPECT_FALSE(stream.abandoned());  // 宽限期内继续生成
+
+    auto second = std::make_shared<FakeSink>();
+    ASSERT_TRUE(stream.attach(second, 1));
+    stream.publish("d");
+    EXPECT_EQ(second->payloads, std::vector<std::string>({"b", "c", "d"}));
+    EXPECT_EQ(second->ids, std::vector<std::string>({"k:2", "k:3", "k:4"}));
+}
+
+TEST(SseStreamTest, RejectsResumeWhenFramesWereEvicted)
+{
+    SseStream stream("k", 1, smallOptions());
+    for (int i = 0; i < 6; ++i) stream.publish(std::to_string(i));  // 只保留 3..6
+
+    EXPECT_FALSE(stream.attach(std::make_shared<FakeSink>(), 1));
+    EXPECT_FALSE(stream.attach(std::make_shared<FakeSink>(), 7));  // 超前的序号
+    auto sink = std::make_shared<FakeSink>();
+    ASSERT_TRUE(stream.attach(sink, 2));
+    EXPECT_EQ(sink->payloads, std::vector<std::string>({"2", "3", "4", "5"}));
+}
+
+TEST(SseStreamTest, EvictsByBytes)
+{
+    SseStream::Options options = smallOptions();
+    options.maxBytes = 10;
+    SseStream stream("k", 1, options);
+    stream.publish(std::string(6, 'x'));
+    stream.publish(std::string(6, 'y'));  // 超出字节上限，淘汰第一帧
+
+    EXPECT_FALSE(stream.attach(std::make_shared<FakeSink>(), 0));
+    auto sink = std::make_shared<FakeSink>();
+    ASSERT_TRUE(stream.attach(sink, 1));
+    EXPECT_EQ(sink->payloads, std::vector<std::string>({std::string(6, 'y')}));
+}
+
+TEST(SseStreamTest, FinishedStreamReplaysTailAndCloses)
+{
+    SseStream stream("k", 1, smallOptions());
+    stream.publish("a");
+    stream.publish("[DONE]");
+    stream.finish();
+
+    auto sink = std::make_shared<FakeSink>();
+    ASSERT_TRUE(stream.attach(sink, 1));
+    EXPECT_EQ(sink->payloads, std::vector<std::string>({"[DONE]"}));
+    EXPECT_TRUE(sink->closed);
+    EXPECT_FALSE(stream.abandoned());
+}
+
+TEST(SseStreamTest, AbandonedAfterGracePeriodWithoutSink)
+{
+    SseStream stream("k", 1, smallOptions());
+    auto sink = std::make_shared<FakeSink>();
+    stream.attach(sink, 0);
+    sink->open = false;
+    EXPECT_TRUE(stream.writable());  // 无连接时帧只进重放环
+    EXPECT_FALSE(stream.abandoned());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    EXPECT_TRUE(stream.abandoned());
+    EXPECT_FALSE(stream.attach(std::make_shared<FakeSink>(), 0));
+}
+
+TEST(SseStreamTest, WritableFollowsSink)
+{
+    SseStream stream("k", 1, smallOptions());
+    auto sink = std::make_shared<FakeSink>();
+    stream.attach(sink, 0);
+    EXPECT_TRUE(stream.writable());
+    sink->full = true;
+    EXPECT_FALSE(stream.writable());
+}
+
+TEST(SseStreamRegistryTest, FindChecksOwnerAndSweepsExpired)
+{
+    SseStreamRegistry::Options options;
+    options.stream = smallOptions();
+    options.sweepIntervalMs = 0;
+    SseStreamRegistry registry(options);
+
+    auto stream = registry.create("a", 7);
+    stream->attach(std::make_shared<FakeSink>(), 0);
+    EXPECT_EQ(registry.find("a", 7), stream);
+    EXPECT_EQ(registry.find("a", 8), nullptr);
+    EXPECT_EQ(registry.find("b", 7), nullptr);
+
+    stream->finish();
+    EXPECT_EQ(registry.find("a", 7), stream);  // 完成后仍保留宽限期
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    EXPECT_EQ(registry.find("a", 7), nullptr);
+
+    registry.create("b", 7);  // 新建时顺带清理
+    EXPECT_EQ(registry.size(), 1u);
+}
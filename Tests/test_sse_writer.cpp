@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThread.h>
+#include <muduo/net/InetAddress.h>
+#include <muduo/net/TcpConnection.h>
+#include <string>
+#include <thread>
+
+#include "http/SseWriter.h"
+
+using http::ResponseWriter;
+using http::SseWriter;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+// 在回环地址上建立一对已连接的 TCP socket；rcvBuf > 0 时在建连前缩小客户端接收缓冲
+bool connectedPair(int* serverFd, int* clientFd, int rcvBuf)
+{
+    int listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof addr;
+    if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+        ::listen(listenFd, 1) != 0 || ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &len) != 0)
+    {
+        ::close(listenFd);
+        return false;
+    }
+    *clientFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (rcvBuf > 0)
+    {
+        ::setsockopt(*clientFd, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof rcvBuf);
+    }
+    bool ok = ::connect(*clientFd, reinterpret_cast<sockaddr*>(&addr), len) == 0;
+    *serverFd = ok ? ::accept(listenFd, nullptr, nullptr) : -1;
+    ::close(listenFd);
+    return ok && *serverFd >= 0;
+}
+
+// 在连接上开启 SseWriter 的测试夹具：服务端是真实的 muduo TcpConnection，客户端直接读 socket
+class SseWriterTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        loop_ = loopThread_.startLoop();
+    }
+
+    void TearDown() override
+    {
+        if (sse_)
+        {
+            sse_->close();
+            sse_.reset();
+        }
+        if (conn_)
+        {
+            runInLoopAndWait([this]() { conn_->connectDestroyed(); });
+            conn_.reset();
+        }
+        if (clientFd_ >= 0)
+        {
+            ::close(clientFd_);
+        }
+    }
+
+    void runInLoopAndWait(const std::function<void()>& fn)
+    {
+        std::promise<void> done;
+        loop_->runInLoop(
+            [&]()
+            {
+                fn();
+                done.set_value();
+            });
+        done.get_future().wait();
+    }
+
+    void open(const SseWriter::Options& options, int rcvBuf = 0, int sndBuf = 0)
+    {
+        int serverFd = -1;
+        ASSERT_TRUE(connectedPair(&serverFd, &clientFd_, rcvBuf));
+        if (sndBuf > 0)
+        {
+            ::setsockopt(serverFd, SOL_SOCKET, SO_SNDBUF, &sndBuf, sizeof sndBuf);
+        }
+
+        sockaddr_in local{};
+        sockaddr_in peer{};
+        socklen_t len = sizeof local;
+        ::getsockname(serverFd, reinterpret_cast<sockaddr*>(&local), &len);
+        len = sizeof peer;
+        ::getpeername(serverFd, reinterpret_cast<sockaddr*>(&peer), &len);
+
+        conn_ = std::make_shared<muduo::net::TcpConnection>(loop_, "sse-test", serverFd,
+                                                            muduo::net::InetAddress(local),
+                                                            muduo::net::InetAddress(peer));
+        conn_->setConnectionCallback([](const muduo::net::TcpConnectionPtr&) {});
+        conn_->setMessageCallback([](const muduo::net::TcpConnectionPtr&, muduo::net::Buffer* buf, muduo::Timestamp)
+                                  { buf->retrieveAll(); });
+        conn_->setCloseCallback([](const muduo::net::TcpConnectionPtr&) {});
+        runInLoopAndWait(
+            [this, &options]()
+            {
+                conn_->connectEstablished();
+                sse_ = SseWriter::open(ResponseWriter(conn_, nullptr), options);
+            });
+        runInLoopAndWait([]() {});  // 等待 start() 安装回调与心跳
+    }
+
+    // 读取 timeoutMs 内到达的全部数据
+    std::string readFor(int timeoutMs)
+    {
+        std::string out;
+        auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (readSome(&out, deadline))
+        {
+        }
+        return out;
+    }
+
+    // 读取直到收到的数据以 suffix 结尾或超时
+    std::string readUntil(const std::string& suffix, int timeoutMs)
+    {
+        std::string out;
+        auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+        while ((out.size() < suffix.size() || out.compare(out.size() - suffix.size(), suffix.size(), suffix) != 0) &&
+               readSome(&out, deadline))
+        {
+        }
+        return out;
+    }
+
+    bool readSome(std::string* out, Clock::time_point deadline)
+    {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+        if (remaining <= 0)
+        {
+            return false;
+        }
+        pollfd pfd{clientFd_, POLLIN, 0};
+        if (::poll(&pfd, 1, static_cast<int>(remaining)) <= 0)
+        {
+            return false;
+        }
+        char buf[16384];
+        ssize_t n = ::recv(clientFd_, buf, sizeof buf, 0);
+        if (n <= 0)
+        {
+            return false;
+        }
+        out->append(buf, static_cast<size_t>(n));
+        return true;
+    }
+
+    template <typename Pred>
+    static bool waitUntil(Pred pred, int timeoutMs)
+    {
+        auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (!pred())
+        {
+            if (Clock::now() >= deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    muduo::net::EventLoopThread loopThread_;
+    muduo::net::EventLoop* loop_ = nullptr;
+    muduo::net::TcpConnectionPtr conn_;
+    std::shared_ptr<SseWriter> sse_;
+    int clientFd_ = -1;
+};
+
+SseWriter::Options quietOptions()
+{
+    SseWriter::Options options;
+    options.heartbeatSec = 0;
+    options.stallTimeoutSec = 0;
+    return options;
+}
+
+}  // namespace
+
+TEST(SseWriterOptionsTest, DefaultCoalescingThresholds)
+{
+    SseWriter::Options options;
+    EXPECT_EQ(options.flushBytes, 4096u);
+    EXPECT_EQ(options.flushIntervalMs, 10);
+}
+
+TEST_F(SseWriterTest, SmallEventsCoalesceUntilFlushInterval)
+{
+    SseWriter::Options options = quietOptions();
+    options.flushIntervalMs = 300;
+    open(options);
+
+    EXPECT_TRUE(sse_->data("a"));
+    EXPECT_TRUE(sse_->data("b"));
+    EXPECT_TRUE(sse_->event("k:3", "c"));
+    EXPECT_EQ(readFor(100), "");  // 未满 flushBytes，等待合并
+
+    EXPECT_EQ(readUntil("data: c\n\n", 2000), "data: a\n\ndata: b\n\nid: k:3\ndata: c\n\n");
+}
+
+TEST_F(SseWriterTest, ReachingFlushBytesWritesWithoutWaiting)
+{
+    SseWriter::Options options = quietOptions();
+    options.flushIntervalMs = 10000;
+    open(options);
+
+    std::string small(100, 'x');
+    std::string large(options.flushBytes, 'y');
+    sse_->data(small);
+    EXPECT_EQ(readFor(100), "");
+
+    auto start = Clock::now();
+    sse_->data(large);
+    std::string expected = "data: " + small + "\n\ndata: " + large + "\n\n";
+    EXPECT_EQ(readUntil(expected, 2000), expected);
+    EXPECT_LT(Clock::now() - start, std::chrono::milliseconds(options.flushIntervalMs));
+}
+
+TEST_F(SseWriterTest, PausesAboveHighWaterMarkAndResumesOnWriteComplete)
+{
+    SseWriter::Options options = quietOptions();
+    options.highWaterMark = 64 * 1024;
+    open(options, 4096, 4096);  // 缩小两端 socket 缓冲，让数据堆积在连接的输出缓冲中
+
+    // 客户端不读：内核缓冲写满后数据留在 muduo 输出缓冲，越过高水位即暂停
+    std::string chunk(8192, 'z');
+    size_t sent = 0;
+    EXPECT_TRUE(waitUntil(
+        [&]()
+        {
+            if (sse_->writable() && sent < 64u * 1024 * 1024)
+            {
+                sse_->data(chunk);
+                sent += chunk.size();
+            }
+            return !sse_->writable();
+        },
+        5000));
+    EXPECT_FALSE(sse_->writable());
+    EXPECT_TRUE(sse_->connected());
+
+    // 客户端读空后输出缓冲写完，WriteCompleteCallback 恢复上游
+    std::string drained;
+    auto deadline = Clock::now() + std::chrono::seconds(10);
+    while (!sse_->writable() && Clock::now() < deadline)
+    {
+        readSome(&drained, Clock::now() + std::chrono::milliseconds(10));
+    }
+    EXPECT_TRUE(sse_->writable());
+    EXPECT_FALSE(drained.empty());
+
+    EXPECT_TRUE(sse_->data("after"));
+    std::string rest = readUntil("data: after\n\n", 10000);
+    EXPECT_NE(rest.find("data: after\n\n"), std::string::npos);
+}
+
+TEST_F(SseWriterTest, HeartbeatSkippedWhileDataFlows)
+{
+    SseWriter::Options options;
+    options.heartbeatSec = 0.3;
+    options.stallTimeoutSec = 0;
+    open(options);
+
+    // 持续输出期间 heartbeatSec 内总有数据写出，不插入心跳
+    std::string received;
+    auto until = Clock::now() + std::chrono::milliseconds(1200);
+    while (Clock::now() < until)
+    {
+        sse_->data("tick");
+        readSome(&received, Clock::now() + std::chrono::milliseconds(20));
+    }
+    received += readFor(50);
+    EXPECT_NE(received.find("data: tick\n\n"), std::string::npos);
+    EXPECT_EQ(received.find(": ping"), std::string::npos);
+
+    // 停止输出后空闲超过 heartbeatSec，发送注释帧
+    EXPECT_NE(readUntil(": ping\n\n", 2000).find(": ping\n\n"), std::string::npos);
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include "http/FileBody.h"
+#include "http/StaticFileCache.h"
+
+using http::ByteRangeResult;
+using http::StaticFileCache;
+
+namespace
+{
+
+std::string writeTempFile(const std::string& content)
+{
+    char name[] = "/tmp/static_cache_XXXXXX";
+    int fd = ::mkstemp(name);
+    ::close(fd);
+    std::ofstream(name, std::ios::binary) << content;
+    return name;
+}
+
+}  // namespace
+
+TEST(StaticFileCacheTest, HitReturnsSameEntryWithPrebuiltHeaders)
+{
+    std::string path = writeTempFile(std::string(4096, 'a'));
+    StaticFileCache cache;
+    StaticFileCache::EntryPtr first = cache.lookup(path, "text/css");
+    ASSERT_TRUE(first);
+    EXPECT_EQ(cache.lookup(path, "text/css"), first);
+
+    const auto& identity = first->variants[StaticFileCache::kIdentity];
+    ASSERT_TRUE(identity.body);
+    EXPECT_EQ(identity.body->size(), 4096u);
+    EXPECT_NE(identity.headers->find("Content-Length: 4096\r\n"), std::string::npos);
+    EXPECT_NE(identity.headers->find("ETag: " + first->etag + "\r\n"), std::string::npos);
+    EXPECT_EQ(identity.notModified->find("Content-Length"), std::string::npos);
+    EXPECT_GT(cache.bytes(), 0u);
+    std::remove(path.c_str());
+}
+
+TEST(StaticFileCacheTest, ConditionalRequests)
+{
+    std::string path = writeTempFile("body{}");
+    StaticFileCache cache;
+    StaticFileCache::EntryPtr entry = cache.lookup(path, "text/css");
+    ASSERT_TRUE(entry);
+
+    EXPECT_TRUE(StaticFileCache::notModified(*entry, entry->etag, ""));
+    EXPECT_TRUE(StaticFileCache::notModified(*entry, "\"x\", " + entry->etag, ""));
+    EXPECT_TRUE(StaticFileCache::notModified(*entry, "*", ""));
+    EXPECT_FALSE(StaticFileCache::notModified(*entry, "\"other\"", entry->lastModified));
+    EXPECT_TRUE(StaticFileCache::notModified(*entry, "", entry->lastModified));
+    EXPECT_FALSE(StaticFileCache::notModified(*entry, "", "Thu, 01 Jan 1970 00:00:00 GMT"));
+    EXPECT_FALSE(StaticFileCache::notModified(*entry, "", ""));
+    std::remove(path.c_str());
+}
+
+TEST(StaticFileCacheTest, NegotiateFallsBackToIdentity)
+{
+    std::string path = writeTempFile(std::string(8192, 'x'));
+    StaticFileCache cache;
+    StaticFileCache::EntryPtr entry = cache.lookup(path, "application/javascript");
+    ASSERT_TRUE(entry);
+
+    EXPECT_EQ(StaticFileCache::negotiate(*entry, ""), StaticFileCache::kIdentity);
+    EXPECT_EQ(StaticFileCache::negotiate(*entry, "identity"), StaticFileCache::kIdentity);
+    StaticFileCache::Encoding enc = StaticFileCache::negotiate(*entry, "gzip, deflate, br");
+    EXPECT_TRUE(entry->variants[enc].body);
+    if (entry->variants[StaticFileCache::kGzip].body)
+    {
+        EXPECT_EQ(StaticFileCache::negotiate(*entry, "gzip, br;q=0"), StaticFileCache::kGzip);
+        EXPECT_NE(entry->variants[StaticFileCache::kGzip].etag, entry->etag);
+        EXPECT_EQ(StaticFileCache::negotiate(*entry, "gzip;q=0.5"), StaticFileCache::kIdentity);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(StaticFileCacheTest, BinaryTypesAreNotCompressed)
+{
+    std::string path = writeTempFile(std::string(8192, 'x'));
+    StaticFileCache cache;
+    StaticFileCache::EntryPtr entry = cache.lookup(path, "image/png");
+    ASSERT_TRUE(entry);
+    EXPECT_FALSE(entry->variants[StaticFileCache::kGzip].body);
+    EXPECT_FALSE(entry->variants[StaticFileCache::kBrotli].body);
+    EXPECT_EQ(StaticFileCache::negotiate(*entry, "gzip, br"), StaticFileCache::kIdentity);
+    std::remove(path.c_str());
+}
+
+TEST(StaticFileCacheTest, OversizedAndMissingFilesAreNotCached)
+{
+    StaticFileCache::Options options;
+    options.maxFileBytes = 16;
+    StaticFileCache cache(options);
+    std::string path = writeTempFile(std::string(64, 'z'));
+    EXPECT_FALSE(cache.lookup(path, "text/plain"));
+    EXPECT_FALSE(cache.lookup("/nonexistent/static/file.css", "text/css"));
+    std::remove(path.c_str());
+}
+
+TEST(ByteRangeTest, SingleRanges)
+{
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    EXPECT_EQ(http::parseByteRange("bytes=0-99", 1000, &offset, &length), ByteRangeResult::kSatisfiable);
+    EXPECT_EQ(offset, 0u);
+    EXPECT_EQ(length, 100u);
+    EXPECT_EQ(http::parseByteRange("bytes=900-", 1000, &offset, &length), ByteRangeResult::kSatisfiable);
+    EXPECT_EQ(offset, 900u);
+    EXPECT_EQ(length, 100u);
+    EXPECT_EQ(http::parseByteRange("bytes=-10", 1000, &offset, &length), ByteRangeResult::kSatisfiable);
+    EXPECT_EQ(offset, 990u);
+    EXPECT_EQ(length, 10u);
+    // 末端超出文件时截断，后缀超出文件时取整个文件
+    EXPECT_EQ(http::parseByteRange("bytes=500-5000", 1000, &offset, &length), ByteRangeResult::kSatisfiable);
+    EXPECT_EQ(length, 500u);
+    EXPECT_EQ(http::parseByteRange("bytes=-5000", 1000, &offset, &length), ByteRangeResult::kSatisfiable);
+    EXPECT_EQ(offset, 0u);
+    EXPECT_EQ(length, 1000u);
+}
+
+TEST(ByteRangeTest, UnsupportedAndUnsatisfiable)
+{
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    EXPECT_EQ(http::parseByteRange("", 1000, &offset, &length), ByteRangeResult::kNone);
+    EXPECT_EQ(http::parseByteRange("items=0-1", 1000, &offset, &length), ByteRangeResult::kNone);
+    EXPECT_EQ(http::parseByteRange("bytes=0-1,5-6", 1000, &offset, &length), ByteRangeResult::kNone);
+    EXPECT_EQ(http::parseByteRange("bytes=9-3", 1000, &offset, &length), ByteRangeResult::kNone);
+    EXPECT_EQ(http::parseByteRange("bytes=a-3", 1000, &offset, &length), ByteRangeResult::kNone);
+    EXPECT_EQ(http::parseByteRange("bytes=1000-", 1000, &offset, &length), ByteRangeResult::kUnsatisfiable);
+    EXPECT_EQ(http::parseByteRange("bytes=-0", 1000, &offset, &length), ByteRangeResult::kUnsatisfiable);
+}
+
+TEST(FileBodyTest, OpenRegularFileOnly)
+{
+    std::string path = writeTempFile("0123456789");
+    std::shared_ptr<http::FileBody> body = http::FileBody::open(path);
+    ASSERT_TRUE(body);
+    EXPECT_EQ(body->fileSize(), 10u);
+    EXPECT_EQ(body->offset(), 0u);
+    EXPECT_EQ(body->length(), 10u);
+    EXPECT_FALSE(http::FileBody::open("/tmp"));
+    EXPECT_FALSE(http::FileBody::open("/nonexistent/file.bin"));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "llm/StreamDeltaParser.h"
+
+namespace
+{
+
+// OpenAI 兼容格式：文本增量后接一个分三段到达的工具调用
+const char* kStream =
+    "data: {\"id\":\"chatcmpl-1\",\"object\":\"chat.completion.chunk\",\"created\":1700000000,\"model\":\"qwen-plus\","
+    "\"choices\":[{\"index\":0,\"delta\":{\"role\":\"assistant\",\"content\":\"\"},\"finish_reason\":null}]}\r\n\r\n"
+    "data: {\"choices\":[{\"index\":0,\"delta\":{\"content\":\"\\u4f60\\u597d\"},\"finish_reason\":null}],"
+    "\"usage\":null}\n\n"
+    "data: {\"choices\":[{\"index\":0,\"delta\":{\"content\":\"，\\\"世界\\\"\\n\"},\"logprobs\":{\"x\":[1,{\"y\":\"}]\"}]}}]}\n\n"
+    "data: {\"choices\":[{\"delta\":{\"content\":null,\"tool_calls\":[{\"index\":0,\"id\":\"call_1\",\"type\":\"function\","
+    "\"function\":{\"name\":\"get_weather\",\"arguments\":\"\"}}]}}]}\n\n"
+    "data: {\"choices\":[{\"delta\":{\"tool_calls\":[{\"index\":0,\"id\":\"\",\"function\":{\"arguments\":\"{\\\"city\\\":\"}}]}}]}\n\n"
+    "data: {\"choices\":[{\"delta\":{\"tool_calls\":[{\"index\":0,\"function\":{\"arguments\":\"\\\"北京\\\"}\"}}]}}]}\n\n"
+    "data: {\"choices\":[{\"delta\":{},\"finish_reason\":\"tool_calls\"}],\"usage\":{\"total_tokens\":42}}\n\n"
+    "data: [DONE]\n\n";
+
+struct Collected
+{
+    std::vector<std::string> tokens;
+    StreamResult result;
+};
+
+Collected feedInPieces(const std::string& stream, size_t piece)
+{
+    Collected out;
+    StreamDeltaParser parser(
+        [&](const std::string& token)
+        {
+            out.tokens.push_back(token);
+            return true;
+        });
+    for (size_t i = 0; i < stream.size(); i += piece)
+    {
+        EXPECT_TRUE(parser.feed(std::string_view(stream).substr(i, piece)));
+    }
+    out.result = parser.finish();
+    return out;
+}
+
+}  // namespace
+
+TEST(SseLineBufferTest, SplitsLinesAcrossAppends)
+{
+    SseLineBuffer buf;
+    std::string_view line;
+    buf.append("data: a\r\nda");
+    ASSERT_TRUE(buf.nextLine(&line));
+    EXPECT_EQ(line, "data: a");
+    EXPECT_FALSE(buf.nextLine(&line));
+    EXPECT_EQ(buf.pending(), 2u);
+
+    buf.append("ta: b\n\n");
+    ASSERT_TRUE(buf.nextLine(&line));
+    EXPECT_EQ(line, "data: b");
+    ASSERT_TRUE(buf.nextLine(&line));
+    EXPECT_EQ(line, "");
+    EXPECT_FALSE(buf.nextLine(&line));
+    EXPECT_EQ(buf.pending(), 0u);
+}
+
+TEST(ChatDeltaTest, ExtractsContentAndUnescapes)
+{
+    ChatDelta delta;
+    ASSERT_TRUE(parseChatDelta(
+        "{\"id\":\"x\",\"choices\":[{\"index\":0,\"delta\":{\"content\":\"a\\\"b\\\\c\\/\\t\\u00e9\\ud83d\\ude00\"}}]}",
+        &delta));
+    EXPECT_TRUE(delta.hasContent);
+    EXPECT_EQ(delta.content, "a\"b\\c/\t\xC3\xA9\xF0\x9F\x98\x80");
+    EXPECT_EQ(delta.toolCallCount, 0u);
+
+    ASSERT_TRUE(parseChatDelta("{\"choices\":[{\"delta\":{\"content\":null}}]}", &delta));
+    EXPECT_FALSE(delta.hasContent);
+    ASSERT_TRUE(parseChatDelta("{\"choices\":[]}", &delta));
+    EXPECT_FALSE(delta.hasContent);
+    // 只取 choices[0]
+    ASSERT_TRUE(parseChatDelta(
+        "{\"choices\":[{\"delta\":{\"content\":\"first\"}},{\"delta\":{\"content\":\"second\"}}]}", &delta));
+    EXPECT_EQ(delta.content, "first");
+}
+
+TEST(ChatDeltaTest, ExtractsToolCallFragments)
+{
+    ChatDelta delta;
+    ASSERT_TRUE(parseChatDelta("{\"choices\":[{\"delta\":{\"tool_calls\":[{\"index\":1,\"id\":\"c\",\"type\":"
+                               "\"function\",\"function\":{\"name\":\"f\",\"arguments\":\"{\\\"a\\\":1\"}},"
+                               "{\"index\":2,\"function\":{\"arguments\":null}}]}}]}",
+                               &delta));
+    ASSERT_EQ(delta.toolCallCount, 2u);
+    const auto& first = delta.toolCalls[0];
+    EXPECT_EQ(first.index, 1);
+    EXPECT_EQ(first.id, "c");
+    EXPECT_EQ(first.type, "function");
+    EXPECT_EQ(first.name, "f");
+    EXPECT_EQ(first.arguments, "{\"a\":1");
+    const auto& second = delta.toolCalls[1];
+    EXPECT_EQ(second.index, 2);
+    EXPECT_TRUE(second.hasFunction);
+    EXPECT_FALSE(second.hasArguments);
+    EXPECT_FALSE(second.hasId);
+}
+
+TEST(ChatDeltaTest, RejectsMalformedJson)
+{
+    ChatDelta delta;
+    EXPECT_FALSE(parseChatDelta("", &delta));
+    EXPECT_FALSE(parseChatDelta("{\"choices\":[{\"delta\":{\"content\":\"abc}}]}", &delta));
+    EXPECT_FALSE(parseChatDelta("{\"choices\":[{\"delta\":{\"content\":12}}]}", &delta));
+    EXPECT_FALSE(parseChatDelta("{\"choices\":[{\"delta\":{\"content\":\"\\x\"}}]}", &delta));
+    EXPECT_FALSE(parseChatDelta("{\"choices\":[]} trailing", &delta));
+}
+
+TEST(StreamDeltaParserTest, ResultIndependentOfNetworkChunking)
+{
+    std::string stream = kStream;
+    Collected whole = feedInPieces(stream, stream.size());
+    const StreamResult& r = whole.result;
+    EXPECT_EQ(r.content, "你好，\"世界\"\n");
+    EXPECT_EQ(whole.tokens, std::vector<std::string>({"你好", "，\"世界\"\n"}));
+    ASSERT_EQ(r.toolCalls.size(), 1u);
+    EXPECT_EQ(r.toolCalls[0].index, 0);
+    EXPECT_EQ(r.toolCalls[0].id, "call_1");  // 后续片段的空 id 不覆盖
+    EXPECT_EQ(r.toolCalls[0].type, "function");
+    EXPECT_EQ(r.toolCalls[0].name, "get_weather");
+    EXPECT_EQ(r.toolCalls[0].arguments, "{\"city\":\"北京\"}");
+    EXPECT_EQ(r.finishReason, "tool_calls");
+    EXPECT_EQ(r.usage, json({{"total_tokens", 42}}));
+
+    for (size_t piece : {1, 2, 3, 7, 64})
+    {
+        Collected split = feedInPieces(stream, piece);
+        EXPECT_EQ(split.tokens, whole.tokens) << "piece=" << piece;
+        EXPECT_EQ(split.result.content, r.content) << "piece=" << piece;
+        ASSERT_EQ(split.result.toolCalls.size(), 1u) << "piece=" << piece;
+        EXPECT_EQ(split.result.toolCalls[0].arguments, r.toolCalls[0].arguments) << "piece=" << piece;
+        EXPECT_EQ(split.result.finishReason, r.finishReason) << "piece=" << piece;
+        EXPECT_EQ(split.result.usage, r.usage) << "piece=" << piece;
+    }
+}
+
+TEST(StreamDeltaParserTest, SkipsNonDataLinesAndBadChunks)
+{
+    std::vector<std::string> tokens;
+    StreamDeltaParser parser(
+        [&](const std::string& token)
+        {
+            tokens.push_back(token);
+            return true;
+        });
+    EXPECT_TRUE(parser.feed(": keep-alive\n"
+                            "event: message\n"
+                            "{\"error\":{\"message\":\"invalid api key\"}}\n"
+                            "data: {not json}\n"
+                            "data:{\"choices\":[{\"delta\":{\"content\":\"ok\"}}]}\n"));
+    EXPECT_EQ(tokens, std::vector<std::string>({"ok"}));
+    StreamResult result = parser.finish();
+    EXPECT_EQ(result.content, "ok");
+    EXPECT_TRUE(result.toolCalls.empty());
+    EXPECT_TRUE(result.usage.is_null());
+}
+
+TEST(StreamDeltaParserTest, StopsWhenCallbackDeclines)
+{
+    int calls = 0;
+    StreamDeltaParser parser([&](const std::string&) { return ++calls < 2; });
+    EXPECT_FALSE(parser.feed("data: {\"choices\":[{\"delta\":{\"content\":\"a\"}}]}\n"
+                             "data: {\"choices\":[{\"delta\":{\"content\":\"b\"}}]}\n"
+                             "data: {\"choices\":[{\"delta\":{\"content\":\"c\"}}]}\n"));
+    EXPECT_EQ(calls, 2);
+}
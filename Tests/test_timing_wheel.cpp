@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "http/TimingWheel.h"
+
+using http::TimingWheel;
+
+TEST(TimingWheelTest, FiresAfterDelayIncludingFullRounds)
+{
+    std::vector<int> fired;
+    TimingWheel<int> wheel(4, [&fired](const std::shared_ptr<int>& v, uint64_t) {
+        fired.push_back(*v);
+        return 0;
+    });
+    auto a = std::make_shared<int>(1);
+    auto b = std::make_shared<int>(2);
+    wheel.schedule(a, 0, 2);
+    wheel.schedule(b, 0, 9);  // 超过一圈
+
+    for (int t = 1; t <= 9; ++t)
+    {
+        wheel.tick();
+        if (t == 2)
+        {
+            EXPECT_EQ(fired, std::vector<int>({1}));
+        }
+        if (t == 8)
+        {
+            EXPECT_EQ(fired.size(), 1u);
+        }
+    }
+    EXPECT_EQ(fired, std::vector<int>({1, 2}));
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimingWheelTest, DropsReleasedTargetsAndReschedules)
+{
+    int calls = 0;
+    TimingWheel<int> wheel(8, [&calls](const std::shared_ptr<int>&, uint64_t token) {
+        ++calls;
+        return token == 7 && calls == 1 ? 3 : 0;  // 第一次到期时要求顺延 3 个 tick
+    });
+    auto gone = std::make_shared<int>(0);
+    auto kept = std::make_shared<int>(0);
+    wheel.schedule(gone, 1, 1);
+    wheel.schedule(kept, 7, 1);
+    gone.reset();
+
+    wheel.tick();
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(wheel.size(), 1u);
+    wheel.tick();
+    wheel.tick();
+    EXPECT_EQ(calls, 1);
+    wheel.tick();
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(wheel.size(), 0u);
+}
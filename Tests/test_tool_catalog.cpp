@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mcp/ToolCatalog.h"
+
+namespace
+{
+
+json weatherTool()
+{
+    return {{"name", "get_weather"},
+            {"description", "查询天气"},
+            {"inputSchema", {{"type", "object"}, {"properties", {{"city", {{"type", "string"}}}}}}}};
+}
+
+// 可控的工具源：统计 tools/list 次数
+struct FakeSource
+{
+    std::atomic<int> loads{0};
+    json tools = json::array({weatherTool()});
+    bool fail = false;
+    bool partial = false;  // 部分 server 失败
+
+    ToolCatalog::Loader loader()
+    {
+        return [this](bool* complete)
+        {
+            ++loads;
+            if (fail) throw std::runtime_error("server down");
+            *complete = !partial;
+            return tools;
+        };
+    }
+};
+
+}  // namespace
+
+TEST(ToolCatalogTest, ConvertsMcpToolsToOpenAiFormat)
+{
+    json mcp = json::array({weatherTool(), {{"name", "ping"}}, "not an object"});
+    json tools = ToolCatalog::toOpenAiTools(mcp);
+    ASSERT_EQ(tools.size(), 2u);
+    EXPECT_EQ(tools[0]["type"], "function");
+    EXPECT_EQ(tools[0]["function"]["name"], "get_weather");
+    EXPECT_EQ(tools[0]["function"]["description"], "查询天气");
+    EXPECT_EQ(tools[0]["function"]["parameters"], weatherTool()["inputSchema"]);
+    EXPECT_EQ(tools[1]["function"]["description"], "");
+    EXPECT_EQ(tools[1]["function"]["parameters"], json::object());
+    EXPECT_TRUE(ToolCatalog::toOpenAiTools(json::object()).empty());
+}
+
+TEST(ToolCatalogTest, CachesUntilInvalidated)
+{
+    FakeSource source;
+    ToolCatalog catalog(source.loader());
+
+    auto first = catalog.snapshot();
+    ASSERT_TRUE(first);
+    EXPECT_EQ(first->version, 1u);
+    EXPECT_EQ(first->tools.size(), 1u);
+    EXPECT_EQ(first->toolsJson, first->tools.dump());
+    for (int i = 0; i < 10; ++i) EXPECT_EQ(catalog.snapshot(), first);
+    EXPECT_EQ(source.loads, 1);
+
+    // 失效但内容未变：重新拉取，沿用同一快照与版本号
+    catalog.invalidate();
+    EXPECT_EQ(catalog.snapshot(), first);
+    EXPECT_EQ(source.loads, 2);
+
+    // 内容变化：版本递增，旧快照对持有者保持不变
+    source.tools.push_back({{"name", "ping"}});
+    catalog.invalidate();
+    auto second = catalog.snapshot();
+    EXPECT_EQ(second->version, 2u);
+    EXPECT_EQ(second->tools.size(), 2u);
+    EXPECT_EQ(first->tools.size(), 1u);
+    EXPECT_EQ(source.loads, 3);
+}
+
+TEST(ToolCatalogTest, ExpiresAfterMaxAge)
+{
+    FakeSource source;
+    ToolCatalog catalog(source.loader(), std::chrono::milliseconds(20));
+    catalog.snapshot();
+    catalog.snapshot();
+    EXPECT_EQ(source.loads, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    catalog.snapshot();
+    EXPECT_EQ(source.loads, 2);
+
+    catalog.setMaxAge(std::chrono::milliseconds(0));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    catalog.snapshot();
+    EXPECT_EQ(source.loads, 2);
+}
+
+TEST(ToolCatalogTest, KeepsPreviousToolsWhenLoadFails)
+{
+    FakeSource source;
+    source.fail = true;
+    ToolCatalog catalog(source.loader());
+    auto empty = catalog.snapshot();
+    ASSERT_TRUE(empty);
+    EXPECT_TRUE(empty->empty());
+    EXPECT_EQ(empty->toolsJson, "[]");
+
+    source.fail = false;
+    catalog.invalidate();
+    auto loaded = catalog.snapshot();
+    EXPECT_EQ(loaded->tools.size(), 1u);
+
+    source.fail = true;
+    catalog.invalidate();
+    EXPECT_EQ(catalog.snapshot(), loaded);
+    EXPECT_EQ(catalog.snapshot(), loaded);  // 失败后不在每次调用时重试
+    EXPECT_EQ(source.loads, 3);
+}
+
+TEST(ToolCatalogTest, RetriesIncompleteResultsSooner)
+{
+    FakeSource source;
+    source.partial = true;
+    ToolCatalog catalog(source.loader(), std::chrono::minutes(5));
+    catalog.setRetryInterval(std::chrono::milliseconds(20));
+
+    // 部分 server 失败：结果照常发布，但只保留 retryInterval
+    auto partial = catalog.snapshot();
+    EXPECT_EQ(partial->tools.size(), 1u);
+    EXPECT_EQ(catalog.snapshot(), partial);
+    EXPECT_EQ(source.loads, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    source.partial = false;
+    source.tools.push_back({{"name", "ping"}});
+    auto recovered = catalog.snapshot();
+    EXPECT_EQ(recovered->tools.size(), 2u);
+    EXPECT_EQ(source.loads, 2);
+
+    // 完整结果按 maxAge 缓存
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_EQ(catalog.snapshot(), recovered);
+    EXPECT_EQ(source.loads, 2);
+
+    // 整体拉取失败：保留旧快照，同样在 retryInterval 后重试
+    source.fail = true;
+    catalog.invalidate();
+    EXPECT_EQ(catalog.snapshot(), recovered);
+    EXPECT_EQ(source.loads, 3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    catalog.snapshot();
+    EXPECT_EQ(source.loads, 4);
+}
+
+TEST(ToolCatalogTest, ConcurrentReadersShareOneLoad)
+{
+    std::atomic<int> loads{0};
+    ToolCatalog catalog(
+        [&](bool*)
+        {
+            ++loads;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return json::array({weatherTool()});
+        });
+
+    std::vector<std::thread> threads;
+    std::atomic<int> nonEmpty{0};
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back(
+            [&]
+            {
+                for (int i = 0; i < 100; ++i) nonEmpty += !catalog.snapshot()->empty();
+            });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(loads, 1);
+    EXPECT_EQ(nonEmpty, 800);
+}
+
+TEST(ToolSnapshotTest, SplicesToolsIntoSerializedRequest)
+{
+    ToolSnapshot snap;
+    snap.tools = ToolCatalog::toOpenAiTools(json::array({weatherTool()}));
+    snap.toolsJson = snap.tools.dump();
+
+    json payload = {{"model", "qwen-plus"}, {"messages", json::array()}, {"stream", true}};
+    json spliced = json::parse(snap.spliceInto(payload.dump()));
+    EXPECT_EQ(spliced["tools"], snap.tools);
+    EXPECT_EQ(spliced["model"], "qwen-plus");
+    EXPECT_EQ(spliced.size(), 4u);
+
+    EXPECT_EQ(json::parse(snap.spliceInto("{}")), json({{"tools", snap.tools}}));
+    EXPECT_EQ(ToolSnapshot().spliceInto(payload.dump()), payload.dump());
+}
@@ -214,6 +214,10 @@ export async function fetchSessions(sessions, renderSessions) {
 
 // ---- SSE 流式发送 ----
 
+// 流中断后的续传次数与退避基数（服务端断线宽限期为 30s）
+const SSE_RESUME_RETRIES = 5;
+const SSE_RESUME_DELAY_MS = 1000;
+
 export async function sendWithSSE(question, modelType, provider, modelName, sessionId, ragId, endpointId, sessions, appendMsg, imageBase64) {
     const tk = document.querySelector('#thinkingMsg');
     if (tk) tk.remove();
@@ -228,58 +232,88 @@ export async function sendWithSSE(question, modelType, provider, modelName, sess
 
     let fullContent = '';
     let resolvedSid = sessionId;
+    // 断线续传：记下最后一个事件 ID，网络中断时带 Last-Event-ID 重发，服务端补发错过的事件并接上实时输出
+    let lastEventId = '';
+    let finished = false;
+    let failed = false;
+
+    const body = { question, modelType, provider, sessionId, ragId, endpointId };
+    if (imageBase64) body.image_base64 = imageBase64;
+
+    for (let attempt = 0; !finished && attempt <= SSE_RESUME_RETRIES; attempt++) {
+        if (attempt > 0) {
+            if (!lastEventId) break;  // 尚未收到任何事件，无从续传
+            await new Promise(r => setTimeout(r, SSE_RESUME_DELAY_MS * attempt));
+        }
+        try {
+            const headers = { 'Content-Type': 'application/json', 'X-Stream-Resume': '1' };
+            if (lastEventId) headers['Last-Event-ID'] = lastEventId;
+            const response = await fetch('/chat/send-stream', {
+                method: 'POST',
+                headers,
+                credentials: 'include',
+                body: JSON.stringify(body)
+            });
+            if (lastEventId && !response.ok) {
+                // 流已过期（超过服务端宽限期）
+                span.textContent = '连接中断，请重新生成';
+                finished = true;
+                break;
+            }
 
-    try {
-        const body = { question, modelType, provider, sessionId, ragId, endpointId };
-        if (imageBase64) body.image_base64 = imageBase64;
-        const response = await fetch('/chat/send-stream', {
-            method: 'POST',
-            headers: { 'Content-Type': 'application/json' },
-            credentials: 'include',
-            body: JSON.stringify(body)
-        });
-
-        const reader = response.body.getReader();
-        const decoder = new TextDecoder();
-        let buf = '';
-
-        while (true) {
-            const { done, value } = await reader.read();
-            if (done) break;
-            buf += decoder.decode(value, { stream: true });
-
-            const lines = buf.split('\n');
-            buf = lines.pop();
-
-            for (const line of lines) {
-                const trimmed = line.trim();
-                if (!trimmed || trimmed === 'data: [DONE]') continue;
-                if (trimmed.startsWith('data: ')) {
-                    try {
-                        const payload = JSON.parse(trimmed.slice(6));
-                        if (payload.sessionId && !resolvedSid) {
-                            resolvedSid = String(payload.sessionId);
-                            sessions[resolvedSid] = {
-                                name: question.slice(0, 18) + '...',
-                                messages: [{ role: 'user', content: question }]
-                            };
-                            continue;
-                        }
-                        if (payload.token) {
-                            fullContent += payload.token;
-                            span.innerHTML = DOMPurify.sanitize(marked.parse(fullContent));
-                            chatArea.scrollTop = chatArea.scrollHeight;
-                        }
-                        if (payload.error) {
-                            span.textContent = '错误: ' + payload.error;
-                        }
-                    } catch (_) { }
+            const reader = response.body.getReader();
+            const decoder = new TextDecoder();
+            let buf = '';
+
+            while (true) {
+                const { done, value } = await reader.read();
+                if (done) break;
+                buf += decoder.decode(value, { stream: true });
+
+                const lines = buf.split('\n');
+                buf = lines.pop();
+
+                for (const line of lines) {
+                    const trimmed = line.trim();
+                    if (!trimmed) continue;
+                    if (trimmed === 'data: [DONE]') {
+                        finished = true;
+                        continue;
+                    }
+                    if (trimmed.startsWith('id: ')) {
+                        lastEventId = trimmed.slice(4);
+                        continue;
+                    }
+                    if (trimmed.startsWith('data: ')) {
+                        try {
+                            const payload = JSON.parse(trimmed.slice(6));
+                            if (payload.sessionId && !resolvedSid) {
+                                resolvedSid = String(payload.sessionId);
+                                sessions[resolvedSid] = {
+                                    name: question.slice(0, 18) + '...',
+                                    messages: [{ role: 'user', content: question }]
+                                };
+                                continue;
+                            }
+                            if (payload.token) {
+                                fullContent += payload.token;
+                                span.innerHTML = DOMPurify.sanitize(marked.parse(fullContent));
+                                chatArea.scrollTop = chatArea.scrollHeight;
+                            }
+                            if (payload.error) {
+                                span.textContent = '错误: ' + payload.error;
+                            }
+                        } catch (_) { }
+                    }
                 }
             }
+            failed = false;
+            if (!lastEventId) break;  // 非流式响应（如 401 / 429），不重试
+        } catch (err) {
+            failed = true;
         }
-    } catch (err) {
-        span.textContent = '无法连接到服务器';
     }
+    if (failed) span.textContent = '无法连接到服务器';
 
     const esc = fullContent.replace(/`/g, '\\`').replace(/\$/g, '\\$');
     const acts = document.createElement('div');